@@ -1,7 +1,12 @@
 include_guard(GLOBAL)
 
 prepend(POPULAR_COMMON_SOURCES ${COMMON_DIR}/
+        algorithms/gbdt-inference.cpp
+        algorithms/json-string-scan.cpp
+        algorithms/json-structural-index.cpp
         algorithms/simd-int-to-string.cpp
+        algorithms/simd-string-search.cpp
+        algorithms/simd-vector-ops.cpp
         server/limits.cpp
         server/signals.cpp
         server/relogin.cpp
@@ -0,0 +1,136 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/algorithms/gbdt-inference.h"
+
+namespace {
+
+constexpr int TREES_COUNT = 500;
+constexpr int MAX_DEPTH = 6;
+constexpr int FEATURES_COUNT = 100;
+
+// the straightforward evaluation of the trees: a node refers to its children, a row goes through a tree node by node
+struct NaiveNode {
+  int feature{-1};
+  float threshold{0};
+  int yes{-1};
+  int no{-1};
+  int missing{-1};
+  float leaf_value{0};
+};
+
+using NaiveTree = std::vector<NaiveNode>;
+
+// generates a random tree in the XGBoost text dump format, the nodes are numbered in the depth first order
+void gen_tree(std::mt19937 &gen, NaiveTree &tree, int depth, std::string &dump) {
+  const int id = static_cast<int>(tree.size());
+  tree.emplace_back();
+  const std::string indent(depth, '\t');
+  if (depth == MAX_DEPTH || gen() % 8 == 0) {
+    const std::string leaf_value = std::to_string(static_cast<float>(static_cast<int>(gen() % 2001) - 1000) / 997);
+    tree[id].leaf_value = std::stof(leaf_value);
+    dump += indent + std::to_string(id) + ":leaf=" + leaf_value + "\n";
+    return;
+  }
+  const int feature = static_cast<int>(gen() % FEATURES_COUNT);
+  const float threshold = static_cast<float>(static_cast<int>(gen() % 21) - 10) / 4;
+  std::string children_dump;
+  const int yes = static_cast<int>(tree.size());
+  gen_tree(gen, tree, depth + 1, children_dump);
+  const int no = static_cast<int>(tree.size());
+  gen_tree(gen, tree, depth + 1, children_dump);
+  const int missing = gen() % 2 ? yes : no;
+  tree[id] = NaiveNode{feature, threshold, yes, no, missing, 0};
+  dump += indent + std::to_string(id) + ":[f" + std::to_string(feature) + "<" + std::to_string(threshold) + "] yes=" + std::to_string(yes) +
+          ",no=" + std::to_string(no) + ",missing=" + std::to_string(missing) + "\n" + children_dump;
+}
+
+float naive_predict(const std::vector<NaiveTree> &trees, const float *row) noexcept {
+  float sum = 0;
+  for (const auto &tree : trees) {
+    const NaiveNode *node = &tree[0];
+    while (node->feature != -1) {
+      const float value = row[node->feature];
+      node = &tree[std::isnan(value) ? node->missing : (value < node->threshold ? node->yes : node->no)];
+    }
+    sum += node->leaf_value;
+  }
+  return sum;
+}
+
+struct BenchmarkModel {
+  std::vector<NaiveTree> trees;
+  GbdtModel model;
+
+  BenchmarkModel() {
+    std::mt19937 gen{42};
+    std::string dump;
+    trees.resize(TREES_COUNT);
+    for (int i = 0; i < TREES_COUNT; ++i) {
+      dump += "booster[" + std::to_string(i) + "]:\n";
+      gen_tree(gen, trees[i], 0, dump);
+    }
+    std::string error;
+    if (!model.load_xgboost_dump(dump.data(), dump.size(), error)) {
+      std::abort();
+    }
+  }
+};
+
+const BenchmarkModel &get_model() {
+  static const BenchmarkModel model;
+  return model;
+}
+
+std::vector<float> gen_rows(size_t rows_count) {
+  std::mt19937 gen{7};
+  std::vector<float> rows(rows_count * FEATURES_COUNT);
+  for (auto &x : rows) {
+    x = gen() % 10 ? static_cast<float>(static_cast<int>(gen() % 25) - 12) / 4 : std::numeric_limits<float>::quiet_NaN();
+  }
+  return rows;
+}
+
+} // namespace
+
+static void BM_gbdt_naive_tree_walk(benchmark::State &state) {
+  const auto &model = get_model();
+  const size_t rows_count = state.range(0);
+  const std::vector<float> rows = gen_rows(rows_count);
+  std::vector<float> out(rows_count);
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < rows_count; ++i) {
+      out[i] = naive_predict(model.trees, rows.data() + i * FEATURES_COUNT);
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * rows_count);
+}
+BENCHMARK(BM_gbdt_naive_tree_walk)->RangeMultiplier(8)->Range(8, 8 << 9);
+
+static void BM_gbdt_flattened_predict(benchmark::State &state) {
+  const auto &model = get_model();
+  const size_t rows_count = state.range(0);
+  const std::vector<float> rows = gen_rows(rows_count);
+  std::vector<float> out(rows_count);
+
+  for (auto _ : state) {
+    model.model.predict(rows.data(), rows_count, FEATURES_COUNT, out.data());
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * rows_count);
+}
+BENCHMARK(BM_gbdt_flattened_predict)->RangeMultiplier(8)->Range(8, 8 << 9);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,118 @@
+#include <cmath>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/algorithms/gbdt-inference.h"
+
+namespace {
+
+struct ReferenceNode {
+  int feature{-1};
+  float threshold{0};
+  int yes{-1};
+  int no{-1};
+  int missing{-1};
+  float leaf_value{0};
+};
+
+using ReferenceTree = std::map<int, ReferenceNode>;
+
+// generates a random tree in the XGBoost text dump format, the nodes are numbered in the depth first order
+void gen_tree(std::mt19937 &gen, ReferenceTree &tree, int depth, int features_count, std::string &dump) {
+  const int id = static_cast<int>(tree.size());
+  ReferenceNode &node = tree[id];
+  const std::string indent(depth, '\t');
+  if (depth == 6 || gen() % 4 == 0) {
+    const std::string leaf_value = std::to_string(static_cast<float>(static_cast<int>(gen() % 2001) - 1000) / 997);
+    node.leaf_value = std::stof(leaf_value);
+    dump += indent + std::to_string(id) + ":leaf=" + leaf_value + ",cover=1\n";
+    return;
+  }
+  node.feature = static_cast<int>(gen() % features_count);
+  node.threshold = static_cast<float>(static_cast<int>(gen() % 21) - 10) / 4;
+  std::string line = indent + std::to_string(id) + ":[f" + std::to_string(node.feature) + "<" + std::to_string(node.threshold) + "] ";
+  std::string children_dump;
+  node.yes = static_cast<int>(tree.size());
+  gen_tree(gen, tree, depth + 1, features_count, children_dump);
+  tree[id].no = static_cast<int>(tree.size());
+  gen_tree(gen, tree, depth + 1, features_count, children_dump);
+  ReferenceNode &split = tree[id];
+  split.missing = gen() % 2 ? split.yes : split.no;
+  dump += line + "yes=" + std::to_string(split.yes) + ",no=" + std::to_string(split.no) + ",missing=" + std::to_string(split.missing) + "\n" + children_dump;
+}
+
+float reference_predict(const std::vector<ReferenceTree> &trees, const float *row) {
+  float sum = 0;
+  for (const auto &tree : trees) {
+    const ReferenceNode *node = &tree.at(0);
+    while (node->feature != -1) {
+      const float value = row[node->feature];
+      node = &tree.at(std::isnan(value) ? node->missing : (value < node->threshold ? node->yes : node->no));
+    }
+    sum += node->leaf_value;
+  }
+  return sum;
+}
+
+} // namespace
+
+TEST(gbdt_inference, predict) {
+  std::mt19937 gen{42};
+  const int features_count = 13;
+  std::vector<ReferenceTree> trees(50);
+  std::string dump;
+  for (size_t i = 0; i < trees.size(); ++i) {
+    dump += "booster[" + std::to_string(i) + "]:\n";
+    gen_tree(gen, trees[i], 0, features_count, dump);
+  }
+
+  GbdtModel model;
+  std::string error;
+  ASSERT_TRUE(model.load_xgboost_dump(dump.data(), dump.size(), error)) << error;
+  ASSERT_EQ(model.trees_count(), trees.size());
+  ASSERT_LE(model.features_count(), features_count);
+
+  for (size_t stride : {size_t{features_count}, size_t{features_count + 3}}) {
+    for (size_t rows_count = 0; rows_count < 40; ++rows_count) {
+      std::vector<float> rows(rows_count * stride);
+      for (auto &x : rows) {
+        x = gen() % 7 ? static_cast<float>(static_cast<int>(gen() % 25) - 12) / 4 : std::numeric_limits<float>::quiet_NaN();
+      }
+      std::vector<float> out(rows_count);
+      model.predict(rows.data(), rows_count, stride, out.data());
+      for (size_t i = 0; i < rows_count; ++i) {
+        ASSERT_EQ(out[i], reference_predict(trees, rows.data() + i * stride));
+      }
+    }
+  }
+}
+
+TEST(gbdt_inference, single_leaf) {
+  const std::string dump = "booster[0]:\n0:leaf=0.5\nbooster[1]:\n0:leaf=-0.25\n";
+  GbdtModel model;
+  std::string error;
+  ASSERT_TRUE(model.load_xgboost_dump(dump.data(), dump.size(), error)) << error;
+  ASSERT_EQ(model.features_count(), 0);
+  const std::vector<float> rows(10, 1.0);
+  std::vector<float> out(rows.size());
+  model.predict(rows.data(), rows.size(), 1, out.data());
+  for (float x : out) {
+    ASSERT_EQ(x, 0.25);
+  }
+}
+
+TEST(gbdt_inference, bad_dump) {
+  for (const char *dump : {"", "0:leaf=1\n", "booster[0]:\n", "booster[0]:\n0:[f0<1] yes=1,no=2,missing=1\n1:leaf=1\n",
+                           "booster[0]:\n0:[f0<1] yes=1,no=1,missing=1\n1:leaf=1\n", "booster[0]:\n0:[f0<1] yes=1,no=2,missing=3\n1:leaf=1\n2:leaf=2\n",
+                           "booster[0]:\n0:[f0] yes=1,no=2,missing=1\n1:leaf=1\n2:leaf=2\n", "booster[0]:\n0:leaf=1\n0:leaf=2\n"}) {
+    GbdtModel model;
+    std::string error;
+    ASSERT_FALSE(model.load_xgboost_dump(dump, strlen(dump), error)) << dump;
+    ASSERT_FALSE(error.empty());
+  }
+}
@@ -0,0 +1,213 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include "common/algorithms/gbdt-inference.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "common/cpuid.h"
+
+namespace {
+
+struct ParsedNode {
+  bool defined{false};
+  bool is_leaf{false};
+  int32_t feature{0};
+  float threshold{0};
+  int32_t yes{-1};
+  int32_t no{-1};
+  int32_t missing{-1};
+  float leaf_value{0};
+};
+
+constexpr int32_t MAX_NODES_COUNT = std::numeric_limits<int32_t>::max() >> 2;
+
+#if defined(__x86_64__)
+const bool has_avx2 = kdb_cpuid_has_avx2();
+#endif
+
+} // namespace
+
+bool GbdtModel::load_xgboost_dump(const char *text, size_t size, std::string &error) {
+  *this = GbdtModel{};
+
+  std::vector<std::vector<ParsedNode>> trees;
+  size_t line_number = 0;
+  for (size_t pos = 0; pos < size;) {
+    const char *line_end = static_cast<const char *>(memchr(text + pos, '\n', size - pos));
+    const size_t line_len = line_end ? line_end - (text + pos) : size - pos;
+    const std::string line{text + pos, line_len};
+    pos += line_len + 1;
+    ++line_number;
+
+    const size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos) {
+      continue;
+    }
+    const char *s = line.c_str() + first;
+    if (!strncmp(s, "booster[", 8)) {
+      trees.emplace_back();
+      continue;
+    }
+    if (trees.empty()) {
+      error = "line " + std::to_string(line_number) + ": a node before the first 'booster[...]:' line";
+      return false;
+    }
+
+    ParsedNode node;
+    int32_t id = -1;
+    if (sscanf(s, "%d:leaf=%f", &id, &node.leaf_value) == 2) {
+      node.is_leaf = true;
+    } else if (sscanf(s, "%d:[f%d<%f] yes=%d,no=%d,missing=%d", &id, &node.feature, &node.threshold, &node.yes, &node.no, &node.missing) != 6) {
+      error = "line " + std::to_string(line_number) + ": can't parse the node '" + line + "'";
+      return false;
+    }
+    if (id < 0 || id >= MAX_NODES_COUNT || node.feature < 0 || (!node.is_leaf && node.missing != node.yes && node.missing != node.no)) {
+      error = "line " + std::to_string(line_number) + ": bad node '" + line + "'";
+      return false;
+    }
+    auto &nodes = trees.back();
+    if (nodes.size() <= id) {
+      nodes.resize(id + 1);
+    }
+    if (nodes[id].defined) {
+      error = "line " + std::to_string(line_number) + ": node " + std::to_string(id) + " is defined twice";
+      return false;
+    }
+    node.defined = true;
+    nodes[id] = node;
+  }
+
+  for (size_t tree_id = 0; tree_id < trees.size(); ++tree_id) {
+    const auto &nodes = trees[tree_id];
+    const std::string tree_name = "booster[" + std::to_string(tree_id) + "]";
+    if (nodes.empty() || !nodes[0].defined) {
+      error = tree_name + ": there is no root node";
+      return false;
+    }
+
+    // breadth first layout, the children of a node are placed next to each other
+    std::vector<int32_t> order{0};
+    std::vector<int32_t> node_depths{0};
+    std::vector<int32_t> new_index(nodes.size(), -1);
+    new_index[0] = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+      const ParsedNode &node = nodes[order[i]];
+      if (node.is_leaf) {
+        continue;
+      }
+      for (int32_t child : {node.yes, node.no}) {
+        if (child < 0 || child >= nodes.size() || !nodes[child].defined || new_index[child] != -1) {
+          error = tree_name + ": bad child " + std::to_string(child) + " of node " + std::to_string(order[i]);
+          return false;
+        }
+        new_index[child] = static_cast<int32_t>(order.size());
+        order.push_back(child);
+        node_depths.push_back(node_depths[i] + 1);
+      }
+    }
+
+    const int32_t base = static_cast<int32_t>(features_.size());
+    if (order.size() > MAX_NODES_COUNT - base) {
+      error = "too many nodes";
+      return false;
+    }
+    roots_.push_back(base);
+    depths_.push_back(*std::max_element(node_depths.begin(), node_depths.end()));
+    for (int32_t id : order) {
+      const ParsedNode &node = nodes[id];
+      if (node.is_leaf) {
+        features_.push_back(0);
+        thresholds_.push_back(0);
+        children_.push_back(static_cast<int32_t>(features_.size() - 1) << 2);
+        leaf_values_.push_back(node.leaf_value);
+      } else {
+        features_.push_back(node.feature);
+        thresholds_.push_back(node.threshold);
+        children_.push_back((base + new_index[node.yes]) << 2 | 2 | (node.missing == node.yes));
+        leaf_values_.push_back(0);
+        features_count_ = std::max(features_count_, static_cast<size_t>(node.feature) + 1);
+      }
+    }
+  }
+
+  if (roots_.empty()) {
+    error = "there are no trees";
+    return false;
+  }
+  return true;
+}
+
+int32_t GbdtModel::next_node(int32_t node, const float *row) const noexcept {
+  const int32_t children = children_[node];
+  const float value = row[features_[node]];
+  const bool go_yes = value < thresholds_[node] || (std::isnan(value) && (children & 1));
+  return (children >> 2) + (go_yes ? 0 : (children >> 1 & 1));
+}
+
+void GbdtModel::scalar_predict(const float *rows, size_t rows_count, size_t stride, float *out) const noexcept {
+  for (size_t i = 0; i < rows_count; ++i) {
+    const float *row = rows + i * stride;
+    float sum = 0;
+    for (int32_t node : roots_) {
+      // a split node always has the "no" child offset
+      while (children_[node] & 2) {
+        node = next_node(node, row);
+      }
+      sum += leaf_values_[node];
+    }
+    out[i] = sum;
+  }
+}
+
+#if defined(__x86_64__)
+
+[[gnu::target("avx2")]] void GbdtModel::avx2_predict(const float *rows, size_t rows_count, size_t stride, float *out) const noexcept {
+  const __m256i lane_offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(static_cast<int32_t>(stride)));
+  const __m256i one = _mm256_set1_epi32(1);
+  size_t i = 0;
+  for (; i + 8 <= rows_count; i += 8) {
+    const float *block = rows + i * stride;
+    __m256 sums = _mm256_setzero_ps();
+    for (size_t tree = 0; tree < roots_.size(); ++tree) {
+      // the leaves refer to themselves, so the lanes which have already reached a leaf stay there
+      __m256i nodes = _mm256_set1_epi32(roots_[tree]);
+      for (int32_t step = 0; step < depths_[tree]; ++step) {
+        const __m256i features = _mm256_i32gather_epi32(features_.data(), nodes, 4);
+        const __m256 thresholds = _mm256_i32gather_ps(thresholds_.data(), nodes, 4);
+        const __m256i children = _mm256_i32gather_epi32(children_.data(), nodes, 4);
+        const __m256 values = _mm256_i32gather_ps(block, _mm256_add_epi32(lane_offsets, features), 4);
+        const __m256 missing_go_yes = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(children, one), one));
+        const __m256 go_yes = _mm256_or_ps(_mm256_cmp_ps(values, thresholds, _CMP_LT_OQ),
+                                           _mm256_and_ps(_mm256_cmp_ps(values, values, _CMP_UNORD_Q), missing_go_yes));
+        const __m256i no_offset = _mm256_and_si256(_mm256_srli_epi32(children, 1), one);
+        nodes = _mm256_add_epi32(_mm256_srli_epi32(children, 2), _mm256_andnot_si256(_mm256_castps_si256(go_yes), no_offset));
+      }
+      sums = _mm256_add_ps(sums, _mm256_i32gather_ps(leaf_values_.data(), nodes, 4));
+    }
+    _mm256_storeu_ps(out + i, sums);
+  }
+  scalar_predict(rows + i * stride, rows_count - i, stride, out + i);
+}
+
+#endif
+
+void GbdtModel::predict(const float *rows, size_t rows_count, size_t stride, float *out) const noexcept {
+#if defined(__x86_64__)
+  // the gather offsets of a block of 8 rows must fit int32
+  if (has_avx2 && stride <= std::numeric_limits<int32_t>::max() / 8) {
+    avx2_predict(rows, rows_count, stride, out);
+    return;
+  }
+#endif
+  scalar_predict(rows, rows_count, stride, out);
+}
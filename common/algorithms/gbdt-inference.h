@@ -0,0 +1,50 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// An ensemble of gradient boosted decision trees (e.g. trained by XGBoost) flattened for the batch inference.
+// The nodes of all the trees are stored as a structure of arrays; the "yes" and "no" children of a split node are adjacent,
+// and a leaf refers to itself, so several rows are pushed through a tree at once for the fixed number of steps (the tree depth).
+class GbdtModel {
+public:
+  // Parses the text dump of an XGBoost model (Booster.dump_model() output) with the features named f0, f1, ...
+  // Returns false and sets the error message on failure.
+  bool load_xgboost_dump(const char *text, size_t size, std::string &error);
+
+  bool empty() const noexcept { return roots_.empty(); }
+  size_t trees_count() const noexcept { return roots_.size(); }
+  // the maximal feature index used by the splits plus one
+  size_t features_count() const noexcept { return features_count_; }
+
+  // Computes the sums of the tree leaves (the raw margins) for the dense rows: row i starts at rows + i * stride,
+  // stride must be at least max(features_count(), 1), NaN is a missing value.
+  // The result is the same as the one of the tree by tree scalar evaluation.
+  void predict(const float *rows, size_t rows_count, size_t stride, float *out) const noexcept;
+
+private:
+  // split: the feature index, leaf: 0
+  std::vector<int32_t> features_;
+  // split: go to the "yes" child if the feature value is less than the threshold
+  std::vector<float> thresholds_;
+  // the index of the "yes" child << 2 | the "no" child offset from it << 1 | the missing values go to the "yes" child;
+  // a leaf refers to itself with zero offset
+  std::vector<int32_t> children_;
+  std::vector<float> leaf_values_;
+
+  std::vector<int32_t> roots_;
+  std::vector<int32_t> depths_;
+  size_t features_count_{0};
+
+  int32_t next_node(int32_t node, const float *row) const noexcept;
+  void scalar_predict(const float *rows, size_t rows_count, size_t stride, float *out) const noexcept;
+#if defined(__x86_64__)
+  void avx2_predict(const float *rows, size_t rows_count, size_t stride, float *out) const noexcept;
+#endif
+};
@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+
+#include "common/algorithms/json-string-scan.h"
+
+namespace {
+
+size_t plain_prefix_length_naive(const std::string &s, bool ascii_only) {
+  size_t pos = 0;
+  for (; pos < s.size(); ++pos) {
+    const auto c = static_cast<unsigned char>(s[pos]);
+    if (c == '"' || c == '\\' || c == '/' || c < 0x20 || (ascii_only && c >= 0x80)) {
+      break;
+    }
+  }
+  return pos;
+}
+
+} // namespace
+
+TEST(json_string_scan, simple) {
+  ASSERT_EQ(json_plain_prefix_length("", 0), 0);
+  ASSERT_EQ(json_plain_prefix_length("hello", 5), 5);
+  ASSERT_EQ(json_plain_prefix_length("hello \"world\"", 13), 6);
+  ASSERT_EQ(json_plain_prefix_length("a/b", 3), 1);
+  ASSERT_EQ(json_plain_prefix_length("abcdefghijklmnopqrstuvwxyz\\", 27), 26);
+  ASSERT_EQ(json_plain_prefix_length("abcdefghijklmnopqrstuvwxyz0123456789\n", 37), 36);
+
+  const std::string unicode = "привет, мир\t";
+  ASSERT_EQ(json_plain_prefix_length(unicode.data(), unicode.size()), unicode.size() - 1);
+  ASSERT_EQ(json_ascii_plain_prefix_length(unicode.data(), unicode.size()), 0);
+  ASSERT_EQ(json_ascii_plain_prefix_length("0123456789abcdef\x7f\x80", 18), 17);
+}
+
+TEST(json_string_scan, random) {
+  std::mt19937 gen{17};
+  const char alphabet[] = {'a', 'b', ' ', '"', '\\', '/', '\0', '\n', '\x1f', '\x7f', '\x80', '\xff'};
+  for (int i = 0; i < 20000; ++i) {
+    std::string s(gen() % 100, 'x');
+    // mostly clean strings with a few special characters
+    for (int j = gen() % 4; j > 0 && !s.empty(); --j) {
+      s[gen() % s.size()] = alphabet[gen() % sizeof(alphabet)];
+    }
+    ASSERT_EQ(json_plain_prefix_length(s.data(), s.size()), plain_prefix_length_naive(s, false)) << s;
+    ASSERT_EQ(json_ascii_plain_prefix_length(s.data(), s.size()), plain_prefix_length_naive(s, true)) << s;
+  }
+}
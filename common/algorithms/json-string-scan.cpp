@@ -0,0 +1,109 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include "common/algorithms/json-string-scan.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "common/cpuid.h"
+
+namespace {
+
+template<bool ascii_only>
+inline bool is_plain_char(char c) noexcept {
+  if (c == '"' || c == '\\' || c == '/') {
+    return false;
+  }
+  return ascii_only ? c >= 0x20 : static_cast<unsigned char>(c) >= 0x20;
+}
+
+template<bool ascii_only>
+inline size_t scalar_plain_prefix_length(const char *s, size_t begin, size_t len) noexcept {
+  size_t pos = begin;
+  while (pos < len && is_plain_char<ascii_only>(s[pos])) {
+    ++pos;
+  }
+  return pos;
+}
+
+#if defined(__x86_64__)
+
+template<bool ascii_only>
+inline int sse_special_chars_mask(const char *s) noexcept {
+  const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+  const __m128i escaped = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('"')), _mm_cmpeq_epi8(chars, _mm_set1_epi8('\\'))),
+                                       _mm_cmpeq_epi8(chars, _mm_set1_epi8('/')));
+  // the signed comparison matches both control characters and non-ascii bytes
+  const __m128i controls = ascii_only ? _mm_cmplt_epi8(chars, _mm_set1_epi8(0x20))
+                                      : _mm_cmpeq_epi8(_mm_max_epu8(chars, _mm_set1_epi8(0x1f)), _mm_set1_epi8(0x1f));
+  return _mm_movemask_epi8(_mm_or_si128(escaped, controls));
+}
+
+template<bool ascii_only>
+[[gnu::target("avx2")]] inline int avx2_special_chars_mask(const char *s) noexcept {
+  const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s));
+  const __m256i escaped = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8('"')), _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('\\'))),
+                                          _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('/')));
+  const __m256i controls = ascii_only ? _mm256_cmpgt_epi8(_mm256_set1_epi8(0x20), chars)
+                                      : _mm256_cmpeq_epi8(_mm256_max_epu8(chars, _mm256_set1_epi8(0x1f)), _mm256_set1_epi8(0x1f));
+  return _mm256_movemask_epi8(_mm256_or_si256(escaped, controls));
+}
+
+template<bool ascii_only>
+size_t sse_plain_prefix_length(const char *s, size_t len) noexcept {
+  size_t pos = 0;
+  for (; pos + 16 <= len; pos += 16) {
+    if (const int mask = sse_special_chars_mask<ascii_only>(s + pos)) {
+      return pos + __builtin_ctz(mask);
+    }
+  }
+  return scalar_plain_prefix_length<ascii_only>(s, pos, len);
+}
+
+template<bool ascii_only>
+[[gnu::target("avx2")]] size_t avx2_plain_prefix_length(const char *s, size_t len) noexcept {
+  size_t pos = 0;
+  for (; pos + 32 <= len; pos += 32) {
+    if (const int mask = avx2_special_chars_mask<ascii_only>(s + pos)) {
+      return pos + __builtin_ctz(mask);
+    }
+  }
+  if (pos + 16 <= len) {
+    if (const int mask = sse_special_chars_mask<ascii_only>(s + pos)) {
+      return pos + __builtin_ctz(mask);
+    }
+    pos += 16;
+  }
+  return scalar_plain_prefix_length<ascii_only>(s, pos, len);
+}
+
+using plain_prefix_length_t = size_t (*)(const char *s, size_t len) noexcept;
+
+const bool has_avx2 = kdb_cpuid_has_avx2();
+const plain_prefix_length_t plain_prefix_length_impl = has_avx2 ? avx2_plain_prefix_length<false> : sse_plain_prefix_length<false>;
+const plain_prefix_length_t ascii_plain_prefix_length_impl = has_avx2 ? avx2_plain_prefix_length<true> : sse_plain_prefix_length<true>;
+
+#else
+
+size_t plain_prefix_length_impl(const char *s, size_t len) noexcept {
+  return scalar_plain_prefix_length<false>(s, 0, len);
+}
+
+size_t ascii_plain_prefix_length_impl(const char *s, size_t len) noexcept {
+  return scalar_plain_prefix_length<true>(s, 0, len);
+}
+
+#endif
+
+} // namespace
+
+size_t json_plain_prefix_length(const char *s, size_t len) noexcept {
+  return plain_prefix_length_impl(s, len);
+}
+
+size_t json_ascii_plain_prefix_length(const char *s, size_t len) noexcept {
+  return ascii_plain_prefix_length_impl(s, len);
+}
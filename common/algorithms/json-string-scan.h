@@ -0,0 +1,14 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <cstddef>
+
+// Json string encoders copy the characters which don't need escaping as is:
+// these functions return the length of the longest prefix of s without quotes, backslashes, slashes and control characters,
+// the ascii version stops at non-ascii bytes as well (they are validated and escaped as utf-8 sequences).
+// The input is scanned by 16 or 32 bytes, so long clean runs are found much faster than char by char.
+size_t json_plain_prefix_length(const char *s, size_t len) noexcept;
+size_t json_ascii_plain_prefix_length(const char *s, size_t len) noexcept;
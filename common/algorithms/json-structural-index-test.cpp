@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/algorithms/json-structural-index.h"
+
+namespace {
+
+std::vector<uint32_t> index_json(const std::string &json, bool &unclosed_string) {
+  std::vector<uint32_t> positions;
+  uint32_t chunk[JsonStructuralIndexer::CHUNK_SIZE];
+  JsonStructuralIndexer indexer{json.data(), static_cast<uint32_t>(json.size())};
+  while (!indexer.finished()) {
+    const size_t count = indexer.index_next_chunk(chunk);
+    positions.insert(positions.end(), chunk, chunk + count);
+  }
+  unclosed_string = indexer.has_unclosed_string();
+  return positions;
+}
+
+// character by character implementation of the same rules
+std::vector<uint32_t> index_json_naive(const std::string &json, bool &unclosed_string) {
+  std::vector<uint32_t> positions;
+  bool in_string = false;
+  bool escape_next = false;
+  bool prev_scalar = false;
+  for (uint32_t i = 0; i < json.size(); ++i) {
+    const char c = json[i];
+    const bool escaped = escape_next;
+    escape_next = !escaped && c == '\\';
+    const bool quote = c == '"' && !escaped;
+    const bool op = c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',';
+    const bool whitespace = c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    const bool scalar = !in_string && !quote && !op && !whitespace;
+    if (quote || (op && !in_string) || (scalar && !prev_scalar)) {
+      positions.emplace_back(i);
+    }
+    if (quote) {
+      in_string = !in_string;
+    }
+    prev_scalar = scalar;
+  }
+  unclosed_string = in_string;
+  return positions;
+}
+
+} // namespace
+
+TEST(json_structural_index, simple) {
+  bool unclosed_string = false;
+  const std::string json = R"({"a\"b": [1, true, "x,y"], "c":null} )";
+  const std::vector<uint32_t> expected{0, 1, 6, 7, 9, 10, 11, 13, 17, 19, 23, 24, 25, 27, 29, 30, 31, 35};
+  ASSERT_EQ(index_json(json, unclosed_string), expected);
+  ASSERT_FALSE(unclosed_string);
+
+  index_json(R"(["abc\"])", unclosed_string);
+  ASSERT_TRUE(unclosed_string);
+}
+
+TEST(json_structural_index, random_inputs) {
+  const char alphabet[] = {'"', '"', '\\', '\\', '\\', ' ', '\n', '{', '}', '[', ']', ':', ',', 'a', '1'};
+  std::mt19937 gen{42};
+  for (int test = 0; test != 10000; ++test) {
+    std::string json(gen() % 300, ' ');
+    for (char &c : json) {
+      c = alphabet[gen() % sizeof(alphabet)];
+    }
+    bool unclosed_string = false;
+    bool expected_unclosed_string = false;
+    ASSERT_EQ(index_json(json, unclosed_string), index_json_naive(json, expected_unclosed_string)) << json;
+    ASSERT_EQ(unclosed_string, expected_unclosed_string) << json;
+  }
+}
+
+TEST(json_structural_index, long_input) {
+  std::string json = "[";
+  for (int i = 0; i != 10000; ++i) {
+    json += R"({"key\\": "value \" , [] {}", "x": -1.5e3},)";
+  }
+  json += "null]";
+  bool unclosed_string = false;
+  bool expected_unclosed_string = false;
+  ASSERT_EQ(index_json(json, unclosed_string), index_json_naive(json, expected_unclosed_string));
+  ASSERT_FALSE(unclosed_string);
+}
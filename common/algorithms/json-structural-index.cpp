@@ -0,0 +1,220 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include "common/algorithms/json-structural-index.h"
+
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "common/cpuid.h"
+
+namespace {
+
+struct BlockMasks {
+  uint64_t whitespace{0};
+  uint64_t op{0};
+  uint64_t quote{0};
+  uint64_t backslash{0};
+};
+
+struct IndexerState {
+  uint64_t &prev_escaped;
+  uint64_t &prev_in_string;
+  uint64_t &prev_scalar;
+};
+
+#if defined(__x86_64__)
+
+// whitespaces and operators are found by the lookup of the low nibble: a character is classified
+// if it is equal to the table value (for operators the comparison is done with 0x20 bit set, so '[' is looked up as '{' and ']' as '}'),
+// other characters with the same low nibble are either unequal or are invalid outside of strings anyway
+#define JSON_WHITESPACE_TABLE ' ', 100, 100, 100, 17, 100, 113, 2, 100, '\t', '\n', 112, 100, '\r', 100, 100
+#define JSON_OP_TABLE 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, ':', '{', ',', '}', 0, 0
+
+struct SseClassifier {
+  [[gnu::always_inline]] static inline BlockMasks classify(const char *block) noexcept {
+    const __m128i whitespace_table = _mm_setr_epi8(JSON_WHITESPACE_TABLE);
+    const __m128i op_table = _mm_setr_epi8(JSON_OP_TABLE);
+    BlockMasks masks;
+    for (int i = 0; i != 4; ++i) {
+      const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 16 * i));
+      const __m128i whitespace = _mm_cmpeq_epi8(in, _mm_shuffle_epi8(whitespace_table, in));
+      const __m128i op = _mm_cmpeq_epi8(_mm_or_si128(in, _mm_set1_epi8(0x20)), _mm_shuffle_epi8(op_table, in));
+      masks.whitespace |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(whitespace))) << (16 * i);
+      masks.op |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(op))) << (16 * i);
+      masks.quote |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(in, _mm_set1_epi8('"'))))) << (16 * i);
+      masks.backslash |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(in, _mm_set1_epi8('\\'))))) << (16 * i);
+    }
+    return masks;
+  }
+};
+
+struct Avx2Classifier {
+  [[gnu::target("avx2")]] static inline BlockMasks classify(const char *block) noexcept {
+    const __m256i whitespace_table = _mm256_setr_epi8(JSON_WHITESPACE_TABLE, JSON_WHITESPACE_TABLE);
+    const __m256i op_table = _mm256_setr_epi8(JSON_OP_TABLE, JSON_OP_TABLE);
+    BlockMasks masks;
+    for (int i = 0; i != 2; ++i) {
+      const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + 32 * i));
+      const __m256i whitespace = _mm256_cmpeq_epi8(in, _mm256_shuffle_epi8(whitespace_table, in));
+      const __m256i op = _mm256_cmpeq_epi8(_mm256_or_si256(in, _mm256_set1_epi8(0x20)), _mm256_shuffle_epi8(op_table, in));
+      masks.whitespace |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(whitespace))) << (32 * i);
+      masks.op |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(op))) << (32 * i);
+      masks.quote |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('"'))))) << (32 * i);
+      masks.backslash |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('\\'))))) << (32 * i);
+    }
+    return masks;
+  }
+};
+
+#undef JSON_WHITESPACE_TABLE
+#undef JSON_OP_TABLE
+
+[[gnu::always_inline]] inline uint64_t prefix_xor(uint64_t bits) noexcept {
+  // carry-less multiplication by all ones, PCLMUL is a part of the target architecture
+  const __m128i result = _mm_clmulepi64_si128(_mm_set_epi64x(0, static_cast<int64_t>(bits)), _mm_set1_epi8(-1), 0);
+  return static_cast<uint64_t>(_mm_cvtsi128_si64(result));
+}
+
+#else
+
+struct ScalarClassifier {
+  static BlockMasks classify(const char *block) noexcept {
+    BlockMasks masks;
+    for (size_t i = 0; i != JsonStructuralIndexer::BLOCK_SIZE; ++i) {
+      const uint64_t bit = uint64_t{1} << i;
+      switch (block[i]) {
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+          masks.whitespace |= bit;
+          break;
+        case '{':
+        case '}':
+        case '[':
+        case ']':
+        case ':':
+        case ',':
+          masks.op |= bit;
+          break;
+        case '"':
+          masks.quote |= bit;
+          break;
+        case '\\':
+          masks.backslash |= bit;
+          break;
+        default:
+          break;
+      }
+    }
+    return masks;
+  }
+};
+
+inline uint64_t prefix_xor(uint64_t bits) noexcept {
+  bits ^= bits << 1;
+  bits ^= bits << 2;
+  bits ^= bits << 4;
+  bits ^= bits << 8;
+  bits ^= bits << 16;
+  bits ^= bits << 32;
+  return bits;
+}
+
+#endif
+
+// returns the characters escaped by backslashes: the ones following an odd-length sequence of backslashes
+[[gnu::always_inline]] inline uint64_t find_escaped(uint64_t backslash, uint64_t &prev_escaped) noexcept {
+  constexpr uint64_t even_bits = 0x5555555555555555ULL;
+  // if the first character is escaped by the previous block, it can't start a new escape
+  backslash &= ~prev_escaped;
+  const uint64_t follows_escape = backslash << 1 | prev_escaped;
+  // the sum turns every sequence started on an odd bit into a carry to the bit after it, so sequences started on even bits remain
+  const uint64_t odd_sequence_starts = backslash & ~even_bits & ~follows_escape;
+  uint64_t sequences_starting_on_even_bits = 0;
+  prev_escaped = __builtin_add_overflow(odd_sequence_starts, backslash, &sequences_starting_on_even_bits);
+  const uint64_t invert_mask = sequences_starting_on_even_bits << 1;
+  return (even_bits ^ invert_mask) & follows_escape;
+}
+
+template<class Classifier>
+[[gnu::always_inline]] inline uint64_t find_tokens(const char *block, IndexerState state) noexcept {
+  const BlockMasks masks = Classifier::classify(block);
+
+  const uint64_t escaped = find_escaped(masks.backslash, state.prev_escaped);
+  const uint64_t quote = masks.quote & ~escaped;
+  // the mask is set from the opening quote (inclusive) to the closing quote (exclusive)
+  const uint64_t in_string = prefix_xor(quote) ^ state.prev_in_string;
+  state.prev_in_string = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+
+  const uint64_t op = masks.op & ~in_string;
+  const uint64_t scalar = ~(masks.whitespace | masks.op | quote | in_string);
+  const uint64_t scalar_starts = scalar & ~(scalar << 1 | state.prev_scalar);
+  state.prev_scalar = scalar >> 63;
+
+  return op | quote | scalar_starts;
+}
+
+[[gnu::always_inline]] inline size_t write_positions(uint64_t tokens, uint32_t block_offset, uint32_t *out) noexcept {
+  size_t count = 0;
+  while (tokens) {
+    out[count++] = block_offset + static_cast<uint32_t>(__builtin_ctzll(tokens));
+    tokens &= tokens - 1;
+  }
+  return count;
+}
+
+template<class Classifier>
+[[gnu::always_inline]] inline size_t index_blocks(const char *s, uint32_t begin, uint32_t end, IndexerState state, uint32_t *out) noexcept {
+  size_t count = 0;
+  uint32_t offset = begin;
+  for (; offset + JsonStructuralIndexer::BLOCK_SIZE <= end; offset += JsonStructuralIndexer::BLOCK_SIZE) {
+    count += write_positions(find_tokens<Classifier>(s + offset, state), offset, out + count);
+  }
+  if (offset != end) {
+    // the tail is padded by whitespaces, they don't produce tokens
+    char block[JsonStructuralIndexer::BLOCK_SIZE];
+    memset(block, ' ', sizeof(block));
+    memcpy(block, s + offset, end - offset);
+    count += write_positions(find_tokens<Classifier>(block, state), offset, out + count);
+  }
+  return count;
+}
+
+using index_blocks_t = size_t (*)(const char *s, uint32_t begin, uint32_t end, IndexerState state, uint32_t *out) noexcept;
+
+#if defined(__x86_64__)
+
+size_t index_blocks_sse(const char *s, uint32_t begin, uint32_t end, IndexerState state, uint32_t *out) noexcept {
+  return index_blocks<SseClassifier>(s, begin, end, state, out);
+}
+
+[[gnu::target("avx2")]] size_t index_blocks_avx2(const char *s, uint32_t begin, uint32_t end, IndexerState state, uint32_t *out) noexcept {
+  return index_blocks<Avx2Classifier>(s, begin, end, state, out);
+}
+
+const index_blocks_t index_blocks_impl = kdb_cpuid_has_avx2() ? index_blocks_avx2 : index_blocks_sse;
+
+#else
+
+// the scalar classifier is used on aarch64 and the other non x86-64 platforms
+const index_blocks_t index_blocks_impl = index_blocks<ScalarClassifier>;
+
+#endif
+
+} // namespace
+
+JsonStructuralIndexer::JsonStructuralIndexer(const char *s, uint32_t len) noexcept
+  : s_(s)
+  , len_(len) {}
+
+size_t JsonStructuralIndexer::index_next_chunk(uint32_t *out) noexcept {
+  const uint32_t begin = offset_;
+  offset_ = len_ - offset_ > CHUNK_SIZE ? offset_ + static_cast<uint32_t>(CHUNK_SIZE) : len_;
+  return index_blocks_impl(s_, begin, offset_, IndexerState{prev_escaped_, prev_in_string_, prev_scalar_}, out);
+}
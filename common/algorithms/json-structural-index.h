@@ -0,0 +1,42 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// The first stage of json parsing (the approach of simdjson, https://arxiv.org/abs/1902.08318):
+// the input is classified by 64 bytes blocks with SIMD instructions into bitmasks of quotes, backslashes, whitespaces and operators,
+// the bitmasks are combined to find the strings, and positions of all the tokens are extracted from them.
+// The tokens are the operators {}[]:, outside of strings, both quotes of every string and the first character of every other value.
+// The second stage (grammar checking and values decoding) is done by the caller over the found positions.
+class JsonStructuralIndexer {
+public:
+  static constexpr size_t BLOCK_SIZE = 64;
+  static constexpr size_t CHUNK_SIZE = 64 * BLOCK_SIZE;
+
+  JsonStructuralIndexer(const char *s, uint32_t len) noexcept;
+
+  // indexes the next (up to) CHUNK_SIZE bytes of input, writes at most CHUNK_SIZE positions into out and returns their count
+  size_t index_next_chunk(uint32_t *out) noexcept;
+
+  bool finished() const noexcept {
+    return offset_ >= len_;
+  }
+
+  // makes sense after the whole input is indexed
+  bool has_unclosed_string() const noexcept {
+    return prev_in_string_ != 0;
+  }
+
+private:
+  const char *s_{nullptr};
+  uint32_t len_{0};
+  uint32_t offset_{0};
+
+  uint64_t prev_escaped_{0};
+  uint64_t prev_in_string_{0};
+  uint64_t prev_scalar_{0};
+};
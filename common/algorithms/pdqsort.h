@@ -0,0 +1,221 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+// Pattern-defeating quicksort (https://arxiv.org/abs/2106.05123): a quicksort with median of 3 / ninther pivots,
+// insertion sort for small ranges, detection of already sorted ranges and of ranges with many equal elements,
+// and a fallback to heapsort when the partitions are too unbalanced too many times.
+// Unlike the original, all the loops are guarded by the range bounds:
+// the comparator can be a user function, which doesn't have to be a strict weak ordering.
+namespace vk {
+namespace pdqsort_impl {
+
+constexpr ptrdiff_t INSERTION_SORT_THRESHOLD = 24;
+constexpr ptrdiff_t NINTHER_THRESHOLD = 128;
+constexpr ptrdiff_t PARTIAL_INSERTION_SORT_LIMIT = 8;
+
+template<typename Iter, typename Less>
+void insertion_sort(Iter begin, Iter end, Less &less) {
+  if (begin == end) {
+    return;
+  }
+  for (Iter cur = begin + 1; cur != end; ++cur) {
+    Iter sift = cur;
+    Iter sift_1 = cur - 1;
+    if (less(*sift, *sift_1)) {
+      auto tmp = std::move(*sift);
+      do {
+        *sift-- = std::move(*sift_1);
+      } while (sift != begin && less(tmp, *--sift_1));
+      *sift = std::move(tmp);
+    }
+  }
+}
+
+// the same as insertion_sort, but gives up and returns false after too many moves
+template<typename Iter, typename Less>
+bool partial_insertion_sort(Iter begin, Iter end, Less &less) {
+  if (begin == end) {
+    return true;
+  }
+  ptrdiff_t moves = 0;
+  for (Iter cur = begin + 1; cur != end; ++cur) {
+    Iter sift = cur;
+    Iter sift_1 = cur - 1;
+    if (less(*sift, *sift_1)) {
+      auto tmp = std::move(*sift);
+      do {
+        *sift-- = std::move(*sift_1);
+      } while (sift != begin && less(tmp, *--sift_1));
+      *sift = std::move(tmp);
+      moves += cur - sift;
+    }
+    if (moves > PARTIAL_INSERTION_SORT_LIMIT) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template<typename Iter, typename Less>
+void sort2(Iter a, Iter b, Less &less) {
+  if (less(*b, *a)) {
+    std::iter_swap(a, b);
+  }
+}
+
+template<typename Iter, typename Less>
+void sort3(Iter a, Iter b, Iter c, Less &less) {
+  sort2(a, b, less);
+  sort2(b, c, less);
+  sort2(a, b, less);
+}
+
+// partitions the range around the pivot *begin: the elements less than the pivot go to the left, the rest go to the right;
+// returns the final position of the pivot and whether the range was already partitioned
+template<typename Iter, typename Less>
+std::pair<Iter, bool> partition_right(Iter begin, Iter end, Less &less) {
+  auto pivot = std::move(*begin);
+  Iter first = begin;
+  Iter last = end;
+  while (++first < last && less(*first, pivot)) {
+  }
+  while (--last > first && !less(*last, pivot)) {
+  }
+  const bool already_partitioned = first >= last;
+  while (first < last) {
+    std::iter_swap(first, last);
+    while (++first < last && less(*first, pivot)) {
+    }
+    while (--last > first && !less(*last, pivot)) {
+    }
+  }
+
+  Iter pivot_pos = first - 1;
+  if (pivot_pos != begin) {
+    *begin = std::move(*pivot_pos);
+  }
+  *pivot_pos = std::move(pivot);
+  return {pivot_pos, already_partitioned};
+}
+
+// the same as partition_right, but the elements equal to the pivot go to the left;
+// it's used when the pivot is equal to the element before the range, so all the left part consists of equal elements
+template<typename Iter, typename Less>
+Iter partition_left(Iter begin, Iter end, Less &less) {
+  auto pivot = std::move(*begin);
+  Iter first = begin;
+  Iter last = end;
+  while (--last > first && less(pivot, *last)) {
+  }
+  while (++first < last && !less(pivot, *first)) {
+  }
+  while (first < last) {
+    std::iter_swap(first, last);
+    while (--last > first && less(pivot, *last)) {
+    }
+    while (++first < last && !less(pivot, *first)) {
+    }
+  }
+
+  Iter pivot_pos = last;
+  if (pivot_pos != begin) {
+    *begin = std::move(*pivot_pos);
+  }
+  *pivot_pos = std::move(pivot);
+  return pivot_pos;
+}
+
+template<typename Iter, typename Less>
+void pdqsort_loop(Iter begin, Iter end, Less &less, int bad_allowed, bool leftmost) {
+  while (true) {
+    const ptrdiff_t size = end - begin;
+    if (size < INSERTION_SORT_THRESHOLD) {
+      insertion_sort(begin, end, less);
+      return;
+    }
+
+    // the pivot is placed at *begin
+    const ptrdiff_t s2 = size / 2;
+    if (size > NINTHER_THRESHOLD) {
+      sort3(begin, begin + s2, end - 1, less);
+      sort3(begin + 1, begin + (s2 - 1), end - 2, less);
+      sort3(begin + 2, begin + (s2 + 1), end - 3, less);
+      sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), less);
+      std::iter_swap(begin, begin + s2);
+    } else {
+      sort3(begin + s2, begin, end - 1, less);
+    }
+
+    // the element before the range is not greater than any element of the range,
+    // if it's equal to the pivot, the equal elements are gathered at the left and don't need sorting
+    if (!leftmost && !less(*(begin - 1), *begin)) {
+      begin = partition_left(begin, end, less) + 1;
+      continue;
+    }
+
+    const auto [pivot_pos, already_partitioned] = partition_right(begin, end, less);
+    const ptrdiff_t l_size = pivot_pos - begin;
+    const ptrdiff_t r_size = end - (pivot_pos + 1);
+    if (l_size < size / 8 || r_size < size / 8) {
+      if (--bad_allowed == 0) {
+        std::make_heap(begin, end, less);
+        std::sort_heap(begin, end, less);
+        return;
+      }
+      // break the patterns which lead to bad pivots
+      if (l_size >= INSERTION_SORT_THRESHOLD) {
+        std::iter_swap(begin, begin + l_size / 4);
+        std::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+        if (l_size > NINTHER_THRESHOLD) {
+          std::iter_swap(begin + 1, begin + (l_size / 4 + 1));
+          std::iter_swap(begin + 2, begin + (l_size / 4 + 2));
+          std::iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+          std::iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+        }
+      }
+      if (r_size >= INSERTION_SORT_THRESHOLD) {
+        std::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+        std::iter_swap(end - 1, end - r_size / 4);
+        if (r_size > NINTHER_THRESHOLD) {
+          std::iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+          std::iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+          std::iter_swap(end - 2, end - (1 + r_size / 4));
+          std::iter_swap(end - 3, end - (2 + r_size / 4));
+        }
+      }
+    } else if (already_partitioned && partial_insertion_sort(begin, pivot_pos, less) && partial_insertion_sort(pivot_pos + 1, end, less)) {
+      // a balanced partition without swaps is likely to be of an already sorted range
+      return;
+    }
+
+    pdqsort_loop(begin, pivot_pos, less, bad_allowed, leftmost);
+    begin = pivot_pos + 1;
+    leftmost = false;
+  }
+}
+
+} // namespace pdqsort_impl
+
+template<typename Iter, typename Less = std::less<typename std::iterator_traits<Iter>::value_type>>
+void pdqsort(Iter begin, Iter end, Less less = Less()) {
+  const auto size = end - begin;
+  if (size < 2) {
+    return;
+  }
+  int log2_size = 0;
+  for (auto n = size; n > 1; n >>= 1) {
+    ++log2_size;
+  }
+  pdqsort_impl::pdqsort_loop(begin, end, less, log2_size, true);
+}
+
+} // namespace vk
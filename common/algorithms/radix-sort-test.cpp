@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/algorithms/pdqsort.h"
+#include "common/algorithms/radix-sort.h"
+
+TEST(pdqsort, patterns) {
+  std::mt19937 gen{7};
+  for (size_t n : {0, 1, 2, 10, 23, 24, 25, 100, 129, 1000, 10000}) {
+    std::vector<std::vector<int>> inputs(6, std::vector<int>(n));
+    for (size_t i = 0; i < n; ++i) {
+      inputs[0][i] = gen();
+      inputs[1][i] = i;
+      inputs[2][i] = n - i;
+      inputs[3][i] = gen() % 3;
+      inputs[4][i] = i % 2 ? i : n - i;
+      inputs[5][i] = 42;
+    }
+    for (auto &v : inputs) {
+      auto expected = v;
+      std::sort(expected.begin(), expected.end());
+      vk::pdqsort(v.begin(), v.end());
+      ASSERT_EQ(v, expected);
+    }
+  }
+}
+
+TEST(pdqsort, inconsistent_comparator) {
+  std::mt19937 gen{7};
+  std::vector<int> v(10000);
+  std::iota(v.begin(), v.end(), 0);
+  // an arbitrary user comparator must not break the memory
+  vk::pdqsort(v.begin(), v.end(), [&gen](int, int) { return gen() % 2 == 0; });
+  std::sort(v.begin(), v.end());
+  for (int i = 0; i < v.size(); ++i) {
+    ASSERT_EQ(v[i], i);
+  }
+}
+
+TEST(radix_sort, numbers) {
+  std::mt19937_64 gen{7};
+  std::vector<int64_t> ints(100000);
+  for (auto &x : ints) {
+    x = gen() % 3 == 0 ? static_cast<int64_t>(gen()) : static_cast<int64_t>(gen() % 1000) - 500;
+  }
+  ints[0] = std::numeric_limits<int64_t>::min();
+  ints[1] = std::numeric_limits<int64_t>::max();
+  auto expected_ints = ints;
+  std::sort(expected_ints.begin(), expected_ints.end());
+  std::vector<int64_t> int_buffer(ints.size());
+  vk::radix_sort(ints.data(), ints.size(), int_buffer.data(), [](int64_t x) { return vk::radix_sort_key(x); });
+  ASSERT_EQ(ints, expected_ints);
+
+  std::vector<double> doubles(100000);
+  for (auto &x : doubles) {
+    x = std::uniform_real_distribution<double>{-1e6, 1e6}(gen);
+  }
+  doubles[0] = -std::numeric_limits<double>::infinity();
+  doubles[1] = std::numeric_limits<double>::infinity();
+  doubles[2] = std::numeric_limits<double>::denorm_min();
+  doubles[3] = -0.5;
+  auto expected_doubles = doubles;
+  std::sort(expected_doubles.begin(), expected_doubles.end());
+  std::vector<double> double_buffer(doubles.size());
+  vk::radix_sort(doubles.data(), doubles.size(), double_buffer.data(), [](double x) { return vk::radix_sort_key(x); });
+  ASSERT_EQ(doubles, expected_doubles);
+}
+
+TEST(radix_sort, strings) {
+  std::mt19937 gen{7};
+  std::vector<std::string> strings(50000);
+  for (auto &s : strings) {
+    s.resize(gen() % 12);
+    // zero bytes are the same as padding of short strings
+
+    for (auto &c : s) {
+      c = static_cast<char>(gen() % 4 ? 'a' + gen() % 3 : gen() % 256);
+    }
+  }
+  // long common prefixes
+  for (int i = 0; i < 1000; ++i) {
+    strings.push_back(std::string(100, 'x') + std::to_string(gen() % 100));
+  }
+  auto expected = strings;
+  std::sort(expected.begin(), expected.end());
+  std::vector<vk::StringRadixSortRecord> buffer(2 * strings.size());
+  vk::string_radix_sort(strings.data(), strings.size(), buffer.data(), [](const std::string &s) { return std::string_view{s}; });
+  ASSERT_EQ(strings, expected);
+}
@@ -0,0 +1,123 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "common/algorithms/pdqsort.h"
+
+namespace vk {
+
+// the unsigned keys which are ordered in the same way as the values
+inline uint64_t radix_sort_key(int64_t value) noexcept {
+  return static_cast<uint64_t>(value) ^ (uint64_t{1} << 63);
+}
+
+// NaNs don't have an order, they must not be sorted this way
+inline uint64_t radix_sort_key(double value) noexcept {
+  uint64_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return (bits >> 63) ? ~bits : bits | (uint64_t{1} << 63);
+}
+
+// LSD radix sort by the bytes of 64-bit keys, the passes over the bytes which are the same in all the keys are skipped;
+// the buffer must have room for n values
+template<typename T, typename ToKey>
+void radix_sort(T *data, size_t n, T *buffer, const ToKey &to_key) noexcept {
+  static_assert(std::is_trivially_copyable<T>{}, "values are copied byte by byte");
+  if (n < 2) {
+    return;
+  }
+
+  std::array<std::array<size_t, 256>, sizeof(uint64_t)> counts{};
+  for (size_t i = 0; i < n; ++i) {
+    const uint64_t key = to_key(data[i]);
+    for (size_t byte = 0; byte < sizeof(uint64_t); ++byte) {
+      ++counts[byte][(key >> (8 * byte)) & 0xff];
+    }
+  }
+
+  T *from = data;
+  T *to = buffer;
+  const uint64_t first_key = to_key(data[0]);
+  for (size_t byte = 0; byte < sizeof(uint64_t); ++byte) {
+    auto &offsets = counts[byte];
+    const size_t shift = 8 * byte;
+    if (offsets[(first_key >> shift) & 0xff] == n) {
+      continue;
+    }
+    size_t offset = 0;
+    for (auto &count : offsets) {
+      offset += std::exchange(count, offset);
+    }
+    for (size_t i = 0; i < n; ++i) {
+      to[offsets[(to_key(from[i]) >> shift) & 0xff]++] = from[i];
+    }
+    std::swap(from, to);
+  }
+  if (from != data) {
+    std::memcpy(data, from, n * sizeof(T));
+  }
+}
+
+struct StringRadixSortRecord {
+  uint64_t prefix;
+  uint32_t index;
+};
+
+// the strings are sorted in the byte lexicographical order by their 8-byte prefixes with radix_sort() above,
+// then the runs of equal prefixes are sorted by comparisons, and the strings are permuted in place;
+// to_view maps the values into std::string_view, the buffer must have room for 2 * n records
+template<typename T, typename ToView>
+void string_radix_sort(T *data, uint32_t n, StringRadixSortRecord *buffer, const ToView &to_view) {
+  StringRadixSortRecord *records = buffer;
+  for (uint32_t i = 0; i < n; ++i) {
+    const std::string_view s = to_view(data[i]);
+    unsigned char prefix_bytes[sizeof(uint64_t)] = {0};
+    std::memcpy(prefix_bytes, s.data(), std::min(s.size(), sizeof(prefix_bytes)));
+    uint64_t prefix = 0;
+    for (auto byte : prefix_bytes) {
+      prefix = (prefix << 8) | byte;
+    }
+    records[i] = StringRadixSortRecord{prefix, i};
+  }
+  radix_sort(records, n, buffer + n, [](const StringRadixSortRecord &record) { return record.prefix; });
+
+  // the strings shorter than the prefix are padded with zeroes, so the runs may consist of different strings of any length
+  for (uint32_t run_begin = 0, run_end = 0; run_begin < n; run_begin = run_end) {
+    while (++run_end < n && records[run_end].prefix == records[run_begin].prefix) {
+    }
+    if (run_end - run_begin > 1) {
+      pdqsort(records + run_begin, records + run_end, [&to_view, data](const StringRadixSortRecord &lhs, const StringRadixSortRecord &rhs) {
+        return to_view(data[lhs.index]) < to_view(data[rhs.index]);
+      });
+    }
+  }
+
+  // records[i].index is the current position of the string which goes to i
+  for (uint32_t i = 0; i < n; ++i) {
+    if (records[i].index == i) {
+      continue;
+    }
+    T value = std::move(data[i]);
+    uint32_t j = i;
+    while (records[j].index != i) {
+      const uint32_t source = records[j].index;
+      data[j] = std::move(data[source]);
+      records[j].index = j;
+      j = source;
+    }
+    data[j] = std::move(value);
+    records[j].index = j;
+  }
+}
+
+} // namespace vk
@@ -0,0 +1,46 @@
+#include <cstring>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+
+#include "common/algorithms/simd-string-search.h"
+
+namespace {
+
+const char *naive_memmem(const std::string &haystack, const std::string &needle) {
+  const size_t pos = haystack.find(needle);
+  return pos == std::string::npos ? nullptr : haystack.c_str() + pos;
+}
+
+} // namespace
+
+TEST(simd_string_search, simple) {
+  const std::string haystack = "hello world, hello kphp";
+  ASSERT_EQ(simd_memmem(haystack.c_str(), haystack.size(), "", 0), haystack.c_str());
+  ASSERT_EQ(simd_memmem(haystack.c_str(), haystack.size(), "w", 1), haystack.c_str() + 6);
+  ASSERT_EQ(simd_memmem(haystack.c_str(), haystack.size(), "hello", 5), haystack.c_str());
+  ASSERT_EQ(simd_memmem(haystack.c_str(), haystack.size(), "kphp", 4), haystack.c_str() + 19);
+  ASSERT_EQ(simd_memmem(haystack.c_str(), haystack.size(), "kphp!", 5), nullptr);
+  ASSERT_EQ(simd_memmem(haystack.c_str(), 3, "hello", 5), nullptr);
+  ASSERT_EQ(simd_memmem("", 0, "a", 1), nullptr);
+}
+
+TEST(simd_string_search, random) {
+  std::mt19937 gen{42};
+  for (int iteration = 0; iteration < 20000; ++iteration) {
+    std::string haystack(gen() % 300, '\0');
+    for (auto &c : haystack) {
+      c = static_cast<char>('a' + gen() % 3);
+    }
+    std::string needle(1 + gen() % 12, '\0');
+    for (auto &c : needle) {
+      c = static_cast<char>('a' + gen() % 3);
+    }
+    if (gen() % 2 && needle.size() <= haystack.size()) {
+      // the needle is placed at the end to check the tails
+      haystack.replace(haystack.size() - needle.size(), needle.size(), needle);
+    }
+    ASSERT_EQ(simd_memmem(haystack.c_str(), haystack.size(), needle.c_str(), needle.size()), naive_memmem(haystack, needle))
+      << haystack << " " << needle;
+  }
+}
@@ -0,0 +1,73 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include "common/algorithms/simd-string-search.h"
+
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "common/cpuid.h"
+
+namespace {
+
+#if defined(__x86_64__)
+
+// the needle is at least 2 bytes long and is not longer than the haystack
+const char *sse_memmem(const char *haystack, size_t haystack_len, const char *needle, size_t needle_len) noexcept {
+  const __m128i first = _mm_set1_epi8(needle[0]);
+  const __m128i last = _mm_set1_epi8(needle[needle_len - 1]);
+  size_t pos = 0;
+  for (; pos + needle_len + 15 <= haystack_len; pos += 16) {
+    const __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + pos));
+    const __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + pos + needle_len - 1));
+    for (unsigned mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last))); mask; mask &= mask - 1) {
+      const char *candidate = haystack + pos + __builtin_ctz(mask);
+      if (!std::memcmp(candidate + 1, needle + 1, needle_len - 2)) {
+        return candidate;
+      }
+    }
+  }
+  return static_cast<const char *>(memmem(haystack + pos, haystack_len - pos, needle, needle_len));
+}
+
+[[gnu::target("avx2")]] const char *avx2_memmem(const char *haystack, size_t haystack_len, const char *needle, size_t needle_len) noexcept {
+  const __m256i first = _mm256_set1_epi8(needle[0]);
+  const __m256i last = _mm256_set1_epi8(needle[needle_len - 1]);
+  size_t pos = 0;
+  for (; pos + needle_len + 31 <= haystack_len; pos += 32) {
+    const __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + pos));
+    const __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + pos + needle_len - 1));
+    for (unsigned mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(block_first, first), _mm256_cmpeq_epi8(block_last, last))); mask; mask &= mask - 1) {
+      const char *candidate = haystack + pos + __builtin_ctz(mask);
+      if (!std::memcmp(candidate + 1, needle + 1, needle_len - 2)) {
+        return candidate;
+      }
+    }
+  }
+  // the rest is shorter than 32 + needle_len bytes
+  return sse_memmem(haystack + pos, haystack_len - pos, needle, needle_len);
+}
+
+const bool has_avx2 = kdb_cpuid_has_avx2();
+
+#endif
+
+} // namespace
+
+const char *simd_memmem(const char *haystack, size_t haystack_len, const char *needle, size_t needle_len) noexcept {
+  if (needle_len > haystack_len) {
+    return nullptr;
+  }
+  if (needle_len <= 1) {
+    return needle_len ? static_cast<const char *>(std::memchr(haystack, needle[0], haystack_len)) : haystack;
+  }
+#if defined(__x86_64__)
+  return has_avx2 ? avx2_memmem(haystack, haystack_len, needle, needle_len) : sse_memmem(haystack, haystack_len, needle, needle_len);
+#else
+  return static_cast<const char *>(memmem(haystack, haystack_len, needle, needle_len));
+#endif
+}
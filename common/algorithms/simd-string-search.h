@@ -0,0 +1,12 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <cstddef>
+
+// The same as memmem(3): returns the first occurrence of the needle in the haystack or nullptr.
+// The candidates are found by 16 or 32 positions at once: their first and last bytes are compared
+// with the first and last bytes of the needle, and only the matched positions are compared with memcmp.
+const char *simd_memmem(const char *haystack, size_t haystack_len, const char *needle, size_t needle_len) noexcept;
@@ -0,0 +1,93 @@
+#include <cmath>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "common/algorithms/simd-vector-ops.h"
+
+namespace {
+
+template<typename T>
+T naive_min(const std::vector<T> &data, bool is_max) {
+  T res = data[0];
+  for (const T &x : data) {
+    if (is_max ? res < x : x < res) {
+      res = x;
+    }
+  }
+  return res;
+}
+
+bool same_double(double lhs, double rhs) {
+  return std::memcmp(&lhs, &rhs, sizeof(double)) == 0;
+}
+
+} // namespace
+
+TEST(simd_vector_ops, int64) {
+  std::mt19937_64 gen{123};
+  for (size_t n = 0; n < 200; ++n) {
+    std::vector<int64_t> data(n);
+    for (auto &x : data) {
+      x = gen() % 3 ? static_cast<int64_t>(gen() % 100) - 50 : static_cast<int64_t>(gen());
+    }
+    for (int64_t value : {int64_t{-50}, int64_t{0}, int64_t{49}, int64_t{100}}) {
+      size_t expected = 0;
+      while (expected < n && data[expected] != value) {
+        ++expected;
+      }
+      ASSERT_EQ(simd_find_int64(data.data(), n, value), expected);
+    }
+
+    uint64_t sum = 0;
+    for (auto x : data) {
+      sum += static_cast<uint64_t>(x);
+    }
+    ASSERT_EQ(simd_sum_int64(data.data(), n), static_cast<int64_t>(sum));
+
+    if (n) {
+      ASSERT_EQ(simd_min_int64(data.data(), n), naive_min(data, false));
+      ASSERT_EQ(simd_max_int64(data.data(), n), naive_min(data, true));
+    }
+  }
+
+  const std::vector<int64_t> limits{std::numeric_limits<int64_t>::max(), 0, std::numeric_limits<int64_t>::min(), 1, 2, 3, 4, 5, 6};
+  ASSERT_EQ(simd_min_int64(limits.data(), limits.size()), std::numeric_limits<int64_t>::min());
+  ASSERT_EQ(simd_max_int64(limits.data(), limits.size()), std::numeric_limits<int64_t>::max());
+}
+
+TEST(simd_vector_ops, double) {
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  std::mt19937_64 gen{321};
+  for (size_t n = 1; n < 200; ++n) {
+    for (int iteration = 0; iteration < 10; ++iteration) {
+      std::vector<double> data(n);
+      for (auto &x : data) {
+        switch (gen() % 8) {
+          case 0:
+            x = nan;
+            break;
+          case 1:
+            x = 0.0;
+            break;
+          case 2:
+            x = -0.0;
+            break;
+          default:
+            x = static_cast<double>(static_cast<int64_t>(gen() % 200) - 100) / 8;
+        }
+      }
+      for (double value : {0.0, -0.0, 1.5, nan, 1000.0}) {
+        size_t expected = 0;
+        while (expected < n && !(data[expected] == value)) {
+          ++expected;
+        }
+        ASSERT_EQ(simd_find_double(data.data(), n, value), expected);
+      }
+      ASSERT_TRUE(same_double(simd_min_double(data.data(), n), naive_min(data, false)));
+      ASSERT_TRUE(same_double(simd_max_double(data.data(), n), naive_min(data, true)));
+    }
+  }
+}
@@ -0,0 +1,259 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include "common/algorithms/simd-vector-ops.h"
+
+#include <cmath>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "common/cpuid.h"
+
+namespace {
+
+template<typename T>
+inline size_t scalar_find(const T *data, size_t begin, size_t n, T value) noexcept {
+  for (size_t i = begin; i < n; ++i) {
+    if (data[i] == value) {
+      return i;
+    }
+  }
+  return n;
+}
+
+inline uint64_t scalar_sum(const int64_t *data, size_t begin, size_t n, uint64_t sum) noexcept {
+  for (size_t i = begin; i < n; ++i) {
+    sum += static_cast<uint64_t>(data[i]);
+  }
+  return sum;
+}
+
+template<typename T, typename Less>
+inline T scalar_min(const T *data, size_t begin, size_t n, T res, const Less &less) noexcept {
+  for (size_t i = begin; i < n; ++i) {
+    if (less(data[i], res)) {
+      res = data[i];
+    }
+  }
+  return res;
+}
+
+constexpr auto int_less = [](int64_t lhs, int64_t rhs) { return lhs < rhs; };
+constexpr auto int_greater = [](int64_t lhs, int64_t rhs) { return lhs > rhs; };
+
+#if defined(__x86_64__) && defined(__SSE4_2__)
+
+inline __m128i sse_load(const int64_t *p) noexcept {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+}
+
+[[gnu::target("avx2")]] inline __m256i avx2_load(const int64_t *p) noexcept {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+size_t sse_find_int64(const int64_t *data, size_t n, int64_t value) noexcept {
+  const __m128i v = _mm_set1_epi64x(value);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m128i eq = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi64(sse_load(data + i), v), _mm_cmpeq_epi64(sse_load(data + i + 2), v)),
+                                    _mm_or_si128(_mm_cmpeq_epi64(sse_load(data + i + 4), v), _mm_cmpeq_epi64(sse_load(data + i + 6), v)));
+    if (!_mm_testz_si128(eq, eq)) {
+      return scalar_find(data, i, i + 8, value);
+    }
+  }
+  return scalar_find(data, i, n, value);
+}
+
+[[gnu::target("avx2")]] size_t avx2_find_int64(const int64_t *data, size_t n, int64_t value) noexcept {
+  const __m256i v = _mm256_set1_epi64x(value);
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m256i eq = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi64(avx2_load(data + i), v), _mm256_cmpeq_epi64(avx2_load(data + i + 4), v)),
+                                       _mm256_or_si256(_mm256_cmpeq_epi64(avx2_load(data + i + 8), v), _mm256_cmpeq_epi64(avx2_load(data + i + 12), v)));
+    if (!_mm256_testz_si256(eq, eq)) {
+      return scalar_find(data, i, i + 16, value);
+    }
+  }
+  return scalar_find(data, i, n, value);
+}
+
+int64_t sse_sum_int64(const int64_t *data, size_t n) noexcept {
+  __m128i acc0 = _mm_setzero_si128();
+  __m128i acc1 = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    acc0 = _mm_add_epi64(acc0, sse_load(data + i));
+    acc1 = _mm_add_epi64(acc1, sse_load(data + i + 2));
+  }
+  const __m128i acc = _mm_add_epi64(acc0, acc1);
+  const uint64_t sum = static_cast<uint64_t>(_mm_cvtsi128_si64(acc)) + static_cast<uint64_t>(_mm_extract_epi64(acc, 1));
+  return static_cast<int64_t>(scalar_sum(data, i, n, sum));
+}
+
+[[gnu::target("avx2")]] int64_t avx2_sum_int64(const int64_t *data, size_t n) noexcept {
+  __m256i acc0 = _mm256_setzero_si256();
+  __m256i acc1 = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm256_add_epi64(acc0, avx2_load(data + i));
+    acc1 = _mm256_add_epi64(acc1, avx2_load(data + i + 4));
+  }
+  const __m256i acc = _mm256_add_epi64(acc0, acc1);
+  const __m128i half = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+  const uint64_t sum = static_cast<uint64_t>(_mm_cvtsi128_si64(half)) + static_cast<uint64_t>(_mm_extract_epi64(half, 1));
+  return static_cast<int64_t>(scalar_sum(data, i, n, sum));
+}
+
+// the lanes are compared with cmpgt(a, b), so min and max differ only in the order of the arguments
+template<bool is_max>
+int64_t sse_min_int64(const int64_t *data, size_t n) noexcept {
+  __m128i acc0 = _mm_set1_epi64x(data[0]);
+  __m128i acc1 = acc0;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m128i x0 = sse_load(data + i);
+    const __m128i x1 = sse_load(data + i + 2);
+    acc0 = _mm_blendv_epi8(acc0, x0, is_max ? _mm_cmpgt_epi64(x0, acc0) : _mm_cmpgt_epi64(acc0, x0));
+    acc1 = _mm_blendv_epi8(acc1, x1, is_max ? _mm_cmpgt_epi64(x1, acc1) : _mm_cmpgt_epi64(acc1, x1));
+  }
+  const int64_t lanes[] = {_mm_cvtsi128_si64(acc0), _mm_extract_epi64(acc0, 1), _mm_cvtsi128_si64(acc1), _mm_extract_epi64(acc1, 1)};
+  const int64_t res = is_max ? scalar_min(lanes, 0, 4, lanes[0], int_greater) : scalar_min(lanes, 0, 4, lanes[0], int_less);
+  return is_max ? scalar_min(data, i, n, res, int_greater) : scalar_min(data, i, n, res, int_less);
+}
+
+template<bool is_max>
+[[gnu::target("avx2")]] int64_t avx2_min_int64(const int64_t *data, size_t n) noexcept {
+  __m256i acc0 = _mm256_set1_epi64x(data[0]);
+  __m256i acc1 = acc0;
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256i x0 = avx2_load(data + i);
+    const __m256i x1 = avx2_load(data + i + 4);
+    acc0 = _mm256_blendv_epi8(acc0, x0, is_max ? _mm256_cmpgt_epi64(x0, acc0) : _mm256_cmpgt_epi64(acc0, x0));
+    acc1 = _mm256_blendv_epi8(acc1, x1, is_max ? _mm256_cmpgt_epi64(x1, acc1) : _mm256_cmpgt_epi64(acc1, x1));
+  }
+  alignas(32) int64_t lanes[8];
+  _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), acc0);
+  _mm256_store_si256(reinterpret_cast<__m256i *>(lanes + 4), acc1);
+  const int64_t res = is_max ? scalar_min(lanes, 0, 8, lanes[0], int_greater) : scalar_min(lanes, 0, 8, lanes[0], int_less);
+  return is_max ? scalar_min(data, i, n, res, int_greater) : scalar_min(data, i, n, res, int_less);
+}
+
+const bool has_avx2 = kdb_cpuid_has_avx2();
+
+#endif
+
+#if defined(__x86_64__)
+
+size_t sse_find_double(const double *data, size_t n, double value) noexcept {
+  const __m128d v = _mm_set1_pd(value);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m128d eq = _mm_or_pd(_mm_or_pd(_mm_cmpeq_pd(_mm_loadu_pd(data + i), v), _mm_cmpeq_pd(_mm_loadu_pd(data + i + 2), v)),
+                                 _mm_or_pd(_mm_cmpeq_pd(_mm_loadu_pd(data + i + 4), v), _mm_cmpeq_pd(_mm_loadu_pd(data + i + 6), v)));
+    if (_mm_movemask_pd(eq)) {
+      return scalar_find(data, i, i + 8, value);
+    }
+  }
+  return scalar_find(data, i, n, value);
+}
+
+// returns the minimal (maximal) value ignoring NaNs, data[0] must not be NaN;
+// minpd(x, acc) returns acc if x is NaN
+template<bool is_max>
+double sse_min_double_value(const double *data, size_t n) noexcept {
+  __m128d acc0 = _mm_set1_pd(data[0]);
+  __m128d acc1 = acc0;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    acc0 = is_max ? _mm_max_pd(_mm_loadu_pd(data + i), acc0) : _mm_min_pd(_mm_loadu_pd(data + i), acc0);
+    acc1 = is_max ? _mm_max_pd(_mm_loadu_pd(data + i + 2), acc1) : _mm_min_pd(_mm_loadu_pd(data + i + 2), acc1);
+  }
+  double lanes[4];
+  _mm_storeu_pd(lanes, acc0);
+  _mm_storeu_pd(lanes + 2, acc1);
+  double res = lanes[0];
+  for (size_t j = 1; j < 4; ++j) {
+    res = (is_max ? lanes[j] > res : lanes[j] < res) ? lanes[j] : res;
+  }
+  for (; i < n; ++i) {
+    res = (is_max ? data[i] > res : data[i] < res) ? data[i] : res;
+  }
+  return res;
+}
+
+#endif
+
+template<bool is_max>
+double min_double(const double *data, size_t n) noexcept {
+  // nothing is less or greater than NaN, so the loop keeps it
+  if (std::isnan(data[0])) {
+    return data[0];
+  }
+#if defined(__x86_64__)
+  const double res = sse_min_double_value<is_max>(data, n);
+#else
+  double res = data[0];
+  for (size_t i = 1; i < n; ++i) {
+    res = (is_max ? data[i] > res : data[i] < res) ? data[i] : res;
+  }
+#endif
+  // all the values equal to the result are the same except for zeros: the loop keeps the first of -0.0 and 0.0
+  if (res == 0.0) {
+    return data[scalar_find(data, 0, n, 0.0)];
+  }
+  return res;
+}
+
+} // namespace
+
+size_t simd_find_int64(const int64_t *data, size_t n, int64_t value) noexcept {
+#if defined(__x86_64__) && defined(__SSE4_2__)
+  return has_avx2 ? avx2_find_int64(data, n, value) : sse_find_int64(data, n, value);
+#else
+  return scalar_find(data, 0, n, value);
+#endif
+}
+
+size_t simd_find_double(const double *data, size_t n, double value) noexcept {
+#if defined(__x86_64__)
+  return sse_find_double(data, n, value);
+#else
+  return scalar_find(data, 0, n, value);
+#endif
+}
+
+int64_t simd_sum_int64(const int64_t *data, size_t n) noexcept {
+#if defined(__x86_64__) && defined(__SSE4_2__)
+  return has_avx2 ? avx2_sum_int64(data, n) : sse_sum_int64(data, n);
+#else
+  return static_cast<int64_t>(scalar_sum(data, 0, n, 0));
+#endif
+}
+
+int64_t simd_min_int64(const int64_t *data, size_t n) noexcept {
+#if defined(__x86_64__) && defined(__SSE4_2__)
+  return has_avx2 ? avx2_min_int64<false>(data, n) : sse_min_int64<false>(data, n);
+#else
+  return scalar_min(data, 1, n, data[0], int_less);
+#endif
+}
+
+int64_t simd_max_int64(const int64_t *data, size_t n) noexcept {
+#if defined(__x86_64__) && defined(__SSE4_2__)
+  return has_avx2 ? avx2_min_int64<true>(data, n) : sse_min_int64<true>(data, n);
+#else
+  return scalar_min(data, 1, n, data[0], int_greater);
+#endif
+}
+
+double simd_min_double(const double *data, size_t n) noexcept {
+  return min_double<false>(data, n);
+}
+
+double simd_max_double(const double *data, size_t n) noexcept {
+  return min_double<true>(data, n);
+}
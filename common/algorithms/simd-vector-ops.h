@@ -0,0 +1,24 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Kernels for the contiguous storage of int and float vectors, they process several elements per instruction.
+// The results are exactly the same as the ones of the element by element loops:
+//  - find returns the index of the first element equal to value (in terms of operator==), or n if there is no such element;
+//  - sum wraps on overflow;
+//  - min/max return the same element as `res = data[0]; for (x : data) if (x < res) res = x;` does
+//    (and the symmetrical loop for max), including NaN and signed zero cases; n must be positive.
+size_t simd_find_int64(const int64_t *data, size_t n, int64_t value) noexcept;
+size_t simd_find_double(const double *data, size_t n, double value) noexcept;
+
+int64_t simd_sum_int64(const int64_t *data, size_t n) noexcept;
+
+int64_t simd_min_int64(const int64_t *data, size_t n) noexcept;
+int64_t simd_max_int64(const int64_t *data, size_t n) noexcept;
+double simd_min_double(const double *data, size_t n) noexcept;
+double simd_max_double(const double *data, size_t n) noexcept;
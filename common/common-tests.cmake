@@ -1,9 +1,15 @@
 prepend(COMMON_TESTS_SOURCES ${COMMON_DIR}/
         algorithms/compare-test.cpp
         algorithms/contains-test.cpp
+        algorithms/gbdt-inference-test.cpp
         algorithms/hashes-test.cpp
+        algorithms/json-string-scan-test.cpp
+        algorithms/json-structural-index-test.cpp
         algorithms/projections-test.cpp
+        algorithms/radix-sort-test.cpp
         algorithms/simd-int-to-string-test.cpp
+        algorithms/simd-string-search-test.cpp
+        algorithms/simd-vector-ops-test.cpp
         algorithms/string-algorithms-test.cpp
         allocators/freelist-test.cpp
         allocators/lockfree-slab-test.cpp
@@ -15,6 +21,7 @@ prepend(COMMON_TESTS_SOURCES ${COMMON_DIR}/
         smart_iterators/smart-iterators-test.cpp
         smart_ptrs/tagged-ptr-test.cpp
         type_traits/list_of_types_test.cpp
+        unicode/utf8-utils-test.cpp
         wrappers/span-test.cpp
         wrappers/string_view-test.cpp)
 
@@ -16,6 +16,18 @@ const kdb_cpuid_t *kdb_cpuid() {
   }
   int a;
   asm volatile("cpuid\n\t" : "=a"(a), "=b"(cached.x86_64.ebx), "=c"(cached.x86_64.ecx), "=d"(cached.x86_64.edx) : "0"(1));
+  int ext_ecx = 0, ext_edx = 0;
+  asm volatile("cpuid\n\t" : "=a"(a), "=b"(cached.x86_64.ext_ebx), "=c"(ext_ecx), "=d"(ext_edx) : "0"(7), "2"(0));
+  // ymm registers are usable only if OS saves them on context switch (OSXSAVE is set and XCR0 has SSE and AVX states)
+  bool ymm_enabled = false;
+  if (cached.x86_64.ecx & (1 << 27)) {
+    unsigned xcr0_lo = 0, xcr0_hi = 0;
+    asm volatile("xgetbv\n\t" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+    ymm_enabled = (xcr0_lo & 6) == 6;
+  }
+  if (!ymm_enabled) {
+    cached.x86_64.ext_ebx &= ~(1 << 5);
+  }
   cached.type = KDB_CPUID_X86_64;
 #elif defined(__arm64__)  // Apple M1
   if (cached.type) {
@@ -37,3 +49,11 @@ const kdb_cpuid_t *kdb_cpuid() {
 
   return &cached;
 }
+
+int kdb_cpuid_has_avx2() {
+#if defined(__x86_64__)
+  return (kdb_cpuid()->x86_64.ext_ebx >> 5) & 1;
+#else
+  return 0;
+#endif
+}
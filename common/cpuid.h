@@ -13,10 +13,15 @@ typedef struct {
   union {
     struct {
       int ebx, ecx, edx;
+      // ebx of the leaf 7 (extended features), AVX2 bit is cleared if OS doesn't save ymm registers
+      int ext_ebx;
     } x86_64;
   };
 } kdb_cpuid_t;
 
 const kdb_cpuid_t *kdb_cpuid ();
 
+// AVX2 may be used
+int kdb_cpuid_has_avx2 ();
+
 #endif
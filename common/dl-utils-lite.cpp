@@ -243,6 +243,29 @@ mem_info_t get_self_mem_stats() {
   return info;
 }
 
+uint32_t get_self_pss_kb() {
+  int fd = open ("/proc/self/smaps_rollup", O_RDONLY);
+  if (fd == -1) {
+    return 0;
+  }
+
+  constexpr size_t TMEM_SIZE = 4096;
+  static char mem[TMEM_SIZE];
+  const auto size = read(fd, mem, TMEM_SIZE - 1);
+  close (fd);
+  if (size <= 0) {
+    return 0;
+  }
+  mem[size] = 0;
+
+  uint32_t pss = 0;
+  const char *s = strstr (mem, "\nPss:");
+  if (s) {
+    sscanf (s + 5, "%" SCNu32, &pss);
+  }
+  return pss;
+}
+
 int get_pid_info (pid_t pid, pid_info_t *info) {
   constexpr size_t TMEM_SIZE = 10000;
   static char mem[TMEM_SIZE];
@@ -305,7 +328,7 @@ unsigned long long get_pid_start_time (pid_t pid) {
   return res;
 }
 
-int get_cpu_total (unsigned long long *cpu_total) {
+int get_cpu_total (unsigned long long *cpu_total, unsigned long long *cpu_idle) {
   constexpr size_t TMEM_SIZE = 10000;
   static char mem[TMEM_SIZE];
   snprintf (mem, TMEM_SIZE, "/proc/stat");
@@ -321,13 +344,20 @@ int get_cpu_total (unsigned long long *cpu_total) {
     return 0;
   }
 
-  unsigned long long sum = 0, cur = 0;
-  int i;
+  // cpu user nice system idle iowait irq ...
+  unsigned long long sum = 0, cur = 0, idle = 0;
+  int i, field = 0, in_number = 0;
   for (i = 0; i < size; i++) {
     int c = mem[i];
     if (c >= '0' && c <= '9') {
       cur = cur * 10 + (unsigned long long)c - '0';
+      in_number = 1;
     } else {
+      if (in_number && (field == 3 || field == 4)) {
+        idle += cur;
+      }
+      field += in_number;
+      in_number = 0;
       sum += cur;
       cur = 0;
       if (c == '\n') {
@@ -337,6 +367,9 @@ int get_cpu_total (unsigned long long *cpu_total) {
   }
 
   *cpu_total = sum;
+  if (cpu_idle) {
+    *cpu_idle = idle;
+  }
 
   close (fd);
   return 1;
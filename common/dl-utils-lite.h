@@ -60,6 +60,9 @@ struct mem_info_t {
 };
 
 mem_info_t get_self_mem_stats();
+// the proportional set size from /proc/self/smaps_rollup: the shared pages are divided between the processes mapping them
+uint32_t get_self_pss_kb();
 int get_pid_info (pid_t pid, pid_info_t *info);
 unsigned long long get_pid_start_time (pid_t pid);
-int get_cpu_total (unsigned long long *cpu_total);
+// the sum of the host CPU time counters from /proc/stat, optionally the idle (with iowait) part of it
+int get_cpu_total (unsigned long long *cpu_total, unsigned long long *cpu_idle = nullptr);
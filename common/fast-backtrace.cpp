@@ -54,6 +54,21 @@ int fast_backtrace(void **buffer, int size) {
   return i;
 }
 
+int fast_backtrace_by_bp(void *bp, const char *stack_begin, const char *stack_end, void **buffer, int size) noexcept {
+  auto *frame = static_cast<stack_frame *>(bp);
+  int i = 0;
+  while (i < size && reinterpret_cast<char *>(frame) >= stack_begin && reinterpret_cast<char *>(frame + 1) <= stack_end &&
+         !(reinterpret_cast<long>(frame) & (sizeof(long) - 1))) {
+    buffer[i++] = frame->ip;
+    stack_frame *p = frame->bp;
+    if (p <= frame) {
+      break;
+    }
+    frame = p;
+  }
+  return i;
+}
+
 int fast_backtrace_without_recursions(void **buffer, int size) noexcept {
 #ifndef __APPLE__
   if (!stack_end) {
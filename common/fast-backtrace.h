@@ -15,5 +15,8 @@ extern char *stack_end;
 
 int fast_backtrace (void **buffer, int size) __attribute__ ((noinline));
 int fast_backtrace_without_recursions(void **buffer, int size) noexcept;
+// unwinds the frames starting from the given frame pointer, the frames outside the [stack_begin, stack_end) are not touched,
+// so it is safe to use it from signal handlers with the interrupted context registers
+int fast_backtrace_by_bp(void *bp, const char *stack_begin, const char *stack_end, void **buffer, int size) noexcept;
 
 #endif
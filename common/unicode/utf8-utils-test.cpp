@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+
+#include "common/unicode/utf8-utils.h"
+
+namespace {
+
+// the straightforward implementation of RFC 3629
+bool naive_is_valid(const std::string &s) {
+  for (size_t pos = 0; pos < s.size();) {
+    int code = 0;
+    const char *p = s.c_str() + pos;
+    const int n = get_char_utf8(&code, p);
+    if (n == 0) {
+      pos++;
+      continue;
+    }
+    if (n < 0 || n > 4 || pos + n > s.size() || (0xd800 <= code && code <= 0xdfff) || code > 0x10ffff) {
+      return false;
+    }
+    // get_char_utf8 rejects the overlong forms of 2 and 3 bytes only
+    if (n == 4 && code < 0x10000) {
+      return false;
+    }
+    pos += n;
+  }
+  return true;
+}
+
+size_t naive_code_points_count(const std::string &s) {
+  size_t count = 0;
+  for (char c : s) {
+    count += (c & 0xc0) != 0x80;
+  }
+  return count;
+}
+
+std::string random_utf8_string(std::mt19937 &gen, size_t len) {
+  static const std::string pieces[] = {"a", "Z", " ", std::string(1, '\0'), "\xd0\x9f", "\xd1\x8f", "\xe2\x82\xac", "\xf0\x9f\x98\x80",
+                                       "\x80", "\xbf", "\xc0\xaf", "\xc1\xbf", "\xe0\x9f\xbf", "\xed\xa0\x80", "\xed\x9f\xbf", "\xf0\x8f\xbf\xbf",
+                                       "\xf4\x90\x80\x80", "\xf4\x8f\xbf\xbf", "\xf5\x80\x80\x80", "\xf8", "\xff", "\xc3", "\xe2\x82", "\xf0\x9f\x98"};
+  std::string s;
+  while (s.size() < len) {
+    // mostly ASCII strings with rare bad pieces
+    const size_t i = gen() % 4 ? gen() % 8 : gen() % (sizeof(pieces) / sizeof(pieces[0]));
+    s += pieces[i];
+  }
+  return s;
+}
+
+} // namespace
+
+TEST(utf8_utils, is_valid_pairs_and_triples) {
+  // every sequence of up to 3 bytes from the interesting set is checked at every offset of a block
+  const unsigned char bytes[] = {0x00, 0x41, 0x7f, 0x80, 0x8f, 0x90, 0x9f, 0xa0, 0xbf, 0xc0, 0xc1, 0xc2, 0xdf, 0xe0, 0xe1, 0xec, 0xed, 0xee, 0xef,
+                                 0xf0, 0xf1, 0xf3, 0xf4, 0xf5, 0xf7, 0xf8, 0xfe, 0xff};
+  for (unsigned char a : bytes) {
+    for (unsigned char b : bytes) {
+      for (unsigned char c : bytes) {
+        for (unsigned char d : {0x41, 0x80, 0xbf}) {
+          for (size_t offset : {0, 1, 12, 13, 14, 15, 29, 30, 31, 40}) {
+            std::string s(offset, 'x');
+            s += static_cast<char>(a);
+            s += static_cast<char>(b);
+            s += static_cast<char>(c);
+            s += static_cast<char>(d);
+            for (size_t len = offset + 1; len <= s.size(); ++len) {
+              const std::string prefix = s.substr(0, len);
+              ASSERT_EQ(utf8_is_valid(prefix.c_str(), len), naive_is_valid(prefix)) << offset << ' ' << int{a} << ' ' << int{b} << ' ' << int{c};
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(utf8_utils, random_strings) {
+  std::mt19937 gen{42};
+  for (size_t len = 0; len < 300; ++len) {
+    for (int iteration = 0; iteration < 20; ++iteration) {
+      const std::string s = random_utf8_string(gen, len);
+      ASSERT_EQ(utf8_is_valid(s.c_str(), s.size()), naive_is_valid(s));
+
+      const size_t count = naive_code_points_count(s);
+      ASSERT_EQ(utf8_code_points_count(s.c_str(), s.size()), count);
+      for (size_t index = 0, offset = 0; index <= count; ++index, ++offset) {
+        while (offset < s.size() && (s[offset] & 0xc0) == 0x80) {
+          ++offset;
+        }
+        ASSERT_EQ(utf8_code_point_offset(s.c_str(), s.size(), index), std::min(offset, s.size()));
+      }
+
+      std::string lower(s.size(), '?');
+      std::string upper(s.size(), '?');
+      const size_t ascii_len = utf8_ascii_prefix_tolower(s.c_str(), s.size(), &lower[0]);
+      ASSERT_EQ(utf8_ascii_prefix_toupper(s.c_str(), s.size(), &upper[0]), ascii_len);
+      for (size_t i = 0; i < ascii_len; ++i) {
+        ASSERT_GT(s[i], 0);
+        ASSERT_EQ(lower[i], static_cast<char>(std::tolower(s[i])));
+        ASSERT_EQ(upper[i], static_cast<char>(std::toupper(s[i])));
+      }
+      ASSERT_TRUE(ascii_len == s.size() || s[ascii_len] <= 0);
+    }
+  }
+}
@@ -8,6 +8,12 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "common/cpuid.h"
+
 void string_to_utf8 (const char *s, int *v) {
   int *tv = v;
 #define CHECK(x) if (!(x)) {v = tv; break;}
@@ -1693,3 +1699,341 @@ int has_bad_symbols (int *v_s) {
   }
   return 0;
 }
+
+namespace {
+
+constexpr bool is_utf8_continuation_byte(char c) {
+  return (c & 0xc0) == 0x80;
+}
+
+template<char first, char last, char delta>
+size_t scalar_ascii_prefix_convert(const char *s, size_t pos, size_t len, char *out) noexcept {
+  for (; pos < len && s[pos] > 0; ++pos) {
+    out[pos] = static_cast<char>(first <= s[pos] && s[pos] <= last ? s[pos] + delta : s[pos]);
+  }
+  return pos;
+}
+
+size_t scalar_code_points_count(const char *s, size_t pos, size_t len, size_t count) noexcept {
+  for (; pos < len; ++pos) {
+    count += !is_utf8_continuation_byte(s[pos]);
+  }
+  return count;
+}
+
+size_t scalar_code_point_offset(const char *s, size_t pos, size_t len, size_t index) noexcept {
+  for (; pos < len; ++pos) {
+    if (!is_utf8_continuation_byte(s[pos]) && index-- == 0) {
+      return pos;
+    }
+  }
+  return len;
+}
+
+#if defined(__x86_64__) && defined(__SSE4_2__)
+
+template<char first, char last, char delta>
+size_t sse_ascii_prefix_convert(const char *s, size_t len, char *out) noexcept {
+  const __m128i zero = _mm_setzero_si128();
+  size_t pos = 0;
+  for (; pos + 16 <= len; pos += 16) {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + pos));
+    const __m128i in_range = _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8(first - 1)), _mm_cmpgt_epi8(_mm_set1_epi8(last + 1), x));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + pos), _mm_add_epi8(x, _mm_and_si128(in_range, _mm_set1_epi8(delta))));
+    // the high bit is set for non-ASCII bytes and for '\0'
+    if (const unsigned mask = _mm_movemask_epi8(_mm_or_si128(x, _mm_cmpeq_epi8(x, zero)))) {
+      return pos + __builtin_ctz(mask);
+    }
+  }
+  return scalar_ascii_prefix_convert<first, last, delta>(s, pos, len, out);
+}
+
+// the signed comparison with -65 (0xbf) separates the continuation bytes 0x80..0xbf from all the others
+unsigned sse_code_points_mask(const char *s) noexcept {
+  return _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(s)), _mm_set1_epi8(-65)));
+}
+
+[[gnu::target("avx2")]] unsigned avx2_code_points_mask(const char *s) noexcept {
+  return _mm256_movemask_epi8(_mm256_cmpgt_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(s)), _mm256_set1_epi8(-65)));
+}
+
+size_t sse_code_points_count(const char *s, size_t len) noexcept {
+  size_t count = 0;
+  size_t pos = 0;
+  for (; pos + 16 <= len; pos += 16) {
+    count += __builtin_popcount(sse_code_points_mask(s + pos));
+  }
+  return scalar_code_points_count(s, pos, len, count);
+}
+
+[[gnu::target("avx2")]] size_t avx2_code_points_count(const char *s, size_t len) noexcept {
+  size_t count = 0;
+  size_t pos = 0;
+  for (; pos + 32 <= len; pos += 32) {
+    count += __builtin_popcount(avx2_code_points_mask(s + pos));
+  }
+  return scalar_code_points_count(s, pos, len, count);
+}
+
+size_t mask_bit_offset(unsigned mask, size_t index) noexcept {
+  for (; index; --index) {
+    mask &= mask - 1;
+  }
+  return __builtin_ctz(mask);
+}
+
+size_t sse_code_point_offset(const char *s, size_t len, size_t index) noexcept {
+  size_t pos = 0;
+  for (; pos + 16 <= len; pos += 16) {
+    const unsigned mask = sse_code_points_mask(s + pos);
+    const size_t count = __builtin_popcount(mask);
+    if (index < count) {
+      return pos + mask_bit_offset(mask, index);
+    }
+    index -= count;
+  }
+  return scalar_code_point_offset(s, pos, len, index);
+}
+
+[[gnu::target("avx2")]] size_t avx2_code_point_offset(const char *s, size_t len, size_t index) noexcept {
+  size_t pos = 0;
+  for (; pos + 32 <= len; pos += 32) {
+    const unsigned mask = avx2_code_points_mask(s + pos);
+    const size_t count = __builtin_popcount(mask);
+    if (index < count) {
+      return pos + mask_bit_offset(mask, index);
+    }
+    index -= count;
+  }
+  return scalar_code_point_offset(s, pos, len, index);
+}
+
+// The validation is done by the lookup algorithm of J. Keiser and D. Lemire ("Validating UTF-8 In Less Than
+// One Instruction Per Byte"): almost every error is found by a pair of adjacent bytes, the high nibble of the first byte,
+// its low nibble and the high nibble of the second byte are mapped to the sets of errors they may take part in,
+// and the intersection of the three sets is the set of errors of the pair.
+// The rest is the check that the continuations are where the 3 and 4 byte sequences expect them.
+enum : char {
+  TOO_SHORT = 1 << 0,     // 11______ 0_______ or 11______ 11______
+  TOO_LONG = 1 << 1,      // 0_______ 10______
+  OVERLONG_3 = 1 << 2,    // 11100000 100_____
+  TOO_LARGE = 1 << 3,     // 11110100 1001____ or 11110100 101_____ or 11110101..11111111 10______
+  SURROGATE = 1 << 4,     // 11101101 101_____
+  OVERLONG_2 = 1 << 5,    // 1100000_ 10______
+  TOO_LARGE_1000 = 1 << 6,// 11110101..11111111 1000____
+  OVERLONG_4 = 1 << 6,    // 11110000 1000____
+  TWO_CONTS = char(1 << 7),// 10______ 10______
+  CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS,
+};
+
+#define UTF8_BYTE_1_HIGH_TABLE                                                                                                                       \
+  TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,                       \
+    TOO_SHORT | OVERLONG_2, TOO_SHORT, TOO_SHORT | OVERLONG_3 | SURROGATE, TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+
+#define UTF8_BYTE_1_LOW_TABLE                                                                                                                        \
+  CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4, CARRY | OVERLONG_2, CARRY, CARRY, CARRY | TOO_LARGE, CARRY | TOO_LARGE | TOO_LARGE_1000,             \
+    CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000, \
+    CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,                                     \
+    CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000
+
+#define UTF8_BYTE_2_HIGH_TABLE                                                                                                                       \
+  TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,                                                           \
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4, TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,       \
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE, TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE, TOO_SHORT, TOO_SHORT,      \
+    TOO_SHORT, TOO_SHORT
+
+// a sequence is incomplete at the end of a block if one of the last 3 bytes is a lead byte that needs more bytes than there are left
+#define UTF8_INCOMPLETE_TABLE                                                                                                                        \
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, char(0xf0 - 1), char(0xe0 - 1), char(0xc0 - 1)
+
+struct sse_utf8_validator {
+  __m128i error = _mm_setzero_si128();
+  __m128i prev_input = _mm_setzero_si128();
+  __m128i prev_incomplete = _mm_setzero_si128();
+
+  void check_block(__m128i input) noexcept {
+    if (_mm_movemask_epi8(input) == 0) {
+      error = _mm_or_si128(error, prev_incomplete);
+    } else {
+      const __m128i low_nibble_mask = _mm_set1_epi8(0x0f);
+      const __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+      const __m128i byte_1_high = _mm_shuffle_epi8(_mm_setr_epi8(UTF8_BYTE_1_HIGH_TABLE), _mm_and_si128(_mm_srli_epi16(prev1, 4), low_nibble_mask));
+      const __m128i byte_1_low = _mm_shuffle_epi8(_mm_setr_epi8(UTF8_BYTE_1_LOW_TABLE), _mm_and_si128(prev1, low_nibble_mask));
+      const __m128i byte_2_high = _mm_shuffle_epi8(_mm_setr_epi8(UTF8_BYTE_2_HIGH_TABLE), _mm_and_si128(_mm_srli_epi16(input, 4), low_nibble_mask));
+      const __m128i special_cases = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+      // only 111_____ and 1111____ get the high bit after the subtraction
+      const __m128i is_third_byte = _mm_subs_epu8(_mm_alignr_epi8(input, prev_input, 14), _mm_set1_epi8(0xe0 - 0x80));
+      const __m128i is_fourth_byte = _mm_subs_epu8(_mm_alignr_epi8(input, prev_input, 13), _mm_set1_epi8(0xf0 - 0x80));
+      const __m128i must_be_continuation = _mm_and_si128(_mm_or_si128(is_third_byte, is_fourth_byte), _mm_set1_epi8(char(0x80)));
+
+      error = _mm_or_si128(error, _mm_xor_si128(must_be_continuation, special_cases));
+      prev_incomplete = _mm_subs_epu8(input, _mm_setr_epi8(UTF8_INCOMPLETE_TABLE));
+    }
+    prev_input = input;
+  }
+
+  bool is_valid() const noexcept {
+    const __m128i result = _mm_or_si128(error, prev_incomplete);
+    return _mm_testz_si128(result, result);
+  }
+};
+
+// the members are set by the creator: the implicit constructor would be compiled without avx2
+struct avx2_utf8_validator {
+  __m256i error;
+  __m256i prev_input;
+  __m256i prev_incomplete;
+
+  // the bytes of input shifted by n positions, the last bytes of prev_input come first
+  template<int n>
+  [[gnu::target("avx2")]] __m256i prev(__m256i input) const noexcept {
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev_input, input, 0x21), 16 - n);
+  }
+
+  [[gnu::target("avx2")]] void check_block(__m256i input) noexcept {
+    if (_mm256_movemask_epi8(input) == 0) {
+      error = _mm256_or_si256(error, prev_incomplete);
+    } else {
+      const __m256i low_nibble_mask = _mm256_set1_epi8(0x0f);
+      const __m256i prev1 = prev<1>(input);
+      const __m256i byte_1_high = _mm256_shuffle_epi8(_mm256_setr_epi8(UTF8_BYTE_1_HIGH_TABLE, UTF8_BYTE_1_HIGH_TABLE),
+                                                      _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_nibble_mask));
+      const __m256i byte_1_low = _mm256_shuffle_epi8(_mm256_setr_epi8(UTF8_BYTE_1_LOW_TABLE, UTF8_BYTE_1_LOW_TABLE), _mm256_and_si256(prev1, low_nibble_mask));
+      const __m256i byte_2_high = _mm256_shuffle_epi8(_mm256_setr_epi8(UTF8_BYTE_2_HIGH_TABLE, UTF8_BYTE_2_HIGH_TABLE),
+                                                      _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibble_mask));
+      const __m256i special_cases = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+      const __m256i is_third_byte = _mm256_subs_epu8(prev<2>(input), _mm256_set1_epi8(0xe0 - 0x80));
+      const __m256i is_fourth_byte = _mm256_subs_epu8(prev<3>(input), _mm256_set1_epi8(0xf0 - 0x80));
+      const __m256i must_be_continuation = _mm256_and_si256(_mm256_or_si256(is_third_byte, is_fourth_byte), _mm256_set1_epi8(char(0x80)));
+
+      error = _mm256_or_si256(error, _mm256_xor_si256(must_be_continuation, special_cases));
+      prev_incomplete = _mm256_subs_epu8(input, _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, UTF8_INCOMPLETE_TABLE));
+    }
+    prev_input = input;
+  }
+
+  [[gnu::target("avx2")]] bool is_valid() const noexcept {
+    const __m256i result = _mm256_or_si256(error, prev_incomplete);
+    return _mm256_testz_si256(result, result);
+  }
+};
+
+#undef UTF8_BYTE_1_HIGH_TABLE
+#undef UTF8_BYTE_1_LOW_TABLE
+#undef UTF8_BYTE_2_HIGH_TABLE
+#undef UTF8_INCOMPLETE_TABLE
+
+// the tail is padded by zeros, they are valid ASCII characters
+bool sse_utf8_is_valid(const char *s, size_t len) noexcept {
+  sse_utf8_validator validator;
+  size_t pos = 0;
+  for (; pos + 16 <= len; pos += 16) {
+    validator.check_block(_mm_loadu_si128(reinterpret_cast<const __m128i *>(s + pos)));
+  }
+  if (pos < len) {
+    alignas(16) char tail[16] = {0};
+    memcpy(tail, s + pos, len - pos);
+    validator.check_block(_mm_load_si128(reinterpret_cast<const __m128i *>(tail)));
+  }
+  return validator.is_valid();
+}
+
+[[gnu::target("avx2")]] bool avx2_utf8_is_valid(const char *s, size_t len) noexcept {
+  avx2_utf8_validator validator{_mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256()};
+  size_t pos = 0;
+  for (; pos + 32 <= len; pos += 32) {
+    validator.check_block(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + pos)));
+  }
+  if (pos < len) {
+    alignas(32) char tail[32] = {0};
+    memcpy(tail, s + pos, len - pos);
+    validator.check_block(_mm256_load_si256(reinterpret_cast<const __m256i *>(tail)));
+  }
+  return validator.is_valid();
+}
+
+const bool has_avx2 = kdb_cpuid_has_avx2();
+
+#else
+
+bool scalar_utf8_is_valid(const char *s, size_t len) noexcept {
+  const auto *u = reinterpret_cast<const unsigned char *>(s);
+  for (size_t pos = 0; pos < len;) {
+    const unsigned int a = u[pos];
+    if (a < 0x80) {
+      pos++;
+      continue;
+    }
+    size_t n = 0;
+    unsigned int min_second = 0x80, max_second = 0xbf;
+    if (0xc2 <= a && a <= 0xdf) {
+      n = 2;
+    } else if (0xe0 <= a && a <= 0xef) {
+      n = 3;
+      min_second = a == 0xe0 ? 0xa0 : 0x80;
+      max_second = a == 0xed ? 0x9f : 0xbf;
+    } else if (0xf0 <= a && a <= 0xf4) {
+      n = 4;
+      min_second = a == 0xf0 ? 0x90 : 0x80;
+      max_second = a == 0xf4 ? 0x8f : 0xbf;
+    } else {
+      return false;
+    }
+    if (len - pos < n || u[pos + 1] < min_second || u[pos + 1] > max_second) {
+      return false;
+    }
+    for (size_t i = 2; i < n; ++i) {
+      if (!is_utf8_continuation_byte(s[pos + i])) {
+        return false;
+      }
+    }
+    pos += n;
+  }
+  return true;
+}
+
+#endif
+
+} // namespace
+
+size_t utf8_ascii_prefix_tolower(const char *s, size_t len, char *out) noexcept {
+#if defined(__x86_64__) && defined(__SSE4_2__)
+  return sse_ascii_prefix_convert<'A', 'Z', 'a' - 'A'>(s, len, out);
+#else
+  return scalar_ascii_prefix_convert<'A', 'Z', 'a' - 'A'>(s, 0, len, out);
+#endif
+}
+
+size_t utf8_ascii_prefix_toupper(const char *s, size_t len, char *out) noexcept {
+#if defined(__x86_64__) && defined(__SSE4_2__)
+  return sse_ascii_prefix_convert<'a', 'z', 'A' - 'a'>(s, len, out);
+#else
+  return scalar_ascii_prefix_convert<'a', 'z', 'A' - 'a'>(s, 0, len, out);
+#endif
+}
+
+size_t utf8_code_points_count(const char *s, size_t len) noexcept {
+#if defined(__x86_64__) && defined(__SSE4_2__)
+  return has_avx2 ? avx2_code_points_count(s, len) : sse_code_points_count(s, len);
+#else
+  return scalar_code_points_count(s, 0, len, 0);
+#endif
+}
+
+size_t utf8_code_point_offset(const char *s, size_t len, size_t index) noexcept {
+#if defined(__x86_64__) && defined(__SSE4_2__)
+  return has_avx2 ? avx2_code_point_offset(s, len, index) : sse_code_point_offset(s, len, index);
+#else
+  return scalar_code_point_offset(s, 0, len, index);
+#endif
+}
+
+bool utf8_is_valid(const char *s, size_t len) noexcept {
+#if defined(__x86_64__) && defined(__SSE4_2__)
+  return has_avx2 ? avx2_utf8_is_valid(s, len) : sse_utf8_is_valid(s, len);
+#else
+  return scalar_utf8_is_valid(s, len);
+#endif
+}
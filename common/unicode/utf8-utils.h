@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 void string_to_utf8 (const char *s, int *v);
 void string_to_utf8_len (const char *s, int s_len, int *v);
 void html_string_to_utf8 (const char *s, int *v);
@@ -102,3 +104,21 @@ static inline int put_char_utf8 (unsigned int x, char *s) {
 constexpr bool is_invalid_utf8_first_byte(char c) {
   return (c & 0xc0) == 0x80;
 }
+
+// The functions below process 16 or 32 bytes at once, they don't stop at '\0' unless it's said explicitly.
+
+// Converts the longest prefix of s[0, len) that consists of ASCII characters other than '\0' to lower (upper) case
+// and writes it to out, returns the length of the prefix; out must have space for len bytes,
+// the bytes after the prefix may be overwritten
+size_t utf8_ascii_prefix_tolower(const char *s, size_t len, char *out) noexcept;
+size_t utf8_ascii_prefix_toupper(const char *s, size_t len, char *out) noexcept;
+
+// Returns the number of code points in s[0, len), that is the number of bytes that are not continuation bytes
+size_t utf8_code_points_count(const char *s, size_t len) noexcept;
+
+// Returns the offset of the code point with the given index in s[0, len), or len if there are fewer code points
+size_t utf8_code_point_offset(const char *s, size_t len, size_t index) noexcept;
+
+// Checks that s[0, len) is a well-formed UTF-8 string (RFC 3629): there are no overlong forms,
+// surrogates, code points above U+10FFFF and truncated sequences
+bool utf8_is_valid(const char *s, size_t len) noexcept;
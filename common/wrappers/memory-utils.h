@@ -19,6 +19,10 @@
   #define MADV_DONTDUMP 16
 #endif
 
+#ifndef MADV_POPULATE_WRITE
+  #define MADV_POPULATE_WRITE 23
+#endif
+
 inline int our_madvise(void *addr, size_t len, int advice) noexcept {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
@@ -810,7 +810,7 @@ static void compile_json_visitor_call(CodeGenerator &W, ClassPtr json_encoder, C
   }
 }
 
-void ClassDeclaration::compile_accept_json_visitor(CodeGenerator &W, ClassPtr klass, bool to_encode, ClassPtr json_encoder) {
+void ClassDeclaration::compile_accept_json_visitor(CodeGenerator &W, ClassPtr klass, bool to_encode, ClassPtr json_encoder, const char *visitor_type) {
   bool parent_has_method = false;
   if (ClassPtr parent = klass->parent_class) {
     parent_has_method |= parent->json_encoders.end() != std::find(parent->json_encoders.begin(), parent->json_encoders.end(), std::pair{json_encoder, to_encode});
@@ -832,7 +832,7 @@ void ClassDeclaration::compile_accept_json_visitor(CodeGenerator &W, ClassPtr kl
       .set_final(parent_has_method && !has_derived)
       .set_overridden(parent_has_method && has_derived)
       .set_pure_virtual(is_pure_virtual)
-      << fmt_format("void accept({}<{}> &visitor)", to_encode ? "ToJsonVisitor" : "FromJsonVisitor", JsonEncoderTags::get_cppStructTag_name(json_encoder->name))
+      << fmt_format("void accept({}<{}> &visitor)", visitor_type, JsonEncoderTags::get_cppStructTag_name(json_encoder->name))
       << SemicolonAndNL{};
     return;
   } else {
@@ -841,7 +841,7 @@ void ClassDeclaration::compile_accept_json_visitor(CodeGenerator &W, ClassPtr kl
       .set_final(parent_has_method && !has_derived)
       .set_overridden(parent_has_method && has_derived)
       .set_pure_virtual(is_pure_virtual)
-      << fmt_format("void accept({}<{}> &visitor)", to_encode ? "ToJsonVisitor" : "FromJsonVisitor", JsonEncoderTags::get_cppStructTag_name(json_encoder->name))
+      << fmt_format("void accept({}<{}> &visitor)", visitor_type, JsonEncoderTags::get_cppStructTag_name(json_encoder->name))
       << BEGIN;
   }
 
@@ -881,6 +881,21 @@ void ClassDeclaration::compile_accept_json_visitor(CodeGenerator &W, ClassPtr kl
   W << END << NL;
 }
 
+// if there are no instances inside the fields, the instance is the only one in its graph,
+// so the instance cache visitors don't need to track the visited instances for it
+static bool has_no_class_instances_inside(ClassPtr klass) {
+  if (klass->is_interface() || !klass->derived_classes.empty()) {
+    return false;
+  }
+  bool has_instances_inside = false;
+  for (auto cur_klass = klass; cur_klass; cur_klass = cur_klass->parent_class) {
+    cur_klass->members.for_each([&has_instances_inside](const ClassMemberInstanceField &f) {
+      has_instances_inside = has_instances_inside || tinf::get_type(f.var)->has_class_type_inside();
+    });
+  }
+  return !has_instances_inside;
+}
+
 void ClassDeclaration::compile_accept_visitor_methods(CodeGenerator &W, ClassPtr klass) {
   bool need_generic_accept =
     klass->need_to_array_debug_visitor ||
@@ -908,6 +923,9 @@ void ClassDeclaration::compile_accept_visitor_methods(CodeGenerator &W, ClassPtr
 
   if (klass->need_instance_cache_visitors) {
     W << NL;
+    if (has_no_class_instances_inside(klass)) {
+      W << "constexpr static bool has_no_class_instances_inside{true};" << NL;
+    }
     compile_accept_visitor(W, klass, "InstanceReferencesCountingVisitor");
     compile_accept_visitor(W, klass, "InstanceDeepCopyVisitor");
     compile_accept_visitor(W, klass, "InstanceDeepDestroyVisitor");
@@ -915,7 +933,14 @@ void ClassDeclaration::compile_accept_visitor_methods(CodeGenerator &W, ClassPtr
 
   for (auto[encoder, to_encode] : klass->json_encoders) {
     W << NL;
-    compile_accept_json_visitor(W, klass, to_encode, encoder);
+    if (to_encode) {
+      compile_accept_json_visitor(W, klass, true, encoder, "ToJsonVisitor");
+    } else {
+      // FromJsonDocumentVisitor decodes the json string directly, FromJsonVisitor is used for the values already decoded into mixed
+      compile_accept_json_visitor(W, klass, false, encoder, "FromJsonDocumentVisitor");
+      W << NL;
+      compile_accept_json_visitor(W, klass, false, encoder, "FromJsonVisitor");
+    }
   }
 }
 
@@ -924,8 +949,8 @@ void ClassDeclaration::compile_msgpack_serialize(CodeGenerator &W, ClassPtr klas
     return;
   }
 
-  //template<typename Packer>
-  //void msgpack_pack(Packer &packer) const {
+  //template<typename Stream>
+  //void msgpack_pack(vk::msgpack::packer<Stream> &packer) const {
   //   packer.pack(tag_1);
   //   packer.pack(field_1);
   //   ...
@@ -941,8 +966,10 @@ void ClassDeclaration::compile_msgpack_serialize(CodeGenerator &W, ClassPtr klas
     }
   });
 
+  // the instances are packed twice: the first pass counts the size of the result, see f$msgpack_serialize()
+  W << "template<typename Stream>" << NL;
   FunctionSignatureGenerator(W).set_const_this()
-    << "void msgpack_pack(vk::msgpack::packer<string_buffer> &packer)" << BEGIN
+    << "void msgpack_pack(vk::msgpack::packer<Stream> &packer)" << BEGIN
     << "packer.pack_array(" << cnt_fields << ");" << NL
     << body << NL
     << END << NL;
@@ -65,6 +65,10 @@ void CombinatorGen::compile_right(CodeGenerator &W) const {
 void CombinatorStore::gen_before_args_processing(CodeGenerator &W) const {
   W << "(void)tl_object;" << NL;
   if (combinator->is_function()) {
+    const int64_t fixed_size = typed_mode ? tl2cpp::get_fixed_serialized_size(combinator) : -1;
+    if (fixed_size > 4) {
+      W << fmt_format("store_reserve({});", fixed_size) << NL;
+    }
     W << fmt_format("f$store_int({:#010x});", static_cast<unsigned int>(combinator->id)) << NL;
   }
 }
@@ -175,6 +175,13 @@ void TlTypeDeclaration::compile(CodeGenerator &W) const {
   W << "struct " << struct_name << " " << BEGIN;
   W << "using PhpType = "
     << (needs_typed_fetch_store ? get_php_runtime_type(t) : "tl_undefined_php_type") << ";" << NL;
+  if (template_decl.empty() && !t->is_polymorphic()) {
+    // vectors of fixed size types reserve the exact space for all the items at once, see t_Vector
+    const int64_t fixed_size = get_fixed_serialized_size(constructor);
+    if (fixed_size >= 0) {
+      W << "static constexpr int64_t FIXED_SIZE = " << fixed_size << ";" << NL;
+    }
+  }
   std::vector<std::string> constructor_params;
   std::vector<std::string> constructor_inits;
   for (const auto &arg : constructor->args) {
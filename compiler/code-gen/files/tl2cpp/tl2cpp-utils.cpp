@@ -264,6 +264,45 @@ bool is_magic_processing_needed(const vk::tlo_parsing::type_expr *type_expr) {
   return !(handles_magic_inside || is_used_as_bare);
 }
 
+int64_t get_fixed_serialized_size(const vk::tlo_parsing::type_expr_base *type_expr) {
+  // see FIXED_SIZE of these types in tl_builtins.h
+  static const std::unordered_map<std::string, int64_t> builtin_sizes{{"#", 4}, {"Int", 4}, {"Long", 8}, {"Double", 8}, {"Float", 4}, {"Bool", 4}, {"True", 0}};
+
+  const auto *as_type_expr = type_expr->as<vk::tlo_parsing::type_expr>();
+  if (!as_type_expr) {
+    return -1;
+  }
+  const auto *type = type_of(as_type_expr);
+  const int64_t magic_size = is_magic_processing_needed(as_type_expr) ? 4 : 0;
+  auto builtin_it = builtin_sizes.find(type->name);
+  if (builtin_it != builtin_sizes.end()) {
+    return magic_size + builtin_it->second;
+  }
+  if (CUSTOM_IMPL_TYPES.count(type->name) || type->is_polymorphic() || !as_type_expr->children.empty()) {
+    return -1;
+  }
+  const int64_t constructor_size = get_fixed_serialized_size(type->constructors[0].get());
+  return constructor_size < 0 ? -1 : magic_size + constructor_size;
+}
+
+int64_t get_fixed_serialized_size(const vk::tlo_parsing::combinator *combinator) {
+  int64_t size = combinator->is_function() ? 4 : 0;
+  for (const auto &arg : combinator->args) {
+    if (arg->is_optional() || arg->is_named_fields_mask_bit()) {
+      continue;
+    }
+    if (arg->is_fields_mask_optional() || arg->is_forwarded_function()) {
+      return -1;
+    }
+    const int64_t arg_size = get_fixed_serialized_size(arg->type_expr.get());
+    if (arg_size < 0) {
+      return -1;
+    }
+    size += arg_size;
+  }
+  return size;
+}
+
 vk::tlo_parsing::type *type_of(const std::unique_ptr<vk::tlo_parsing::type_expr_base> &type_expr, const vk::tlo_parsing::tl_scheme *scheme) {
   if (auto *casted = type_expr->template as<vk::tlo_parsing::type_expr>()) {
     auto type_it = scheme->types.find(casted->type_id);
@@ -36,6 +36,10 @@ std::string get_magic_storing(const vk::tlo_parsing::type_expr_base *arg_type_ex
 std::string get_magic_fetching(const vk::tlo_parsing::type_expr_base *arg_type_expr, const std::string &error_msg);
 std::string cpp_tl_struct_name(const char *prefix, std::string tl_name, const std::string &template_args_postfix = "");
 
+// the size of the serialized value if it doesn't depend on the value (ints, doubles and the structures of them), or -1
+int64_t get_fixed_serialized_size(const vk::tlo_parsing::type_expr_base *type_expr);
+int64_t get_fixed_serialized_size(const vk::tlo_parsing::combinator *combinator);
+
 std::string cpp_tl_const_str(std::string tl_name);
 std::string register_tl_const_str(const std::string &tl_name);
 int64_t hash_tl_const_str(const std::string &tl_name);
@@ -16,6 +16,7 @@ constexpr auto get_all_inspections() noexcept {
       {PerformanceInspections::array_reserve,              "array-reserve"},
       {PerformanceInspections::constant_execution_in_loop, "constant-execution-in-loop"},
       {PerformanceInspections::implicit_array_cast,        "implicit-array-cast"},
+      {PerformanceInspections::string_concat_in_loop,      "string-concat-in-loop"},
       {PerformanceInspections::all_inspections,            "all"},
     });
 }
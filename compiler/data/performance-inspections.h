@@ -15,7 +15,8 @@ public:
     array_reserve = (1 << 1),
     constant_execution_in_loop = (1 << 2),
     implicit_array_cast = (1 << 3),
-    all_inspections = array_merge_into | array_reserve | constant_execution_in_loop | implicit_array_cast,
+    string_concat_in_loop = (1 << 4),
+    all_inspections = array_merge_into | array_reserve | constant_execution_in_loop | implicit_array_cast | string_concat_in_loop,
   };
 
   explicit PerformanceInspections(Inspections enabled = Inspections::no_inspections) noexcept;
@@ -224,6 +224,9 @@ void AnalyzePerformance::analyze_set(VertexAdaptor<op_set> op_set_vertex) noexce
   if (is_enabled<PerformanceInspections::implicit_array_cast>()) {
     check_implicit_array_conversion(op_set_vertex->rhs(), tinf::get_type(op_set_vertex->lhs()));
   }
+  if (is_enabled<PerformanceInspections::string_concat_in_loop>() && !loop_data_for_second_pass_.empty()) {
+    check_string_concat_in_loop(op_set_vertex);
+  }
 }
 
 void AnalyzePerformance::analyze_set_array_value(VertexAdaptor<op_set_value> op_set_value_vertex) noexcept {
@@ -289,6 +292,27 @@ void AnalyzePerformance::check_implicit_array_conversion(VertexPtr expr, const T
   }
 }
 
+// the local strings are appended in place by OptimizationPass, so the reported expressions are the ones it couldn't handle
+void AnalyzePerformance::check_string_concat_in_loop(VertexAdaptor<op_set> op_set_vertex) noexcept {
+  auto string_build = remove_conv_wrap(op_set_vertex->rhs()).try_as<op_string_build>();
+  if (!string_build || vk::none_of_equal(tinf::get_type(op_set_vertex->lhs())->get_real_ptype(), tp_string, tp_mixed)) {
+    return;
+  }
+
+  const auto lhs = op_set_vertex->lhs();
+  const auto lhs_help = get_description_for_help_impl<false>(lhs);
+  const auto parts = string_build->args();
+  if (is_same_var_expression(lhs, parts[0])) {
+    trigger_inspection(PerformanceInspections::string_concat_in_loop,
+                       "expression " + lhs_help + " = " + lhs_help + " . <...> copies the whole string in a loop, " +
+                       "it can be replaced with " + lhs_help + " .= <...>");
+  } else if (std::any_of(std::next(parts.begin()), parts.end(), [&lhs](VertexPtr part) { return is_same_var_expression(lhs, part); })) {
+    trigger_inspection(PerformanceInspections::string_concat_in_loop,
+                       "expression " + lhs_help + " = <...> . " + lhs_help + " copies the whole string in a loop, " +
+                       "the parts can be collected into an array and joined with implode()");
+  }
+}
+
 void AnalyzePerformance::save_to_second_pass_analyze_on_loop_exit(VertexPtr vertex) noexcept {
   if (!loop_data_for_second_pass_.empty() && !loop_data_for_second_pass_.back().condition_depth && !second_pass_saved_top_vertex_) {
     loop_data_for_second_pass_.back().second_pass_vertexes.emplace_back(vertex);
@@ -351,14 +375,20 @@ void AnalyzePerformance::run_second_pass_on_loop_exit(VertexPtr vertex, uint64_t
   }
 }
 
+bool AnalyzePerformance::is_loop_analysis_enabled() const noexcept {
+  return is_enabled<PerformanceInspections::constant_execution_in_loop>() ||
+         is_enabled<PerformanceInspections::array_reserve>() ||
+         is_enabled<PerformanceInspections::string_concat_in_loop>();
+}
+
 void AnalyzePerformance::enter_loop() noexcept {
-  if (is_enabled<PerformanceInspections::constant_execution_in_loop>() || is_enabled<PerformanceInspections::array_reserve>()) {
+  if (is_loop_analysis_enabled()) {
     loop_data_for_second_pass_.emplace_back();
   }
 }
 
 void AnalyzePerformance::exit_loop(VertexPtr loop_vertex) noexcept {
-  if (!is_enabled<PerformanceInspections::constant_execution_in_loop>() && !is_enabled<PerformanceInspections::array_reserve>()) {
+  if (!is_loop_analysis_enabled()) {
     return;
   }
   const size_t loop_depth = loop_data_for_second_pass_.size();
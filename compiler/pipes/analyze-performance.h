@@ -37,10 +37,12 @@ private:
   void analyze_op_var(VertexAdaptor<op_var> op_var_vertex) noexcept;
 
   void check_implicit_array_conversion(VertexPtr expr, const TypeData *to) noexcept;
+  void check_string_concat_in_loop(VertexAdaptor<op_set> op_set_vertex) noexcept;
 
   void save_to_second_pass_analyze_on_loop_exit(VertexPtr vertex) noexcept;
   void run_second_pass_on_loop_exit(VertexPtr vertex, uint64_t enabled_inspections, VertexPtr loop_vertex) noexcept;
 
+  bool is_loop_analysis_enabled() const noexcept;
   void enter_loop() noexcept;
   void exit_loop(VertexPtr loop_vertex) noexcept;
 
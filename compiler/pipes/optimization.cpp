@@ -90,6 +90,23 @@ void explicit_cast_array_type(VertexPtr &type_acceptor, const TypeData *required
   }
 }
 
+bool is_var_used(VertexPtr root, VarPtr var) noexcept {
+  if (auto var_vertex = root.try_as<op_var>()) {
+    return var_vertex->var_id == var;
+  }
+  return vk::any_of(*root, [&var](VertexPtr child) { return is_var_used(child, var); });
+}
+
+// a local string variable can't be changed by the function calls, so `$s = $s . $x` can be replaced with `$s .= $x`
+bool can_concat_be_appended_inplace(VertexAdaptor<op_var> var_vertex) noexcept {
+  const VarPtr &var = var_vertex->var_id;
+  if (vk::none_of_equal(var->type(), VarData::var_local_t, VarData::var_param_t) || var->is_reference || var->is_foreach_reference) {
+    return false;
+  }
+  const auto *type = tinf::get_type(var_vertex);
+  return type->ptype() == tp_string && !type->use_optional();
+}
+
 } // namespace
 
 VertexPtr OptimizationPass::optimize_set_push_back(VertexAdaptor<op_set> set_op) {
@@ -130,6 +147,37 @@ VertexPtr OptimizationPass::optimize_set_push_back(VertexAdaptor<op_set> set_op)
   result->rl_type = set_op->rl_type;
   return result;
 }
+
+// `$s = $s . $x . $y` builds a new string and copies $s into it, so a loop of such assignments is quadratic;
+// it's replaced with `$s .= $x . $y`, that appends the parts to $s in place and grows it geometrically
+VertexPtr OptimizationPass::optimize_set_concat(VertexAdaptor<op_set> set_op) {
+  auto lhs = set_op->lhs().try_as<op_var>();
+  if (set_op->rl_type != val_none || !lhs || vk::none_of_equal(set_op->rhs()->type(), op_concat, op_string_build) ||
+      !can_concat_be_appended_inplace(lhs)) {
+    return set_op;
+  }
+
+  std::vector<VertexPtr> collected;
+  collect_concat(set_op->rhs(), &collected);
+  auto first = collected.front();
+  if (auto conv = first.try_as<op_conv_string>()) {
+    first = conv->expr();
+  }
+  auto first_var = first.try_as<op_var>();
+  if (!first_var || first_var->var_id != lhs->var_id || collected.size() < 2 ||
+      std::any_of(std::next(collected.begin()), collected.end(), [&lhs](VertexPtr part) { return is_var_used(part, lhs->var_id); })) {
+    return set_op;
+  }
+
+  auto appended = VertexAdaptor<op_string_build>::create(std::vector<VertexPtr>{std::next(collected.begin()), collected.end()});
+  appended->location = set_op->rhs()->get_location();
+  appended->rl_type = val_r;
+  auto result = VertexAdaptor<op_set_dot>::create(lhs, appended);
+  result->location = set_op->get_location();
+  result->rl_type = set_op->rl_type;
+  return result;
+}
+
 void OptimizationPass::collect_concat(VertexPtr root, std::vector<VertexPtr> *collected) {
   if (root->type() == op_string_build || root->type() == op_concat) {
     for (auto i : *root) {
@@ -272,6 +320,9 @@ VertexPtr OptimizationPass::on_enter_vertex(VertexPtr root) {
   if (auto set_vertex = root.try_as<op_set>()) {
     explicit_cast_array_type(set_vertex->rhs(), tinf::get_type(set_vertex->lhs()), &current_function->explicit_const_var_ids);
     root = optimize_set_push_back(set_vertex);
+    if (auto not_push_back_set_vertex = root.try_as<op_set>()) {
+      root = optimize_set_concat(not_push_back_set_vertex);
+    }
   } else if (root->type() == op_string_build || root->type() == op_concat) {
     root = optimize_string_building(root);
   } else if (root->type() == op_postfix_inc) {
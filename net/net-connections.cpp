@@ -641,11 +641,23 @@ static inline int compute_conn_events(struct connection *c) {
 }
 #endif
 
+static bool special_connections_accept_paused = false;
+
+void set_special_connections_accept_paused(int listening_fd, bool paused) {
+  assert(Connections[listening_fd].basic_type == ct_listen);
+  special_connections_accept_paused = paused;
+  if (paused) {
+    epoll_remove(listening_fd);
+  } else if (active_special_connections < max_special_connections) {
+    epoll_insert(listening_fd, EVT_READ | EVT_LEVEL);
+  }
+}
+
 void close_special_connection(struct connection *c) {
   if (c->basic_type != ct_listen) {
     --active_special_connections;
     on_active_special_connections_update_callback();
-    if (active_special_connections < max_special_connections && Connections[c->listening].basic_type == ct_listen &&
+    if (!special_connections_accept_paused && active_special_connections < max_special_connections && Connections[c->listening].basic_type == ct_listen &&
         Connections[c->listening].generation == c->listening_generation) {
       epoll_insert(c->listening, EVT_READ | EVT_LEVEL);
     }
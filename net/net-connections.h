@@ -242,6 +242,9 @@ extern long long total_failed_connections, total_connect_failures, unused_connec
 extern const char *unix_socket_directory;
 
 void set_on_active_special_connections_update_callback(void (*callback)()) noexcept;
+// stops polling the listening socket of the special connections until it's unpaused,
+// so the kernel passes the new connections to the other processes listening the same socket
+void set_special_connections_accept_paused(int listening_fd, bool paused);
 
 int init_listening_connection_mode(int fd, conn_type_t *type, void *extra, int mode);
 
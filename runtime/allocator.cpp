@@ -19,6 +19,7 @@
 #include "runtime/kphp-backtrace.h"
 #include "runtime/memory_resource/dealer.h"
 #include "runtime/php_assert.h"
+#include "runtime/script-phases.h"
 #include "server/server-log.h"
 
 namespace dl {
@@ -56,6 +57,10 @@ void restore_default_script_allocator(bool force_disable) noexcept {
   }
 }
 
+void set_script_allocation_sampler(int64_t (*sampler)(void *mem, size_t size) noexcept, int64_t bytes_to_next_sample) noexcept {
+  get_memory_dealer().default_script_resource().set_allocation_sampler(sampler, bytes_to_next_sample);
+}
+
 const memory_resource::MemoryStats &get_script_memory_stats() noexcept {
   return get_memory_dealer().current_script_resource().get_memory_stats();
 }
@@ -108,6 +113,7 @@ void *allocate(size_t size) noexcept {
     return nullptr;
   }
 
+  ScriptPhaseGuard phase_guard{ScriptPhase::memory_allocation};
   return dealer.current_script_resource().allocate(size);
 }
 
@@ -122,6 +128,7 @@ void *allocate0(size_t size) noexcept {
     return nullptr;
   }
 
+  ScriptPhaseGuard phase_guard{ScriptPhase::memory_allocation};
   return dealer.current_script_resource().allocate0(size);
 }
 
@@ -136,6 +143,7 @@ void *reallocate(void *mem, size_t new_size, size_t old_size) noexcept {
     return mem;
   }
 
+  ScriptPhaseGuard phase_guard{ScriptPhase::memory_allocation};
   return dealer.current_script_resource().reallocate(mem, new_size, old_size);
 }
 
@@ -147,6 +155,7 @@ void deallocate(void *mem, size_t size) noexcept {
   }
 
   if (script_allocator_enabled) {
+    ScriptPhaseGuard phase_guard{ScriptPhase::memory_allocation};
     dealer.current_script_resource().deallocate(mem, size);
   }
 }
@@ -318,6 +327,26 @@ MemoryReplacementGuard::~MemoryReplacementGuard() {
   dl::leave_critical_section();
 }
 
+HeapMemoryReplacementGuard::HeapMemoryReplacementGuard() noexcept {
+  dl::enter_critical_section();
+  auto &dealer = get_memory_dealer();
+  dealer.set_script_resource_replacer(dealer.get_heap_resource());
+}
+
+HeapMemoryReplacementGuard::~HeapMemoryReplacementGuard() noexcept {
+  get_memory_dealer().drop_replacer();
+  dl::leave_critical_section();
+}
+
+ConstantsRegionGuard::ConstantsRegionGuard() noexcept {
+  constexpr size_t CONSTANTS_REGION_CAPACITY = size_t{1} << 32;
+  get_memory_dealer().get_heap_resource().open_constants_region(CONSTANTS_REGION_CAPACITY);
+}
+
+ConstantsRegionGuard::~ConstantsRegionGuard() noexcept {
+  get_memory_dealer().get_heap_resource().close_constants_region();
+}
+
 } // namespace dl
 
 // sanitizers aren't happy with custom realization of malloc-like functions
@@ -25,6 +25,9 @@ memory_resource::unsynchronized_pool_resource &get_default_script_allocator() no
 void set_current_script_allocator(memory_resource::unsynchronized_pool_resource &replacer, bool force_enable) noexcept;
 void restore_default_script_allocator(bool force_disable) noexcept;
 
+// samples the allocations of the default script allocator, see unsynchronized_pool_resource::allocation_sampler
+void set_script_allocation_sampler(int64_t (*sampler)(void *mem, size_t size) noexcept, int64_t bytes_to_next_sample) noexcept;
+
 const memory_resource::MemoryStats &get_script_memory_stats() noexcept;
 size_t get_heap_memory_used() noexcept;
 
@@ -59,6 +62,22 @@ public:
   ~MemoryReplacementGuard();
 };
 
+// makes the script allocation functions use the heap until the destructor is executed,
+// it's used for the objects that outlive the request and are never freed by the script allocator
+class HeapMemoryReplacementGuard {
+public:
+  HeapMemoryReplacementGuard() noexcept;
+  ~HeapMemoryReplacementGuard() noexcept;
+};
+
+// places the heap allocations into the constants region until the destructor is executed,
+// it's used for the global constants initialization in the master process, see heap_resource::open_constants_region()
+class ConstantsRegionGuard {
+public:
+  ConstantsRegionGuard() noexcept;
+  ~ConstantsRegionGuard() noexcept;
+};
+
 } // namespace dl
 
 // replace malloc so it starts to use a script memory
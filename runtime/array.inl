@@ -7,6 +7,7 @@
 #include <type_traits>
 
 #include "common/algorithms/fastmod.h"
+#include "common/algorithms/pdqsort.h"
 
 #ifndef INCLUDED_FROM_KPHP_CORE
   #error "this file must be included only from kphp_core.h"
@@ -48,55 +49,8 @@ namespace dl {
 
 template<class T, class T1>
 void sort(T *begin_init, T *end_init, const T1 &compare) {
-  T *begin_stack[32];
-  T *end_stack[32];
-
-  begin_stack[0] = begin_init;
-  end_stack[0] = end_init - 1;
-
-  for (int depth = 0; depth >= 0; --depth) {
-    T *begin = begin_stack[depth];
-    T *end = end_stack[depth];
-
-    while (begin < end) {
-      const auto offset = (end - begin) >> 1;
-      swap(*begin, begin[offset]);
-
-      T *i = begin + 1, *j = end;
-
-      while (1) {
-        while (i < j && compare(*begin, *i) > 0) {
-          i++;
-        }
-
-        while (i <= j && compare(*j, *begin) > 0) {
-          j--;
-        }
-
-        if (i >= j) {
-          break;
-        }
-
-        swap(*i++, *j--);
-      }
-
-      swap(*begin, *j);
-
-      if (j - begin <= end - j) {
-        if (j + 1 < end) {
-          begin_stack[depth] = j + 1;
-          end_stack[depth++] = end;
-        }
-        end = j - 1;
-      } else {
-        if (begin < j - 1) {
-          begin_stack[depth] = begin;
-          end_stack[depth++] = j - 1;
-        }
-        begin = j + 1;
-      }
-    }
-  }
+  // compare(lhs, rhs) > 0 means that lhs goes after rhs
+  vk::pdqsort(begin_init, end_init, [&compare](const T &lhs, const T &rhs) { return compare(rhs, lhs) > 0; });
 }
 
 } // namespace dl
@@ -152,6 +106,16 @@ bool array<T>::array_inner::is_vector() const {
   return string_buf_size == std::numeric_limits<uint32_t>::max();
 }
 
+template<class T>
+bool array<T>::array_inner::is_vector_with_holes() const {
+  return CAN_HAVE_HOLES && string_buf_size == std::numeric_limits<uint32_t>::max() - 1;
+}
+
+template<class T>
+bool array<T>::array_inner::has_vector_layout() const {
+  return CAN_HAVE_HOLES ? string_buf_size >= std::numeric_limits<uint32_t>::max() - 1 : is_vector();
+}
+
 
 template<class T>
 typename array<T>::list_hash_entry *array<T>::array_inner::get_entry(entry_pointer_type pointer) const {
@@ -236,6 +200,16 @@ size_t array<T>::array_inner::sizeof_vector(uint32_t int_size) {
   return sizeof(array_inner) + int_size * sizeof(T);
 }
 
+template<class T>
+size_t array<T>::array_inner::sizeof_vector_with_holes(uint32_t int_size) {
+  return sizeof_vector(int_size) + (int_size + 63) / 64 * sizeof(uint64_t);
+}
+
+template<class T>
+bool array<T>::array_inner::is_dense_enough(int64_t keys_count, int64_t keys_span) {
+  return keys_span <= 4 * keys_count + 8;
+}
+
 template<class T>
 size_t array<T>::array_inner::sizeof_map(uint32_t int_size, uint32_t string_size) {
   return sizeof(array_inner_fields_for_map) + sizeof(array_inner) + int_size * sizeof(int_hash_entry) + string_size * sizeof(string_hash_entry);
@@ -304,6 +278,19 @@ typename array<T>::array_inner *array<T>::array_inner::create(int64_t new_int_si
   return p;
 }
 
+template<class T>
+typename array<T>::array_inner *array<T>::array_inner::create_vector_with_holes(uint32_t new_int_size) {
+  php_assert (CAN_HAVE_HOLES && new_int_size > 0);
+  auto p = reinterpret_cast<array_inner *>(dl::allocate0(sizeof_vector_with_holes(new_int_size)));
+  p->ref_cnt = 0;
+  p->max_key = -1;
+  p->int_size = 0;
+  p->int_buf_size = new_int_size;
+  p->string_size = 0;
+  p->string_buf_size = std::numeric_limits<uint32_t>::max() - 1;
+  return p;
+}
+
 template<class T>
 void array<T>::array_inner::dispose() {
   if (ref_cnt < ExtraRefCnt::for_global_const) {
@@ -318,6 +305,11 @@ void array<T>::array_inner::dispose() {
         return;
       }
 
+      if (is_vector_with_holes()) {
+        dl::deallocate((void *)this, sizeof_vector_with_holes(int_buf_size));
+        return;
+      }
+
       for (const string_hash_entry *it = begin(); it != end(); it = next(it)) {
         it->value.~T();
         if (is_string_hash_entry(it)) {
@@ -367,6 +359,81 @@ const T &array<T>::array_inner::get_vector_value(int64_t int_key) const {
   return reinterpret_cast<const T *>(int_entries)[int_key];
 }
 
+template<class T>
+const uint64_t *array<T>::array_inner::get_presence_bits() const {
+  return reinterpret_cast<const uint64_t *>(reinterpret_cast<const T *>(int_entries) + int_buf_size);
+}
+
+template<class T>
+uint64_t *array<T>::array_inner::get_presence_bits() {
+  return reinterpret_cast<uint64_t *>(reinterpret_cast<T *>(int_entries) + int_buf_size);
+}
+
+template<class T>
+bool array<T>::array_inner::has_vector_with_holes_value(int64_t int_key) const {
+  return int_key >= 0 && int_key < int_buf_size && (get_presence_bits()[int_key >> 6] >> (int_key & 63) & 1);
+}
+
+template<class T>
+void array<T>::array_inner::set_vector_with_holes_presence(uint32_t begin_key, uint32_t end_key, bool present) {
+  uint64_t *bits = get_presence_bits();
+  for (uint32_t key = begin_key; key < end_key;) {
+    const uint32_t word_end = std::min(end_key, (key | 63) + 1);
+    const uint64_t mask = (word_end - key == 64 ? ~uint64_t{0} : ((uint64_t{1} << (word_end - key)) - 1)) << (key & 63);
+    bits[key >> 6] = present ? bits[key >> 6] | mask : bits[key >> 6] & ~mask;
+    key = word_end;
+  }
+}
+
+template<class T>
+int64_t array<T>::array_inner::next_vector_with_holes_key(int64_t int_key) const {
+  const uint64_t *bits = get_presence_bits();
+  const int64_t end_key = max_key + 1;
+  int64_t key = int_key + 1;
+  if (key >= end_key) {
+    return end_key;
+  }
+  uint64_t word = bits[key >> 6] & (~uint64_t{0} << (key & 63));
+  key &= ~int64_t{63};
+  while (word == 0) {
+    key += 64;
+    if (key >= end_key) {
+      return end_key;
+    }
+    word = bits[key >> 6];
+  }
+  return std::min(key + __builtin_ctzll(word), end_key);
+}
+
+template<class T>
+int64_t array<T>::array_inner::prev_vector_with_holes_key(int64_t int_key) const {
+  const uint64_t *bits = get_presence_bits();
+  int64_t key = std::min(int_key, max_key + 1) - 1;
+  if (key < 0) {
+    return -1;
+  }
+  uint64_t word = bits[key >> 6] & (~uint64_t{0} >> (63 - (key & 63)));
+  key &= ~int64_t{63};
+  while (word == 0) {
+    key -= 64;
+    if (key < 0) {
+      return -1;
+    }
+    word = bits[key >> 6];
+  }
+  return key + 63 - __builtin_clzll(word);
+}
+
+template<class T>
+T array<T>::array_inner::unset_vector_with_holes_value(int64_t int_key) {
+  T &value = get_vector_value(int_key);
+  T res = value;
+  value = T{};
+  set_vector_with_holes_presence(static_cast<uint32_t>(int_key), static_cast<uint32_t>(int_key + 1), false);
+  int_size--;
+  return res;
+}
+
 template<class T>
 template<class ...Args>
 T &array<T>::array_inner::emplace_vector_value(int64_t int_key, Args &&... args) noexcept {
@@ -525,12 +592,15 @@ const T *array<T>::array_inner::find_map_value(Key &&... key) const noexcept {
 
 template<class T>
 const T *array<T>::array_inner::find_vector_value(int64_t int_key) const noexcept {
+  if (is_vector_with_holes()) {
+    return has_vector_with_holes_value(int_key) ? &get_vector_value(int_key) : nullptr;
+  }
   return int_key >= 0 && int_key < int_size ? &get_vector_value(int_key) : nullptr;
 }
 
 template<class T>
 T *array<T>::array_inner::find_vector_value(int64_t int_key) noexcept {
-  return int_key >= 0 && int_key < int_size ? &get_vector_value(int_key) : nullptr;
+  return const_cast<T *>(static_cast<const array_inner *>(this)->find_vector_value(int_key));
 }
 
 template<class T>
@@ -636,6 +706,10 @@ bool array<T>::array_inner::is_vector_internal_or_last_index(int64_t key) const
 
 template<class T>
 size_t array<T>::array_inner::estimate_memory_usage() const {
+  if (is_vector_with_holes()) {
+    // the copy is sized to the keys span
+    return sizeof_vector_with_holes(static_cast<uint32_t>(max_key + 1));
+  }
   int64_t int_elements = int_size;
   int64_t string_elements = 0;
   const bool vector_structure = is_vector();
@@ -651,6 +725,11 @@ bool array<T>::is_vector() const {
   return p->is_vector();
 }
 
+template<class T>
+bool array<T>::is_vector_with_holes() const {
+  return p->is_vector_with_holes();
+}
+
 template<class T>
 bool array<T>::is_pseudo_vector() const {
   if (p->string_size) {
@@ -673,6 +752,7 @@ bool array<T>::mutate_if_vector_shared(uint32_t mul) {
 template<class T>
 bool array<T>::mutate_to_size_if_vector_shared(int64_t int_size) {
   if (p->ref_cnt > 0) {
+    ScriptPhaseGuard phase_guard{ScriptPhase::copying};
     array_inner *new_array = array_inner::create(int_size, 0, true);
 
     const auto size = static_cast<uint32_t>(p->int_size);
@@ -692,6 +772,7 @@ bool array<T>::mutate_to_size_if_vector_shared(int64_t int_size) {
 template<class T>
 bool array<T>::mutate_if_map_shared(uint32_t mul) {
   if (p->ref_cnt > 0) {
+    ScriptPhaseGuard phase_guard{ScriptPhase::copying};
     array_inner *new_array = array_inner::create(p->int_size * mul + 1, p->string_size * mul + 1, false);
 
     for (const string_hash_entry *it = p->begin(); it != p->end(); it = p->next(it)) {
@@ -789,19 +870,88 @@ void array<T>::mutate_if_map_needed_string() {
 
 template<class T>
 void array<T>::mutate_to_map_if_vector_or_map_need_string() {
-  if (is_vector()) {
+  if (p->has_vector_layout()) {
     convert_to_map();
   } else {
     mutate_if_map_needed_string();
   }
 }
 
+template<class T>
+void array<T>::mutate_to_vector_with_holes(int64_t int_size) {
+  if constexpr (array_inner::CAN_HAVE_HOLES) {
+    const bool was_vector = p->is_vector();
+    if (!was_vector && p->ref_cnt <= 0 && int_size <= p->int_buf_size) {
+      return;
+    }
+
+    const int64_t keys_span = p->max_key + 1;
+    int64_t new_int_size = p->int_buf_size;
+    if (int_size > p->int_buf_size) {
+      new_int_size = std::max(int_size, std::min(int64_t{p->int_buf_size} * 2, int64_t{array_inner::MAX_HASHTABLE_SIZE}));
+    } else if (p->ref_cnt > 0) {
+      new_int_size = std::max({int_size, keys_span, int64_t{1}});
+    }
+    if (unlikely(new_int_size > array_inner::MAX_HASHTABLE_SIZE)) {
+      php_critical_error ("max array size exceeded: int_size = %" PRIi64, new_int_size);
+    }
+    const auto new_int_buf_size = static_cast<uint32_t>(new_int_size);
+
+    if (p->ref_cnt > 0) {
+      ScriptPhaseGuard phase_guard{ScriptPhase::copying};
+      array_inner *new_array = array_inner::create_vector_with_holes(new_int_buf_size);
+      memcpy(new_array->int_entries, p->int_entries, keys_span * sizeof(T));
+      if (was_vector) {
+        new_array->set_vector_with_holes_presence(0, p->int_size, true);
+      } else {
+        memcpy(new_array->get_presence_bits(), p->get_presence_bits(), (keys_span + 63) / 64 * sizeof(uint64_t));
+      }
+      new_array->max_key = p->max_key;
+      new_array->int_size = p->int_size;
+
+      p->dispose();
+      p = new_array;
+      return;
+    }
+
+    // not shared (ref_cnt == 0), the values are kept at their places and the presence bits are moved after them
+    const uint32_t old_int_buf_size = p->int_buf_size;
+    const size_t old_size = was_vector ? array_inner::sizeof_vector(old_int_buf_size) : array_inner::sizeof_vector_with_holes(old_int_buf_size);
+    p = static_cast<array_inner *>(dl::reallocate(p, array_inner::sizeof_vector_with_holes(new_int_buf_size), old_size));
+    const uint64_t *old_bits = p->get_presence_bits();
+    p->int_buf_size = new_int_buf_size;
+    uint64_t *new_bits = p->get_presence_bits();
+    const uint32_t old_words = was_vector ? 0 : (old_int_buf_size + 63) / 64;
+    memmove(new_bits, old_bits, old_words * sizeof(uint64_t));
+    memset(new_bits + old_words, 0, ((new_int_buf_size + 63) / 64 - old_words) * sizeof(uint64_t));
+    const uint32_t values_end = was_vector ? p->int_size : old_int_buf_size;
+    memset(reinterpret_cast<T *>(p->int_entries) + values_end, 0, (new_int_buf_size - values_end) * sizeof(T));
+    if (was_vector) {
+      p->set_vector_with_holes_presence(0, p->int_size, true);
+      p->string_buf_size = std::numeric_limits<uint32_t>::max() - 1;
+    }
+  } else {
+    static_cast<void>(int_size);
+    php_critical_error ("vector with holes can't be created for such values");
+  }
+}
+
+template<class T>
+void array<T>::mutate_if_vector_with_holes_shared() {
+  if (p->ref_cnt > 0) {
+    mutate_to_vector_with_holes(p->max_key + 1);
+  }
+}
+
 template<class T>
 void array<T>::reserve(int64_t int_size, int64_t string_size, bool make_vector_if_possible) {
   if (int_size > int64_t{p->int_buf_size} || (string_size > 0 && string_size > int64_t{p->string_buf_size})) {
     if (is_vector() && string_size == 0 && make_vector_if_possible) {
       mutate_to_size(int_size);
     } else {
+      if (p->is_vector_with_holes()) {
+        convert_to_map();
+      }
       const int64_t new_int_size = std::max(int_size, int64_t{p->int_buf_size});
       const int64_t new_string_size = std::max(string_size, is_vector() ? 0L : int64_t{p->string_buf_size});
       array_inner *new_array = array_inner::create(new_int_size, new_string_size, false);
@@ -879,7 +1029,13 @@ void array<T>::convert_to_map() {
 
   T *elements = reinterpret_cast<T *>(p->int_entries);
   const bool move_values = p->ref_cnt == 0;
-  if (move_values) {
+  if (p->is_vector_with_holes()) {
+    for (int64_t it = p->next_vector_with_holes_key(-1); it <= p->max_key; it = p->next_vector_with_holes_key(it)) {
+      new_array->set_map_value(overwrite_element::YES, it, elements[it]);
+    }
+    // the max key of the unset values is kept as map keeps it
+    new_array->max_key = p->max_key;
+  } else if (move_values) {
     for (uint32_t it = 0; it != p->int_size; it++) {
       new_array->emplace_int_key_map_value(overwrite_element::YES, it, std::move(elements[it]));
     }
@@ -895,6 +1051,26 @@ void array<T>::convert_to_map() {
   p = new_array;
 }
 
+template<class T>
+T *array<T>::emplace_vector_with_holes_value(int64_t int_key) noexcept {
+  if constexpr (array_inner::CAN_HAVE_HOLES) {
+    if (p->is_vector_with_holes() && p->has_vector_with_holes_value(int_key)) {
+      mutate_if_vector_with_holes_shared();
+      return &p->get_vector_value(int_key);
+    }
+    // the keys must be ascending in the insertion order, so only the ones after the max key are added
+    if (int_key > p->max_key && array_inner::is_dense_enough(int64_t{p->int_size} + 1, int_key + 1)) {
+      mutate_to_vector_with_holes(int_key + 1);
+      p->set_vector_with_holes_presence(static_cast<uint32_t>(int_key), static_cast<uint32_t>(int_key + 1), true);
+      p->int_size++;
+      p->max_key = int_key;
+      return &p->get_vector_value(int_key);
+    }
+  }
+  convert_to_map();
+  return nullptr;
+}
+
 template<class T>
 template<class T1>
 void array<T>::copy_from(const array<T1> &other) {
@@ -911,6 +1087,12 @@ void array<T>::copy_from(const array<T1> &other) {
     for (uint32_t i = 0; i < size; i++) {
       new_array->push_back_vector_value(convert_to<T>::convert(it[i]));
     }
+  } else if (other.p->is_vector_with_holes()) {
+    T1 *it = reinterpret_cast<T1 *>(other.p->int_entries);
+    for (int64_t i = other.p->next_vector_with_holes_key(-1); i <= other.p->max_key; i = other.p->next_vector_with_holes_key(i)) {
+      new_array->set_map_value(overwrite_element::YES, i, convert_to<T>::convert(it[i]));
+    }
+    new_array->max_key = other.p->max_key;
   } else {
     for (const typename array<T1>::string_hash_entry *it = other.p->begin(); it != other.p->end(); it = other.p->next(it)) {
       if (other.p->is_string_hash_entry(it)) {
@@ -949,6 +1131,12 @@ void array<T>::move_from(array<T1> &&other) noexcept {
     for (uint32_t i = 0; i < size; i++) {
       new_array->emplace_back_vector_value(convert_to<T>::convert(std::move(it[i])));
     }
+  } else if (other.p->is_vector_with_holes()) {
+    T1 *it = reinterpret_cast<T1 *>(other.p->int_entries);
+    for (int64_t i = other.p->next_vector_with_holes_key(-1); i <= other.p->max_key; i = other.p->next_vector_with_holes_key(i)) {
+      new_array->emplace_int_key_map_value(overwrite_element::YES, i, convert_to<T>::convert(it[i]));
+    }
+    new_array->max_key = other.p->max_key;
   } else {
     for (auto it = other.p->begin(); it != other.p->end(); it = other.p->next(it)) {
       if (other.p->is_string_hash_entry(it)) {
@@ -1096,7 +1284,13 @@ T &array<T>::operator[](int64_t int_key) {
       }
     }
 
-    convert_to_map();
+    if (T *value = emplace_vector_with_holes_value(int_key)) {
+      return *value;
+    }
+  } else if (p->is_vector_with_holes()) {
+    if (T *value = emplace_vector_with_holes_value(int_key)) {
+      return *value;
+    }
   } else {
     mutate_if_map_needed_int();
   }
@@ -1149,7 +1343,7 @@ T &array<T>::operator[](double double_key) {
 
 template<class T>
 T &array<T>::operator[](const const_iterator &it) noexcept {
-  if (it.self_->is_vector()) {
+  if (it.self_->has_vector_layout()) {
     const auto key = static_cast<int64_t>(reinterpret_cast<const T *>(it.entry_) - reinterpret_cast<const T *>(it.self_->int_entries));
     return operator[](key);
   }
@@ -1181,7 +1375,15 @@ void array<T>::emplace_value(int64_t int_key, Args &&... args) noexcept {
       return;
     }
 
-    convert_to_map();
+    if (T *value = emplace_vector_with_holes_value(int_key)) {
+      *value = T(std::forward<Args>(args)...);
+      return;
+    }
+  } else if (p->is_vector_with_holes()) {
+    if (T *value = emplace_vector_with_holes_value(int_key)) {
+      *value = T(std::forward<Args>(args)...);
+      return;
+    }
   } else {
     mutate_if_map_needed_int();
   }
@@ -1313,7 +1515,7 @@ void array<T>::set_value(const Optional<OptionalT> &key, const T &value) noexcep
 
 template<class T>
 void array<T>::set_value(const const_iterator &it) noexcept {
-  if (it.self_->is_vector()) {
+  if (it.self_->has_vector_layout()) {
     const auto key = static_cast<int64_t>(reinterpret_cast<const T *>(it.entry_) - reinterpret_cast<const T *>(it.self_->int_entries));
     emplace_value(key, *reinterpret_cast<const T *>(it.entry_));
     return;
@@ -1339,7 +1541,7 @@ void array<T>::assign_raw(const char *s) {
 
 template<class T>
 const T *array<T>::find_value(int64_t int_key) const noexcept {
-  return p->is_vector()
+  return p->has_vector_layout()
          ? p->find_vector_value(int_key)
          : p->find_map_value(int_key);
 }
@@ -1348,15 +1550,26 @@ template<class T>
 const T *array<T>::find_value(const char *s, string::size_type l) const noexcept {
   int64_t int_val = 0;
   const bool is_key_int = php_try_to_int(s, l, &int_val);
-  if (p->is_vector()) {
+  if (p->has_vector_layout()) {
     return is_key_int ? p->find_vector_value(int_val) : nullptr;
   }
   return is_key_int ? p->find_map_value(int_val) : p->find_map_value(s, l, string_hash(s, l));
 }
 
+template<class T>
+const T *array<T>::find_value(const string &string_key) const noexcept {
+  int64_t int_val = 0;
+  const bool is_key_int = string_key.try_to_int(&int_val);
+  if (p->has_vector_layout()) {
+    return is_key_int ? p->find_vector_value(int_val) : nullptr;
+  }
+  // unlike the raw keys, the strings cache their hashes
+  return is_key_int ? p->find_map_value(int_val) : p->find_map_value(string_key, string_key.hash());
+}
+
 template<class T>
 const T *array<T>::find_value(const string &string_key, int64_t precomputed_hash) const noexcept {
-  return p->is_vector() ? nullptr : p->find_map_value(string_key, precomputed_hash);
+  return p->has_vector_layout() ? nullptr : p->find_map_value(string_key, precomputed_hash);
 }
 
 template<class T>
@@ -1387,7 +1600,7 @@ const T *array<T>::find_value(double double_key) const noexcept {
 
 template<class T>
 const T *array<T>::find_value(const const_iterator &it) const noexcept {
-  if (it.self_->is_vector()) {
+  if (it.self_->has_vector_layout()) {
     const auto key = static_cast<int64_t>(reinterpret_cast<const T *>(it.entry_) - reinterpret_cast<const T *>(it.self_->int_entries));
     return find_value(key);
   } else {
@@ -1405,7 +1618,7 @@ const T *array<T>::find_value(const iterator &it) const noexcept {
 
 template<class T>
 typename array<T>::iterator array<T>::find_no_mutate(int64_t int_key) noexcept {
-  if (p->is_vector()) {
+  if (p->has_vector_layout()) {
     if (auto *vector_entry = p->find_vector_value(int_key)) {
       return iterator{p, reinterpret_cast<list_hash_entry *>(vector_entry)};
     }
@@ -1420,7 +1633,7 @@ typename array<T>::iterator array<T>::find_no_mutate(const string &string_key) n
   if (string_key.try_to_int(&int_key)) {
     return find_no_mutate(int_key);
   }
-  if (p->is_vector()) {
+  if (p->has_vector_layout()) {
     return end_no_mutate();
   }
   return find_iterator_in_map_no_mutate(string_key, string_key.hash());
@@ -1506,11 +1719,27 @@ T array<T>::unset(int64_t int_key) {
       mutate_if_vector_shared();
       return p->unset_vector_value();
     }
-    convert_to_map();
-  } else {
+    if constexpr (array_inner::CAN_HAVE_HOLES) {
+      mutate_to_vector_with_holes(p->int_size);
+    } else {
+      convert_to_map();
+    }
+  } else if (!p->is_vector_with_holes()) {
     mutate_if_map_shared();
   }
 
+  if (p->is_vector_with_holes()) {
+    if (!p->has_vector_with_holes_value(int_key)) {
+      return {};
+    }
+    mutate_if_vector_with_holes_shared();
+    T res = p->unset_vector_with_holes_value(int_key);
+    if (!array_inner::is_dense_enough(p->int_size, p->max_key + 1)) {
+      convert_to_map();
+    }
+    return res;
+  }
+
   return p->unset_map_value(int_key);
 }
 
@@ -1521,7 +1750,7 @@ T array<T>::unset(const string &string_key) {
     return unset(int_val);
   }
 
-  if (is_vector()) {
+  if (p->has_vector_layout()) {
     return {};
   }
 
@@ -1530,7 +1759,7 @@ T array<T>::unset(const string &string_key) {
 
 template<class T>
 T array<T>::unset(const string &string_key, int64_t precomputed_hash) {
-  if (is_vector()) {
+  if (p->has_vector_layout()) {
     return {};
   }
 
@@ -1619,6 +1848,10 @@ const array<T> array<T>::operator+(const array<T> &other) const {
         result.p->set_map_value(overwrite_element::YES, i, it[i]);
       }
     }
+  } else if (p->is_vector_with_holes()) {
+    for (int64_t i = p->next_vector_with_holes_key(-1); i <= p->max_key; i = p->next_vector_with_holes_key(i)) {
+      result.p->set_map_value(overwrite_element::YES, i, p->get_vector_value(i));
+    }
   } else {
     for (const string_hash_entry *it = p->begin(); it != p->end(); it = p->next(it)) {
       if (p->is_string_hash_entry(it)) {
@@ -1642,6 +1875,10 @@ const array<T> array<T>::operator+(const array<T> &other) const {
         result.p->set_map_value(overwrite_element::NO, i, it[i]);
       }
     }
+  } else if (other.p->is_vector_with_holes()) {
+    for (int64_t i = other.p->next_vector_with_holes_key(-1); i <= other.p->max_key; i = other.p->next_vector_with_holes_key(i)) {
+      result.p->set_map_value(overwrite_element::NO, i, other.p->get_vector_value(i));
+    }
   } else {
     for (const string_hash_entry *it = other.p->begin(); it != other.p->end(); it = other.p->next(it)) {
       if (other.p->is_string_hash_entry(it)) {
@@ -1660,6 +1897,9 @@ array<T> &array<T>::operator+=(const array<T> &other) {
   if (other.empty()) {
     return *this;
   }
+  if (p->is_vector_with_holes()) {
+    convert_to_map();
+  }
   if (is_vector()) {
     if (other.is_vector()) {
       uint32_t size = other.p->int_size;
@@ -1734,6 +1974,10 @@ array<T> &array<T>::operator+=(const array<T> &other) {
     for (uint32_t i = 0; i < size; i++) {
       p->set_map_value(overwrite_element::NO, i, it[i]);
     }
+  } else if (other.p->is_vector_with_holes()) {
+    for (int64_t i = other.p->next_vector_with_holes_key(-1); i <= other.p->max_key; i = other.p->next_vector_with_holes_key(i)) {
+      p->set_map_value(overwrite_element::NO, i, other.p->get_vector_value(i));
+    }
   } else {
     for (string_hash_entry *it = other.p->begin(); it != other.p->end(); it = other.p->next(it)) {
       if (other.p->is_string_hash_entry(it)) {
@@ -1753,10 +1997,15 @@ T &array<T>::emplace_back(Args &&... args) noexcept {
   if (is_vector()) {
     mutate_if_vector_needed_int();
     return p->emplace_back_vector_value(std::forward<Args>(args)...);
+  }
+  if (p->is_vector_with_holes()) {
+    if (T *value = emplace_vector_with_holes_value(get_next_key())) {
+      return *value = T(std::forward<Args>(args)...);
+    }
   } else {
     mutate_if_map_needed_int();
-    return p->emplace_int_key_map_value(overwrite_element::YES, get_next_key(), std::forward<Args>(args)...);
   }
+  return p->emplace_int_key_map_value(overwrite_element::YES, get_next_key(), std::forward<Args>(args)...);
 }
 
 template<class T>
@@ -1784,7 +2033,7 @@ std::enable_if_t<recursive == merge_recursive::YES> array<T>::start_merge_recurs
 template<class T>
 template<merge_recursive recursive, class T1>
 void array<T>::push_back_iterator(const array_iterator<T1> &it) noexcept {
-  if (it.self_->is_vector()) {
+  if (it.self_->has_vector_layout()) {
     emplace_back(*reinterpret_cast<const T1 *>(it.entry_));
   } else {
     auto *entry = reinterpret_cast<typename array_iterator<T1>::string_hash_type *>(it.entry_);
@@ -1801,13 +2050,7 @@ void array<T>::push_back_iterator(const array_iterator<T1> &it) noexcept {
 
       start_merge_recursive<recursive>(value_ref, inserted, entry->value);
     } else {
-      if (is_vector()) {
-        mutate_if_vector_needed_int();
-        p->push_back_vector_value(entry->value);
-      } else {
-        mutate_if_map_needed_int();
-        p->set_map_value(overwrite_element::YES, get_next_key(), entry->value);
-      }
+      emplace_back(entry->value);
     }
   }
 }
@@ -1893,7 +2136,15 @@ void array<T>::sort(const T1 &compare, bool renumber) {
       return;
     }
 
-    if (!is_vector()) {
+    if (p->is_vector_with_holes()) {
+      array_inner *res = array_inner::create(n, 0, true);
+      for (int64_t it = p->next_vector_with_holes_key(-1); it <= p->max_key; it = p->next_vector_with_holes_key(it)) {
+        res->push_back_vector_value(p->get_vector_value(it));
+      }
+
+      p->dispose();
+      p = res;
+    } else if (!is_vector()) {
       array_inner *res = array_inner::create(n, 0, true);
       for (string_hash_entry *it = p->begin(); it != p->end(); it = p->next(it)) {
         res->push_back_vector_value(it->value);
@@ -1918,7 +2169,7 @@ void array<T>::sort(const T1 &compare, bool renumber) {
     return;
   }
 
-  if (is_vector()) {
+  if (p->has_vector_layout()) {
     convert_to_map();
   } else {
     mutate_if_map_shared();
@@ -1958,7 +2209,7 @@ void array<T>::ksort(const T1 &compare) {
     return;
   }
 
-  if (is_vector()) {
+  if (p->has_vector_layout()) {
     convert_to_map();
   } else {
     mutate_if_map_shared();
@@ -2029,6 +2280,10 @@ T array<T>::pop() {
     return p->unset_vector_value();
   }
 
+  if (p->is_vector_with_holes()) {
+    return unset(p->prev_vector_with_holes_key(p->max_key + 1));
+  }
+
   mutate_if_map_shared();
   string_hash_entry *it = p->prev(p->end());
 
@@ -2059,6 +2314,19 @@ T array<T>::shift() {
     memmove((void *)it, it + 1, --p->int_size * sizeof(T));
     p->max_key--;
 
+    return res;
+  } else if (p->is_vector_with_holes()) {
+    array_inner *new_array = array_inner::create(p->int_size - 1, 0, true);
+    int64_t it = p->next_vector_with_holes_key(-1);
+    T res = p->get_vector_value(it);
+
+    for (it = p->next_vector_with_holes_key(it); it <= p->max_key; it = p->next_vector_with_holes_key(it)) {
+      new_array->push_back_vector_value(p->get_vector_value(it));
+    }
+
+    p->dispose();
+    p = new_array;
+
     return res;
   } else {
     array_size new_size = size().cut(count() - 1);
@@ -2099,6 +2367,16 @@ int64_t array<T>::unshift(const T &val) {
     memmove((void *)(it + 1), it, p->int_size++ * sizeof(T));
     p->max_key++;
     new(it) T(val);
+  } else if (p->is_vector_with_holes()) {
+    array_inner *new_array = array_inner::create(p->int_size + 1, 0, true);
+    new_array->push_back_vector_value(val);
+
+    for (int64_t it = p->next_vector_with_holes_key(-1); it <= p->max_key; it = p->next_vector_with_holes_key(it)) {
+      new_array->push_back_vector_value(p->get_vector_value(it));
+    }
+
+    p->dispose();
+    p = new_array;
   } else {
     array_size new_size = size();
     bool is_v = (new_size.string_size == 0);
@@ -2183,6 +2461,9 @@ typename array<T>::iterator array<T>::begin_no_mutate() {
   if (is_vector()) {
     return typename array<T>::iterator(p, p->int_entries);
   }
+  if (p->is_vector_with_holes()) {
+    return typename array<T>::iterator(p, reinterpret_cast<list_hash_entry *>(&p->get_vector_value(p->next_vector_with_holes_key(-1))));
+  }
   return typename array<T>::iterator(p, p->begin());
 }
 
@@ -2195,6 +2476,8 @@ template<class T>
 void array<T>::mutate_if_shared() noexcept {
   if (is_vector()) {
     mutate_if_vector_shared();
+  } else if (p->is_vector_with_holes()) {
+    mutate_if_vector_with_holes_shared();
   } else {
     mutate_if_map_shared();
   }
@@ -2212,6 +2495,39 @@ T *array<T>::get_vector_pointer() {
   return &(p->get_vector_value(0));
 }
 
+template<class T>
+template<class F>
+void array<T>::for_each_vector_run(const F &f) const noexcept {
+  const T *values = reinterpret_cast<const T *>(p->int_entries);
+  if (is_vector()) {
+    if (p->int_size) {
+      f(int64_t{0}, values, size_t{p->int_size});
+    }
+    return;
+  }
+
+  php_assert (p->is_vector_with_holes());
+  const uint64_t *bits = p->get_presence_bits();
+  const int64_t end_key = p->max_key + 1;
+  for (int64_t key = p->next_vector_with_holes_key(-1); key < end_key;) {
+    // the run lasts until the first absent key
+    int64_t run_end = key + 1;
+    while (run_end < end_key) {
+      const uint64_t absent = ~bits[run_end >> 6] & (~uint64_t{0} << (run_end & 63));
+      if (absent) {
+        run_end = std::min((run_end & ~int64_t{63}) + __builtin_ctzll(absent), end_key);
+        break;
+      }
+      run_end = (run_end | 63) + 1;
+    }
+    run_end = std::min(run_end, end_key);
+    if (!f(key, values + key, static_cast<size_t>(run_end - key))) {
+      return;
+    }
+    key = p->next_vector_with_holes_key(run_end);
+  }
+}
+
 template<class T>
 bool array<T>::is_equal_inner_pointer(const array &other) const noexcept {
   return p == other.p;
@@ -108,14 +108,23 @@ private:
     //if key is string, int_key contains hash of this string, string_key contains this string.
     //empty hash_entry identified by (next == EMPTY_POINTER)
     //vector is_identified by string_buf_size == -1
+    //vector with holes is identified by string_buf_size == -2:
+    //  the values are stored at their int keys as in vector, the presence bits of the keys are stored after the values,
+    //  the holes are filled with T{}, the keys are ascending in the insertion order, so it iterates as a map with the same keys
 
     static constexpr uint32_t MAX_HASHTABLE_SIZE = (1 << 26);
 
     static constexpr entry_pointer_type EMPTY_POINTER = 0;
 
+    // only the vectors of int and float values can have holes, the other ones are converted to map
+    static constexpr bool CAN_HAVE_HOLES = std::is_same<T, int64_t>{} || std::is_same<T, double>{};
+
     int_hash_entry int_entries[KPHP_ARRAY_TAIL_SIZE];
 
     inline bool is_vector() const __attribute__ ((always_inline));
+    inline bool is_vector_with_holes() const __attribute__ ((always_inline));
+    // vector with or without holes, the values are stored at their int keys
+    inline bool has_vector_layout() const __attribute__ ((always_inline));
 
     inline list_hash_entry *get_entry(entry_pointer_type pointer) const __attribute__ ((always_inline));
     inline entry_pointer_type get_pointer(list_hash_entry *entry) const __attribute__ ((always_inline));
@@ -142,9 +151,13 @@ private:
     inline static uint32_t choose_bucket(int64_t key, uint32_t buf_size, uint64_t modulo_helper) __attribute__ ((always_inline));
 
     inline static size_t sizeof_vector(uint32_t int_size) __attribute__((always_inline));
+    inline static size_t sizeof_vector_with_holes(uint32_t int_size) __attribute__((always_inline));
+    // the vector with holes is kept while at least a quarter of its keys are present
+    inline static bool is_dense_enough(int64_t keys_count, int64_t keys_span) __attribute__((always_inline));
     inline static size_t sizeof_map(uint32_t int_size, uint32_t string_size) __attribute__((always_inline));
     inline static size_t estimate_size(int64_t &new_int_size, int64_t &new_string_size, bool is_vector);
     inline static array_inner *create(int64_t new_int_size, int64_t new_string_size, bool is_vector);
+    inline static array_inner *create_vector_with_holes(uint32_t new_int_size);
 
     inline static array_inner *empty_array() __attribute__ ((always_inline));
 
@@ -187,6 +200,15 @@ private:
 
     inline const T &get_vector_value(int64_t int_key) const;//unsafe
     inline T &get_vector_value(int64_t int_key);//unsafe
+
+    inline const uint64_t *get_presence_bits() const __attribute__ ((always_inline));
+    inline uint64_t *get_presence_bits() __attribute__ ((always_inline));
+    inline bool has_vector_with_holes_value(int64_t int_key) const __attribute__ ((always_inline));
+    inline void set_vector_with_holes_presence(uint32_t begin_key, uint32_t end_key, bool present);
+    // the nearest present keys of vector with holes: next returns max_key + 1 and prev returns -1 if there are no such keys
+    inline int64_t next_vector_with_holes_key(int64_t int_key) const;
+    inline int64_t prev_vector_with_holes_key(int64_t int_key) const;
+    inline T unset_vector_with_holes_value(int64_t int_key);
     inline T unset_map_value(const string &string_key, int64_t precomputed_hash);
 
     bool is_vector_internal_or_last_index(int64_t key) const noexcept;
@@ -209,8 +231,13 @@ private:
   inline void mutate_if_map_needed_int();
   inline void mutate_if_map_needed_string();
   inline void mutate_to_map_if_vector_or_map_need_string();
+  inline void mutate_to_vector_with_holes(int64_t int_size);
+  inline void mutate_if_vector_with_holes_shared();
 
   inline void convert_to_map();
+  // returns the value of the int key out of the vector range, the vector becomes the vector with holes if it's dense enough;
+  // otherwise, it's converted to map and nullptr is returned
+  inline T *emplace_vector_with_holes_value(int64_t int_key) noexcept;
 
   template<class T1>
   inline void copy_from(const array<T1> &other);
@@ -262,6 +289,7 @@ public:
   inline void clear() __attribute__ ((always_inline));
 
   inline bool is_vector() const __attribute__ ((always_inline));
+  inline bool is_vector_with_holes() const __attribute__ ((always_inline));
   inline bool is_pseudo_vector() const __attribute__ ((always_inline));
 
   T &operator[](int64_t int_key);
@@ -316,7 +344,7 @@ public:
   const T *find_value(int32_t key) const noexcept { return find_value(int64_t{key}); }
   const T *find_value(const char *s, string::size_type l) const noexcept;
   const T *find_value(tmp_string s) const noexcept { return find_value(s.data, s.size); }
-  const T *find_value(const string &s) const noexcept { return find_value(s.c_str(), s.size()); }
+  const T *find_value(const string &s) const noexcept;
   const T *find_value(const string &s, int64_t precomputed_hash) const noexcept;
   const T *find_value(const mixed &v) const noexcept;
   const T *find_value(double double_key) const noexcept;
@@ -426,6 +454,11 @@ public:
   const T *get_const_vector_pointer() const; // unsafe
   T *get_vector_pointer(); // unsafe
 
+  // calls f(first_key, values, values_count) for the runs of the consecutive keys of vector (with or without holes)
+  // in the keys order while it returns true
+  template<class F>
+  void for_each_vector_run(const F &f) const noexcept;
+
   bool is_equal_inner_pointer(const array &other) const noexcept;
 
   void reserve(int64_t int_size, int64_t string_size, bool make_vector_if_possible);
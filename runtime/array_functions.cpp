@@ -4,51 +4,22 @@
 
 #include "runtime/array_functions.h"
 
+#include "common/algorithms/simd-string-search.h"
+
 template<class FN>
 void walk_parts(const char *d, int64_t d_len, const string &str, int64_t limit, FN handle_part) {
   const char *s = str.c_str();
   int64_t s_len = str.size();
   int64_t prev = 0;
 
-  if (d_len == 1) {
-    // a faster path for 1-char delimiter (a very frequent case)
-    if (limit > 1) {
-      char delimiter_char = d[0];
-      for (string::size_type i = 0; i < s_len;) {
-        if (delimiter_char == s[i]) {
-          handle_part(s + prev, static_cast<string::size_type>(i - prev));
-          i++;
-          prev = i;
-          limit--;
-          if (limit == 1) {
-            break;
-          }
-        } else {
-          i++;
-        }
-      }
-    }
-    handle_part(s + prev, static_cast<string::size_type>(s_len - prev));
-    return;
-  }
-
-  if (limit > 1) {
-    for (int64_t i = 0; i < s_len;) {
-      int64_t j = 0;
-      for (j = 0; j < d_len && d[j] == s[i + j]; j++) {
-      }
-      if (j == d_len) {
-        handle_part(s + prev, static_cast<string::size_type>(i - prev));
-        i += d_len;
-        prev = i;
-        limit--;
-        if (limit == 1) {
-          break;
-        }
-      } else {
-        i++;
-      }
+  // simd_memmem uses memchr for 1-char delimiters (a very frequent case)
+  for (; limit > 1; limit--) {
+    const char *pos = simd_memmem(s + prev, s_len - prev, d, d_len);
+    if (pos == nullptr) {
+      break;
     }
+    handle_part(s + prev, static_cast<string::size_type>(pos - (s + prev)));
+    prev = pos - s + d_len;
   }
   handle_part(s + prev, static_cast<string::size_type>(s_len - prev));
 }
@@ -7,6 +7,8 @@
 #include <climits>
 #include <numeric>
 
+#include "common/algorithms/radix-sort.h"
+#include "common/algorithms/simd-vector-ops.h"
 #include "common/type_traits/function_traits.h"
 #include "common/vector-product.h"
 
@@ -970,8 +972,35 @@ bool f$array_key_exists(K, const array<T> &) {
   return false;
 }
 
+// the key of the first element of an int or float vector (with or without holes) which is equal to the value of the same type, or -1;
+// == and === are the same for them
+template<class T, class T1>
+int64_t find_in_primitive_vector(const T1 &val, const array<T> &a) noexcept {
+  int64_t key = -1;
+  a.for_each_vector_run([&val, &key](int64_t first_key, const T *values, size_t n) {
+    size_t pos = 0;
+    if constexpr (std::is_same<T, int64_t>{}) {
+      pos = simd_find_int64(values, n, val);
+    } else {
+      pos = simd_find_double(values, n, val);
+    }
+    if (pos != n) {
+      key = first_key + static_cast<int64_t>(pos);
+      return false;
+    }
+    return true;
+  });
+  return key;
+}
+
 template<class T, class T1>
 typename array<T>::key_type f$array_search(const T1 &val, const array<T> &a, bool strict) {
+  if constexpr (vk::is_type_in_list<T, int64_t, double>{} && std::is_same<T, T1>{}) {
+    if (a.is_vector() || a.is_vector_with_holes()) {
+      const int64_t pos = find_in_primitive_vector(val, a);
+      return pos == -1 ? typename array<T>::key_type(false) : typename array<T>::key_type(pos);
+    }
+  }
   for (const auto &it : a) {
     if (strict ? equals(it.get_value(), val) : eq2(it.get_value(), val)) {
       return it.get_key();
@@ -1116,6 +1145,11 @@ array<typename array<T>::key_type> f$array_flip(const array<T> &a) {
 
 template<class T, class T1>
 bool f$in_array(const T1 &value, const array<T> &a, bool strict) {
+  if constexpr (vk::is_type_in_list<T, int64_t, double>{} && std::is_same<T, T1>{}) {
+    if (a.is_vector() || a.is_vector_with_holes()) {
+      return find_in_primitive_vector(value, a) != -1;
+    }
+  }
   if (!strict) {
     for (const auto &it : a) {
       if (eq2(it.get_value(), value)) {
@@ -1362,8 +1396,55 @@ struct sort_compare_natural {
   }
 };
 
+// long vectors of numbers and of strings compared as strings are sorted by radix sort,
+// the elements equal for these comparisons are indistinguishable, so the result is the same as with sort_compare
+template<class T>
+bool radix_sort_vector(array<T> &a, int64_t flag, bool reverse) {
+  constexpr int64_t RADIX_SORT_MIN_SIZE = 256;
+  constexpr bool is_number = vk::is_type_in_list<T, int64_t, double>{};
+  if constexpr (is_number || std::is_same<T, string>{}) {
+    if (is_number ? !vk::any_of_equal(flag, SORT_REGULAR, SORT_NUMERIC) : flag != SORT_STRING) {
+      return false;
+    }
+    const int64_t n = a.count();
+    if (n < RADIX_SORT_MIN_SIZE || !a.is_vector()) {
+      return false;
+    }
+    if constexpr (std::is_same<T, double>{}) {
+      const double *values = a.get_const_vector_pointer();
+      if (std::any_of(values, values + n, [](double value) { return std::isnan(value); })) {
+        return false;
+      }
+    }
+
+    a.mutate_if_shared();
+    T *values = a.get_vector_pointer();
+    if constexpr (is_number) {
+      T *buffer = static_cast<T *>(dl::allocate(n * sizeof(T)));
+      vk::radix_sort(values, n, buffer, [](T value) { return vk::radix_sort_key(value); });
+      dl::deallocate(buffer, n * sizeof(T));
+    } else {
+      auto *buffer = static_cast<vk::StringRadixSortRecord *>(dl::allocate(2 * n * sizeof(vk::StringRadixSortRecord)));
+      vk::string_radix_sort(values, n, buffer, [](const string &s) { return std::string_view{s.c_str(), s.size()}; });
+      dl::deallocate(buffer, 2 * n * sizeof(vk::StringRadixSortRecord));
+    }
+    if (reverse) {
+      std::reverse(values, values + n);
+    }
+    return true;
+  } else {
+    static_cast<void>(a);
+    static_cast<void>(flag);
+    static_cast<void>(reverse);
+    return false;
+  }
+}
+
 template<class T>
 void f$sort(array<T> &a, int64_t flag) {
+  if (radix_sort_vector(a, flag, false)) {
+    return;
+  }
   switch (flag) {
     case SORT_REGULAR:
       return a.sort(sort_compare<T>(), true);
@@ -1406,6 +1487,9 @@ struct rsort_compare_string {
 
 template<class T>
 void f$rsort(array<T> &a, int64_t flag) {
+  if (radix_sort_vector(a, flag, true)) {
+    return;
+  }
   switch (flag) {
     case SORT_REGULAR:
       return a.sort(rsort_compare<T>(), true);
@@ -1501,6 +1585,17 @@ template<class T, class ReturnT>
 ReturnT f$array_sum(const array<T> &a) {
   static_assert(!std::is_same_v<T, int>, "int is forbidden");
 
+  if constexpr (std::is_same_v<T, int64_t> && std::is_same_v<ReturnT, int64_t>) {
+    if (a.is_vector() || a.is_vector_with_holes()) {
+      int64_t result = 0;
+      a.for_each_vector_run([&result](int64_t, const int64_t *values, size_t n) {
+        result = static_cast<int64_t>(static_cast<uint64_t>(result) + static_cast<uint64_t>(simd_sum_int64(values, n)));
+        return true;
+      });
+      return result;
+    }
+  }
+
   ReturnT result = 0;
   for (const auto &it : a) {
     if constexpr (std::is_same_v<T, int64_t>) {
@@ -1594,21 +1689,41 @@ T vk_dot_product_dense(const array<T> &a, const array<T> &b) {
   return result;
 }
 
+inline int64_t vk_dot_product_values(const int64_t *ap, const int64_t *bp, int64_t size) {
+  return std::inner_product(ap, ap + size, bp, 0L);
+}
+
+inline double vk_dot_product_values(const double *ap, const double *bp, int64_t size) {
+  return __dot_product(ap, bp, static_cast<int>(size));
+}
+
 template<>
 inline int64_t vk_dot_product_dense<int64_t>(const array<int64_t> &a, const array<int64_t> &b) {
   const int64_t size = min(a.count(), b.count());
-  const int64_t *ap = a.get_const_vector_pointer();
-  const int64_t *bp = b.get_const_vector_pointer();
-  return std::inner_product(ap, ap + size, bp, 0L);
+  return vk_dot_product_values(a.get_const_vector_pointer(), b.get_const_vector_pointer(), size);
 }
 
 
 template<>
 inline double vk_dot_product_dense<double>(const array<double> &a, const array<double> &b) {
   int64_t size = min(a.count(), b.count());
-  const double *ap = a.get_const_vector_pointer();
-  const double *bp = b.get_const_vector_pointer();
-  return __dot_product(ap, bp, static_cast<int>(size));
+  return vk_dot_product_values(a.get_const_vector_pointer(), b.get_const_vector_pointer(), size);
+}
+
+// a is a vector with holes and b is a vector, the runs of the consecutive keys of a are multiplied as the dense vectors
+template<class T>
+T vk_dot_product_with_holes(const array<T> &a, const array<T> &b) {
+  const T *bp = b.get_const_vector_pointer();
+  const int64_t b_size = b.count();
+  T result = T();
+  a.for_each_vector_run([bp, b_size, &result](int64_t first_key, const T *values, size_t n) {
+    if (first_key >= b_size) {
+      return false;
+    }
+    result += vk_dot_product_values(values, bp + first_key, min(static_cast<int64_t>(n), b_size - first_key));
+    return true;
+  });
+  return result;
 }
 
 
@@ -1617,5 +1732,13 @@ T f$vk_dot_product(const array<T> &a, const array<T> &b) {
   if (a.is_vector() && b.is_vector()) {
     return vk_dot_product_dense<T>(a, b);
   }
+  if constexpr (vk::is_type_in_list<T, int64_t, double>{}) {
+    if (a.is_vector_with_holes() && b.is_vector()) {
+      return vk_dot_product_with_holes<T>(a, b);
+    }
+    if (a.is_vector() && b.is_vector_with_holes()) {
+      return vk_dot_product_with_holes<T>(b, a);
+    }
+  }
   return vk_dot_product_sparse<T>(a, b);
 }
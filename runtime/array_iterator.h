@@ -41,16 +41,16 @@ public:
   }
 
   inline value_type &get_value() noexcept __attribute__ ((always_inline)) {
-    return self_->is_vector() ? *reinterpret_cast<value_type *>(entry_) : static_cast<int_hash_type *>(entry_)->value;
+    return self_->has_vector_layout() ? *reinterpret_cast<value_type *>(entry_) : static_cast<int_hash_type *>(entry_)->value;
   }
 
   inline const value_type &get_value() const noexcept __attribute__ ((always_inline)) {
-    return self_->is_vector() ? *reinterpret_cast<value_type *>(entry_) : static_cast<int_hash_type *>(entry_)->value;
+    return self_->has_vector_layout() ? *reinterpret_cast<value_type *>(entry_) : static_cast<int_hash_type *>(entry_)->value;
   }
 
   inline key_type get_key() const noexcept __attribute__ ((always_inline)) {
-    if (self_->is_vector()) {
-      return key_type{static_cast<int64_t>(reinterpret_cast<value_type *>(entry_) - reinterpret_cast<value_type *>(self_->int_entries))};
+    if (self_->has_vector_layout()) {
+      return key_type{get_vector_key()};
     }
 
     if (is_string_key()) {
@@ -69,7 +69,7 @@ public:
   }
 
   inline bool is_string_key() const noexcept __attribute__ ((always_inline)) ubsan_supp("alignment") {
-    return !self_->is_vector() && self_->is_string_hash_entry(static_cast<const string_hash_type *>(entry_));
+    return !self_->has_vector_layout() && self_->is_string_hash_entry(static_cast<const string_hash_type *>(entry_));
   }
 
   inline const_conditional_t<string> &get_string_key() noexcept __attribute__ ((always_inline)) {
@@ -81,16 +81,24 @@ public:
   }
 
   inline array_iterator &operator++() noexcept __attribute__ ((always_inline)) ubsan_supp("alignment") {
-    entry_ = self_->is_vector()
-             ? reinterpret_cast<list_hash_type *>(reinterpret_cast<value_type *>(entry_) + 1)
-             : self_->next(static_cast<string_hash_type *>(entry_));
+    if (self_->is_vector()) {
+      entry_ = reinterpret_cast<list_hash_type *>(reinterpret_cast<value_type *>(entry_) + 1);
+    } else if (self_->is_vector_with_holes()) {
+      entry_ = get_vector_entry(self_, self_->next_vector_with_holes_key(get_vector_key()));
+    } else {
+      entry_ = self_->next(static_cast<string_hash_type *>(entry_));
+    }
     return *this;
   }
 
   inline array_iterator &operator--() noexcept __attribute__ ((always_inline)) ubsan_supp("alignment") {
-    entry_ = self_->is_vector()
-             ? reinterpret_cast<list_hash_type *>(reinterpret_cast<value_type *>(entry_) - 1)
-             : self_->prev(static_cast<string_hash_type *>(entry_));
+    if (self_->is_vector()) {
+      entry_ = reinterpret_cast<list_hash_type *>(reinterpret_cast<value_type *>(entry_) - 1);
+    } else if (self_->is_vector_with_holes()) {
+      entry_ = get_vector_entry(self_, self_->prev_vector_with_holes_key(get_vector_key()));
+    } else {
+      entry_ = self_->prev(static_cast<string_hash_type *>(entry_));
+    }
     return *this;
   }
 
@@ -112,6 +120,9 @@ public:
 
   static inline array_iterator make_begin(std::add_const_t<array_type> &arr) noexcept __attribute__ ((always_inline)) {
     static_assert(std::is_const<T>{}, "expected to be const");
+    if (arr.p->is_vector_with_holes()) {
+      return make_vector_with_holes_begin(arr);
+    }
     return arr.is_vector()
            ? array_iterator{arr.p, arr.p->int_entries}
            : array_iterator{arr.p, arr.p->begin()};
@@ -124,11 +135,19 @@ public:
       return array_iterator{arr.p, arr.p->int_entries};
     }
 
+    if (arr.p->is_vector_with_holes()) {
+      arr.mutate_if_vector_with_holes_shared();
+      return make_vector_with_holes_begin(arr);
+    }
+
     arr.mutate_if_map_shared();
     return array_iterator{arr.p, arr.p->begin()};
   }
 
   static inline array_iterator make_end(array_type &arr) noexcept __attribute__ ((always_inline)) {
+    if (arr.p->is_vector_with_holes()) {
+      return array_iterator{arr.p, get_vector_entry(arr.p, arr.p->max_key + 1)};
+    }
     return arr.is_vector()
            ? array_iterator{arr.p, reinterpret_cast<list_hash_type *>(reinterpret_cast<value_type *>(arr.p->int_entries) + arr.p->int_size)}
            : array_iterator{arr.p, arr.p->end()};
@@ -151,6 +170,21 @@ public:
       return array_iterator{arr.p, reinterpret_cast<list_hash_type *>(reinterpret_cast<value_type *>(arr.p->int_entries) + n)};
     }
 
+    if (arr.p->is_vector_with_holes()) {
+      if (n < 0) {
+        n += l;
+      }
+      if (n < 0 || n >= l) {
+        return make_end(arr);
+      }
+      array_iterator result = make_vector_with_holes_begin(arr);
+      while (n > 0) {
+        n--;
+        ++result;
+      }
+      return result;
+    }
+
     if (n < -l / 2) {
       n += l;
       if (n < 0) {
@@ -183,6 +217,18 @@ public:
   }
 
 private:
+  inline int64_t get_vector_key() const noexcept __attribute__ ((always_inline)) {
+    return static_cast<int64_t>(reinterpret_cast<value_type *>(entry_) - reinterpret_cast<value_type *>(self_->int_entries));
+  }
+
+  static inline list_hash_type *get_vector_entry(inner_type *self, int64_t key) noexcept __attribute__ ((always_inline)) {
+    return reinterpret_cast<list_hash_type *>(reinterpret_cast<value_type *>(self->int_entries) + key);
+  }
+
+  static inline array_iterator make_vector_with_holes_begin(array_type &arr) noexcept __attribute__ ((always_inline)) {
+    return array_iterator{arr.p, get_vector_entry(arr.p, arr.p->next_vector_with_holes_key(-1))};
+  }
+
   inner_type *self_{nullptr};
   list_hash_type *entry_{nullptr};
 };
@@ -7,6 +7,7 @@
 #include <string_view>
 
 #include "runtime/kphp_core.h"
+#include "runtime/json-document.h"
 #include "runtime/json-functions.h"
 #include "runtime/json-processor-utils.h"
 
@@ -194,16 +195,177 @@ void FromJsonVisitor<Tag>::do_set(class_instance<I> &klass, const mixed &json) n
   klass = from_json_impl<I, Tag>(json, json_path_);
 }
 
-template<class ClassName, class Tag>
-ClassName f$JsonEncoder$$from_json_impl(Tag /*tag*/, const string &json_string, const string &/*class_mame*/) noexcept {
-  JsonEncoderError::msg = {};
+// decodes values directly from the indexed json string, without building mixed for the whole json;
+// the rare cases (arrays from json objects, mixed fields, type mismatches) are delegated to FromJsonVisitor over the decoded value
+template<class Tag>
+class FromJsonDocumentVisitor {
+public:
+  FromJsonDocumentVisitor(const JsonDocument &document, JsonDocument::token_t json, bool flatten_class, JsonPath &json_path) noexcept
+    : document_(document)
+    , json_(json)
+    , flatten_class_(flatten_class)
+    , json_path_(json_path) {}
 
-  auto [json, success] = json_decode(json_string, FromJsonVisitor<Tag>::get_json_obj_magic_key());
+  template<class T>
+  void operator()(const char *key, T &value, bool required = false) noexcept {
+    if (!error_.empty()) {
+      return;
+    }
+    if (flatten_class_) {
+      do_set(value, json_);
+      return;
+    }
+    json_path_.enter(key);
+    const auto json_value = document_.find_member(json_, key, strlen(key));
+    if (required && !json_value) {
+      error_.append("absent required field ");
+      error_.append(json_path_.to_string());
+    }
+    if (json_value) {
+      do_set(value, json_value);
+    }
+    json_path_.leave();
+  }
 
-  if (!success) {
-    JsonEncoderError::msg.append(json_string.empty() ? "provided empty json string" : "failed to parse json string");
-    return {};
+  bool has_error() const noexcept { return !error_.empty(); }
+  const string &get_error() const noexcept { return error_; }
+
+private:
+  using token_t = JsonDocument::token_t;
+
+  template<class T>
+  [[gnu::noinline]] void do_set_from_mixed(T &value, token_t json_value) noexcept {
+    mixed json;
+    document_.decode(json_value, json, FromJsonVisitor<Tag>::get_json_obj_magic_key());
+    FromJsonVisitor<Tag> visitor{json, true, json_path_};
+    visitor(nullptr, value);
+    if (visitor.has_error()) {
+      error_ = visitor.get_error();
+    }
+  }
+
+  void do_set(bool &value, token_t json) noexcept {
+    switch (document_.token_char(json)) {
+      case 't':
+        value = true;
+        break;
+      case 'f':
+        value = false;
+        break;
+      default:
+        do_set_from_mixed(value, json);
+    }
+  }
+
+  void do_set(std::int64_t &value, token_t json) noexcept {
+    if (!document_.get_int(json, value)) {
+      do_set_from_mixed(value, json);
+    }
+  }
+
+  void do_set(double &value, token_t json) noexcept {
+    if (!document_.get_double(json, value)) {
+      do_set_from_mixed(value, json);
+    }
+  }
+
+  void do_set(string &value, token_t json) noexcept {
+    if (!document_.get_string(json, value)) {
+      do_set_from_mixed(value, json);
+    }
   }
+
+  template<class T>
+  void do_set(Optional<T> &value, token_t json) noexcept {
+    if (document_.token_char(json) == 'n') {
+      value = Optional<bool>{};
+      return;
+    }
+    do_set(value.ref(), json);
+  }
+
+  template<class I>
+  void do_set(class_instance<I> &klass, token_t json) noexcept;
+
+  template<class T>
+  void do_set(array<T> &array, token_t json) noexcept {
+    if (document_.token_char(json) != '[') {
+      do_set_from_mixed(array, json);
+      return;
+    }
+
+    int64_t size = 0;
+    for (token_t element = json + 1; document_.token_char(element) != ']'; ++size) {
+      element = document_.skip(element);
+      element += document_.token_char(element) == ',';
+    }
+    // overwrite (but not just merge) array data
+    array.clear();
+    array.reserve(size, 0, true);
+
+    json_path_.enter(nullptr);
+    int64_t index = 0;
+    for (token_t element = json + 1; document_.token_char(element) != ']'; ++index) {
+      do_set(array[index], element);
+      element = document_.skip(element);
+      element += document_.token_char(element) == ',';
+    }
+    json_path_.leave();
+  }
+
+  // just don't fail compilation with empty untyped arrays
+  void do_set(array<Unknown> &/*array*/, token_t /*json*/) noexcept {}
+
+  // mixed, JsonRawString
+  template<class T>
+  void do_set(T &value, token_t json) noexcept {
+    do_set_from_mixed(value, json);
+  }
+
+  string error_;
+  const JsonDocument &document_;
+  token_t json_;
+  bool flatten_class_{false};
+  JsonPath &json_path_;
+};
+
+template<class I, class Tag>
+class_instance<I> from_json_document_impl(const JsonDocument &document, JsonDocument::token_t json, JsonPath &json_path) noexcept {
+  class_instance<I> instance;
+  if constexpr (std::is_empty_v<I>) {
+    instance.empty_alloc();
+  } else {
+    instance.alloc();
+    FromJsonDocumentVisitor<Tag> visitor{document, json, impl_::IsJsonFlattenClass<I>::value, json_path};
+    instance.get()->accept(visitor);
+    if (visitor.has_error()) {
+      JsonEncoderError::msg.append(visitor.get_error());
+      return {};
+    }
+  }
+  if constexpr (impl_::HasClassWakeupMethod<I>::value) {
+    instance.get()->wakeup(instance);
+  }
+  return JsonEncoderError::msg.empty() ? instance : class_instance<I>{};
+}
+
+template<class Tag>
+template<class I>
+void FromJsonDocumentVisitor<Tag>::do_set(class_instance<I> &klass, token_t json) noexcept {
+  if constexpr (!impl_::IsJsonFlattenClass<I>::value) {
+    if (document_.token_char(json) == 'n') {
+      return;
+    }
+    if (!document_.is_map_object(json)) {
+      do_set_from_mixed(klass, json);
+      return;
+    }
+  }
+  klass = from_json_document_impl<I, Tag>(document_, json, json_path_);
+}
+
+template<class ClassName, class Tag>
+ClassName from_json_mixed_impl(const mixed &json) noexcept {
   if constexpr (!impl_::IsJsonFlattenClass<typename ClassName::ClassType>::value) {
     if (!json.is_array() || json.as_array().is_vector()) {
       JsonEncoderError::msg.append("root element of json string must be an object type, got ");
@@ -216,4 +378,27 @@ ClassName f$JsonEncoder$$from_json_impl(Tag /*tag*/, const string &json_string,
   return from_json_impl<typename ClassName::ClassType, Tag>(json, json_path);
 }
 
+template<class ClassName, class Tag>
+ClassName f$JsonEncoder$$from_json_impl(Tag /*tag*/, const string &json_string, const string &/*class_mame*/) noexcept {
+  ScriptPhaseGuard phase_guard{ScriptPhase::json};
+  JsonEncoderError::msg = {};
+
+  JsonDocument document{json_string};
+  if (!document.validate()) {
+    JsonEncoderError::msg.append(json_string.empty() ? "provided empty json string" : "failed to parse json string");
+    return {};
+  }
+  if constexpr (!impl_::IsJsonFlattenClass<typename ClassName::ClassType>::value) {
+    if (!document.is_map_object(0)) {
+      mixed json;
+      JsonDocument::token_t token = 0;
+      document.decode(token, json, FromJsonVisitor<Tag>::get_json_obj_magic_key());
+      return from_json_mixed_impl<ClassName, Tag>(json);
+    }
+  }
+
+  JsonPath json_path;
+  return from_json_document_impl<typename ClassName::ClassType, Tag>(document, 0, json_path);
+}
+
 string f$JsonEncoder$$getLastError() noexcept;
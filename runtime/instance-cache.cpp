@@ -4,11 +4,18 @@
 
 #include "runtime/instance-cache.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
+#include <fcntl.h>
 #include <forward_list>
 #include <map>
 #include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <unordered_set>
+#include <vector>
 
 #include "common/kprintf.h"
 #include "common/wrappers/memory-utils.h"
@@ -49,6 +56,27 @@ static constexpr size_t DATA_SHARDS_COUNT{997u};
 // The buckets check step during the cache cleanup
 static constexpr size_t SHARDS_PURGE_PERIOD{5u};
 
+// The snapshot file: SnapshotHeader, then SnapshotHeader::elements records of
+// SnapshotRecordHeader, the key, the class name and the msgpack packed instance
+static constexpr uint64_t SNAPSHOT_MAGIC{0x31534349'5048504bULL};
+
+struct SnapshotHeader {
+  uint64_t magic{SNAPSHOT_MAGIC};
+  uint64_t elements{0};
+  // the system clock time of the snapshot writing end
+  int64_t written_at_ns{0};
+  int64_t snapshot_time_ns{0};
+};
+
+struct SnapshotRecordHeader {
+  // unix time in seconds, 0 if the element is immortal
+  int64_t expiring_at{0};
+  uint32_t fetches{0};
+  uint32_t key_size{0};
+  uint32_t class_name_size{0};
+  uint32_t packed_size{0};
+};
+
 class ElementHolder;
 
 struct CacheContext : private vk::not_copyable {
@@ -117,6 +145,8 @@ public:
   std::chrono::nanoseconds stored_at{std::chrono::nanoseconds::min()};
   std::chrono::nanoseconds expiring_at{std::chrono::nanoseconds::max()};
   bool early_fetch_performed{false};
+  // it's used to put the hottest elements first into the snapshot
+  std::atomic<uint32_t> fetches{0};
   const pid_t inserted_by_process{0};
 
   std::unique_ptr<InstanceCopyistBase> instance_wrapper;
@@ -378,6 +408,7 @@ public:
         }
       } else {
         context_->stats.elements_fetched.fetch_add(1, std::memory_order_relaxed);
+        it->second->fetches.fetch_add(1, std::memory_order_relaxed);
         ic_debug("fetch '%s' from inter process cache\n", key.c_str());
       }
 
@@ -524,14 +555,157 @@ public:
     return last_memory_stats_;
   }
 
+  // this function should be called only from master
+  bool write_snapshot(const char *path, InstanceCacheSnapshotStats &stats) noexcept {
+    const auto started_at = std::chrono::steady_clock::now();
+    update_now();
+
+    struct Record {
+      SnapshotRecordHeader header;
+      std::string key;
+      std::string class_name;
+      std::string packed;
+    };
+    // the master doesn't replace malloc, so the records are placed in the heap
+    std::vector<Record> records;
+    auto &current_data = data_manager_.get_current_resource();
+    auto *data_shards = current_data.get_data_shards();
+    for (size_t shard_id = 0; shard_id < current_data.get_data_shards_count(); ++shard_id) {
+      auto &data_shard = data_shards[shard_id];
+      if (data_shard.is_storage_empty.load(std::memory_order_relaxed)) {
+        continue;
+      }
+      std::lock_guard<inter_process_mutex> shared_data_lock{data_shard.storage_mutex};
+      for (const auto &stored_element : data_shard.storage) {
+        const ElementHolder &element = *stored_element.second;
+        Record record;
+        if (element.expiring_at <= now_ || !element.instance_wrapper->pack(record.packed)) {
+          continue;
+        }
+        record.key.assign(stored_element.first.c_str(), stored_element.first.size());
+        record.class_name = element.instance_wrapper->get_class();
+        if (element.expiring_at != std::chrono::nanoseconds::max()) {
+          record.header.expiring_at = std::chrono::ceil<std::chrono::seconds>(element.expiring_at).count();
+        }
+        record.header.fetches = element.fetches.load(std::memory_order_relaxed);
+        record.header.key_size = static_cast<uint32_t>(record.key.size());
+        record.header.class_name_size = static_cast<uint32_t>(record.class_name.size());
+        record.header.packed_size = static_cast<uint32_t>(record.packed.size());
+        records.emplace_back(std::move(record));
+      }
+    }
+    std::stable_sort(records.begin(), records.end(), [](const Record &lhs, const Record &rhs) {
+      return lhs.header.fetches > rhs.header.fetches;
+    });
+
+    const std::string tmp_path = std::string{path} + ".tmp";
+    FILE *file = fopen(tmp_path.c_str(), "wb");
+    if (!file) {
+      return false;
+    }
+    SnapshotHeader header;
+    header.elements = records.size();
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (const auto &record : records) {
+      ok = ok && fwrite(&record.header, sizeof(record.header), 1, file) == 1
+           && fwrite(record.key.data(), 1, record.key.size(), file) == record.key.size()
+           && fwrite(record.class_name.data(), 1, record.class_name.size(), file) == record.class_name.size()
+           && fwrite(record.packed.data(), 1, record.packed.size(), file) == record.packed.size();
+    }
+    const long bytes = ftell(file);
+    update_now();
+    header.written_at_ns = now_.count();
+    header.snapshot_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started_at).count();
+    ok = ok && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = (fclose(file) == 0) && ok;
+    if (!ok || rename(tmp_path.c_str(), path) != 0) {
+      unlink(tmp_path.c_str());
+      return false;
+    }
+
+    stats.elements = records.size();
+    stats.bytes = static_cast<uint64_t>(bytes);
+    stats.snapshot_time_sec = std::chrono::duration<double>{std::chrono::nanoseconds{header.snapshot_time_ns}}.count();
+    return true;
+  }
+
+  // this function should be called only from master
+  bool load_snapshot(const char *path, InstanceCacheSnapshotStats &stats) noexcept {
+    const auto started_at = std::chrono::steady_clock::now();
+    update_now();
+
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size < sizeof(SnapshotHeader)) {
+      close(fd);
+      return false;
+    }
+    const size_t size = st.st_size;
+    void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+      return false;
+    }
+    auto unmap = vk::finally([mapped, size] { munmap(mapped, size); });
+
+    const char *pos = static_cast<const char *>(mapped);
+    const char *end = pos + size;
+    SnapshotHeader header;
+    std::memcpy(&header, pos, sizeof(header));
+    pos += sizeof(header);
+    if (header.magic != SNAPSHOT_MAGIC) {
+      return false;
+    }
+
+    auto &current_data = data_manager_.get_current_resource();
+    auto &context = current_data.get_context();
+    // the elements are created in the master process, see purge_expired()
+    dl::MemoryReplacementGuard shared_memory_guard{context.memory_resource, true};
+    InstanceDeepCopyVisitor detach_processor{context.memory_resource, ExtraRefCnt::for_instance_cache};
+    const int64_t now_sec = std::chrono::duration_cast<std::chrono::seconds>(now_).count();
+    stats = InstanceCacheSnapshotStats{};
+    for (uint64_t i = 0; i != header.elements; ++i) {
+      SnapshotRecordHeader record;
+      if (end - pos < sizeof(record)) {
+        break;
+      }
+      std::memcpy(&record, pos, sizeof(record));
+      pos += sizeof(record);
+      const size_t record_size = size_t{record.key_size} + record.class_name_size + record.packed_size;
+      if (end - pos < record_size) {
+        break;
+      }
+      const char *key = pos;
+      pos += record_size;
+      if (record.expiring_at && record.expiring_at <= now_sec) {
+        continue;
+      }
+      if (!insert_packed_element(current_data, detach_processor, record, key, now_sec)) {
+        break;
+      }
+      ++stats.elements;
+    }
+
+    stats.bytes = size;
+    stats.snapshot_time_sec = std::chrono::duration<double>{std::chrono::nanoseconds{header.snapshot_time_ns}}.count();
+    stats.transfer_time_sec = std::max(std::chrono::duration<double>{now_ - std::chrono::nanoseconds{header.written_at_ns}}.count(), 0.0);
+    stats.load_time_sec = std::chrono::duration<double>{std::chrono::steady_clock::now() - started_at}.count();
+    return true;
+  }
+
 private:
   bool is_element_insertion_can_be_skipped(SharedDataStorages &data, const string &key) const {
     std::lock_guard<inter_process_mutex> shared_data_lock{data.storage_mutex};
     auto it = data.storage.find(key);
     // allow to skip the insertion of the element if it was inserted by another process recently enough
+    // the elements loaded from the snapshot are replaced with the unpacked ones
     if (it != data.storage.end() &&
         it->second->freshness_ratio(now_) < FRESHNESS_ELEMENT_RATIO &&
-        it->second->inserted_by_process != getpid()) {
+        it->second->inserted_by_process != getpid() &&
+        !dynamic_cast<const PackedInstanceCopyist *>(it->second->instance_wrapper.get())) {
       ic_debug("skip '%s' because it was recently updated\n", key.c_str());
       context_->stats.elements_storing_skipped_due_recent_update.fetch_add(1, std::memory_order_relaxed);
       return true;
@@ -628,6 +802,44 @@ private:
     return nullptr;
   }
 
+  // returns false if there is not enough memory
+  bool insert_packed_element(SharedMemoryData &current_data, InstanceDeepCopyVisitor &detach_processor,
+                             const SnapshotRecordHeader &record, const char *key_data, int64_t now_sec) noexcept {
+    auto &context = current_data.get_context();
+    const size_t memory_needed = string::estimate_memory_usage(record.key_size) + string::estimate_memory_usage(record.class_name_size) +
+                                 string::estimate_memory_usage(record.packed_size) + sizeof(size_t) + sizeof(PackedInstanceCopyist) +
+                                 sizeof(ElementHolder) + ElementStorage_::allocator_type::max_value_type_size();
+    std::lock_guard<inter_process_mutex> allocator_lock{context.allocator_mutex};
+    if (!detach_processor.is_enough_memory_for(memory_needed)) {
+      return false;
+    }
+
+    const char *class_name_data = key_data + record.key_size;
+    string key{key_data, record.key_size};
+    string class_name{class_name_data, record.class_name_size};
+    string packed{class_name_data + record.class_name_size, record.packed_size};
+    detach_processor.process(key);
+    detach_processor.process(class_name);
+    detach_processor.process(packed);
+    auto instance_wrapper = make_unique_on_script_memory<PackedInstanceCopyist>(std::move(class_name), std::move(packed), record.expiring_at);
+    const int64_t ttl = record.expiring_at ? std::max(record.expiring_at - now_sec, int64_t{1}) : 0;
+    void *mem = detach_processor.prepare_raw_memory(sizeof(ElementHolder));
+    vk::intrusive_ptr<ElementHolder> element{new(mem) ElementHolder{now_, ttl, std::move(instance_wrapper), context}};
+    element->fetches.store(record.fetches, std::memory_order_relaxed);
+
+    auto &data = current_data.get_data(key);
+    std::lock_guard<inter_process_mutex> shared_data_lock{data.storage_mutex};
+    if (data.storage.find(key) != data.storage.end()) {
+      // the workers of the new master have already stored it, the unused element goes to the garbage
+      InstanceDeepDestroyVisitor{ExtraRefCnt::for_instance_cache}.process(key);
+      return true;
+    }
+    data.storage.emplace(std::move(key), std::move(element));
+    data.is_storage_empty.store(false, std::memory_order_relaxed);
+    context.stats.elements_cached.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
   void fire_warning(const InstanceDeepCopyVisitor &detach_processor, const char *class_name) noexcept {
     if (detach_processor.is_memory_limit_exceeded()) {
       php_warning("Memory limit exceeded on saving instance of class '%s' into cache", class_name);
@@ -669,6 +881,26 @@ private:
   size_t purge_shard_offset_{0};
 };
 
+PackedInstanceCopyist::PackedInstanceCopyist(string class_name, string packed, int64_t expiring_at) noexcept:
+  class_name_(std::move(class_name)),
+  packed_(std::move(packed)),
+  expiring_at_(expiring_at) {
+}
+
+bool PackedInstanceCopyist::pack(std::string &out) const noexcept {
+  out.assign(packed_.c_str(), packed_.size());
+  return true;
+}
+
+int64_t PackedInstanceCopyist::get_ttl_left() const noexcept {
+  return expiring_at_ ? std::max(expiring_at_ - static_cast<int64_t>(time(nullptr)), int64_t{1}) : 0;
+}
+
+PackedInstanceCopyist::~PackedInstanceCopyist() noexcept {
+  InstanceDeepDestroyVisitor{ExtraRefCnt::for_instance_cache}.process(class_name_);
+  InstanceDeepDestroyVisitor{ExtraRefCnt::for_instance_cache}.process(packed_);
+}
+
 bool instance_cache_store(const string &key, const InstanceCopyistBase &instance_wrapper, int64_t ttl) {
   return InstanceCache::get().store(key, instance_wrapper, ttl);
 }
@@ -716,6 +948,16 @@ void instance_cache_purge_expired_elements() {
   impl_::InstanceCache::get().purge_expired();
 }
 
+// should be called only from master
+bool instance_cache_write_snapshot(const char *path, InstanceCacheSnapshotStats &stats) noexcept {
+  return impl_::InstanceCache::get().write_snapshot(path, stats);
+}
+
+// should be called only from master
+bool instance_cache_load_snapshot(const char *path, InstanceCacheSnapshotStats &stats) noexcept {
+  return impl_::InstanceCache::get().load_snapshot(path, stats);
+}
+
 void instance_cache_release_all_resources_acquired_by_this_proc() {
   impl_::InstanceCache::get().force_release_all_resources();
 }
@@ -20,13 +20,72 @@
 
 #include "runtime/instance-copy-processor.h"
 #include "runtime/kphp_core.h"
+#include "runtime/msgpack-serialization.h"
 #include "runtime/shape.h"
 
 namespace impl_ {
 
+// An element loaded from the instance cache snapshot (see instance_cache_load_snapshot()):
+// the msgpack packed instance, which is unpacked and stored as a usual element on the first fetch.
+class PackedInstanceCopyist final : public InstanceCopyistBase {
+public:
+  PackedInstanceCopyist(string class_name, string packed, int64_t expiring_at) noexcept;
+
+  const char *get_class() const noexcept final {
+    return class_name_.c_str();
+  }
+
+  std::unique_ptr<InstanceCopyistBase> deep_copy_and_set_ref_cnt(InstanceDeepCopyVisitor &) const noexcept final {
+    return {};
+  }
+
+  std::unique_ptr<InstanceCopyistBase> shallow_copy() const noexcept final {
+    return {};
+  }
+
+  bool pack(std::string &out) const noexcept final;
+
+  const string &get_packed() const noexcept {
+    return packed_;
+  }
+
+  // 0 if the element is immortal
+  int64_t get_ttl_left() const noexcept;
+
+  ~PackedInstanceCopyist() noexcept final;
+
+private:
+  string class_name_;
+  string packed_;
+  // unix time in seconds, 0 if the element is immortal
+  int64_t expiring_at_{0};
+};
+
 bool instance_cache_store(const string &key, const InstanceCopyistBase &instance_wrapper, int64_t ttl);
 const InstanceCopyistBase *instance_cache_fetch_wrapper(const string &key, bool even_if_expired);
 
+template<typename ClassInstanceType>
+ClassInstanceType unpack_instance(const string &class_name, const string &key, const PackedInstanceCopyist &packed_wrapper) noexcept {
+  if constexpr (IsMsgpackSerializable<typename ClassInstanceType::ClassType>{}) {
+    string err_msg;
+    auto result = f$msgpack_deserialize<ClassInstanceType>(packed_wrapper.get_packed(), &err_msg);
+    if (err_msg.empty() && !result.is_null() && !strcmp(result.get_class(), packed_wrapper.get_class())) {
+      InstanceCopyistImpl<ClassInstanceType> instance_wrapper{result};
+      instance_cache_store(key, instance_wrapper, packed_wrapper.get_ttl_left());
+      return result;
+    }
+    if (!err_msg.empty()) {
+      // the snapshot is made by the previous version, the class schema could be changed since then
+      php_warning("Trying to fetch incompatible instance class from the instance cache snapshot: expect '%s', got '%s': %s",
+                  class_name.c_str(), packed_wrapper.get_class(), err_msg.c_str());
+      return {};
+    }
+  }
+  php_warning("Trying to fetch incompatible instance class from the instance cache snapshot: expect '%s', got '%s'",
+              class_name.c_str(), packed_wrapper.get_class());
+  return {};
+}
+
 } // namespace impl_
 
 void global_init_instance_cache_lib();
@@ -68,6 +127,23 @@ const memory_resource::MemoryStats &instance_cache_get_memory_stats();
 // these function should be called from master
 void instance_cache_purge_expired_elements();
 
+struct InstanceCacheSnapshotStats {
+  uint64_t elements{0};
+  uint64_t bytes{0};
+  // the time of the snapshot packing and writing by the old master
+  double snapshot_time_sec{0};
+  // the time between the end of the snapshot writing and the beginning of the snapshot loading
+  double transfer_time_sec{0};
+  double load_time_sec{0};
+};
+
+// The instance cache snapshot is used on the graceful restart: the old master writes the elements of the serializable
+// (@kphp-serializable) classes into a file, the most fetched ones go first, and the new master loads them packed into its instance cache.
+// these function should be called from master
+bool instance_cache_write_snapshot(const char *path, InstanceCacheSnapshotStats &stats) noexcept;
+// these function should be called from master
+bool instance_cache_load_snapshot(const char *path, InstanceCacheSnapshotStats &stats) noexcept;
+
 void instance_cache_release_all_resources_acquired_by_this_proc();
 
 template<typename ClassInstanceType>
@@ -76,6 +152,7 @@ bool f$instance_cache_store(const string &key, const ClassInstanceType &instance
   if (instance.is_null()) {
     return false;
   }
+  ScriptPhaseGuard phase_guard{ScriptPhase::instance_cache};
   InstanceCopyistImpl<ClassInstanceType> instance_wrapper{instance};
   return impl_::instance_cache_store(key, instance_wrapper, ttl);
 }
@@ -83,6 +160,7 @@ bool f$instance_cache_store(const string &key, const ClassInstanceType &instance
 template<typename ClassInstanceType>
 ClassInstanceType f$instance_cache_fetch(const string &class_name, const string &key, bool even_if_expired = false) {
   static_assert(is_class_instance<ClassInstanceType>::value, "class_instance<> type expected");
+  ScriptPhaseGuard phase_guard{ScriptPhase::instance_cache};
   if (const auto *base_wrapper = impl_::instance_cache_fetch_wrapper(key, even_if_expired)) {
     // do not use first parameter (class name) for verifying type,
     // because different classes from separated libs may have same names
@@ -90,6 +168,8 @@ ClassInstanceType f$instance_cache_fetch(const string &class_name, const string
       auto result = wrapper->get_instance();
       php_assert(!result.is_null());
       return result;
+    } else if (auto packed_wrapper = dynamic_cast<const impl_::PackedInstanceCopyist *>(base_wrapper)) {
+      return impl_::unpack_instance<ClassInstanceType>(class_name, key, *packed_wrapper);
     } else {
       php_warning("Trying to fetch incompatible instance class: expect '%s', got '%s'",
                   class_name.c_str(), base_wrapper->get_class());
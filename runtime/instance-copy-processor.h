@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <string>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -14,9 +15,19 @@
 #include "runtime/critical_section.h"
 #include "runtime/kphp_core.h"
 #include "runtime/memory_resource/unsynchronized_pool_resource.h"
+#include "runtime/msgpack/adaptors.h"
+#include "runtime/msgpack/packer.h"
 
 namespace impl_ {
 
+// the classes marked with @kphp-serializable have the generated msgpack_pack() and msgpack_unpack()
+template<typename T, typename = void>
+struct IsMsgpackSerializable : std::false_type {};
+
+template<typename T>
+struct IsMsgpackSerializable<T, std::void_t<decltype(std::declval<const T &>().msgpack_pack(
+  std::declval<vk::msgpack::packer<vk::msgpack::size_counting_stream> &>()))>> : std::true_type {};
+
 template<typename Child>
 class InstanceDeepBasicVisitor : vk::not_copyable {
 public:
@@ -106,6 +117,13 @@ private:
 
 constexpr static uint32_t VISITED_INSTANCE_MASK{0x80000000};
 
+// the compiler marks the classes without instances inside their fields, see ClassDeclaration::compile_accept_visitor_methods()
+template<typename T, typename = std::void_t<>>
+struct HasNoClassInstancesInside : std::false_type {};
+
+template<typename T>
+struct HasNoClassInstancesInside<T, std::enable_if_t<T::has_no_class_instances_inside>> : std::true_type {};
+
 } // namespace impl_
 
 class InstanceReferencesCountingVisitor : impl_::InstanceDeepBasicVisitor<InstanceReferencesCountingVisitor> {
@@ -203,6 +221,10 @@ public:
   template<class I>
   bool process_instance(class_instance<I> &instance) noexcept {
     class_instance<I> instance_copy = instance;
+    if constexpr (impl_::HasNoClassInstancesInside<I>{}) {
+      // there is nothing to share inside, so the copied instances aren't tracked
+      return instance.is_null() || (clone_instance(instance) && Basic::process(instance));
+    }
     const bool result = process(instance);
     copied_instances_table.clear();
     return result;
@@ -222,18 +244,26 @@ private:
       return true;
     }
 
+    if (!clone_instance(instance)) {
+      return false;
+    }
+    copied_instance_ptr = instance.get_base_raw_ptr();
+    return Basic::process(instance);
+  }
+
+  template<class I>
+  bool clone_instance(class_instance<I> &instance) noexcept {
     if (unlikely(!is_enough_memory_for(instance.estimate_memory_usage()))) {
       instance = class_instance<I>{};
       return false;
     }
 
     instance = instance.virtual_builtin_clone();
-    copied_instance_ptr = instance.get_base_raw_ptr();
 
     if (const auto extra_ref_cnt = get_memory_ref_cnt()) {
       instance.set_reference_counter_to(extra_ref_cnt);
     }
-    return Basic::process(instance);
+    return true;
   }
 
   template<class T>
@@ -313,6 +343,15 @@ public:
 
   template<class I>
   bool process_instance(class_instance<I> &instance) noexcept {
+    if constexpr (impl_::HasNoClassInstancesInside<I>{}) {
+      // the instance isn't referenced from its fields, so the references don't need to be counted
+      if (!instance.is_null()) {
+        Basic::process(instance);
+        instance.force_destroy(get_memory_ref_cnt());
+        instance = class_instance<I>{};
+      }
+      return true;
+    }
     InstanceReferencesCountingVisitor{instances_refcnt_table}.process_instance(instance);
     auto res = process(instance);
     instances_refcnt_table.clear();
@@ -348,6 +387,8 @@ public:
   virtual const char *get_class() const noexcept = 0;
   virtual std::unique_ptr<InstanceCopyistBase> deep_copy_and_set_ref_cnt(InstanceDeepCopyVisitor &detach_processor) const noexcept = 0;
   virtual std::unique_ptr<InstanceCopyistBase> shallow_copy() const noexcept = 0;
+  // packs the instance with msgpack into the heap memory, returns false if the class isn't serializable
+  virtual bool pack(std::string &/*out*/) const noexcept { return false; }
   virtual ~InstanceCopyistBase() noexcept = default;
 };
 
@@ -393,6 +434,24 @@ public:
     return instance_;
   }
 
+  bool pack(std::string &out) const noexcept final {
+    if constexpr (impl_::IsMsgpackSerializable<I>{}) {
+      // the instance isn't modified, so it can be packed by any process mapping it, e.g. by master from the instance cache
+      vk::msgpack::packer_float32_decorator::clear();
+      vk::msgpack::CheckInstanceDepth::depth = 0;
+      vk::msgpack::size_counting_stream counter;
+      vk::msgpack::packer{counter}.pack(instance_);
+      if (vk::msgpack::CheckInstanceDepth::is_exceeded()) {
+        return false;
+      }
+      out.resize(counter.size());
+      vk::msgpack::raw_buffer_stream stream{out.data()};
+      vk::msgpack::packer{stream}.pack(instance_);
+      return true;
+    }
+    return false;
+  }
+
   ~InstanceCopyistImpl() noexcept final {
     if (memory_ref_cnt_ && !instance_.is_null()) {
       InstanceDeepDestroyVisitor{static_cast<ExtraRefCnt::extra_ref_cnt_value>(memory_ref_cnt_)}.process_instance(instance_);
@@ -45,6 +45,7 @@
 #include "runtime/regexp.h"
 #include "runtime/resumable.h"
 #include "runtime/rpc.h"
+#include "runtime/script-phases.h"
 #include "runtime/streams.h"
 #include "runtime/string_functions.h"
 #include "runtime/typed_rpc.h"
@@ -2274,6 +2275,7 @@ static void init_interface_lib() {
 }
 
 static void init_runtime_libs() {
+  vk::singleton<ScriptPhasesStats>::get().reset();
   // init_curl_lib() lazy called in runtime
   init_instance_cache_lib();
   init_confdata_functions_lib();
@@ -36,6 +36,25 @@ private:
   int job_id;
 };
 
+class job_response_chunk_resumable : public Resumable {
+public:
+  using ReturnT = class_instance<C$KphpJobWorkerResponse>;
+
+  explicit job_response_chunk_resumable(int64_t job_resumable_id)
+    : job_resumable_id(job_resumable_id) {}
+
+protected:
+  bool run() final {
+    auto &processing_jobs = vk::singleton<job_workers::ProcessingJobs>::get();
+    if (!processing_jobs.is_job_response_chunk_ready(job_resumable_id)) {
+      WAIT;
+    }
+    RETURN(processing_jobs.withdraw_job_response_chunk(job_resumable_id));
+  }
+private:
+  int64_t job_resumable_id;
+};
+
 namespace {
 
 template<typename JobMessageT, typename T>
@@ -58,13 +77,15 @@ JobMessageT *make_job_request_message(const class_instance<T> &instance) {
   return memory_request;
 }
 
-int send_job_request_message(job_workers::JobSharedMessage *job_message, double timeout, job_workers::JobSharedMemoryPiece *common_job = nullptr, bool no_reply = false) {
+int send_job_request_message(job_workers::JobSharedMessage *job_message, double timeout, job_workers::JobSharedMemoryPiece *common_job = nullptr,
+                             bool no_reply = false, bool stream_response = false) {
   auto &client = vk::singleton<job_workers::JobWorkerClient>::get();
 
   const auto now = std::chrono::system_clock::now();
   job_message->job_start_time = std::chrono::duration<double>{now.time_since_epoch()}.count();
   job_message->job_timeout = timeout;
   job_message->no_reply = no_reply;
+  job_message->stream_response = stream_response;
 
   int job_id = 0;
   {
@@ -97,7 +118,10 @@ int send_job_request_message(job_workers::JobSharedMessage *job_message, double
   kphp_event_timer *timer = allocate_event_timer(get_precise_now() + timeout, get_job_timeout_wakeup_id(), job_id);
 
   vk::singleton<job_workers::ProcessingJobs>::get().start_job_processing(job_id, job_workers::JobRequestInfo{job_resumable_id, timer});
-  
+  if (stream_response) {
+    vk::singleton<job_workers::ProcessingJobs>::get().start_job_stream(job_resumable_id);
+  }
+
   return job_resumable_id;
 }
 
@@ -120,7 +144,8 @@ double normalize_job_timeout(double timeout) {
   return timeout;
 }
 
-Optional<int64_t> kphp_job_worker_start_impl(const class_instance<C$KphpJobWorkerRequest> &request, double timeout, bool no_reply) noexcept {
+Optional<int64_t> kphp_job_worker_start_impl(const class_instance<C$KphpJobWorkerRequest> &request, double timeout, bool no_reply,
+                                             bool stream_response = false) noexcept {
   if (!job_workers_api_allowed()) {
     return false;
   }
@@ -135,7 +160,7 @@ Optional<int64_t> kphp_job_worker_start_impl(const class_instance<C$KphpJobWorke
     return false;
   }
 
-  int job_resumable_id = send_job_request_message(memory_request, timeout, nullptr, no_reply);
+  int job_resumable_id = send_job_request_message(memory_request, timeout, nullptr, no_reply, stream_response);
 
   if (job_resumable_id < 0) {
     return false;
@@ -154,6 +179,29 @@ bool f$kphp_job_worker_start_no_reply(const class_instance<C$KphpJobWorkerReques
   return kphp_job_worker_start_impl(request, timeout, true).has_value();
 }
 
+Optional<int64_t> f$kphp_job_worker_start_stream(const class_instance<C$KphpJobWorkerRequest> &request, double timeout) noexcept {
+  return kphp_job_worker_start_impl(request, timeout, false, true);
+}
+
+Optional<int64_t> f$kphp_job_worker_next_response_chunk(int64_t job_resumable_id) noexcept {
+  auto &processing_jobs = vk::singleton<job_workers::ProcessingJobs>::get();
+  if (!processing_jobs.is_job_stream(job_resumable_id)) {
+    // the stream has already ended or the job isn't started by kphp_job_worker_start_stream()
+    return false;
+  }
+
+  const bool ready = processing_jobs.is_job_response_chunk_ready(job_resumable_id);
+  if (!ready && processing_jobs.is_job_response_chunk_awaited(job_resumable_id)) {
+    php_warning("Can't get the next job response chunk: the previous one is still awaited");
+    return false;
+  }
+  const int64_t chunk_resumable_id = fork_resumable(new job_response_chunk_resumable{job_resumable_id});
+  if (!ready) {
+    processing_jobs.wait_job_response_chunk(job_resumable_id, chunk_resumable_id);
+  }
+  return chunk_resumable_id;
+}
+
 array<Optional<int64_t>> f$kphp_job_worker_start_multi(const array<class_instance<C$KphpJobWorkerRequest>> &requests, double timeout) noexcept {
   if (!job_workers_api_allowed()) {
     return {};
@@ -11,4 +11,9 @@ void free_job_client_interface_lib() noexcept;
 
 Optional<int64_t> f$kphp_job_worker_start(const class_instance<C$KphpJobWorkerRequest> &request, double timeout) noexcept;
 bool f$kphp_job_worker_start_no_reply(const class_instance<C$KphpJobWorkerRequest> &request, double timeout) noexcept;
+Optional<int64_t> f$kphp_job_worker_start_stream(const class_instance<C$KphpJobWorkerRequest> &request, double timeout) noexcept;
+Optional<int64_t> f$kphp_job_worker_next_response_chunk(int64_t job_resumable_id) noexcept;
+inline Optional<int64_t> f$kphp_job_worker_next_response_chunk(Optional<int64_t> job_resumable_id) noexcept {
+  return f$kphp_job_worker_next_response_chunk(job_resumable_id.val());
+}
 array<Optional<int64_t>> f$kphp_job_worker_start_multi(const array<class_instance<C$KphpJobWorkerRequest>> &requests, double timeout) noexcept;
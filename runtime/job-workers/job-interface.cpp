@@ -21,6 +21,18 @@ void process_job_timeout(kphp_event_timer *timer) {
   ::process_job_timeout(timer->wakeup_extra);
 }
 
+void run_finished_job(int64_t job_resumable_id) noexcept {
+  if (job_resumable_id == 0) {
+    return;
+  }
+
+  // the awaited chunk of the streaming job gets null as the end of the stream
+  if (int64_t chunk_resumable_id = vk::singleton<job_workers::ProcessingJobs>::get().finish_job_stream(job_resumable_id)) {
+    resumable_run_ready(chunk_resumable_id);
+  }
+  resumable_run_ready(job_resumable_id);
+}
+
 } // namespace
 
 int get_job_timeout_wakeup_id() {
@@ -50,23 +62,21 @@ void clear_shared_job_messages() noexcept {
 }
 
 void process_job_answer(int job_id, job_workers::FinishedJob *job_result) noexcept {
-  int64_t job_resumable_id = vk::singleton<job_workers::ProcessingJobs>::get().finish_job_on_answer(job_id, job_result);
+  run_finished_job(vk::singleton<job_workers::ProcessingJobs>::get().finish_job_on_answer(job_id, job_result));
+}
 
-  if (job_resumable_id == 0) {
+void process_job_response_chunk(int job_id, job_workers::FinishedJob *job_chunk) noexcept {
+  int64_t chunk_resumable_id = vk::singleton<job_workers::ProcessingJobs>::get().add_job_response_chunk(job_id, job_chunk);
+
+  if (chunk_resumable_id == 0) {
     return;
   }
 
-  resumable_run_ready(job_resumable_id);
+  resumable_run_ready(chunk_resumable_id);
 }
 
 void process_job_timeout(int job_id) noexcept {
-  int64_t job_resumable_id = vk::singleton<job_workers::ProcessingJobs>::get().finish_job_on_timeout(job_id);
-
-  if (job_resumable_id == 0) {
-    return;
-  }
-
-  resumable_run_ready(job_resumable_id);
+  run_finished_job(vk::singleton<job_workers::ProcessingJobs>::get().finish_job_on_timeout(job_id));
 }
 
 class_instance<C$KphpJobWorkerResponseError> f$KphpJobWorkerResponseError$$__construct(class_instance<C$KphpJobWorkerResponseError> const &v$this) noexcept {
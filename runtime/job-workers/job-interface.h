@@ -132,5 +132,6 @@ void clear_shared_job_messages() noexcept;
 int get_job_timeout_wakeup_id();
 
 void process_job_answer(int job_id, job_workers::FinishedJob *job_result) noexcept;
+void process_job_response_chunk(int job_id, job_workers::FinishedJob *job_chunk) noexcept;
 
 void process_job_timeout(int job_id) noexcept;
@@ -2,6 +2,8 @@
 // Copyright (c) 2021 LLC «V Kontakte»
 // Distributed under the GPL v3 License, see LICENSE.notice.txt
 
+#include <utility>
+
 #include "runtime/net_events.h"
 #include "runtime/instance-copy-processor.h"
 
@@ -36,6 +38,30 @@ int64_t ProcessingJobs::finish_job_on_timeout(int job_id) noexcept {
   return finish_job_impl(job_id, nullptr, true);
 }
 
+namespace {
+
+class_instance<C$KphpJobWorkerResponse> withdraw_finished_job_response(job_workers::FinishedJob *job_result, bool timeout) noexcept {
+  if (job_result) {
+    class_instance<C$KphpJobWorkerResponse> response = std::move(job_result->response);
+    job_result->~FinishedJob();
+    dl::deallocate(job_result, sizeof(job_workers::FinishedJob));
+    return response;
+  }
+
+  class_instance<C$KphpJobWorkerResponseError> error;
+  error.alloc();
+  if (timeout) {
+    error.get()->error = string{"Job client timeout"};
+    error.get()->error_code = client_timeout_error;
+  } else {
+    error.get()->error = string{"Not enough memory for accepting job response"};
+    error.get()->error_code = client_oom_error;
+  }
+  return error;
+}
+
+} // namespace
+
 int64_t ProcessingJobs::finish_job_impl(int job_id, job_workers::FinishedJob *job_result, bool timeout) noexcept {
   if (!processing_.has_key(job_id)) {
     // possible in case of answer after timeout
@@ -43,23 +69,7 @@ int64_t ProcessingJobs::finish_job_impl(int job_id, job_workers::FinishedJob *jo
   }
 
   auto &ready_job = processing_[job_id];
-
-  if (job_result) {
-    ready_job.response = std::move(job_result->response);
-    job_result->~FinishedJob();
-    dl::deallocate(job_result, sizeof(job_workers::FinishedJob));
-  } else {
-    class_instance<C$KphpJobWorkerResponseError> error;
-    error.alloc();
-    if (timeout) {
-      error.get()->error = string{"Job client timeout"};
-      error.get()->error_code = client_timeout_error;
-    } else {
-      error.get()->error = string{"Not enough memory for accepting job response"};
-      error.get()->error_code = client_oom_error;
-    }
-    ready_job.response = std::move(error);
-  }
+  ready_job.response = withdraw_finished_job_response(job_result, timeout);
 
   if (ready_job.timer) {
     remove_event_timer(ready_job.timer);
@@ -67,6 +77,7 @@ int64_t ProcessingJobs::finish_job_impl(int job_id, job_workers::FinishedJob *jo
 
   return ready_job.resumable_id;
 }
+
 class_instance<C$KphpJobWorkerResponse> ProcessingJobs::withdraw(int job_id) noexcept {
   JobRequestInfo &ready_job = processing_[job_id];
   php_assert(ready_job.resumable_id != 0);
@@ -75,4 +86,68 @@ class_instance<C$KphpJobWorkerResponse> ProcessingJobs::withdraw(int job_id) noe
   return result;
 }
 
+void ProcessingJobs::start_job_stream(int64_t job_resumable_id) noexcept {
+  streams_[job_resumable_id] = JobResponseStream{};
+}
+
+bool ProcessingJobs::is_job_stream(int64_t job_resumable_id) const noexcept {
+  return streams_.has_key(job_resumable_id);
+}
+
+int64_t ProcessingJobs::add_job_response_chunk(int job_id, job_workers::FinishedJob *job_chunk) noexcept {
+  class_instance<C$KphpJobWorkerResponse> chunk = withdraw_finished_job_response(job_chunk, false);
+  if (!processing_.has_key(job_id)) {
+    // possible in case of chunk after timeout
+    return 0;
+  }
+  const int64_t job_resumable_id = processing_[job_id].resumable_id;
+  if (!streams_.has_key(job_resumable_id)) {
+    return 0;
+  }
+
+  auto &stream = streams_[job_resumable_id];
+  stream.chunks.push_back(std::move(chunk));
+  return std::exchange(stream.chunk_resumable_id, 0);
+}
+
+int64_t ProcessingJobs::finish_job_stream(int64_t job_resumable_id) noexcept {
+  if (!streams_.has_key(job_resumable_id)) {
+    return 0;
+  }
+  auto &stream = streams_[job_resumable_id];
+  stream.finished = true;
+  return std::exchange(stream.chunk_resumable_id, 0);
+}
+
+bool ProcessingJobs::is_job_response_chunk_ready(int64_t job_resumable_id) const noexcept {
+  const auto *stream = streams_.find_value(job_resumable_id);
+  return stream && (stream->finished || stream->next_chunk < stream->chunks.count());
+}
+
+bool ProcessingJobs::is_job_response_chunk_awaited(int64_t job_resumable_id) const noexcept {
+  const auto *stream = streams_.find_value(job_resumable_id);
+  return stream && stream->chunk_resumable_id;
+}
+
+void ProcessingJobs::wait_job_response_chunk(int64_t job_resumable_id, int64_t chunk_resumable_id) noexcept {
+  auto &stream = streams_[job_resumable_id];
+  php_assert(!stream.chunk_resumable_id);
+  stream.chunk_resumable_id = chunk_resumable_id;
+}
+
+class_instance<C$KphpJobWorkerResponse> ProcessingJobs::withdraw_job_response_chunk(int64_t job_resumable_id) noexcept {
+  auto &stream = streams_[job_resumable_id];
+  if (stream.next_chunk < stream.chunks.count()) {
+    class_instance<C$KphpJobWorkerResponse> chunk = std::move(stream.chunks[stream.next_chunk++]);
+    if (stream.next_chunk == stream.chunks.count()) {
+      stream.chunks.clear();
+      stream.next_chunk = 0;
+    }
+    return chunk;
+  }
+  php_assert(stream.finished);
+  streams_.unset(job_resumable_id);
+  return {};
+}
+
 } // namespace job_workers
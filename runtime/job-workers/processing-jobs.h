@@ -34,6 +34,15 @@ struct JobRequestInfo {
     , timer(timer) {}
 };
 
+// The response chunks of the streaming job, they outlive the job until they are all withdrawn
+struct JobResponseStream {
+  array<class_instance<C$KphpJobWorkerResponse>> chunks;
+  int64_t next_chunk{0};
+  // the resumable waiting for the next chunk
+  int64_t chunk_resumable_id{0};
+  bool finished{false};
+};
+
 class ProcessingJobs : vk::not_copyable {
 public:
   void start_job_processing(int job_id, JobRequestInfo &&job_request_info) noexcept;
@@ -43,14 +52,29 @@ public:
 
   class_instance<C$KphpJobWorkerResponse> withdraw(int job_id) noexcept;
 
+  // the streams are identified by the job resumable id, as the client script sees it
+  void start_job_stream(int64_t job_resumable_id) noexcept;
+  bool is_job_stream(int64_t job_resumable_id) const noexcept;
+  // returns the resumable id waiting for the chunk or 0
+  int64_t add_job_response_chunk(int job_id, job_workers::FinishedJob *job_chunk) noexcept;
+  // returns the resumable id waiting for the chunk or 0, it gets null as the end of the stream
+  int64_t finish_job_stream(int64_t job_resumable_id) noexcept;
+  bool is_job_response_chunk_ready(int64_t job_resumable_id) const noexcept;
+  bool is_job_response_chunk_awaited(int64_t job_resumable_id) const noexcept;
+  void wait_job_response_chunk(int64_t job_resumable_id, int64_t chunk_resumable_id) noexcept;
+  // the stream is forgotten after null is withdrawn
+  class_instance<C$KphpJobWorkerResponse> withdraw_job_response_chunk(int64_t job_resumable_id) noexcept;
+
   void reset() noexcept {
     hard_reset_var(processing_);
+    hard_reset_var(streams_);
   }
 
 private:
   friend class vk::singleton<ProcessingJobs>;
 
   array<JobRequestInfo> processing_;
+  array<JobResponseStream> streams_;
 
   ProcessingJobs() = default;
 
@@ -42,39 +42,65 @@ class_instance<C$KphpJobWorkerRequest> f$kphp_job_worker_fetch_request() noexcep
   return result;
 }
 
-void f$kphp_job_worker_store_response(const class_instance<C$KphpJobWorkerResponse> &response) noexcept {
+namespace {
+
+bool store_job_response_impl(const class_instance<C$KphpJobWorkerResponse> &response, bool is_chunk) noexcept {
+  const char *what = is_chunk ? "response chunk" : "response";
   if (response.is_null()) {
-    php_warning("Can't store job response: the response shouldn't be null");
-    return;
+    php_warning("Can't store job %s: the response shouldn't be null", what);
+    return false;
   }
   if (!f$is_kphp_job_workers_enabled()) {
-    php_warning("Can't store job response %s: job workers disabled", response.get_class());
-    return;
+    php_warning("Can't store job %s %s: job workers disabled", what, response.get_class());
+    return false;
   }
   if (!current_job.send_reply) {
-    php_warning("Can't store job response %s: this is a not job request", response.get_class());
-    return;
+    php_warning("Can't store job %s %s: this is a not job request", what, response.get_class());
+    return false;
   }
   auto &memory_manager = vk::singleton<job_workers::SharedMemoryManager>::get();
+  if (is_chunk) {
+    if (!current_job.job_request->stream_response) {
+      php_warning("Can't store job response chunk %s: the job isn't started by kphp_job_worker_start_stream()", response.get_class());
+      return false;
+    }
+    if (!memory_manager.can_acquire_message_for_response_chunk()) {
+      // the clients don't keep up with the job workers, the job should retry later or put the rest into the final response
+      ++memory_manager.get_stats().job_response_chunks_throttled;
+      return false;
+    }
+  }
   auto *response_memory = memory_manager.acquire_shared_message<job_workers::JobSharedMessage>();
   if (!response_memory) {
-    php_warning("Can't store job response %s: not enough shared memory", response.get_class());
-    return;
+    php_warning("Can't store job %s %s: not enough shared memory", what, response.get_class());
+    return false;
   }
+  response_memory->is_response_chunk = is_chunk;
   response_memory->instance = copy_instance_into_other_memory(response, response_memory->resource,
                                                               ExtraRefCnt::for_job_worker_communication, job_workers::request_extra_shared_memory);
   if (response_memory->instance.is_null()) {
-    php_warning("Can't store job response %s: too big response", response.get_class());
+    php_warning("Can't store job %s %s: too big response", what, response.get_class());
     memory_manager.release_shared_message(response_memory);
-    return;
+    return false;
   }
 
   dl::CriticalSectionSmartGuard critical_section;
   if (const char *err = current_job.send_reply(response_memory)) {
     memory_manager.release_shared_message(response_memory);
     critical_section.leave_critical_section();
-    php_warning("Can't store job response %s: %s", response.get_class(), err);
-  } else {
-    memory_manager.detach_shared_message_from_this_proc(response_memory);
+    php_warning("Can't store job %s %s: %s", what, response.get_class(), err);
+    return false;
   }
+  memory_manager.detach_shared_message_from_this_proc(response_memory);
+  return true;
+}
+
+} // namespace
+
+void f$kphp_job_worker_store_response(const class_instance<C$KphpJobWorkerResponse> &response) noexcept {
+  store_job_response_impl(response, false);
+}
+
+bool f$kphp_job_worker_store_response_chunk(const class_instance<C$KphpJobWorkerResponse> &chunk) noexcept {
+  return store_job_response_impl(chunk, true);
 }
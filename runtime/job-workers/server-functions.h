@@ -13,3 +13,4 @@ void free_job_server_interface_lib() noexcept;
 
 class_instance<C$KphpJobWorkerRequest> f$kphp_job_worker_fetch_request() noexcept;
 void f$kphp_job_worker_store_response(const class_instance<C$KphpJobWorkerResponse> &response) noexcept;
+bool f$kphp_job_worker_store_response_chunk(const class_instance<C$KphpJobWorkerResponse> &chunk) noexcept;
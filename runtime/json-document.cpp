@@ -0,0 +1,457 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include "runtime/json-document.h"
+
+#include <cstring>
+
+#include "common/algorithms/find.h"
+#include "common/algorithms/json-structural-index.h"
+
+namespace {
+
+bool is_json_whitespace(char c) noexcept {
+  return vk::any_of_equal(c, ' ', '\t', '\r', '\n');
+}
+
+bool is_json_number_char(char c) noexcept {
+  return c == '-' || ('0' <= c && c <= '9') || c == 'e' || c == 'E' || c == '+' || c == '.';
+}
+
+bool parse_hex4(const char *s, int &num) noexcept {
+  num = 0;
+  for (int t = 0; t < 4; t++) {
+    const char c = s[t];
+    if ('0' <= c && c <= '9') {
+      num = num * 16 + c - '0';
+    } else if ('a' <= (c | 0x20) && (c | 0x20) <= 'f') {
+      num = num * 16 + (c | 0x20) - 'a' + 10;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// unescapes the string contents [s, end) into out (if it isn't null), returns the unescaped length or -1 on invalid escape sequence;
+// the result is never longer than the contents
+int64_t json_unescape(const char *s, const char *end, char *out) noexcept {
+  int64_t l = 0;
+  auto put = [out, &l](int c) {
+    if (out) {
+      out[l] = static_cast<char>(c);
+    }
+    ++l;
+  };
+
+  while (s < end) {
+    if (*s != '\\') {
+      put(*s++);
+      continue;
+    }
+    switch (*++s) {
+      case '"':
+      case '\\':
+      case '/':
+        put(*s);
+        break;
+      case 'b':
+        put('\b');
+        break;
+      case 'f':
+        put('\f');
+        break;
+      case 'n':
+        put('\n');
+        break;
+      case 'r':
+        put('\r');
+        break;
+      case 't':
+        put('\t');
+        break;
+      case 'u': {
+        int num = 0;
+        if (!parse_hex4(s + 1, num)) {
+          return -1;
+        }
+        s += 4;
+        if (0xD7FF < num && num < 0xE000) {
+          int u = 0;
+          if (s[1] != '\\' || s[2] != 'u' || !parse_hex4(s + 3, u) || !(0xD7FF < u && u < 0xE000)) {
+            return -1;
+          }
+          s += 6;
+          num = (((num & 0x3FF) << 10) | (u & 0x3FF)) + 0x10000;
+        }
+
+        if (num < 128) {
+          put(num);
+        } else if (num < 0x800) {
+          put(0xc0 + (num >> 6));
+          put(0x80 + (num & 63));
+        } else if (num < 0xffff) {
+          put(0xe0 + (num >> 12));
+          put(0x80 + ((num >> 6) & 63));
+          put(0x80 + (num & 63));
+        } else {
+          put(0xf0 + (num >> 18));
+          put(0x80 + ((num >> 12) & 63));
+          put(0x80 + ((num >> 6) & 63));
+          put(0x80 + (num & 63));
+        }
+        break;
+      }
+      default:
+        return -1;
+    }
+    ++s;
+  }
+  return l;
+}
+
+} // namespace
+
+JsonDocument::JsonDocument(const string &json) noexcept
+  : json_(json.c_str())
+  , json_len_(json.size()) {
+  auto reserve_positions = [this](uint32_t required) {
+    if (required > positions_capacity_) {
+      const uint32_t new_capacity = std::max(required, 2 * positions_capacity_);
+      positions_ = static_cast<token_t *>(positions_
+                                          ? dl::reallocate(positions_, new_capacity * sizeof(token_t), positions_capacity_ * sizeof(token_t))
+                                          : dl::allocate(new_capacity * sizeof(token_t)));
+      positions_capacity_ = new_capacity;
+    }
+  };
+
+  JsonStructuralIndexer indexer{json_, json_len_};
+  uint32_t indexed = 0;
+  while (!indexer.finished()) {
+    // a chunk can't contain more tokens than characters, and the sentinel is always needed
+    const uint32_t chunk_size = std::min(json_len_ - indexed, static_cast<uint32_t>(JsonStructuralIndexer::CHUNK_SIZE));
+    reserve_positions(tokens_count_ + chunk_size + 1);
+    tokens_count_ += indexer.index_next_chunk(positions_ + tokens_count_);
+    indexed += chunk_size;
+  }
+  if (indexer.has_unclosed_string()) {
+    tokens_count_ = 0;
+  }
+  reserve_positions(tokens_count_ + 1);
+  positions_[tokens_count_] = json_len_;
+}
+
+JsonDocument::~JsonDocument() noexcept {
+  dl::deallocate(positions_, positions_capacity_ * sizeof(token_t));
+  if (skips_) {
+    dl::deallocate(skips_, (tokens_count_ + 1) * sizeof(token_t));
+  }
+}
+
+JsonDocument::ScalarType JsonDocument::parse_scalar(token_t token, bool &bool_value, int64_t &int_value, double &double_value) const noexcept {
+  const uint32_t begin = positions_[token];
+  const char *s = json_ + begin;
+  uint32_t len = 0;
+  ScalarType type = ScalarType::invalid;
+  switch (*s) {
+    case 'n':
+      if (!strncmp(s, "null", 4)) {
+        len = 4;
+        type = ScalarType::null;
+      }
+      break;
+    case 't':
+      if (!strncmp(s, "true", 4)) {
+        len = 4;
+        type = ScalarType::boolean;
+        bool_value = true;
+      }
+      break;
+    case 'f':
+      if (!strncmp(s, "false", 5)) {
+        len = 5;
+        type = ScalarType::boolean;
+        bool_value = false;
+      }
+      break;
+    default:
+      while (is_json_number_char(s[len])) {
+        ++len;
+      }
+      if (len == 0) {
+        break;
+      }
+      if (php_try_to_int(s, len, &int_value)) {
+        type = ScalarType::integer;
+        break;
+      }
+      char *end_ptr = nullptr;
+      double_value = strtod(s, &end_ptr);
+      if (end_ptr == s + len) {
+        type = ScalarType::floating;
+      }
+      break;
+  }
+
+  // the scalar must be followed by a whitespace, the next token or the end of json
+  const uint32_t end = begin + len;
+  if (type != ScalarType::invalid && end != json_len_ && end != positions_[token + 1] && !is_json_whitespace(json_[end])) {
+    return ScalarType::invalid;
+  }
+  return type;
+}
+
+bool JsonDocument::get_int(token_t value, int64_t &result) const noexcept {
+  bool bool_value = false;
+  double double_value = 0;
+  return parse_scalar(value, bool_value, result, double_value) == ScalarType::integer;
+}
+
+bool JsonDocument::get_double(token_t value, double &result) const noexcept {
+  bool bool_value = false;
+  int64_t int_value = 0;
+  switch (parse_scalar(value, bool_value, int_value, result)) {
+    case ScalarType::integer:
+      result = static_cast<double>(int_value);
+      return true;
+    case ScalarType::floating:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool JsonDocument::get_string(token_t value, string &result) const noexcept {
+  if (token_char(value) != '"') {
+    return false;
+  }
+  const char *begin = json_ + positions_[value] + 1;
+  const char *end = json_ + positions_[value + 1];
+  const auto len = static_cast<string::size_type>(end - begin);
+  if (!memchr(begin, '\\', len)) {
+    result = string{begin, len};
+    return true;
+  }
+
+  result = string{len, false};
+  const int64_t unescaped_len = json_unescape(begin, end, result.buffer());
+  if (unescaped_len < 0) {
+    return false;
+  }
+  result.shrink(static_cast<string::size_type>(unescaped_len));
+  return true;
+}
+
+bool JsonDocument::decode(token_t &token, mixed &value, const char *json_obj_magic_key) const noexcept {
+  switch (token_char(token)) {
+    case '"': {
+      string str;
+      if (!get_string(token, str)) {
+        return false;
+      }
+      value = std::move(str);
+      token += 2;
+      return true;
+    }
+    case '[': {
+      array<mixed> result;
+      if (token_char(++token) == ']') {
+        ++token;
+      } else {
+        do {
+          mixed element;
+          if (!decode(token, element, json_obj_magic_key)) {
+            return false;
+          }
+          result.push_back(std::move(element));
+        } while (token_char(token++) == ',');
+
+        if (token_char(token - 1) != ']') {
+          return false;
+        }
+      }
+      value = std::move(result);
+      return true;
+    }
+    case '{': {
+      array<mixed> result;
+      if (token_char(++token) == '}') {
+        ++token;
+      } else {
+        do {
+          string key;
+          if (!get_string(token, key) || token_char(token + 2) != ':') {
+            return false;
+          }
+          token += 3;
+          if (!decode(token, result[key], json_obj_magic_key)) {
+            return false;
+          }
+        } while (token_char(token++) == ',');
+
+        if (token_char(token - 1) != '}') {
+          return false;
+        }
+      }
+
+      // it's impossible to distinguish whether empty php array was an json array or json object;
+      // to overcome it we add dummy key to php array that make array::is_vector() returning false, so we have difference
+      if (json_obj_magic_key && result.empty()) {
+        result[string{json_obj_magic_key}] = true;
+      }
+      value = std::move(result);
+      return true;
+    }
+    default: {
+      bool bool_value = false;
+      int64_t int_value = 0;
+      double double_value = 0;
+      switch (parse_scalar(token, bool_value, int_value, double_value)) {
+        case ScalarType::null:
+          value = mixed{};
+          break;
+        case ScalarType::boolean:
+          value = bool_value;
+          break;
+        case ScalarType::integer:
+          value = int_value;
+          break;
+        case ScalarType::floating:
+          value = double_value;
+          break;
+        case ScalarType::invalid:
+          return false;
+      }
+      ++token;
+      return true;
+    }
+  }
+}
+
+bool JsonDocument::validate_value(token_t &token) noexcept {
+  const token_t begin = token;
+  switch (token_char(token)) {
+    case '"': {
+      const char *str_begin = json_ + positions_[token] + 1;
+      const char *str_end = json_ + positions_[token + 1];
+      if (memchr(str_begin, '\\', str_end - str_begin) && json_unescape(str_begin, str_end, nullptr) < 0) {
+        return false;
+      }
+      token += 2;
+      return true;
+    }
+    case '[':
+      if (token_char(++token) == ']') {
+        ++token;
+      } else {
+        do {
+          if (!validate_value(token)) {
+            return false;
+          }
+        } while (token_char(token++) == ',');
+
+        if (token_char(token - 1) != ']') {
+          return false;
+        }
+      }
+      skips_[begin] = token;
+      return true;
+    case '{':
+      if (token_char(++token) == '}') {
+        ++token;
+      } else {
+        do {
+          if (token_char(token) != '"' || !validate_value(token) || token_char(token++) != ':' || !validate_value(token)) {
+            return false;
+          }
+        } while (token_char(token++) == ',');
+
+        if (token_char(token - 1) != '}') {
+          return false;
+        }
+      }
+      skips_[begin] = token;
+      return true;
+    default: {
+      bool bool_value = false;
+      int64_t int_value = 0;
+      double double_value = 0;
+      if (parse_scalar(token, bool_value, int_value, double_value) == ScalarType::invalid) {
+        return false;
+      }
+      ++token;
+      return true;
+    }
+  }
+}
+
+bool JsonDocument::validate() noexcept {
+  if (is_empty()) {
+    return false;
+  }
+  if (!skips_) {
+    skips_ = static_cast<token_t *>(dl::allocate0((tokens_count_ + 1) * sizeof(token_t)));
+  }
+  token_t token = 0;
+  return validate_value(token) && token == tokens_count_;
+}
+
+JsonDocument::token_t JsonDocument::skip(token_t value) const noexcept {
+  switch (token_char(value)) {
+    case '"':
+      return value + 2;
+    case '[':
+    case '{':
+      return skips_[value];
+    default:
+      return value + 1;
+  }
+}
+
+bool JsonDocument::key_equals(token_t key, const char *str, size_t len) const noexcept {
+  const char *key_begin = json_ + positions_[key] + 1;
+  const size_t key_len = positions_[key + 1] - positions_[key] - 1;
+  if (!memchr(key_begin, '\\', key_len)) {
+    return key_len == len && !memcmp(key_begin, str, len);
+  }
+  string unescaped_key;
+  return get_string(key, unescaped_key) && unescaped_key.size() == len && !memcmp(unescaped_key.c_str(), str, len);
+}
+
+JsonDocument::token_t JsonDocument::find_member(token_t object, const char *key, size_t key_len) const noexcept {
+  token_t found = 0;
+  token_t member = object + 1;
+  if (token_char(member) == '}') {
+    return found;
+  }
+  while (true) {
+    // the member is "key" : value
+    if (key_equals(member, key, key_len)) {
+      found = member + 3;
+    }
+    member = skip(member + 3);
+    if (token_char(member) == '}') {
+      return found;
+    }
+    ++member;
+  }
+}
+
+bool JsonDocument::is_map_object(token_t object) const noexcept {
+  if (token_char(object) != '{') {
+    return false;
+  }
+  if (token_char(object + 1) == '}') {
+    return true;
+  }
+  // the decoded array can become a vector only if the first key is an integer
+  int64_t int_key = 0;
+  const char *key_begin = json_ + positions_[object + 1] + 1;
+  const size_t key_len = positions_[object + 2] - positions_[object + 1] - 1;
+  if (!memchr(key_begin, '\\', key_len)) {
+    return !php_try_to_int(key_begin, key_len, &int_key);
+  }
+  string first_key;
+  return get_string(object + 1, first_key) && !first_key.try_to_int(&int_key);
+}
@@ -0,0 +1,75 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include "common/mixin/not_copyable.h"
+
+#include "runtime/kphp_core.h"
+
+// The second stage of json parsing: the json string is indexed by JsonStructuralIndexer (common/algorithms/json-structural-index.h),
+// then its values are addressed by the tokens they start from, and the tokens are walked according to the grammar.
+// Values are decoded into mixed by json_decode(), or directly into typed fields by JsonEncoder::from_json() (see from-json-processor.h)
+class JsonDocument : vk::not_copyable {
+public:
+  using token_t = uint32_t;
+
+  explicit JsonDocument(const string &json) noexcept;
+  ~JsonDocument() noexcept;
+
+  // a document with an unclosed string or without tokens at all
+  bool is_empty() const noexcept {
+    return tokens_count_ == 0;
+  }
+
+  token_t end() const noexcept {
+    return tokens_count_;
+  }
+
+  // after the last token there is a sentinel pointing to the terminating '\0'
+  char token_char(token_t token) const noexcept {
+    return json_[positions_[token]];
+  }
+
+  // decodes the value starting from the token and moves the token to the next one after the value
+  bool decode(token_t &token, mixed &value, const char *json_obj_magic_key) const noexcept;
+
+  // checks the whole document (even the values which won't be decoded) and prepares it for the methods below
+  bool validate() noexcept;
+
+  token_t skip(token_t value) const noexcept;
+
+  // the member value with the key (the last one if there are several), or 0 if there is no such key
+  token_t find_member(token_t object, const char *key, size_t key_len) const noexcept;
+
+  // true if the object is decoded into a map by decode(), not into a vector (e.g. an object with keys "0", "1")
+  bool is_map_object(token_t object) const noexcept;
+
+  bool get_int(token_t value, int64_t &result) const noexcept;
+  bool get_double(token_t value, double &result) const noexcept;
+  bool get_string(token_t value, string &result) const noexcept;
+
+private:
+  enum class ScalarType {
+    invalid,
+    null,
+    boolean,
+    integer,
+    floating
+  };
+
+  ScalarType parse_scalar(token_t token, bool &bool_value, int64_t &int_value, double &double_value) const noexcept;
+  bool validate_value(token_t &token) noexcept;
+  bool key_equals(token_t key, const char *str, size_t len) const noexcept;
+
+  const char *json_{nullptr};
+  uint32_t json_len_{0};
+
+  token_t *positions_{nullptr};
+  uint32_t positions_capacity_{0};
+  token_t tokens_count_{0};
+
+  // for the first tokens of objects and arrays, the token after their ends
+  token_t *skips_{nullptr};
+};
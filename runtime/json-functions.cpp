@@ -5,8 +5,10 @@
 #include "runtime/json-functions.h"
 
 #include "common/algorithms/find.h"
+#include "common/algorithms/json-string-scan.h"
 
 #include "runtime/exception.h"
+#include "runtime/json-document.h"
 #include "runtime/string_functions.h"
 
 // note: json-functions.cpp is used for non-typed json implementation: for json_encode() and json_decode()
@@ -57,6 +59,14 @@ bool do_json_encode_string_php(const JsonPath &json_path, const char *s, int len
   };
 
   for (int pos = 0; pos < len; pos++) {
+    // the clean runs are copied as is, the space for them is already reserved
+    const int plain_len = json_ascii_plain_prefix_length(s + pos, len - pos);
+    static_SB.append_unsafe(s + pos, plain_len);
+    pos += plain_len;
+    if (pos == len) {
+      break;
+    }
+
     switch (s[pos]) {
       case '"':
         static_SB.append_char('\\');
@@ -176,6 +186,13 @@ bool do_json_encode_string_vkext(const char *s, int len) noexcept {
   static_SB.append_char('"');
 
   for (int pos = 0; pos < len; pos++) {
+    const int plain_len = json_plain_prefix_length(s + pos, len - pos);
+    static_SB.append_unsafe(s + pos, plain_len);
+    pos += plain_len;
+    if (pos == len) {
+      break;
+    }
+
     char c = s[pos];
     if (unlikely (static_cast<unsigned int>(c) < 32u)) {
       switch (c) {
@@ -310,266 +327,14 @@ bool JsonEncoder::encode(const mixed &v) noexcept {
 
 } // namespace impl_
 
-namespace {
-
-void json_skip_blanks(const char *s, int &i) noexcept {
-  while (vk::any_of_equal(s[i], ' ', '\t', '\r', '\n')) {
-    i++;
-  }
-}
-
-bool do_json_decode(const char *s, int s_len, int &i, mixed &v, const char *json_obj_magic_key) noexcept {
-  if (!v.is_null()) {
-    v.destroy();
-  }
-  json_skip_blanks(s, i);
-  switch (s[i]) {
-    case 'n':
-      if (s[i + 1] == 'u' &&
-          s[i + 2] == 'l' &&
-          s[i + 3] == 'l') {
-        i += 4;
-        return true;
-      }
-      break;
-    case 't':
-      if (s[i + 1] == 'r' &&
-          s[i + 2] == 'u' &&
-          s[i + 3] == 'e') {
-        i += 4;
-        new(&v) mixed(true);
-        return true;
-      }
-      break;
-    case 'f':
-      if (s[i + 1] == 'a' &&
-          s[i + 2] == 'l' &&
-          s[i + 3] == 's' &&
-          s[i + 4] == 'e') {
-        i += 5;
-        new(&v) mixed(false);
-        return true;
-      }
-      break;
-    case '"': {
-      int j = i + 1;
-      int slashes = 0;
-      while (j < s_len && s[j] != '"') {
-        if (s[j] == '\\') {
-          slashes++;
-          j++;
-        }
-        j++;
-      }
-      if (j < s_len) {
-        int len = j - i - 1 - slashes;
-
-        string value(len, false);
-
-        i++;
-        int l;
-        for (l = 0; l < len && i < j; l++) {
-          char c = s[i];
-          if (c == '\\') {
-            i++;
-            switch (s[i]) {
-              case '"':
-              case '\\':
-              case '/':
-                value[l] = s[i];
-                break;
-              case 'b':
-                value[l] = '\b';
-                break;
-              case 'f':
-                value[l] = '\f';
-                break;
-              case 'n':
-                value[l] = '\n';
-                break;
-              case 'r':
-                value[l] = '\r';
-                break;
-              case 't':
-                value[l] = '\t';
-                break;
-              case 'u':
-                if (isxdigit(s[i + 1]) && isxdigit(s[i + 2]) && isxdigit(s[i + 3]) && isxdigit(s[i + 4])) {
-                  int num = 0;
-                  for (int t = 0; t < 4; t++) {
-                    char c = s[++i];
-                    if ('0' <= c && c <= '9') {
-                      num = num * 16 + c - '0';
-                    } else {
-                      c |= 0x20;
-                      if ('a' <= c && c <= 'f') {
-                        num = num * 16 + c - 'a' + 10;
-                      }
-                    }
-                  }
-
-                  if (0xD7FF < num && num < 0xE000) {
-                    if (s[i + 1] == '\\' && s[i + 2] == 'u' &&
-                        isxdigit(s[i + 3]) && isxdigit(s[i + 4]) && isxdigit(s[i + 5]) && isxdigit(s[i + 6])) {
-                      i += 2;
-                      int u = 0;
-                      for (int t = 0; t < 4; t++) {
-                        char c = s[++i];
-                        if ('0' <= c && c <= '9') {
-                          u = u * 16 + c - '0';
-                        } else {
-                          c |= 0x20;
-                          if ('a' <= c && c <= 'f') {
-                            u = u * 16 + c - 'a' + 10;
-                          }
-                        }
-                      }
-
-                      if (0xD7FF < u && u < 0xE000) {
-                        num = (((num & 0x3FF) << 10) | (u & 0x3FF)) + 0x10000;
-                      } else {
-                        i -= 6;
-                        return false;
-                      }
-                    } else {
-                      return false;
-                    }
-                  }
-
-                  if (num < 128) {
-                    value[l] = static_cast<char>(num);
-                  } else if (num < 0x800) {
-                    value[l++] = static_cast<char>(0xc0 + (num >> 6));
-                    value[l] = static_cast<char>(0x80 + (num & 63));
-                  } else if (num < 0xffff) {
-                    value[l++] = static_cast<char>(0xe0 + (num >> 12));
-                    value[l++] = static_cast<char>(0x80 + ((num >> 6) & 63));
-                    value[l] = static_cast<char>(0x80 + (num & 63));
-                  } else {
-                    value[l++] = static_cast<char>(0xf0 + (num >> 18));
-                    value[l++] = static_cast<char>(0x80 + ((num >> 12) & 63));
-                    value[l++] = static_cast<char>(0x80 + ((num >> 6) & 63));
-                    value[l] = static_cast<char>(0x80 + (num & 63));
-                  }
-                  break;
-                }
-                /* fallthrough */
-              default:
-                return false;
-            }
-            i++;
-          } else {
-            value[l] = s[i++];
-          }
-        }
-        value.shrink(l);
-
-        new(&v) mixed(value);
-        i++;
-        return true;
-      }
-      break;
-    }
-    case '[': {
-      array<mixed> res;
-      i++;
-      json_skip_blanks(s, i);
-      if (s[i] != ']') {
-        do {
-          mixed value;
-          if (!do_json_decode(s, s_len, i, value, json_obj_magic_key)) {
-            return false;
-          }
-          res.push_back(value);
-          json_skip_blanks(s, i);
-        } while (s[i++] == ',');
-
-        if (s[i - 1] != ']') {
-          return false;
-        }
-      } else {
-        i++;
-      }
-
-      new(&v) mixed(res);
-      return true;
-    }
-    case '{': {
-      array<mixed> res;
-      i++;
-      json_skip_blanks(s, i);
-      if (s[i] != '}') {
-        do {
-          mixed key;
-          if (!do_json_decode(s, s_len, i, key, json_obj_magic_key) || !key.is_string()) {
-            return false;
-          }
-          json_skip_blanks(s, i);
-          if (s[i++] != ':') {
-            return false;
-          }
-
-          if (!do_json_decode(s, s_len, i, res[key], json_obj_magic_key)) {
-            return false;
-          }
-          json_skip_blanks(s, i);
-        } while (s[i++] == ',');
-
-        if (s[i - 1] != '}') {
-          return false;
-        }
-      } else {
-        i++;
-      }
-
-      // it's impossible to distinguish whether empty php array was an json array or json object;
-      // to overcome it we add dummy key to php array that make array::is_vector() returning false, so we have difference
-      if (json_obj_magic_key && res.empty()) {
-        res[string{json_obj_magic_key}] = true;
-      }
-
-      new(&v) mixed(res);
-      return true;
-    }
-    default: {
-      int j = i;
-      while (s[j] == '-' || ('0' <= s[j] && s[j] <= '9') || s[j] == 'e' || s[j] == 'E' || s[j] == '+' || s[j] == '.') {
-        j++;
-      }
-      if (j > i) {
-        int64_t intval = 0;
-        if (php_try_to_int(s + i, j - i, &intval)) {
-          i = j;
-          new(&v) mixed(intval);
-          return true;
-        }
-
-        char *end_ptr;
-        double floatval = strtod(s + i, &end_ptr);
-        if (end_ptr == s + j) {
-          i = j;
-          new(&v) mixed(floatval);
-          return true;
-        }
-      }
-      break;
-    }
-  }
-
-  return false;
-}
-
-} // namespace
-
 std::pair<mixed, bool> json_decode(const string &v, const char *json_obj_magic_key) noexcept {
+  ScriptPhaseGuard phase_guard{ScriptPhase::json};
+  const JsonDocument document{v};
   mixed result;
-  int i = 0;
-  if (do_json_decode(v.c_str(), v.size(), i, result, json_obj_magic_key)) {
-    json_skip_blanks(v.c_str(), i);
-    if (i == static_cast<int>(v.size())) {
-      bool success = true;
-      return {result, success};
-    }
+  JsonDocument::token_t token = 0;
+  if (document.decode(token, result, json_obj_magic_key) && token == document.end()) {
+    bool success = true;
+    return {result, success};
   }
 
   return {};
@@ -161,6 +161,7 @@ Optional<string> f$json_encode(const T &v, int64_t options = 0, bool simple_enco
     return false;
   }
 
+  ScriptPhaseGuard phase_guard{ScriptPhase::json};
   static_SB.clean();
   if (unlikely(!impl_::JsonEncoder(options, simple_encode).encode(v))) {
     return false;
@@ -170,6 +171,7 @@ Optional<string> f$json_encode(const T &v, int64_t options = 0, bool simple_enco
 
 template<class T>
 string f$vk_json_encode_safe(const T &v, bool simple_encode = true) noexcept {
+  ScriptPhaseGuard phase_guard{ScriptPhase::json};
   static_SB.clean();
   string_buffer::string_buffer_error_flag = STRING_BUFFER_ERROR_FLAG_ON;
   impl_::JsonEncoder(0, simple_encode).encode(v);
@@ -4,6 +4,9 @@
 
 #include "runtime/json-writer.h"
 
+#include "common/algorithms/find.h"
+#include "common/algorithms/json-string-scan.h"
+
 #include "runtime/array_functions.h"
 #include "runtime/math_functions.h"
 
@@ -11,8 +14,29 @@
 // for untyped json_encode() and json_decode(), see json-functions.cpp
 namespace impl_ {
 
+// the exact size of the string escaped by escape_json_string(), other control characters are not escaped there
+static size_t json_escaped_size(std::string_view s) noexcept {
+  size_t size = s.size();
+  for (size_t pos = 0; pos < s.size(); ++pos) {
+    pos += json_plain_prefix_length(s.data() + pos, s.size() - pos);
+    if (pos < s.size() && vk::any_of_equal(s[pos], '"', '\\', '/', '\b', '\f', '\n', '\r', '\t')) {
+      ++size;
+    }
+  }
+  return size;
+}
+
+// the buffer must have at least json_escaped_size(s) bytes reserved
 static void escape_json_string(string_buffer &buffer, std::string_view s) noexcept {
-  for (auto c : s) {
+  for (size_t pos = 0; pos < s.size(); ++pos) {
+    const size_t plain_len = json_plain_prefix_length(s.data() + pos, s.size() - pos);
+    buffer.append_unsafe(s.data() + pos, plain_len);
+    pos += plain_len;
+    if (pos == s.size()) {
+      break;
+    }
+
+    const char c = s[pos];
     switch (c) {
       case '"':
         buffer.append_char('\\');
@@ -103,9 +127,10 @@ bool JsonWriter::write_string(const string &s) noexcept {
   if (!register_value()) {
     return false;
   }
-  static_SB.reserve(2 * s.size() + 2);
+  const std::string_view str{s.c_str(), s.size()};
+  static_SB.reserve(json_escaped_size(str) + 2);
   static_SB.append_char('"');
-  escape_json_string(static_SB, {s.c_str(), s.size()});
+  escape_json_string(static_SB, str);
   static_SB.append_char('"');
   return true;
 }
@@ -140,6 +165,7 @@ bool JsonWriter::write_key(std::string_view key, bool escape) noexcept {
   }
   static_SB << '"';
   if (escape) {
+    static_SB.reserve(json_escaped_size(key));
     escape_json_string(static_SB, key);
   } else {
     static_SB.append(key.data(), key.size());
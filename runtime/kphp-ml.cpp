@@ -0,0 +1,87 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include "runtime/kphp-ml.h"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include "common/algorithms/gbdt-inference.h"
+
+namespace {
+
+GbdtModel xgboost_model;
+
+// the rows are converted to the dense float matrix and evaluated by batches of this size
+constexpr size_t PREDICT_BATCH_SIZE = 64;
+
+} // namespace
+
+bool load_xgboost_model(const char *path, std::string &error) noexcept {
+  std::ifstream file(path);
+  if (!file) {
+    error = "can't open the file";
+    return false;
+  }
+  std::stringstream content;
+  content << file.rdbuf();
+  const std::string dump = content.str();
+  return xgboost_model.load_xgboost_dump(dump.data(), dump.size(), error);
+}
+
+array<double> f$kphp_ml_xgboost_predict(const array<array<double>> &rows) noexcept {
+  if (xgboost_model.empty()) {
+    php_warning("XGBoost model is not loaded, see --xgboost-model-path-experimental option");
+    return {};
+  }
+  if (rows.empty()) {
+    return {};
+  }
+
+  const size_t features_count = xgboost_model.features_count();
+  const size_t stride = std::max(features_count, size_t{1});
+  const size_t batch_size = std::min(PREDICT_BATCH_SIZE, static_cast<size_t>(rows.count()));
+  const size_t buffer_size = batch_size * stride * sizeof(float);
+  auto *batch = static_cast<float *>(dl::allocate(buffer_size));
+  if (batch == nullptr) {
+    php_warning("Not enough memory to predict %" PRIi64 " rows", rows.count());
+    return {};
+  }
+
+  array<double> result{array_size(rows.count(), 0, true)};
+  float margins[PREDICT_BATCH_SIZE];
+  size_t batch_rows = 0;
+  const auto flush_batch = [&] {
+    xgboost_model.predict(batch, batch_rows, stride, margins);
+    for (size_t i = 0; i < batch_rows; ++i) {
+      result.push_back(margins[i]);
+    }
+    batch_rows = 0;
+  };
+
+  for (const auto &row_it : rows) {
+    float *row = batch + batch_rows * stride;
+    std::fill(row, row + stride, std::numeric_limits<float>::quiet_NaN());
+    for (const auto &feature_it : row_it.get_value()) {
+      if (feature_it.is_string_key()) {
+        continue;
+      }
+      const int64_t feature = feature_it.get_int_key();
+      if (feature >= 0 && feature < features_count) {
+        row[feature] = static_cast<float>(feature_it.get_value());
+      }
+    }
+    if (++batch_rows == batch_size) {
+      flush_batch();
+    }
+  }
+  if (batch_rows) {
+    flush_batch();
+  }
+
+  dl::deallocate(batch, buffer_size);
+  return result;
+}
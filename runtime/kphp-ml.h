@@ -0,0 +1,18 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <string>
+
+#include "runtime/kphp_core.h"
+
+// The model is loaded by the master before the workers are forked, and it is read only after that,
+// so all the workers share the same physical pages of the flattened trees.
+bool load_xgboost_model(const char *path, std::string &error) noexcept;
+
+// Each row maps the feature indexes to the values, the absent features are missing values.
+// Returns the raw margins (the sums of the tree leaves) in the order of the rows,
+// the base score and the objective transformation (e.g. the sigmoid) are left to the caller.
+array<double> f$kphp_ml_xgboost_predict(const array<array<double>> &rows) noexcept;
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "common/algorithms/simd-vector-ops.h"
+
 #include "runtime/kphp_core.h"
 
 int64_t f$bindec(const string &number) noexcept;
@@ -131,6 +133,41 @@ void init_math_functions() noexcept;
  *
  */
 
+// the same as the element by element loop over an int or float vector (with or without holes),
+// the runs of the consecutive keys are processed by the vectorized kernels
+template<bool is_max, class T>
+T min_of_primitive_vector(const array<T> &a) noexcept {
+  bool is_first_run = true;
+  T res{};
+  a.for_each_vector_run([&is_first_run, &res](int64_t, const T *values, size_t n) {
+    if constexpr (std::is_same<T, double>{}) {
+      // nothing is less or greater than NaN, so the loop keeps it only if it's the first one
+      if (!is_first_run) {
+        for (; n && std::isnan(*values); ++values, --n) {
+        }
+        if (!n) {
+          return true;
+        }
+      }
+    }
+    T run_res{};
+    if constexpr (std::is_same<T, int64_t>{}) {
+      run_res = is_max ? simd_max_int64(values, n) : simd_min_int64(values, n);
+    } else {
+      run_res = is_max ? simd_max_double(values, n) : simd_min_double(values, n);
+    }
+    if (is_first_run || (is_max ? run_res > res : run_res < res)) {
+      res = run_res;
+    }
+    is_first_run = false;
+    if constexpr (std::is_same<T, double>{}) {
+      return !std::isnan(res);
+    }
+    return true;
+  });
+  return res;
+}
+
 
 template<class T>
 T f$min(const array<T> &a) {
@@ -138,6 +175,11 @@ T f$min(const array<T> &a) {
     php_warning("Empty array specified to function min");
     return T();
   }
+  if constexpr (vk::is_type_in_list<T, int64_t, double>{}) {
+    if (a.is_vector() || a.is_vector_with_holes()) {
+      return min_of_primitive_vector<false>(a);
+    }
+  }
 
   typename array<T>::const_iterator p = a.begin();
   T res = p.get_value();
@@ -155,6 +197,11 @@ T f$max(const array<T> &a) {
     php_warning("Empty array specified to function max");
     return T();
   }
+  if constexpr (vk::is_type_in_list<T, int64_t, double>{}) {
+    if (a.is_vector() || a.is_vector_with_holes()) {
+      return min_of_primitive_vector<true>(a);
+    }
+  }
 
   typename array<T>::const_iterator p = a.begin();
   T res = p.get_value();
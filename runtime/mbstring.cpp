@@ -4,6 +4,7 @@
 
 #include "runtime/mbstring.h"
 
+#include "common/algorithms/simd-string-search.h"
 #include "common/unicode/unicode-utils.h"
 #include "common/unicode/utf8-utils.h"
 
@@ -54,80 +55,20 @@ static int mb_detect_encoding(const string &encoding) {
 }
 
 static int64_t mb_UTF8_strlen(const char *s) {
-  int64_t res = 0;
-  for (int64_t i = 0; s[i]; i++) {
-    if ((((unsigned char)s[i]) & 0xc0) != 0x80) {
-      res++;
-    }
-  }
-  return res;
+  return utf8_code_points_count(s, strlen(s));
 }
 
 static int64_t mb_UTF8_advance(const char *s, int64_t cnt) {
   php_assert (cnt >= 0);
-  int64_t i;
-  for (i = 0; s[i] && cnt >= 0; i++) {
-    if ((((unsigned char)s[i]) & 0xc0) != 0x80) {
-      cnt--;
-    }
-  }
-  if (cnt < 0) {
-    i--;
-  }
-  return i;
+  return utf8_code_point_offset(s, strlen(s), cnt);
 }
 
 static int64_t mb_UTF8_get_offset(const char *s, int64_t pos) {
-  int64_t res = 0;
-  for (int64_t i = 0; i < pos && s[i]; i++) {
-    if ((((unsigned char)s[i]) & 0xc0) != 0x80) {
-      res++;
-    }
-  }
-  return res;
+  return utf8_code_points_count(s, strnlen(s, pos));
 }
 
 bool mb_UTF8_check(const char *s) {
-  do {
-#define CHECK(condition) if (!(condition)) {return false;}
-    unsigned int a = (unsigned char)(*s++);
-    if ((a & 0x80) == 0) {
-      if (a == 0) {
-        return true;
-      }
-      continue;
-    }
-
-    CHECK ((a & 0x40) != 0);
-
-    unsigned int b = (unsigned char)(*s++);
-    CHECK((b & 0xc0) == 0x80);
-    if ((a & 0x20) == 0) {
-      CHECK((a & 0x1e) > 0);
-      continue;
-    }
-
-    unsigned int c = (unsigned char)(*s++);
-    CHECK((c & 0xc0) == 0x80);
-    if ((a & 0x10) == 0) {
-      int x = (((a & 0x0f) << 6) | (b & 0x20));
-      CHECK(x != 0 && x != 0x360);//surrogates
-      continue;
-    }
-
-    unsigned int d = (unsigned char)(*s++);
-    CHECK((d & 0xc0) == 0x80);
-    if ((a & 0x08) == 0) {
-      int t = (((a & 0x07) << 6) | (b & 0x30));
-      CHECK(0 < t && t < 0x110);//end of unicode
-      continue;
-    }
-
-    return false;
-#undef CHECK
-  } while (true);
-
-  php_assert (0);
+  return utf8_is_valid(s, strlen(s));
 }
 
 bool f$mb_check_encoding(const string &str, const string &encoding) {
@@ -208,13 +149,24 @@ string f$mb_strtolower(const string &str, const string &encoding) {
     return res;
   } else {
     string res(len * 3, false);
+    char *out = res.buffer();
     const char *s = str.c_str();
+    const char *s_end = s + len;
     int res_len = 0;
     int p;
     int ch;
-    while ((p = get_char_utf8(&ch, s)) > 0) {
+    while (true) {
+      // the runs of ASCII characters are converted by blocks, all the others one by one
+      if (s[0] > 0 && s[1] > 0) {
+        const size_t ascii_len = utf8_ascii_prefix_tolower(s, s_end - s, out + res_len);
+        s += ascii_len;
+        res_len += ascii_len;
+      }
+      if ((p = get_char_utf8(&ch, s)) <= 0) {
+        break;
+      }
       s += p;
-      res_len += put_char_utf8(unicode_tolower(ch), &res[res_len]);
+      res_len += put_char_utf8(unicode_tolower(ch), out + res_len);
     }
     if (p < 0) {
       php_warning("Incorrect UTF-8 string \"%s\" in function mb_strtolower", str.c_str());
@@ -278,13 +230,24 @@ string f$mb_strtoupper(const string &str, const string &encoding) {
     return res;
   } else {
     string res(len * 3, false);
+    char *out = res.buffer();
     const char *s = str.c_str();
+    const char *s_end = s + len;
     int res_len = 0;
     int p;
     int ch;
-    while ((p = get_char_utf8(&ch, s)) > 0) {
+    while (true) {
+      // the runs of ASCII characters are converted by blocks, all the others one by one
+      if (s[0] > 0 && s[1] > 0) {
+        const size_t ascii_len = utf8_ascii_prefix_toupper(s, s_end - s, out + res_len);
+        s += ascii_len;
+        res_len += ascii_len;
+      }
+      if ((p = get_char_utf8(&ch, s)) <= 0) {
+        break;
+      }
       s += p;
-      res_len += put_char_utf8(unicode_toupper(ch), &res[res_len]);
+      res_len += put_char_utf8(unicode_toupper(ch), out + res_len);
     }
     if (p < 0) {
       php_warning("Incorrect UTF-8 string \"%s\" in function mb_strtoupper", str.c_str());
@@ -321,7 +284,7 @@ Optional<int64_t> mp_strpos_impl(const string &haystack, const string &needle, i
   }
 
   int64_t UTF8_offset = mb_UTF8_advance(haystack.c_str(), offset);
-  const char *s = static_cast<const char *>(memmem(haystack.c_str() + UTF8_offset, haystack.size() - UTF8_offset, needle.c_str(), needle.size()));
+  const char *s = simd_memmem(haystack.c_str() + UTF8_offset, haystack.size() - UTF8_offset, needle.c_str(), needle.size());
   if (unlikely(s == nullptr)) {
     return false;
   }
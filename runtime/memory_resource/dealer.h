@@ -46,6 +46,10 @@ public:
     return *current_script_resource_;
   }
 
+  unsynchronized_pool_resource &default_script_resource() noexcept {
+    return default_script_resource_;
+  }
+
 private:
   heap_resource heap_resource_;
   unsynchronized_pool_resource default_script_resource_;
@@ -4,8 +4,11 @@
 
 #include "runtime/memory_resource/heap_resource.h"
 
+#include <algorithm>
 #include <csignal>
 #include <cstdlib>
+#include <sys/mman.h>
+#include <unistd.h>
 
 #include "common/wrappers/likely.h"
 
@@ -14,8 +17,67 @@
 
 namespace memory_resource {
 
+namespace {
+
+constexpr size_t REGION_ALIGNMENT = 16;
+
+size_t align_up(size_t size, size_t alignment) noexcept {
+  return (size + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+void heap_resource::open_constants_region(size_t capacity) noexcept {
+  dl::CriticalSectionGuard lock;
+  php_assert(!region_begin_);
+  capacity = align_up(capacity, getpagesize());
+  // only the touched pages are backed by memory, the unused tail is unmapped on close
+  void *mem = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (mem == MAP_FAILED) {
+    // the constants are allocated with malloc then
+    return;
+  }
+  region_begin_ = static_cast<char *>(mem);
+  region_capacity_ = capacity;
+  region_used_ = 0;
+  region_last_ = nullptr;
+  region_open_ = true;
+}
+
+void heap_resource::close_constants_region() noexcept {
+  dl::CriticalSectionGuard lock;
+  if (!region_open_) {
+    return;
+  }
+  region_open_ = false;
+  region_last_ = nullptr;
+  const size_t used_pages_size = align_up(region_used_, getpagesize());
+  if (used_pages_size < region_capacity_) {
+    munmap(region_begin_ + used_pages_size, region_capacity_ - used_pages_size);
+    region_capacity_ = used_pages_size;
+  }
+  if (!region_capacity_) {
+    region_begin_ = nullptr;
+  }
+}
+
+void *heap_resource::region_allocate(size_t size) noexcept {
+  const size_t aligned_size = align_up(size, REGION_ALIGNMENT);
+  if (!region_open_ || aligned_size > region_capacity_ - region_used_) {
+    return nullptr;
+  }
+  region_last_ = region_begin_ + region_used_;
+  region_used_ += aligned_size;
+  memory_debug("heap region allocate %zu at %p\n", size, region_last_);
+  memory_used_ += size;
+  return region_last_;
+}
+
 void *heap_resource::allocate(size_t size) noexcept {
   dl::CriticalSectionGuard lock;
+  if (void *mem = region_allocate(size)) {
+    return mem;
+  }
   void *mem = std::malloc(size);
   if (unlikely(!mem)) {
     php_out_of_memory_warning("Can't heap_allocate %zu bytes", size);
@@ -30,6 +92,10 @@ void *heap_resource::allocate(size_t size) noexcept {
 
 void *heap_resource::allocate0(size_t size) noexcept {
   dl::CriticalSectionGuard lock;
+  if (void *mem = region_allocate(size)) {
+    // the space of the freed last allocation may be reused
+    return std::memset(mem, 0, size);
+  }
   void *mem = std::calloc(1, size);
   if (unlikely(!mem)) {
     php_out_of_memory_warning("Can't heap_allocate0 %zu bytes", size);
@@ -44,6 +110,28 @@ void *heap_resource::allocate0(size_t size) noexcept {
 
 void *heap_resource::reallocate(void *mem, size_t new_size, size_t old_size) noexcept {
   dl::CriticalSectionGuard lock;
+  if (in_constants_region(mem)) {
+    const size_t offset = static_cast<char *>(mem) - region_begin_;
+    const size_t aligned_new_size = align_up(new_size, REGION_ALIGNMENT);
+    if (region_open_ && mem == region_last_ && aligned_new_size <= region_capacity_ - offset) {
+      region_used_ = offset + aligned_new_size;
+      memory_used_ += (new_size - old_size);
+      return mem;
+    }
+    void *new_mem = region_allocate(new_size);
+    if (!new_mem) {
+      new_mem = std::malloc(new_size);
+      if (unlikely(!new_mem)) {
+        php_out_of_memory_warning("Can't heap_reallocate from %zu to %zu bytes", old_size, new_size);
+        raise(SIGUSR2);
+        return nullptr;
+      }
+      memory_used_ += new_size;
+    }
+    std::memcpy(new_mem, mem, std::min(old_size, new_size));
+    memory_used_ -= old_size;
+    return new_mem;
+  }
   mem = std::realloc(mem, new_size);
   memory_debug("heap reallocate %zu at %p\n", old_size, mem);
   if (unlikely(!mem)) {
@@ -58,6 +146,15 @@ void *heap_resource::reallocate(void *mem, size_t new_size, size_t old_size) noe
 void heap_resource::deallocate(void *mem, size_t size) noexcept {
   dl::CriticalSectionGuard lock;
   memory_used_ -= size;
+  if (in_constants_region(mem)) {
+    // the region memory is never returned, except the last allocation while the region is open
+    if (region_open_ && mem == region_last_) {
+      region_used_ = region_last_ - region_begin_;
+      region_last_ = nullptr;
+    }
+    memory_debug("heap region deallocate %zu at %p\n", size, mem);
+    return;
+  }
 
   std::free(mem);
   memory_debug("heap deallocate %zu at %p\n", size, mem);
@@ -17,8 +17,26 @@ public:
 
   size_t memory_used() const noexcept { return memory_used_; }
 
+  // While the constants region is open, the allocations are bumped from a dedicated anonymous mapping instead of malloc.
+  // The global constants are built there before the workers are forked: they don't share the pages with the malloc chunks
+  // mutated by the workers, and their pages stay shared between the master and the workers.
+  void open_constants_region(size_t capacity) noexcept;
+  void close_constants_region() noexcept;
+  size_t constants_region_used() const noexcept { return region_used_; }
+
 private:
+  bool in_constants_region(const void *mem) const noexcept {
+    return region_begin_ && region_begin_ <= mem && mem < region_begin_ + region_capacity_;
+  }
+  void *region_allocate(size_t size) noexcept;
+
   size_t memory_used_{0};
+
+  char *region_begin_{nullptr};
+  size_t region_capacity_{0};
+  size_t region_used_{0};
+  char *region_last_{nullptr};
+  bool region_open_{false};
 };
 
 } // namespace memory_resource
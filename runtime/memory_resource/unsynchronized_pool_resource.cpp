@@ -11,6 +11,7 @@
 namespace memory_resource {
 
 constexpr size_t unsynchronized_pool_resource::MAX_CHUNK_BLOCK_SIZE_;
+constexpr int64_t unsynchronized_pool_resource::NO_SAMPLING_;
 
 void unsynchronized_pool_resource::init(void *buffer, size_t buffer_size) noexcept {
   monotonic_buffer_resource::init(buffer, buffer_size);
@@ -97,6 +98,11 @@ void *unsynchronized_pool_resource::perform_defragmentation_and_allocate_huge_pi
   return allocate_huge_piece(aligned_size, false);
 }
 
+void unsynchronized_pool_resource::on_sampled_allocation(void *mem, size_t aligned_size) noexcept {
+  // the body of this function is moved to the cpp file intentionally, so it doesn't get inlined into the allocate method
+  bytes_to_next_sample_ = allocation_sampler_ ? allocation_sampler_(mem, aligned_size) : NO_SAMPLING_;
+}
+
 bool unsynchronized_pool_resource::is_memory_from_extra_pool(void *mem, size_t size) const noexcept {
   auto *extra_pool = extra_memory_head_;
   do {
@@ -5,6 +5,8 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
+#include <limits>
 
 #include "runtime/memory_resource/details/memory_chunk_list.h"
 #include "runtime/memory_resource/details/memory_chunk_tree.h"
@@ -22,6 +24,10 @@ public:
   using monotonic_buffer_resource::get_memory_stats;
   using monotonic_buffer_resource::memory_begin;
 
+  // the sampler is called for a successful allocation once the given number of bytes is allocated,
+  // and for every failed allocation (with mem == nullptr); it returns the number of bytes until the next sample
+  using allocation_sampler = int64_t (*)(void *mem, size_t size) noexcept;
+
   void init(void *buffer, size_t buffer_size) noexcept;
   void hard_reset() noexcept;
 
@@ -41,6 +47,9 @@ public:
     }
 
     register_allocation(mem, aligned_size);
+    if (unlikely(!mem || (bytes_to_next_sample_ -= static_cast<int64_t>(aligned_size)) < 0)) {
+      on_sampled_allocation(mem, aligned_size);
+    }
     return mem;
   }
 
@@ -83,6 +92,12 @@ public:
     put_memory_back(extra_memory->memory_begin(), extra_memory->get_pool_payload_size());
   }
 
+  // the sampler survives init() and hard_reset(), so it is set once per process
+  void set_allocation_sampler(allocation_sampler sampler, int64_t bytes_to_next_sample) noexcept {
+    allocation_sampler_ = sampler;
+    bytes_to_next_sample_ = sampler ? bytes_to_next_sample : NO_SAMPLING_;
+  }
+
 private:
   void *try_allocate_small_piece(size_t aligned_size) noexcept {
     const auto chunk_id = details::get_chunk_id(aligned_size);
@@ -115,6 +130,7 @@ private:
   }
 
   void *allocate_small_piece_from_fallback_resource(size_t aligned_size) noexcept;
+  void on_sampled_allocation(void *mem, size_t aligned_size) noexcept;
   void *perform_defragmentation_and_allocate_huge_piece(size_t aligned_size) noexcept;
   bool is_memory_from_extra_pool(void *mem, size_t size) const noexcept;
 
@@ -138,6 +154,10 @@ private:
   extra_memory_pool *extra_memory_head_{nullptr};
   extra_memory_pool extra_memory_tail_{sizeof(extra_memory_pool)};
 
+  static constexpr int64_t NO_SAMPLING_{std::numeric_limits<int64_t>::max()};
+  allocation_sampler allocation_sampler_{nullptr};
+  int64_t bytes_to_next_sample_{NO_SAMPLING_};
+
   static constexpr size_t MAX_CHUNK_BLOCK_SIZE_{16u * 1024u};
   std::array<details::memory_chunk_list, details::get_chunk_id(MAX_CHUNK_BLOCK_SIZE_)> free_chunks_;
 };
@@ -4,6 +4,8 @@
 
 #include "runtime/memory_usage.h"
 
+#include "server/allocation-profiler.h"
+
 int64_t f$estimate_memory_usage(const string &value) {
   if (value.is_reference_counter(ExtraRefCnt::for_global_const) || value.is_reference_counter(ExtraRefCnt::for_instance_cache)) {
     return 0;
@@ -19,3 +21,7 @@ int64_t f$estimate_memory_usage(const mixed &value) {
   }
   return 0;
 }
+
+bool f$kphp_allocation_profile_dump() noexcept {
+  return vk::singleton<AllocationProfiler>::get().request_dump();
+}
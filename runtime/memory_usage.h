@@ -22,6 +22,8 @@ int64_t f$estimate_memory_usage(const CDataPtr<T> &ptr __attribute__ ((unused)))
 
 int64_t f$estimate_memory_usage(const string &value);
 
+bool f$kphp_allocation_profile_dump() noexcept;
+
 int64_t f$estimate_memory_usage(const mixed &value);
 
 template<typename T,
@@ -9,8 +9,6 @@
 #include "runtime/msgpack/unpacker.h"
 #include "runtime/msgpack/unpack_exception.h"
 
-#include "common/containers/final_action.h"
-
 #include "runtime/critical_section.h"
 #include "runtime/exception.h"
 #include "runtime/interface.h"
@@ -19,18 +17,17 @@
 
 template<class T>
 inline Optional<string> f$msgpack_serialize(const T &value, string *out_err_msg = nullptr) noexcept {
-  f$ob_start();
-  php_assert(f$ob_get_length().has_value() && f$ob_get_length().val() == 0);
-
-  string_buffer::string_buffer_error_flag = STRING_BUFFER_ERROR_FLAG_ON;
-  auto clean_buffer = vk::finally([] {
-    f$ob_end_clean();
-    string_buffer::string_buffer_error_flag = STRING_BUFFER_ERROR_FLAG_OFF;
-  });
+  ScriptPhaseGuard phase_guard{ScriptPhase::serialization};
 
-  vk::msgpack::packer{*coub}.pack(value);
+  // the first pass only counts the packed size, so the second one writes directly into the result of the exact size
+  vk::msgpack::size_counting_stream counter;
+  vk::msgpack::packer{counter}.pack(value);
+  if (vk::msgpack::CheckInstanceDepth::is_exceeded()) {
+    // the error is reported by the caller
+    return string{};
+  }
 
-  if (string_buffer::string_buffer_error_flag == STRING_BUFFER_ERROR_FLAG_FAILED) {
+  if (counter.size() > string_buffer::max_size()) {
     string err_msg{"msgpacke_serialize buffer overflow"};
     if (out_err_msg) {
       *out_err_msg = std::move(err_msg);
@@ -40,7 +37,11 @@ inline Optional<string> f$msgpack_serialize(const T &value, string *out_err_msg
     return {};
   }
 
-  return coub->str();
+  string result{static_cast<string::size_type>(counter.size()), false};
+  vk::msgpack::raw_buffer_stream stream{result.buffer()};
+  vk::msgpack::packer{stream}.pack(value);
+  php_assert(stream.pos() == result.c_str() + result.size());
+  return result;
 }
 
 template<class T>
@@ -103,6 +104,7 @@ inline ResultType f$msgpack_deserialize(const string &buffer, string *out_err_ms
     return {};
   }
 
+  ScriptPhaseGuard phase_guard{ScriptPhase::serialization};
   const auto malloc_replacement_guard = make_malloc_replacement_with_script_allocator();
   string err_msg;
   try {
@@ -371,6 +371,8 @@ void packer<Stream>::append_buffer(const char *buf, size_t len) noexcept {
 }
 
 template class packer<string_buffer>;
+template class packer<size_counting_stream>;
+template class packer<raw_buffer_stream>;
 
 uint32_t packer_float32_decorator::serialize_as_float32_ = 0;
 
@@ -7,6 +7,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 #include "common/mixin/not_copyable.h"
 
@@ -65,6 +66,40 @@ private:
   Stream &stream_;
 };
 
+// counts the size of the packed data without writing it
+class size_counting_stream {
+public:
+  void write(const char * /*buf*/, size_t len) noexcept {
+    size_ += len;
+  }
+
+  size_t size() const noexcept {
+    return size_;
+  }
+
+private:
+  size_t size_{0};
+};
+
+// writes the packed data into the preallocated buffer, its size is counted with size_counting_stream beforehand
+class raw_buffer_stream {
+public:
+  explicit raw_buffer_stream(char *buf) noexcept
+    : pos_(buf) {}
+
+  void write(const char *buf, size_t len) noexcept {
+    std::memcpy(pos_, buf, len);
+    pos_ += len;
+  }
+
+  const char *pos() const noexcept {
+    return pos_;
+  }
+
+private:
+  char *pos_{nullptr};
+};
+
 class packer_float32_decorator {
 public:
   static void clear() noexcept {
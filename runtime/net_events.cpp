@@ -50,7 +50,11 @@ bool process_net_event(net_event_t *e) {
          process_rpc_error(e->slot_id, data.error_code, data.error_message);
      },
      [&](const net_events_data::job_worker_answer &data) {
-         process_job_answer(e->slot_id, data.job_result);
+         if (data.is_chunk) {
+           process_job_response_chunk(e->slot_id, data.job_result);
+         } else {
+           process_job_answer(e->slot_id, data.job_result);
+         }
      },
      [&](database_drivers::Response *response) {
          php_assert(e->slot_id == response->bound_request_id);
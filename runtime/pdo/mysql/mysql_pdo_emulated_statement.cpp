@@ -30,6 +30,7 @@ public:
       TRY_WAIT(MysqlPdoEmulatedStatement_ExecuteResumable_label, response, std::unique_ptr<database_drivers::Response>);
       if (auto *casted = dynamic_cast<database_drivers::MysqlResponse *>(response.get())) {
         ctx->response = std::unique_ptr<database_drivers::MysqlResponse>{casted};
+        ctx->column_names = {};
         response.release();
       } else {
         php_critical_error("Unexpected error at MySQL PDO::execute");
@@ -48,19 +49,48 @@ bool MysqlPdoEmulatedStatement::execute(const class_instance<C$PDOStatement> &v$
   return start_resumable<bool>(new ExecuteResumable(this, v$this.get()->timeout_sec));
 }
 
+const array<string> &MysqlPdoEmulatedStatement::get_column_names() noexcept {
+  if (column_names.empty()) {
+    MYSQL_RES *mysql_res = response->res;
+    unsigned int fields_num = LIB_MYSQL_CALL(mysql_num_fields(mysql_res));
+    column_names.reserve(fields_num, 0, true);
+    for (int i = 0; i < fields_num; ++i) {
+      MYSQL_FIELD *cur_field = LIB_MYSQL_CALL(mysql_fetch_field_direct(mysql_res, i));
+      column_names.push_back(string{cur_field->name, cur_field->name_length});
+    }
+  }
+  return column_names;
+}
+
+array<mixed> MysqlPdoEmulatedStatement::make_row(char **row) noexcept {
+  const array<string> &names = get_column_names();
+  const unsigned long *lengths = LIB_MYSQL_CALL(mysql_fetch_lengths(response->res));
+  const int64_t fields_num = names.count();
+  array<mixed> res{array_size(fields_num, fields_num, false)};
+  for (int64_t i = 0; i < fields_num; ++i) {
+    string value = row[i] ? string{row[i], static_cast<string::size_type>(lengths[i])} : string{};
+    res.set_value(i, value);
+    res.set_value(names.get_value(i), std::move(value));
+  }
+  return res;
+}
+
 mixed MysqlPdoEmulatedStatement::fetch(const class_instance<C$PDOStatement> &) noexcept {
-  MYSQL_RES *mysql_res = response->res;
-  MYSQL_ROW row = LIB_MYSQL_CALL(mysql_fetch_row(mysql_res));
+  MYSQL_ROW row = LIB_MYSQL_CALL(mysql_fetch_row(response->res));
   if (row == nullptr) {
     return {};
   }
-  array<mixed> res;
-  unsigned int fields_num = LIB_MYSQL_CALL(mysql_num_fields(mysql_res));
-  for (int i = 0; i < fields_num; ++i) {
-    MYSQL_FIELD *cur_field = LIB_MYSQL_CALL(mysql_fetch_field_direct(mysql_res, i));
-    const char *cur_col = row[i];
-    res.set_value(i, string{cur_col});
-    res.set_value(string{cur_field->name}, string{cur_col});
+  return make_row(row);
+}
+
+array<mixed> MysqlPdoEmulatedStatement::fetch_all(const class_instance<C$PDOStatement> &) noexcept {
+  MYSQL_RES *mysql_res = response->res;
+  if (mysql_res == nullptr) {
+    return {};
+  }
+  array<mixed> res{array_size(static_cast<int64_t>(LIB_MYSQL_CALL(mysql_num_rows(mysql_res))), 0, true)};
+  while (MYSQL_ROW row = LIB_MYSQL_CALL(mysql_fetch_row(mysql_res))) {
+    res.push_back(make_row(row));
   }
   return res;
 }
@@ -19,6 +19,7 @@ public:
 
   bool execute(const class_instance<C$PDOStatement> &v$this, const Optional<array<mixed>> &params) noexcept final;
   mixed fetch(const class_instance<C$PDOStatement> &v$this) noexcept final;
+  array<mixed> fetch_all(const class_instance<C$PDOStatement> &v$this) noexcept final;
   int64_t affected_rows() noexcept final;
 
 private:
@@ -26,6 +27,11 @@ private:
   int connector_id{};
 
   std::unique_ptr<database_drivers::MysqlResponse> response;
+  // the names of the result columns, they are shared as keys by all the fetched rows
+  array<string> column_names;
+
+  const array<string> &get_column_names() noexcept;
+  array<mixed> make_row(char **row) noexcept;
 
   class ExecuteResumable;
 };
@@ -17,10 +17,8 @@ mixed f$PDOStatement$$fetch(const class_instance<C$PDOStatement> &v$this) noexce
 }
 
 array<mixed> f$PDOStatement$$fetchAll(const class_instance<C$PDOStatement> &v$this) noexcept {
-  array<mixed> res;
-  mixed row;
-  while (f$boolval(row = f$PDOStatement$$fetch(v$this))) {
-    res.emplace_back(std::move(row));
-  };
-  return res;
+  if (v$this.is_null()) {
+    return {};
+  }
+  return v$this.get()->statement->fetch_all(v$this);
 }
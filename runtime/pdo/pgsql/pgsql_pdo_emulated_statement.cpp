@@ -31,6 +31,7 @@ public:
       TRY_WAIT(PgsqlPdoEmulatedStatement_ExecuteResumable_label, response, std::unique_ptr<database_drivers::Response>);
       if (auto *casted = dynamic_cast<database_drivers::PgsqlResponse *>(response.get())) {
         ctx->response = std::unique_ptr<database_drivers::PgsqlResponse>{casted};
+        ctx->column_names = {};
         response.release();
       } else {
         php_critical_error("Unexpected error at pgSQL PDO::execute");
@@ -49,6 +50,34 @@ bool PgsqlPdoEmulatedStatement::execute(const class_instance<C$PDOStatement> &v$
   return start_resumable<bool>(new ExecuteResumable(this, v$this.get()->timeout_sec));
 }
 
+const array<string> &PgsqlPdoEmulatedStatement::get_column_names() noexcept {
+  if (column_names.empty()) {
+    PGresult *pGresult = response->res;
+    int columns = LIB_PGSQL_CALL(PQnfields(pGresult));
+    column_names.reserve(columns, 0, true);
+    for (int column = 0; column < columns; ++column) {
+      column_names.push_back(string{LIB_PGSQL_CALL(PQfname(pGresult, column))});
+    }
+  }
+  return column_names;
+}
+
+array<mixed> PgsqlPdoEmulatedStatement::make_row(int row) noexcept {
+  PGresult *pGresult = response->res;
+  const array<string> &names = get_column_names();
+  const int columns = static_cast<int>(names.count());
+  array<mixed> res{array_size(columns, columns, false)};
+  {
+    dl::CriticalSectionGuard guard;
+    for (int column = 0; column < columns; ++column) {
+      string value{PQgetvalue(pGresult, row, column), static_cast<string::size_type>(PQgetlength(pGresult, row, column))};
+      res.set_value(names.get_value(column), value);
+      res.set_value(column, std::move(value));
+    }
+  }
+  return res;
+}
+
 mixed PgsqlPdoEmulatedStatement::fetch(const class_instance<C$PDOStatement> &) noexcept {
   PGresult *pGresult = response->res;
   assert(LIB_PGSQL_CALL(PQresultStatus(pGresult)) == PGRES_TUPLES_OK || PQresultStatus(pGresult) == PGRES_COMMAND_OK);
@@ -59,14 +88,21 @@ mixed PgsqlPdoEmulatedStatement::fetch(const class_instance<C$PDOStatement> &) n
   }
 
   ++processed_row;
-  int columns = LIB_PGSQL_CALL(PQnfields(pGresult));
-  array<mixed> res;
-  {
-    dl::CriticalSectionGuard guard;
-    for (int column = 0; column < columns; ++column) {
-      res.set_value(string{PQfname(pGresult, column)}, string{PQgetvalue(pGresult, processed_row, column)});
-      res.set_value(column, string{PQgetvalue(pGresult, processed_row, column)});
-    }
+  return make_row(processed_row);
+}
+
+array<mixed> PgsqlPdoEmulatedStatement::fetch_all(const class_instance<C$PDOStatement> &) noexcept {
+  PGresult *pGresult = response->res;
+  assert(LIB_PGSQL_CALL(PQresultStatus(pGresult)) == PGRES_TUPLES_OK || PQresultStatus(pGresult) == PGRES_COMMAND_OK);
+  if (LIB_PGSQL_CALL(PQresultStatus(pGresult)) == PGRES_COMMAND_OK) {
+    return {};
+  }
+
+  const int rows = LIB_PGSQL_CALL(PQntuples(pGresult));
+  array<mixed> res{array_size(rows - processed_row - 1, 0, true)};
+  while (processed_row + 1 < rows) {
+    ++processed_row;
+    res.push_back(make_row(processed_row));
   }
   return res;
 }
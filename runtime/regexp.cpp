@@ -4,13 +4,26 @@
 
 #include "runtime/regexp.h"
 
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
 #include <cstddef>
+#include <deque>
+#include <limits>
 #include <re2/re2.h>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
 #if ASAN_ENABLED
 #include <sanitizer/lsan_interface.h>
 #endif
 #include "common/containers/final_action.h"
 #include "common/unicode/utf8-utils.h"
+#include "common/wrappers/memory-utils.h"
 
 #include "runtime/critical_section.h"
 
@@ -32,6 +45,161 @@ static re2::StringPiece RE2_submatch[MAX_SUBPATTERNS];
 int32_t regexp::submatch[3 * MAX_SUBPATTERNS];
 pcre_extra regexp::extra;
 
+namespace {
+
+RegexpCacheStats regexp_cache_stats;
+
+pcre_jit_stack *regexp_jit_stack{nullptr};
+
+// The patterns promoted by the workers, the master takes them before forking a worker in compile_shared_regexp_patterns(),
+// so the taken slots are reused. A slot is owned by the worker writing it, the slots of the dead writers are freed by the master.
+struct SharedRegexpPatterns : vk::not_copyable {
+  static constexpr size_t slots_count = 256;
+  static constexpr size_t max_pattern_size = 1024;
+  static constexpr pid_t free_slot = 0;
+  static constexpr pid_t ready_slot = -1;
+
+  struct Slot {
+    // free_slot, ready_slot or the pid of the writer
+    std::atomic<pid_t> owner{free_slot};
+    std::atomic<size_t> hash{0};
+    uint32_t size{0};
+    char pattern[max_pattern_size];
+  };
+
+  std::array<Slot, slots_count> slots;
+
+  // is called by the workers, the pattern is dropped if all the slots are busy
+  void push(std::string_view pattern) noexcept {
+    if (pattern.size() > max_pattern_size) {
+      return;
+    }
+    // the pattern waiting in a slot isn't pushed again, a hash collision only loses the promotion
+    const size_t pattern_hash = std::hash<std::string_view>{}(pattern);
+    for (const auto &slot : slots) {
+      if (slot.owner.load(std::memory_order_acquire) == ready_slot && slot.hash.load(std::memory_order_relaxed) == pattern_hash) {
+        return;
+      }
+    }
+    for (auto &slot : slots) {
+      pid_t expected = free_slot;
+      if (slot.owner.compare_exchange_strong(expected, getpid(), std::memory_order_acquire)) {
+        memcpy(slot.pattern, pattern.data(), pattern.size());
+        slot.size = static_cast<uint32_t>(pattern.size());
+        slot.hash.store(pattern_hash, std::memory_order_relaxed);
+        slot.owner.store(ready_slot, std::memory_order_release);
+        return;
+      }
+    }
+  }
+
+  // is called by the master, the slots are freed before the patterns are compiled
+  std::vector<std::string> take_all() noexcept {
+    std::vector<std::string> patterns;
+    for (auto &slot : slots) {
+      const pid_t owner = slot.owner.load(std::memory_order_acquire);
+      if (owner == ready_slot) {
+        patterns.emplace_back(slot.pattern, slot.size);
+        slot.owner.store(free_slot, std::memory_order_release);
+      } else if (owner != free_slot && kill(owner, 0) == -1 && errno == ESRCH) {
+        // the writer has been killed in the middle of the push
+        slot.owner.store(free_slot, std::memory_order_release);
+      }
+    }
+    return patterns;
+  }
+};
+
+SharedRegexpPatterns *shared_regexp_patterns{nullptr};
+
+} // namespace
+
+// The dynamic patterns compiled on the heap, they are kept for the process lifetime and are shared by all the requests.
+// A pattern gets here after it's compiled in several requests of the worker or when the master compiles the pattern
+// promoted by some worker: the workers forked after that inherit it.
+class PersistentRegexpCache : vk::not_copyable {
+public:
+  static PersistentRegexpCache &get() noexcept {
+    static PersistentRegexpCache cache;
+    return cache;
+  }
+
+  const regexp *find(const string &pattern) const noexcept {
+    const auto it = regexps_.find(std::string_view{pattern.c_str(), pattern.size()});
+    return it == regexps_.end() ? nullptr : it->second;
+  }
+
+  // is called when the pattern is compiled for a request
+  void on_request_compilation(const string &pattern) noexcept {
+    if (regexps_.size() >= max_regexps || pattern.size() > SharedRegexpPatterns::max_pattern_size) {
+      return;
+    }
+
+    dl::CriticalSectionGuard critical_section;
+    const std::string_view pattern_view{pattern.c_str(), pattern.size()};
+    auto seen_it = seen_.emplace(std::string{pattern_view}, 0).first;
+    if (seen_it->second == rejected_pattern) {
+      return;
+    }
+    if (++seen_it->second < promotion_requests_count) {
+      if (seen_.size() > max_seen_patterns) {
+        // the rare patterns are forgotten
+        seen_.clear();
+      }
+      return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const regexp *re = add(pattern_view);
+    regexp_cache_stats.compile_time_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    if (re != nullptr) {
+      seen_.erase(seen_it);
+      ++regexp_cache_stats.promotions;
+      if (shared_regexp_patterns) {
+        shared_regexp_patterns->push(pattern_view);
+      }
+    } else {
+      // not to compile it again
+      seen_it->second = rejected_pattern;
+    }
+  }
+
+  // compiles the pattern on the heap, the patterns with compilation warnings are not kept;
+  // the warnings are not reported, the request compilation has already reported them
+  const regexp *add(std::string_view pattern) noexcept {
+    if (regexps_.size() >= max_regexps || regexps_.count(pattern)) {
+      return nullptr;
+    }
+
+    dl::HeapMemoryReplacementGuard heap_memory_guard;
+    const std::string &key = patterns_.emplace_back(pattern);
+    auto *re = new regexp{};
+    re->use_heap_memory = true;
+    re->is_persistent = true;
+    re->init(key.c_str(), key.size());
+
+    if (re->regex_compilation_warning || (re->pcre_regexp == nullptr && re->RE2_regexp == nullptr)) {
+      delete re;
+      patterns_.pop_back();
+      return nullptr;
+    }
+    regexps_.emplace(key, re);
+    return re;
+  }
+
+private:
+  PersistentRegexpCache() = default;
+
+  static constexpr size_t max_regexps = 1024;
+  static constexpr size_t max_seen_patterns = 4096;
+  static constexpr uint32_t promotion_requests_count = 2;
+  static constexpr uint32_t rejected_pattern = std::numeric_limits<uint32_t>::max();
+
+  std::deque<std::string> patterns_;
+  std::unordered_map<std::string_view, const regexp *> regexps_;
+  std::unordered_map<std::string, uint32_t> seen_;
+};
+
 
 regexp::regexp(const string &regexp_string) {
   init(regexp_string);
@@ -48,6 +216,14 @@ void regexp::pattern_compilation_warning(const char *function, const char *file,
   vsnprintf(buf, sizeof(buf), message, args);
   va_end (args);
 
+  if (is_persistent) {
+    // the persistent regexps are compiled out of the requests, the warning only rejects the pattern
+    if (!regex_compilation_warning) {
+      regex_compilation_warning = strdup(buf);
+    }
+    return;
+  }
+
   if (function || file) {
     php_warning("%s [in function %s() at %s]", buf, function ? function : "unknown_function", file ? file : "unknown_file");
   } else {
@@ -315,6 +491,7 @@ void regexp::init(const string &regexp_string, const char *function, const char
   static array<regexp *> *regexp_cache = (array<regexp *> *)regexp_cache_storage;
   static long long regexp_last_query_num = -1;
 
+  ScriptPhaseGuard phase_guard{ScriptPhase::regexp};
   use_heap_memory = (dl::get_script_memory_stats().memory_limit == 0);
 
   if (!use_heap_memory) {
@@ -323,27 +500,27 @@ void regexp::init(const string &regexp_string, const char *function, const char
       regexp_last_query_num = dl::query_num;
     }
 
-    regexp *re = regexp_cache->get_value(regexp_string);
+    const regexp *re = regexp_cache->get_value(regexp_string);
+    if (re == nullptr) {
+      re = PersistentRegexpCache::get().find(regexp_string);
+      if (re != nullptr) {
+        ++regexp_cache_stats.hits;
+        regexp_cache->set_value(regexp_string, const_cast<regexp *>(re));
+      }
+    }
     if (re != nullptr) {
-      php_assert (!re->use_heap_memory);
-
-      subpatterns_count = re->subpatterns_count;
-      named_subpatterns_count = re->named_subpatterns_count;
-      is_utf8 = re->is_utf8;
-      use_heap_memory = re->use_heap_memory;
-
-      subpattern_names = re->subpattern_names;
-
-      pcre_regexp = re->pcre_regexp;
-      RE2_regexp = re->RE2_regexp;
-
+      borrow(*re);
       return;
     }
   }
 
+  const auto start = std::chrono::steady_clock::now();
   init(regexp_string.c_str(), regexp_string.size(), function, file);
 
   if (!use_heap_memory) {
+    ++regexp_cache_stats.misses;
+    regexp_cache_stats.compile_time_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
     regexp *re = static_cast <regexp *> (dl::allocate(sizeof(regexp)));
     new(re) regexp();
 
@@ -358,9 +535,25 @@ void regexp::init(const string &regexp_string, const char *function, const char
     re->RE2_regexp = RE2_regexp;
 
     regexp_cache->set_value(regexp_string, re);
+
+    PersistentRegexpCache::get().on_request_compilation(regexp_string);
   }
 }
 
+void regexp::borrow(const regexp &cached) noexcept {
+  subpatterns_count = cached.subpatterns_count;
+  named_subpatterns_count = cached.named_subpatterns_count;
+  is_utf8 = cached.is_utf8;
+  use_heap_memory = cached.use_heap_memory;
+  is_borrowed = true;
+
+  subpattern_names = cached.subpattern_names;
+
+  pcre_regexp = cached.pcre_regexp;
+  pcre_jit_extra = cached.pcre_jit_extra;
+  RE2_regexp = cached.RE2_regexp;
+}
+
 void regexp::init(const char *regexp_string, int64_t regexp_len, const char *function, const char *file) {
   if (regexp_len == 0) {
     pattern_compilation_warning(function, file, "Empty regular expression");
@@ -410,9 +603,18 @@ void regexp::init(const char *regexp_string, int64_t regexp_len, const char *fun
     return;
   }
 
-  static_SB.clean().append(regexp_string + 1, static_cast<size_t>(regexp_end - 1));
+  // the regexps of the persistent cache are compiled on the heap during a request
+  use_heap_memory = use_heap_memory || (dl::get_script_memory_stats().memory_limit == 0);
 
-  use_heap_memory = (dl::get_script_memory_stats().memory_limit == 0);
+  // the heap regexps can be compiled out of the requests, they don't use the script buffers
+  std::string heap_pattern;
+  if (use_heap_memory) {
+    heap_pattern.assign(regexp_string + 1, static_cast<size_t>(regexp_end - 1));
+  } else {
+    static_SB.clean().append(regexp_string + 1, static_cast<size_t>(regexp_end - 1));
+  }
+  const char *pattern = use_heap_memory ? heap_pattern.c_str() : static_SB.c_str();
+  const size_t pattern_size = use_heap_memory ? heap_pattern.size() : static_SB.size();
 
   auto malloc_replacement_guard = make_malloc_replacement_with_script_allocator(!use_heap_memory);
 
@@ -476,23 +678,23 @@ void regexp::init(const char *regexp_string, int64_t regexp_len, const char *fun
     }
   }
 
-  can_use_RE2 = can_use_RE2 && is_valid_RE2_regexp(static_SB.c_str(), static_SB.size(), is_utf8, function, file);
+  can_use_RE2 = can_use_RE2 && is_valid_RE2_regexp(pattern, pattern_size, is_utf8, function, file);
 
-  if (is_utf8 && !mb_UTF8_check(static_SB.c_str())) {
-    pattern_compilation_warning(function, file, "Regexp \"%s\" contains not UTF-8 symbols", static_SB.c_str());
+  if (is_utf8 && !mb_UTF8_check(pattern)) {
+    pattern_compilation_warning(function, file, "Regexp \"%s\" contains not UTF-8 symbols", pattern);
     clean();
     return;
   }
 
   bool need_pcre = false;
   if (can_use_RE2) {
-    RE2_regexp = new RE2(re2::StringPiece(static_SB.c_str(), static_SB.size()), RE2_options);
+    RE2_regexp = new RE2(re2::StringPiece(pattern, pattern_size), RE2_options);
 #if ASAN_ENABLED
     __lsan_ignore_object(RE2_regexp);
 #endif
     if (!RE2_regexp->ok()) {
       pattern_compilation_warning(function, file, "RE2 compilation of regexp \"%s\" failed. Error %d at %s",
-        static_SB.c_str(), RE2_regexp->error_code(), RE2_regexp->error().c_str());
+        pattern, RE2_regexp->error_code(), RE2_regexp->error().c_str());
 
       delete RE2_regexp;
       RE2_regexp = nullptr;
@@ -512,7 +714,7 @@ void regexp::init(const char *regexp_string, int64_t regexp_len, const char *fun
   if (RE2_regexp == nullptr || need_pcre) {
     const char *error;
     int32_t erroffset = 0;
-    pcre_regexp = pcre_compile(static_SB.c_str(), pcre_options, &error, &erroffset, nullptr);
+    pcre_regexp = pcre_compile(pattern, pcre_options, &error, &erroffset, nullptr);
 #if ASAN_ENABLED
     __lsan_ignore_object(pcre_regexp);
 #endif
@@ -578,11 +780,33 @@ void regexp::init(const char *regexp_string, int64_t regexp_len, const char *fun
     clean();
     return;
   }
+
+  if (use_heap_memory && pcre_regexp) {
+    compile_jit();
+  }
+}
+
+// the JIT code is executable memory out of the script allocator, so it's used only for the long-lived regexps
+void regexp::compile_jit() noexcept {
+  const char *error = nullptr;
+  pcre_jit_extra = pcre_study(pcre_regexp, PCRE_STUDY_JIT_COMPILE, &error);
+  if (pcre_jit_extra == nullptr) {
+    return;
+  }
+#if ASAN_ENABLED
+  __lsan_ignore_object(pcre_jit_extra);
+#endif
+  pcre_jit_extra->flags |= extra.flags;
+  pcre_jit_extra->match_limit = extra.match_limit;
+  pcre_jit_extra->match_limit_recursion = extra.match_limit_recursion;
+  if (regexp_jit_stack) {
+    pcre_assign_jit_stack(pcre_jit_extra, nullptr, regexp_jit_stack);
+  }
 }
 
 void regexp::clean() {
-  if (!use_heap_memory) {
-    // Regexp is stored inside a static cache, see regexp_cache_storage
+  if (!use_heap_memory || is_borrowed) {
+    // Regexp is stored inside a static cache, see regexp_cache_storage and PersistentRegexpCache
     return;
   }
 
@@ -593,6 +817,11 @@ void regexp::clean() {
   is_utf8 = false;
   use_heap_memory = false;
 
+  if (pcre_jit_extra != nullptr) {
+    pcre_free_study(pcre_jit_extra);
+    pcre_jit_extra = nullptr;
+  }
+
   if (pcre_regexp != nullptr) {
     pcre_free(pcre_regexp);
     pcre_regexp = nullptr;
@@ -614,6 +843,7 @@ regexp::~regexp() {
 int64_t regexp::pcre_last_error;
 
 int64_t regexp::exec(const string &subject, int64_t offset, bool second_try) const {
+  ScriptPhaseGuard phase_guard{ScriptPhase::regexp};
   if (RE2_regexp && !second_try) {
     {
       dl::CriticalSectionGuard critical_section;
@@ -646,8 +876,12 @@ int64_t regexp::exec(const string &subject, int64_t offset, bool second_try) con
 
   int32_t options = second_try ? PCRE_NO_UTF8_CHECK | PCRE_NOTEMPTY_ATSTART : PCRE_NO_UTF8_CHECK;
   dl::enter_critical_section();//OK
-  int64_t count = pcre_exec(pcre_regexp, &extra, subject.c_str(), subject.size(),
+  int64_t count = pcre_exec(pcre_regexp, pcre_jit_extra ? pcre_jit_extra : &extra, subject.c_str(), subject.size(),
                             static_cast<int32_t>(offset), options, submatch, 3 * subpatterns_count);
+  if (count == PCRE_ERROR_JIT_STACKLIMIT) {
+    // the interpreter isn't limited by the JIT stack size
+    count = pcre_exec(pcre_regexp, &extra, subject.c_str(), subject.size(), static_cast<int32_t>(offset), options, submatch, 3 * subpatterns_count);
+  }
   dl::leave_critical_section();
 
   php_assert (count != 0);
@@ -1124,9 +1358,24 @@ void regexp::global_init() {
   extra.flags = PCRE_EXTRA_MATCH_LIMIT | PCRE_EXTRA_MATCH_LIMIT_RECURSION;
   extra.match_limit = PCRE_BACKTRACK_LIMIT;
   extra.match_limit_recursion = PCRE_RECURSION_LIMIT;
+
+  regexp_jit_stack = pcre_jit_stack_alloc(32 * 1024, 1024 * 1024);
+  shared_regexp_patterns = new(mmap_shared(sizeof(SharedRegexpPatterns))) SharedRegexpPatterns{};
 }
 
 void global_init_regexp_lib() {
   regexp::global_init();
 }
 
+RegexpCacheStats take_regexp_cache_stats() noexcept {
+  return std::exchange(regexp_cache_stats, RegexpCacheStats{});
+}
+
+void compile_shared_regexp_patterns() noexcept {
+  if (shared_regexp_patterns == nullptr) {
+    return;
+  }
+  for (const std::string &pattern : shared_regexp_patterns->take_all()) {
+    PersistentRegexpCache::get().add(pattern);
+  }
+}
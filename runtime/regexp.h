@@ -45,14 +45,22 @@ private:
   int32_t named_subpatterns_count{0};
   bool is_utf8{false};
   bool use_heap_memory{false};
+  // the compiled data below belongs to a cached regexp, it must not be freed
+  bool is_borrowed{false};
+  // the regexp of the persistent cache, it's compiled out of the requests and doesn't report the warnings
+  bool is_persistent{false};
 
   string *subpattern_names{nullptr};
 
   pcre *pcre_regexp{nullptr};
+  // the JIT compiled code of pcre_regexp, it's built only for the regexps on the heap
+  pcre_extra *pcre_jit_extra{nullptr};
   re2::RE2 *RE2_regexp{nullptr};
 
   char *regex_compilation_warning{nullptr};
 
+  void compile_jit() noexcept;
+  void borrow(const regexp &cached) noexcept;
   void clean();
 
   int64_t exec(const string &subject, int64_t offset, bool second_try) const;
@@ -99,10 +107,28 @@ public:
   ~regexp();
 
   static void global_init();
+
+  friend class PersistentRegexpCache;
+};
+
+struct RegexpCacheStats {
+  // the dynamic patterns found in the cache of the compiled on the heap regexps
+  uint64_t hits{0};
+  // the dynamic patterns compiled for a request
+  uint64_t misses{0};
+  // the dynamic patterns compiled on the heap after they are seen in several requests
+  uint64_t promotions{0};
+  uint64_t compile_time_ns{0};
 };
 
+// returns the stats collected since the previous call
+RegexpCacheStats take_regexp_cache_stats() noexcept;
+
 void global_init_regexp_lib();
 
+// the master compiles the dynamic patterns promoted by the workers before the fork, so the new worker inherits them
+void compile_shared_regexp_patterns() noexcept;
+
 inline void preg_add_match(array<mixed> &v, const mixed &match, const string &name);
 inline void preg_add_match(array<string> &v, const string &match, const string &name);
 
@@ -16,6 +16,7 @@
 #include "runtime/misc.h"
 #include "runtime/net_events.h"
 #include "runtime/resumable.h"
+#include "runtime/script-phases.h"
 #include "runtime/string_functions.h"
 #include "runtime/tl/rpc_function.h"
 #include "runtime/tl/rpc_request.h"
@@ -240,6 +241,21 @@ void f$fetch_raw_vector_double(array<double> &out, int64_t n_elems) {
   rpc_data += rpc_data_buf_offset;
 }
 
+void fetch_raw_vector_int(array<int64_t> &out, int64_t n_elems) {
+  TRY_CALL_VOID(void, (check_rpc_data_len(n_elems)));
+  for (int64_t i = 0; i < n_elems; ++i) {
+    out.push_back(rpc_data[i]);
+  }
+  rpc_data += n_elems;
+}
+
+void fetch_raw_vector_long(array<int64_t> &out, int64_t n_elems) {
+  int64_t rpc_data_buf_offset = static_cast<int64_t>(sizeof(int64_t) * n_elems / 4);
+  TRY_CALL_VOID(void, (check_rpc_data_len(rpc_data_buf_offset)));
+  out.memcpy_vector(n_elems, rpc_data);
+  rpc_data += rpc_data_buf_offset;
+}
+
 static inline const char *f$fetch_string_raw(int *string_len) {
   TRY_CALL_VOID_(check_rpc_data_len(1), return nullptr);
   const char *str = reinterpret_cast <const char *> (rpc_data);
@@ -396,11 +412,39 @@ bool f$store_raw(const string &data) {
   return true;
 }
 
+void store_reserve(int64_t bytes) {
+  data_buf.reserve(static_cast<int>(bytes));
+}
+
 void f$store_raw_vector_double(const array<double> &vector) {
   data_buf.append(reinterpret_cast<const char *>(vector.get_const_vector_pointer()),
                   sizeof(double) * vector.count());
 }
 
+bool store_raw_vector_int(const array<int64_t> &vector) {
+  const int64_t *values = vector.get_const_vector_pointer();
+  const int64_t n = vector.count();
+  for (int64_t i = 0; i < n; ++i) {
+    if (unlikely(static_cast<int32_t>(values[i]) != values[i])) {
+      return false;
+    }
+  }
+  data_buf.reserve(static_cast<int>(sizeof(int32_t) * n));
+  if (unlikely(string_buffer::string_buffer_error_flag == STRING_BUFFER_ERROR_FLAG_FAILED)) {
+    return true;
+  }
+  for (int64_t i = 0; i < n; ++i) {
+    const auto v32 = static_cast<int32_t>(values[i]);
+    data_buf.append_unsafe(reinterpret_cast<const char *>(&v32), sizeof(v32));
+  }
+  return true;
+}
+
+void store_raw_vector_long(const array<int64_t> &vector) {
+  data_buf.append(reinterpret_cast<const char *>(vector.get_const_vector_pointer()),
+                  sizeof(int64_t) * vector.count());
+}
+
 bool store_header(long long cluster_id, int64_t flags) {
   if (flags) {
     store_int(TL_RPC_DEST_ACTOR_FLAGS);
@@ -571,8 +615,16 @@ struct rpc_request {
     const char *error;
   };
   uint32_t function_magic{0};
+  int64_t actor_id{0};
+  uint64_t sent_tsc{0}; // != 0 only if script phases tracking is enabled
 };
 
+static void account_rpc_request_wait(const rpc_request *request) {
+  if (request->sent_tsc) {
+    vk::singleton<ScriptPhasesStats>::get().add_rpc_actor_wait(request->actor_id, cycleclock_now() - request->sent_tsc);
+  }
+}
+
 
 // only for good linkage. Will be never used to load
 template<>
@@ -614,9 +666,9 @@ protected:
 
 /*
     if (request->resumable_id == -1) {
-      int len = *reinterpret_cast <int *>(request->answer - 12);
+      int len = *reinterpret_cast <int *>(request->answer - string::inner_sizeof());
       fprintf (stderr, "Receive  string of len %d at %p\n", len, request->answer);
-      for (int i = -12; i <= len; i++) {
+      for (int i = -static_cast<int>(string::inner_sizeof()); i <= len; i++) {
         fprintf (stderr, "%d: %x(%d)\t%c\n", i, request->answer[i], request->answer[i], request->answer[i] >= 32 ? request->answer[i] : '.');
       }
     }
@@ -723,6 +775,8 @@ int64_t rpc_send(const class_instance<C$RpcConnection> &conn, double timeout, bo
 
   cur->resumable_id = register_forked_resumable(new rpc_resumable(result));
   cur->function_magic = function_magic;
+  cur->actor_id = conn.get()->default_actor_id;
+  cur->sent_tsc = 0;
   cur->timer = nullptr;
   if (ignore_answer) {
     int64_t resumable_id = cur->resumable_id;
@@ -730,6 +784,9 @@ int64_t rpc_send(const class_instance<C$RpcConnection> &conn, double timeout, bo
     get_forked_storage(resumable_id)->load<rpc_request>();
     return resumable_id;
   } else {
+    if (ScriptPhasesStats::is_enabled()) {
+      cur->sent_tsc = cycleclock_now();
+    }
     rpc_request_need_timer.set_value(result, timeout);
     return cur->resumable_id;
   }
@@ -782,12 +839,13 @@ void process_rpc_answer(int32_t request_id, char *result, int32_t result_len __a
 
   if (request->resumable_id < 0) {
     php_assert (result != nullptr);
-    dl::deallocate(result - 12, result_len + 13);
+    dl::deallocate(result - string::inner_sizeof(), string::inner_sizeof() + result_len + 1);
     php_assert (request->resumable_id != -1);
     return;
   }
   int64_t resumable_id = request->resumable_id;
   request->resumable_id = -1;
+  account_rpc_request_wait(request);
 
   if (request->timer) {
     remove_event_timer(request->timer);
@@ -810,6 +868,7 @@ void process_rpc_error(int32_t request_id, int32_t error_code __attribute__((unu
   }
   int64_t resumable_id = request->resumable_id;
   request->resumable_id = -2;
+  account_rpc_request_wait(request);
 
   if (request->timer) {
     remove_event_timer(request->timer);
@@ -859,7 +918,7 @@ protected:
       php_assert (res.resumable_id == -1);
 
       string result;
-      result.assign_raw(res.answer - 12);
+      result.assign_raw(res.answer - string::inner_sizeof());
       RETURN(result);
     RESUMABLE_END
   }
@@ -932,7 +991,7 @@ protected:
       php_assert (res.resumable_id == -1);
 
       string result;
-      result.assign_raw(res.answer - 12);
+      result.assign_raw(res.answer - string::inner_sizeof());
       bool parse_result = f$rpc_parse(result);
       php_assert(parse_result);
 
@@ -80,6 +80,10 @@ bool f$fetch_end();
 
 void f$fetch_raw_vector_double(array<double> &out, int64_t n_elems);
 
+// the bulk fetching of bare int and long vectors, the same as f$fetch_raw_vector_double() for doubles
+void fetch_raw_vector_int(array<int64_t> &out, int64_t n_elems);
+void fetch_raw_vector_long(array<int64_t> &out, int64_t n_elems);
+
 void estimate_and_flush_overflow(size_t &bytes_sent);
 
 struct tl_func_base;
@@ -141,8 +145,15 @@ bool f$store_error(int64_t error_code, const string &error_text);
 
 bool f$store_raw(const string &data);
 
+// reserves the space for the next stores, e.g. for all items of a vector of a fixed size type
+void store_reserve(int64_t bytes);
+
 void f$store_raw_vector_double(const array<double> &vector);
 
+// returns false and stores nothing if some value doesn't fit into int32, so the caller can report it element by element
+bool store_raw_vector_int(const array<int64_t> &vector);
+void store_raw_vector_long(const array<int64_t> &vector);
+
 bool f$set_fail_rpc_on_int32_overflow(bool fail_rpc); // TODO: remove when all RPC errors will be fixed
 
 bool is_int32_overflow(int64_t v);
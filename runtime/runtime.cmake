@@ -75,9 +75,11 @@ prepend(KPHP_RUNTIME_SOURCES ${BASE_DIR}/runtime/
         instance-copy-processor.cpp
         inter-process-mutex.cpp
         interface.cpp
+        json-document.cpp
         json-functions.cpp
         json-writer.cpp
         kphp-backtrace.cpp
+        kphp-ml.cpp
         mail.cpp
         math_functions.cpp
         mbstring.cpp
@@ -95,6 +97,7 @@ prepend(KPHP_RUNTIME_SOURCES ${BASE_DIR}/runtime/
         regexp.cpp
         resumable.cpp
         rpc.cpp
+        script-phases.cpp
         serialize-functions.cpp
         storage.cpp
         streams.cpp
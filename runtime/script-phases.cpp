@@ -0,0 +1,64 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include "runtime/script-phases.h"
+
+#include <algorithm>
+
+bool ScriptPhasesStats::enabled_ = false;
+
+const char *script_phase_name(ScriptPhase phase) noexcept {
+  switch (phase) {
+    case ScriptPhase::memory_allocation:
+      return "memory_allocation";
+    case ScriptPhase::copying:
+      return "copying";
+    case ScriptPhase::json:
+      return "json";
+    case ScriptPhase::serialization:
+      return "serialization";
+    case ScriptPhase::regexp:
+      return "regexp";
+    case ScriptPhase::instance_cache:
+      return "instance_cache";
+    case ScriptPhase::types_count:
+      break;
+  }
+  return "unknown";
+}
+
+void ScriptPhasesStats::reset() noexcept {
+  if (!calibration_start_tsc_) {
+    calibration_start_tp_ = std::chrono::steady_clock::now();
+    calibration_start_tsc_ = cycleclock_now();
+  }
+  active_ = false;
+  phases_tsc_.fill(0);
+  rpc_actors_count_ = 0;
+}
+
+void ScriptPhasesStats::add_rpc_actor_wait(int64_t actor_id, uint64_t wait_tsc) noexcept {
+  auto *end = rpc_actors_.begin() + rpc_actors_count_;
+  auto *actor = std::find_if(rpc_actors_.begin(), end, [actor_id](const RpcActorStats &stats) { return stats.actor_id == actor_id; });
+  if (actor == end) {
+    if (rpc_actors_count_ + 1 < rpc_actors_.size() || actor_id == OTHER_RPC_ACTORS_ID) {
+      *actor = RpcActorStats{actor_id, 0, 0};
+      ++rpc_actors_count_;
+    } else {
+      // the last slot is reserved for the rest of actors
+      return add_rpc_actor_wait(OTHER_RPC_ACTORS_ID, wait_tsc);
+    }
+  }
+  ++actor->queries;
+  actor->wait_tsc += wait_tsc;
+}
+
+double ScriptPhasesStats::tsc2sec(uint64_t tsc) const noexcept {
+  const uint64_t interval_tsc = cycleclock_now() - calibration_start_tsc_;
+  const std::chrono::duration<double> interval = std::chrono::steady_clock::now() - calibration_start_tp_;
+  if (!calibration_start_tsc_ || !interval_tsc) {
+    return 0;
+  }
+  return static_cast<double>(tsc) * interval.count() / static_cast<double>(interval_tsc);
+}
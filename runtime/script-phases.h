@@ -0,0 +1,121 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "common/cycleclock.h"
+#include "common/mixin/not_copyable.h"
+#include "common/smart_ptrs/singleton.h"
+#include "common/wrappers/likely.h"
+
+// Per request CPU time attribution of the runtime subsystems.
+// Subsystem entry points are wrapped with ScriptPhaseGuard, the time is accumulated in TSC ticks
+// and is sent to StatsHouse when the request is finished.
+// Only the outermost phase is accounted, e.g. allocations inside json_decode() are attributed to json.
+enum class ScriptPhase : uint8_t {
+  memory_allocation,
+  copying,
+  json,
+  serialization,
+  regexp,
+  instance_cache,
+
+  types_count
+};
+
+const char *script_phase_name(ScriptPhase phase) noexcept;
+
+class ScriptPhasesStats : vk::not_copyable {
+public:
+  struct RpcActorStats {
+    int64_t actor_id{0};
+    uint64_t queries{0};
+    uint64_t wait_tsc{0};
+  };
+
+  static constexpr size_t MAX_RPC_ACTORS = 32;
+  // all the actors that didn't fit into MAX_RPC_ACTORS are accounted here
+  static constexpr int64_t OTHER_RPC_ACTORS_ID = -1;
+
+  static void enable() noexcept {
+    enabled_ = true;
+  }
+
+  static bool is_enabled() noexcept {
+    return enabled_;
+  }
+
+  void reset() noexcept;
+
+  bool try_enter() noexcept {
+    if (active_) {
+      return false;
+    }
+    active_ = true;
+    return true;
+  }
+
+  void leave(ScriptPhase phase, uint64_t spent_tsc) noexcept {
+    phases_tsc_[static_cast<size_t>(phase)] += spent_tsc;
+    active_ = false;
+  }
+
+  void add_rpc_actor_wait(int64_t actor_id, uint64_t wait_tsc) noexcept;
+
+  template<class F>
+  void for_each_phase(const F &callback) const noexcept {
+    for (size_t i = 0; i != phases_tsc_.size(); ++i) {
+      callback(static_cast<ScriptPhase>(i), phases_tsc_[i]);
+    }
+  }
+
+  template<class F>
+  void for_each_rpc_actor(const F &callback) const noexcept {
+    for (size_t i = 0; i != rpc_actors_count_; ++i) {
+      callback(rpc_actors_[i]);
+    }
+  }
+
+  double tsc2sec(uint64_t tsc) const noexcept;
+
+private:
+  friend class vk::singleton<ScriptPhasesStats>;
+
+  ScriptPhasesStats() = default;
+
+  static bool enabled_;
+
+  bool active_{false};
+  std::array<uint64_t, static_cast<size_t>(ScriptPhase::types_count)> phases_tsc_{};
+
+  size_t rpc_actors_count_{0};
+  std::array<RpcActorStats, MAX_RPC_ACTORS> rpc_actors_{};
+
+  std::chrono::steady_clock::time_point calibration_start_tp_;
+  uint64_t calibration_start_tsc_{0};
+};
+
+class ScriptPhaseGuard : vk::not_copyable {
+public:
+  explicit ScriptPhaseGuard(ScriptPhase phase) noexcept {
+    if (unlikely(ScriptPhasesStats::is_enabled()) && vk::singleton<ScriptPhasesStats>::get().try_enter()) {
+      phase_ = phase;
+      start_tsc_ = cycleclock_now();
+    }
+  }
+
+  ~ScriptPhaseGuard() noexcept {
+    if (unlikely(start_tsc_ != 0)) {
+      vk::singleton<ScriptPhasesStats>::get().leave(phase_, cycleclock_now() - start_tsc_);
+    }
+  }
+
+private:
+  ScriptPhase phase_{ScriptPhase::types_count};
+  uint64_t start_tsc_{0};
+};
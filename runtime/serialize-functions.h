@@ -59,6 +59,7 @@ void PhpSerializer::serialize(const Optional<T> &opt) noexcept {
 
 template<class T>
 string f$serialize(const T &v) noexcept {
+  ScriptPhaseGuard phase_guard{ScriptPhase::serialization};
   static_SB.clean();
   impl_::PhpSerializer::serialize(v);
   return static_SB.str();
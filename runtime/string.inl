@@ -27,9 +27,17 @@ void string::string_inner::set_length_and_sharable(size_type n) {
 //  fprintf (stderr, "inc ref cnt %d %s\n", 0, ref_data());
   ref_count = 0;
   size = n;
+  hash = 0;
   ref_data()[n] = '\0';
 }
 
+void string::string_inner::reset_hash() {
+  // the constant strings may be placed in the read only memory
+  if (hash != 0 && ref_count < ExtraRefCnt::for_global_const) {
+    hash = 0;
+  }
+}
+
 char *string::string_inner::ref_data() const {
   return (char *)(this + 1);
 }
@@ -59,6 +67,7 @@ string::string_inner *string::string_inner::create(size_type requested_capacity,
   size_type new_size = (size_type)(sizeof(string_inner) + (capacity + 1));
   string_inner *p = (string_inner *)dl::allocate(new_size);
   p->capacity = capacity;
+  p->hash = 0;
   return p;
 }
 
@@ -99,12 +108,14 @@ char *string::string_inner::ref_copy() {
 }
 
 char *string::string_inner::clone(size_type requested_cap) {
+  ScriptPhaseGuard phase_guard{ScriptPhase::copying};
   string_inner *r = string_inner::create(requested_cap, capacity);
   if (size) {
     memcpy(r->ref_data(), ref_data(), size);
   }
 
   r->set_length_and_sharable(size);
+  r->hash = hash;
   return r->ref_data();
 }
 
@@ -333,6 +344,8 @@ string &string::reserve_at_least(size_type res) {
   } else if (res > capacity()) {
     p = inner()->reserve(res);
   }
+  // the string is going to be changed
+  inner()->reset_hash();
   return *this;
 }
 
@@ -353,6 +366,7 @@ const char &string::operator[](size_type pos) const {
 }
 
 char &string::operator[](size_type pos) {
+  inner()->reset_hash();
   return p[pos];
 }
 
@@ -641,7 +655,7 @@ string &string::assign(size_type n, bool b __attribute__((unused))) {
 
 
 void string::assign_raw(const char *s) {
-  static_assert (sizeof(string_inner) == 12u, "need 12 bytes");
+  static_assert (sizeof(string_inner) == STRING_RAW_HEADER_SIZE, "raw strings should be compatible with string_inner");
   p = const_cast <char *> (s + sizeof(string_inner));
 }
 
@@ -653,6 +667,7 @@ void string::swap(string &s) {
 }
 
 char *string::buffer() {
+  inner()->reset_hash();
   return p;
 }
 
@@ -912,7 +927,16 @@ bool string::is_numeric() const {
 }
 
 int64_t string::hash() const {
-  return string_hash(p, size());
+  string_inner *r = inner();
+  if (r->hash != 0) {
+    return r->hash;
+  }
+  const int64_t result = string_hash(p, size());
+  // the constant strings and the strings in the shared memory may be read only, their hashes are computed in advance
+  if (r->ref_count < ExtraRefCnt::for_global_const) {
+    r->hash = result;
+  }
+  return result;
 }
 
 
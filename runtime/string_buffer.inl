@@ -112,6 +112,10 @@ string::size_type string_buffer::size() const noexcept {
   return static_cast<string::size_type>(buffer_end - buffer_begin);
 }
 
+string::size_type string_buffer::max_size() noexcept {
+  return MAX_BUFFER_LEN - 1;
+}
+
 char *string_buffer::buffer() {
   return buffer_begin;
 }
@@ -45,6 +45,7 @@ public:
   inline void reserve(int len);
 
   inline string::size_type size() const noexcept;
+  static inline string::size_type max_size() noexcept;
 
   inline char *buffer();
   inline const char *buffer() const;
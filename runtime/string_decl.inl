@@ -41,12 +41,18 @@ private:
 
 private:
   struct string_inner {
+    // the header must stay 4-byte aligned, it's followed by the string data
+    using hash_type __attribute__((aligned(4))) = int64_t;
+
     size_type size;
     size_type capacity;
     int ref_count;
+    // the hash of the string which is cached by string::hash(), 0 means that it is not computed yet
+    hash_type hash;
 
     inline bool is_shared() const;
     inline void set_length_and_sharable(size_type n);
+    inline void reset_hash();
 
     inline char *ref_data() const;
 
@@ -8,6 +8,7 @@
 #include <sys/types.h>
 #include <cctype>
 
+#include "common/algorithms/simd-string-search.h"
 #include "common/macos-ports.h"
 #include "common/unicode/unicode-utils.h"
 
@@ -1883,7 +1884,7 @@ Optional<int64_t> f$strpos(const string &haystack, const string &needle, int64_t
     return s - haystack.c_str();
   }
 
-  const char *s = static_cast <const char *> (memmem(haystack.c_str() + offset, haystack.size() - offset, needle.c_str(), needle.size()));
+  const char *s = simd_memmem(haystack.c_str() + offset, haystack.size() - offset, needle.c_str(), needle.size());
   if (s == nullptr) {
     return false;
   }
@@ -1909,11 +1910,11 @@ Optional<int64_t> f$strrpos(const string &haystack, const string &needle, int64_
     return false;
   }
 
-  const char *s = static_cast <const char *> (memmem(haystack.c_str() + offset, haystack.size() - offset, needle.c_str(), needle.size())), *t;
+  const char *s = simd_memmem(haystack.c_str() + offset, haystack.size() - offset, needle.c_str(), needle.size()), *t;
   if (s == nullptr || s >= end) {
     return false;
   }
-  while ((t = static_cast <const char *> (memmem(s + 1, haystack.c_str() + haystack.size() - s - 1, needle.c_str(), needle.size()))) != nullptr && t < end) {
+  while ((t = simd_memmem(s + 1, haystack.c_str() + haystack.size() - s - 1, needle.c_str(), needle.size())) != nullptr && t < end) {
     s = t;
   }
   return s - haystack.c_str();
@@ -1965,7 +1966,7 @@ Optional<string> f$strstr(const string &haystack, const string &needle, bool bef
     return false;
   }
 
-  const char *s = static_cast <const char *> (memmem(haystack.c_str(), haystack.size(), needle.c_str(), needle.size()));
+  const char *s = simd_memmem(haystack.c_str(), haystack.size(), needle.c_str(), needle.size());
   if (s == nullptr) {
     return false;
   }
@@ -2031,15 +2032,20 @@ string f$strtoupper(const string &str) {
 }
 
 string f$strtr(const string &subject, const string &from, const string &to) {
+  // the first occurrence of a char in from wins, the chars without a pair in to are not replaced
+  unsigned char table[256];
+  for (int c = 0; c < 256; c++) {
+    table[c] = static_cast<unsigned char>(c);
+  }
+  for (int i = static_cast<int>(std::min(from.size(), to.size())) - 1; i >= 0; i--) {
+    table[static_cast<unsigned char>(from[i])] = static_cast<unsigned char>(to[i]);
+  }
+
   int n = subject.size();
   string result(n, false);
+  char *output = result.buffer();
   for (int i = 0; i < n; i++) {
-    const char *p = static_cast <const char *> (memchr(static_cast <const void *> (from.c_str()), (int)(unsigned char)subject[i], (size_t)from.size()));
-    if (p == nullptr || static_cast<string::size_type>(p - from.c_str()) >= to.size()) {
-      result[i] = subject[i];
-    } else {
-      result[i] = to[static_cast<string::size_type>(p - from.c_str())];
-    }
+    output[i] = static_cast<char>(table[static_cast<unsigned char>(subject[i])]);
   }
   return result;
 }
@@ -2158,7 +2164,7 @@ static string str_replace_char(char c, const string &replace, const string &subj
 
 static const char *find_substr(const char *where, const char *where_end, const string &what, bool with_case) {
   if (with_case) {
-    return static_cast<char *>(memmem(where, where_end - where, what.c_str(), what.size()));
+    return simd_memmem(where, where_end - where, what.c_str(), what.size());
   }
 
   return strcasestr(where, what.c_str());
@@ -2386,7 +2392,7 @@ int64_t f$substr_count(const string &haystack, const string &needle, int64_t off
     return end - s;
   }
   do {
-    s = static_cast <const char *> (memmem(static_cast <const void *> (s), (size_t)(end - s), static_cast <const void *> (needle.c_str()), (size_t)needle.size()));
+    s = simd_memmem(s, end - s, needle.c_str(), needle.size());
     if (s == nullptr) {
       return ans;
     }
@@ -5,6 +5,9 @@
 #pragma once
 
 #include <type_traits>
+
+#include "common/algorithms/simd-string-search.h"
+
 #include "runtime/kphp_core.h"
 
 extern const string COLON;
@@ -391,7 +394,7 @@ string f$strtr(const string &subject, const array<T> &replace_pairs) {
       if (search_len == 0) {
         return subject;
       }
-      const char *pos = static_cast <const char *> (memmem(static_cast <const void *> (piece), (size_t)(piece_end - piece), static_cast <const void *> (search.c_str()), (size_t)search_len));
+      const char *pos = simd_memmem(piece, piece_end - piece, search.c_str(), search_len);
       if (pos != nullptr && (best_pos == nullptr || best_pos > pos || (best_pos == pos && search_len > best_len))) {
         best_pos = pos;
         best_len = search_len;
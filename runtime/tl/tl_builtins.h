@@ -75,26 +75,6 @@ inline void fetch_magic_if_not_bare(unsigned int inner_magic, const char *error_
   }
 }
 
-template<class T>
-inline void fetch_raw_vector_T(array<T> &out __attribute__ ((unused)), int64_t n_elems __attribute__ ((unused))) {
-  php_assert(0 && "never called in runtime");
-}
-
-template<>
-inline void fetch_raw_vector_T<double>(array<double> &out, int64_t n_elems) {
-  f$fetch_raw_vector_double(out, n_elems);
-}
-
-template<class T>
-inline void store_raw_vector_T(const array<T> &v __attribute__ ((unused))) {
-  php_assert(0 && "never called in runtime");
-}
-
-template<>
-inline void store_raw_vector_T<double>(const array<double> &v) {
-  f$store_raw_vector_double(v);
-}
-
 // Wrap into Optional that TL types which PhpType is:
 //  1. int, double, string, bool
 //  2. array<T>
@@ -138,6 +118,8 @@ get_serialization_target_from_optional_field(OptionalFieldT &v) {
 }
 
 struct t_Int {
+  static constexpr int64_t FIXED_SIZE = 4;
+
   void store(const mixed &tl_object) {
     int32_t v32 = prepare_int_for_storing(f$intval(tl_object));
     store_int(v32);
@@ -175,6 +157,8 @@ struct t_Int {
 };
 
 struct t_Long {
+  static constexpr int64_t FIXED_SIZE = 8;
+
   void store(const mixed &tl_object) {
     store_long(tl_object);
   }
@@ -197,6 +181,8 @@ struct t_Long {
 };
 
 struct t_Double {
+  static constexpr int64_t FIXED_SIZE = 8;
+
   void store(const mixed &tl_object) {
     f$store_double(f$floatval(tl_object));
   }
@@ -219,6 +205,8 @@ struct t_Double {
 };
 
 struct t_Float {
+  static constexpr int64_t FIXED_SIZE = 4;
+
   void store(const mixed &tl_object) {
     f$store_float(f$floatval(tl_object));
   }
@@ -263,6 +251,8 @@ struct t_String {
 };
 
 struct t_Bool {
+  static constexpr int64_t FIXED_SIZE = 4;
+
   void store(const mixed &tl_object) {
     store_int(tl_object.to_bool() ? TL_BOOL_TRUE : TL_BOOL_FALSE);
   }
@@ -301,6 +291,7 @@ struct t_Bool {
 
 struct t_True {
   using PhpType = bool;
+  static constexpr int64_t FIXED_SIZE = 0;
 
   void store(const mixed &__attribute__((unused))) {}
 
@@ -316,6 +307,56 @@ struct t_True {
   }
 };
 
+// the size of a serialized value of T if it doesn't depend on the value, or -1
+template<typename T, typename = void>
+struct tl_fixed_size : std::integral_constant<int64_t, -1> {
+};
+
+template<typename T>
+struct tl_fixed_size<T, std::void_t<decltype(T::FIXED_SIZE)>> : std::integral_constant<int64_t, T::FIXED_SIZE> {
+};
+
+template<typename T, unsigned int inner_magic>
+inline void store_reserve_for_items(int64_t n) {
+  if constexpr (tl_fixed_size<T>::value >= 0) {
+    store_reserve(n * (tl_fixed_size<T>::value + (inner_magic ? sizeof(int32_t) : 0)));
+  }
+}
+
+// bare vectors of ints, longs and doubles are stored and fetched in bulk, without per element calls;
+// these functions return false if the vector has to be processed element by element
+template<typename T>
+inline bool fetch_raw_vector_T(array<typename T::PhpType> &out __attribute__ ((unused)), int64_t n_elems __attribute__ ((unused))) {
+  if constexpr (std::is_same_v<T, t_Int>) {
+    fetch_raw_vector_int(out, n_elems);
+    return true;
+  } else if constexpr (std::is_same_v<T, t_Long>) {
+    fetch_raw_vector_long(out, n_elems);
+    return true;
+  } else if constexpr (std::is_same_v<T, t_Double>) {
+    f$fetch_raw_vector_double(out, n_elems);
+    return true;
+  } else {
+    return false;
+  }
+}
+
+template<typename T>
+inline bool store_raw_vector_T(const array<typename T::PhpType> &v __attribute__ ((unused))) {
+  if constexpr (std::is_same_v<T, t_Int>) {
+    // int32 overflows are reported by the element by element storing
+    return store_raw_vector_int(v);
+  } else if constexpr (std::is_same_v<T, t_Long>) {
+    store_raw_vector_long(v);
+    return true;
+  } else if constexpr (std::is_same_v<T, t_Double>) {
+    f$store_raw_vector_double(v);
+    return true;
+  } else {
+    return false;
+  }
+}
+
 template<typename T, unsigned int inner_magic>
 struct t_Vector {
   T elem_state;
@@ -365,10 +406,10 @@ struct t_Vector {
     int64_t n = v.count();
     f$store_int(n);
 
-    if (std::is_same<T, t_Double>{} && inner_magic == 0 && v.is_vector()) {
-      store_raw_vector_T<typename T::PhpType>(v);
+    if (inner_magic == 0 && v.is_vector() && store_raw_vector_T<T>(v)) {
       return;
     }
+    store_reserve_for_items<T, inner_magic>(n);
 
     for (int64_t i = 0; i < n; ++i) {
       if (!v.isset(i)) {
@@ -389,8 +430,7 @@ struct t_Vector {
     }
     out.reserve(n, 0, true);
 
-    if (std::is_same<T, t_Double>{} && inner_magic == 0) {
-      fetch_raw_vector_T<typename T::PhpType>(out, n);
+    if (inner_magic == 0 && fetch_raw_vector_T<T>(out, n)) {
       return;
     }
 
@@ -606,10 +646,10 @@ struct t_Tuple {
   using PhpType = array<typename T::PhpType>;
 
   void typed_store(const PhpType &v) {
-    if (std::is_same<T, t_Double>{} && inner_magic == 0 && v.is_vector() && v.count() == size) {
-      store_raw_vector_T<typename T::PhpType>(v);
+    if (inner_magic == 0 && v.is_vector() && v.count() == size && store_raw_vector_T<T>(v)) {
       return;
     }
+    store_reserve_for_items<T, inner_magic>(size);
 
     for (int64_t i = 0; i < size; ++i) {
       if (!v.isset(i)) {
@@ -625,8 +665,7 @@ struct t_Tuple {
     CHECK_EXCEPTION(return);
     out.reserve(size, 0, true);
 
-    if (std::is_same<T, t_Double>{} && inner_magic == 0) {
-      fetch_raw_vector_T<typename T::PhpType>(out, size);
+    if (inner_magic == 0 && fetch_raw_vector_T<T>(out, size)) {
       return;
     }
 
@@ -679,10 +718,10 @@ struct tl_array {
   using PhpType = array<typename T::PhpType>;
 
   void typed_store(const PhpType &v) {
-    if (std::is_same<T, t_Double>{} && inner_magic == 0 && v.is_vector() && v.count() == size) {
-      store_raw_vector_T<typename T::PhpType>(v);
+    if (inner_magic == 0 && v.is_vector() && v.count() == size && store_raw_vector_T<T>(v)) {
       return;
     }
+    store_reserve_for_items<T, inner_magic>(size);
 
     for (int64_t i = 0; i < size; ++i) {
       if (!v.isset(i)) {
@@ -698,8 +737,7 @@ struct tl_array {
     CHECK_EXCEPTION(return);
     out.reserve(size, 0, true);
 
-    if (std::is_same<T, t_Double>{} && inner_magic == 0) {
-      fetch_raw_vector_T<typename T::PhpType>(out, size);
+    if (inner_magic == 0 && fetch_raw_vector_T<T>(out, size)) {
       return;
     }
 
@@ -178,6 +178,7 @@ string f$JsonEncoder$$to_json_impl(Tag /*tag*/, const class_instance<T> &klass,
 
   JsonEncoderError::msg = {};
 
+  ScriptPhaseGuard phase_guard{ScriptPhase::json};
   impl_::JsonWriter writer{(flags & JSON_PRETTY_PRINT) > 0, (flags & JSON_PRESERVE_ZERO_FRACTION) > 0};
   to_json_impl<Tag>(klass, writer, more);
 
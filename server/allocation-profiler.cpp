@@ -0,0 +1,215 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include "server/allocation-profiler.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+#include "common/fast-backtrace.h"
+#include "common/kprintf.h"
+
+#include "runtime/allocator.h"
+#include "runtime/kphp-backtrace.h"
+#include "server/server-log.h"
+
+namespace {
+
+constexpr size_t MAX_PROBES = 64;
+// AllocationProfiler::sample() and unsynchronized_pool_resource::on_sampled_allocation()
+constexpr int SKIPPED_FRAMES = 2;
+
+uint64_t calc_stack_hash(void *const *frames, uint32_t depth) noexcept {
+  uint64_t hash = 14695981039346656037ULL;
+  for (uint32_t i = 0; i < depth; ++i) {
+    hash ^= reinterpret_cast<uintptr_t>(frames[i]);
+    hash *= 1099511628211ULL;
+  }
+  // zero is reserved for the empty slots
+  return hash | 1;
+}
+
+} // namespace
+
+bool AllocationProfiler::set_sampling_interval(int64_t bytes) noexcept {
+  if (bytes <= 0) {
+    return false;
+  }
+  sampling_interval_ = bytes;
+  return true;
+}
+
+bool AllocationProfiler::set_workers_ratio(double ratio) noexcept {
+  if (ratio <= 0 || ratio > 1) {
+    return false;
+  }
+  workers_ratio_ = ratio;
+  return true;
+}
+
+void AllocationProfiler::set_output_prefix(const char *prefix) noexcept {
+  output_prefix_ = prefix;
+}
+
+void AllocationProfiler::start_in_worker(uint16_t worker_unique_id) noexcept {
+  // exactly the ratio part of the workers is chosen, and they are spread evenly over the unique ids
+  if (!enabled() || std::floor((worker_unique_id + 1) * workers_ratio_) == std::floor(worker_unique_id * workers_ratio_)) {
+    return;
+  }
+  table_ = new StacksTable{};
+  random_state_ = (static_cast<uint64_t>(getpid()) * 0x9E3779B97F4A7C15ULL) | 1;
+  dl::set_script_allocation_sampler(&AllocationProfiler::sample, next_sampling_interval());
+}
+
+bool AllocationProfiler::request_dump() noexcept {
+  dump_requested_ = true;
+  return table_ != nullptr;
+}
+
+int64_t AllocationProfiler::next_sampling_interval() noexcept {
+  // the intervals are exponentially distributed, so every allocated byte is sampled with the same probability
+  random_state_ ^= random_state_ >> 12;
+  random_state_ ^= random_state_ << 25;
+  random_state_ ^= random_state_ >> 27;
+  const double uniform = static_cast<double>(((random_state_ * 2685821657736338717ULL) >> 11) + 1) / 9007199254740992.0;
+  return std::max(static_cast<int64_t>(-std::log(uniform) * static_cast<double>(sampling_interval_)), int64_t{1});
+}
+
+int64_t AllocationProfiler::sample(void *mem, size_t size) noexcept {
+  auto &profiler = vk::singleton<AllocationProfiler>::get();
+  if (!profiler.table_) {
+    return std::numeric_limits<int64_t>::max();
+  }
+
+  // a failed allocation isn't sampled, but its stack is recorded anyway as the most interesting one
+  uint64_t bytes = size;
+  if (mem) {
+    // the allocation of the given size is sampled with the probability of 1 - exp(-size / interval)
+    const double size_to_interval = static_cast<double>(size) / static_cast<double>(profiler.sampling_interval_);
+    bytes = static_cast<uint64_t>(static_cast<double>(size) / -std::expm1(-size_to_interval));
+  } else {
+    profiler.out_of_memory_ = true;
+  }
+
+  void *frames[MAX_STACK_DEPTH + SKIPPED_FRAMES];
+  const int depth = fast_backtrace(frames, MAX_STACK_DEPTH + SKIPPED_FRAMES);
+  if (depth > SKIPPED_FRAMES) {
+    profiler.add_stack(frames + SKIPPED_FRAMES, depth - SKIPPED_FRAMES, bytes);
+  }
+  return profiler.next_sampling_interval();
+}
+
+void AllocationProfiler::add_stack(void *const *frames, uint32_t depth, uint64_t bytes) noexcept {
+  const uint64_t hash = calc_stack_hash(frames, depth);
+  for (size_t probe = 0; probe < MAX_PROBES; ++probe) {
+    const size_t index = (hash + probe) & (MAX_STACKS - 1);
+    Stack &stack = table_->stacks[index];
+    if (stack.hash == 0) {
+      stack.hash = hash;
+      stack.depth = depth;
+      std::copy(frames, frames + depth, stack.frames);
+      table_->used[table_->used_count++] = static_cast<uint16_t>(index);
+    }
+    if (stack.hash == hash) {
+      ++stack.samples;
+      stack.bytes += bytes;
+      return;
+    }
+  }
+  ++table_->lost_samples;
+}
+
+void AllocationProfiler::on_script_start() noexcept {
+  if (!table_) {
+    return;
+  }
+  for (size_t i = 0; i < table_->used_count; ++i) {
+    Stack &stack = table_->stacks[table_->used[i]];
+    stack.hash = 0;
+    stack.depth = 0;
+    stack.samples = 0;
+    stack.bytes = 0;
+  }
+  table_->used_count = 0;
+  table_->lost_samples = 0;
+  out_of_memory_ = false;
+  dump_requested_ = false;
+  ++scripts_count_;
+}
+
+void AllocationProfiler::on_script_finish(bool memory_exceeded) noexcept {
+  if (!table_) {
+    return;
+  }
+  if (out_of_memory_) {
+    dump("out of memory");
+  } else if (memory_exceeded) {
+    dump("memory limit exceeded");
+  } else if (dump_requested_) {
+    dump("requested");
+  }
+}
+
+void AllocationProfiler::dump(const char *reason) noexcept {
+  std::vector<void *> unique_frames;
+  std::unordered_map<void *, size_t> frame_ids;
+  for (size_t i = 0; i < table_->used_count; ++i) {
+    const Stack &stack = table_->stacks[table_->used[i]];
+    for (uint32_t j = 0; j < stack.depth; ++j) {
+      if (frame_ids.emplace(stack.frames[j], unique_frames.size()).second) {
+        unique_frames.emplace_back(stack.frames[j]);
+      }
+    }
+  }
+
+  std::vector<std::string> frame_names;
+  frame_names.reserve(unique_frames.size());
+  if (!unique_frames.empty()) {
+    KphpBacktrace demangler{unique_frames.data(), static_cast<int32_t>(unique_frames.size())};
+    for (const char *name : demangler.make_demangled_backtrace_range()) {
+      if (name && *name) {
+        frame_names.emplace_back(name);
+      } else {
+        char address[32];
+        snprintf(address, sizeof(address), "%p", unique_frames[frame_names.size()]);
+        frame_names.emplace_back(address);
+      }
+    }
+  }
+  if (frame_names.size() != unique_frames.size()) {
+    log_server_error("Can't symbolize the allocation profile stacks");
+    return;
+  }
+
+  const std::string path = output_prefix_ + "." + std::to_string(getpid()) + "." + std::to_string(scripts_count_) + ".folded";
+  FILE *out = fopen(path.c_str(), "w");
+  if (!out) {
+    log_server_error("Can't open allocation profile output file '%s': %s", path.c_str(), strerror(errno));
+    return;
+  }
+  uint64_t total_bytes = 0;
+  for (size_t i = 0; i < table_->used_count; ++i) {
+    const Stack &stack = table_->stacks[table_->used[i]];
+    // the folded format expects the frames starting from the root
+    for (uint32_t j = stack.depth; j != 0; --j) {
+      fprintf(out, j == stack.depth ? "%s" : ";%s", frame_names[frame_ids[stack.frames[j - 1]]].c_str());
+    }
+    fprintf(out, " %" PRIu64 "\n", stack.bytes);
+    total_bytes += stack.bytes;
+  }
+  fclose(out);
+
+  if (table_->lost_samples) {
+    log_server_warning("Allocation profiler lost %" PRIu64 " samples due to the stacks table overflow", table_->lost_samples);
+  }
+  kprintf("Allocation profile of the script (%s, %" PRIu64 " bytes are estimated to be allocated) is written to '%s'\n", reason, total_bytes, path.c_str());
+}
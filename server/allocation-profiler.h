@@ -0,0 +1,76 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "common/mixin/not_copyable.h"
+#include "common/smart_ptrs/singleton.h"
+
+// Sampling profiler of the script allocations: the script allocator calls it once per about the given number of allocated bytes
+// (the intervals are randomized, so the periodic allocation patterns don't bias it), the allocation stack is unwound by frame pointers
+// and accumulated in the worker memory with the estimated number of allocated bytes.
+// The collected stacks of a script are dumped in the folded format (suitable for flamegraph.pl)
+// if the script runs out of the memory, exceeds the --worker-memory-to-reload or asks for it by kphp_allocation_profile_dump().
+class AllocationProfiler : vk::not_copyable {
+public:
+  static constexpr int MAX_STACK_DEPTH = 32;
+  static constexpr size_t MAX_STACKS = 1 << 10;
+
+  bool set_sampling_interval(int64_t bytes) noexcept;
+  bool set_workers_ratio(double ratio) noexcept;
+  void set_output_prefix(const char *prefix) noexcept;
+
+  bool enabled() const noexcept {
+    return sampling_interval_ > 0;
+  }
+
+  // the profiler is enabled in the part of the workers given by the ratio, it's chosen by the worker unique id
+  void start_in_worker(uint16_t worker_unique_id) noexcept;
+
+  bool request_dump() noexcept;
+
+  void on_script_start() noexcept;
+  void on_script_finish(bool memory_exceeded) noexcept;
+
+private:
+  struct Stack {
+    uint64_t hash{0};
+    uint32_t depth{0};
+    uint64_t samples{0};
+    uint64_t bytes{0};
+    void *frames[MAX_STACK_DEPTH];
+  };
+
+  struct StacksTable {
+    uint64_t lost_samples{0};
+    size_t used_count{0};
+    // the indexes of the used stacks, so the table is cleared without touching all of it
+    uint16_t used[MAX_STACKS];
+    Stack stacks[MAX_STACKS];
+  };
+
+  static int64_t sample(void *mem, size_t size) noexcept;
+
+  int64_t next_sampling_interval() noexcept;
+  void add_stack(void *const *frames, uint32_t depth, uint64_t bytes) noexcept;
+  void dump(const char *reason) noexcept;
+
+  int64_t sampling_interval_{0};
+  double workers_ratio_{1};
+  std::string output_prefix_{"kphp-allocation-profile"};
+
+  StacksTable *table_{nullptr};
+  uint64_t random_state_{0};
+  uint64_t scripts_count_{0};
+  bool out_of_memory_{false};
+  bool dump_requested_{false};
+
+  AllocationProfiler() = default;
+
+  friend class vk::singleton<AllocationProfiler>;
+};
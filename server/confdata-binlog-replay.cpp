@@ -521,6 +521,8 @@ private:
       return;
     }
     assert_correct_ref_counter(str);
+    // the workers can't cache the hash in the shared memory, so it's cached in advance
+    str.hash();
     str.set_reference_counter_to(ExtraRefCnt::for_confdata);
   }
 
@@ -21,6 +21,9 @@ constexpr size_t JOB_SHARED_MESSAGE_BYTES = 512 * 1024; // 512KB
 //    it is started from (2 * JOB_SHARED_MESSAGE_BYTES) Bytes and double for the next:
 //      0 => 1MB, 1 => 2MB, 2 => 4MB, 3 => 8MB, 4 => 16MB, 5 => 32MB, 6 => 64MB
 constexpr size_t JOB_EXTRA_MEMORY_BUFFER_BUCKETS = 7;
+// the response chunks of the streaming jobs can't take more than the half of the shared messages,
+//    so the other half is left for the requests and the final responses
+constexpr size_t JOB_RESPONSE_CHUNKS_MESSAGES_PART = 2;
 // the default multiplier for getting shared memory limit for job workers messaging:
 //    the default value for shared memory = the processes number * JOB_DEFAULT_MEMORY_LIMIT_PROCESS_MULTIPLIER
 constexpr size_t JOB_DEFAULT_MEMORY_LIMIT_PROCESS_MULTIPLIER = 8 * 1024 * 1024; // 8MB for 1 process
@@ -50,6 +53,10 @@ public:
   double job_timeout{-1.0};
   JobSharedMemoryPiece *common_job{nullptr};
   bool no_reply{false};
+  // the request: the client accepts the response chunks before the final response
+  bool stream_response{false};
+  // the response: it's a chunk, the job is still running
+  bool is_response_chunk{false};
 
   double job_deadline_time() const noexcept {
     return job_start_time + job_timeout;
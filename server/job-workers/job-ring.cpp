@@ -0,0 +1,251 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include "server/job-workers/job-ring.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#endif
+
+#include "common/macos-ports.h"
+#include "common/wrappers/memory-utils.h"
+
+#include "runtime/critical_section.h"
+
+namespace job_workers {
+
+bool JobWakeupFd::init(bool semaphore) noexcept {
+  semaphore_ = semaphore;
+#if defined(__linux__)
+  read_fd_ = write_fd_ = eventfd(0, EFD_NONBLOCK | (semaphore ? EFD_SEMAPHORE : 0));
+  return read_fd_ != -1;
+#else
+  int fds[2] = {-1, -1};
+  if (pipe2(fds, O_NONBLOCK) != 0) {
+    return false;
+  }
+  read_fd_ = fds[0];
+  write_fd_ = fds[1];
+  return true;
+#endif
+}
+
+bool JobWakeupFd::notify() const noexcept {
+#if defined(__linux__)
+  const uint64_t value = 1;
+  return write(write_fd_, &value, sizeof(value)) == sizeof(value);
+#else
+  const char value = 1;
+  // the full pipe wakes up the consumers anyway
+  return write(write_fd_, &value, sizeof(value)) == sizeof(value) || errno == EAGAIN;
+#endif
+}
+
+bool JobWakeupFd::consume() const noexcept {
+#if defined(__linux__)
+  uint64_t value = 0;
+  return read(read_fd_, &value, sizeof(value)) == sizeof(value);
+#else
+  char values[256];
+  const ssize_t read_bytes = read(read_fd_, values, semaphore_ ? 1 : sizeof(values));
+  if (!semaphore_) {
+    while (read(read_fd_, values, sizeof(values)) > 0) {
+    }
+  }
+  return read_bytes > 0;
+#endif
+}
+
+JobRing::JobRing(size_t capacity, uint16_t max_consumers, uint16_t max_producers, Cell *cells, std::atomic<bool> *sleeping,
+                 std::atomic<size_t> *producer_positions, std::atomic<size_t> *consumer_positions) noexcept
+  : mask_(capacity - 1)
+  , max_consumers_(max_consumers)
+  , max_producers_(max_producers)
+  , cells_(cells)
+  , sleeping_(sleeping)
+  , producer_positions_(producer_positions)
+  , consumer_positions_(consumer_positions) {
+  for (size_t i = 0; i < capacity; ++i) {
+    new(&cells_[i].sequence) std::atomic<size_t>{i};
+    new(&cells_[i].owner) std::atomic<size_t>{cell_owner(i, CellState::free)};
+    cells_[i].message = nullptr;
+  }
+  for (uint16_t i = 0; i < max_consumers; ++i) {
+    new(&sleeping_[i]) std::atomic<bool>{false};
+    new(&consumer_positions_[i]) std::atomic<size_t>{0};
+  }
+  for (uint16_t i = 0; i < max_producers; ++i) {
+    new(&producer_positions_[i]) std::atomic<size_t>{0};
+  }
+}
+
+JobRing *JobRing::create_in_shared_memory(size_t capacity, uint16_t max_consumers, uint16_t max_producers) noexcept {
+  assert(capacity > 1 && max_consumers > 0 && max_producers > 0);
+  size_t rounded_capacity = 2;
+  while (rounded_capacity < capacity) {
+    rounded_capacity <<= 1;
+  }
+  const size_t ring_size = (sizeof(JobRing) + alignof(Cell) - 1) / alignof(Cell) * alignof(Cell);
+  const size_t cells_size = rounded_capacity * sizeof(Cell);
+  const size_t positions_size = (max_producers + max_consumers) * sizeof(std::atomic<size_t>);
+  auto *mem = static_cast<uint8_t *>(mmap_shared(ring_size + cells_size + positions_size + max_consumers * sizeof(std::atomic<bool>)));
+  auto *cells = reinterpret_cast<Cell *>(mem + ring_size);
+  auto *producer_positions = reinterpret_cast<std::atomic<size_t> *>(mem + ring_size + cells_size);
+  auto *consumer_positions = producer_positions + max_producers;
+  auto *sleeping = reinterpret_cast<std::atomic<bool> *>(mem + ring_size + cells_size + positions_size);
+  return new(mem) JobRing{rounded_capacity, max_consumers, max_producers, cells, sleeping, producer_positions, consumer_positions};
+}
+
+bool JobRing::push(JobSharedMessage *message, uint16_t producer_id) noexcept {
+  assert(producer_id < max_producers_);
+  // a signal handler must not leave the cell taken, but not published
+  dl::CriticalSectionGuard critical_section;
+  Cell *cell = nullptr;
+  size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+  while (true) {
+    cell = &cells_[pos & mask_];
+    const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+    if (diff == 0) {
+      // the position is stored before the cell is taken, so the master finds the cell if the producer is killed right after taking it
+      producer_positions_[producer_id].store(pos + 1, std::memory_order_relaxed);
+      size_t owner = cell_owner(pos, CellState::free);
+      const bool taken = cell->owner.compare_exchange_strong(owner, cell_owner(pos, CellState::produced, producer_id), std::memory_order_relaxed);
+      // the producer which has taken the cell can be killed before moving the position, so everybody moves it
+      size_t expected_pos = pos;
+      enqueue_pos_.compare_exchange_strong(expected_pos, pos + 1, std::memory_order_relaxed);
+      if (taken) {
+        break;
+      }
+      pos = enqueue_pos_.load(std::memory_order_relaxed);
+    } else if (diff < 0) {
+      producer_positions_[producer_id].store(0, std::memory_order_relaxed);
+      return false;
+    } else {
+      size_t expected_pos = pos;
+      enqueue_pos_.compare_exchange_strong(expected_pos, pos + 1, std::memory_order_relaxed);
+      pos = enqueue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+  cell->message = message;
+  cell->sequence.store(pos + 1, std::memory_order_release);
+  producer_positions_[producer_id].store(0, std::memory_order_relaxed);
+  return true;
+}
+
+JobSharedMessage *JobRing::pop(uint16_t consumer_id) noexcept {
+  assert(consumer_id < max_consumers_);
+  dl::CriticalSectionGuard critical_section;
+  size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+  while (true) {
+    Cell *cell = &cells_[pos & mask_];
+    const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+    if (diff == 0) {
+      consumer_positions_[consumer_id].store(pos + 1, std::memory_order_relaxed);
+      size_t owner = cell->owner.load(std::memory_order_relaxed);
+      const bool skipped = owner == cell_owner(pos, CellState::skipped);
+      const bool produced = (owner >> OWNER_ID_BITS) == (cell_owner(pos, CellState::produced) >> OWNER_ID_BITS);
+      const bool taken = (skipped || produced)
+                         && cell->owner.compare_exchange_strong(owner, cell_owner(pos, CellState::consumed, consumer_id), std::memory_order_relaxed);
+      size_t expected_pos = pos;
+      dequeue_pos_.compare_exchange_strong(expected_pos, pos + 1, std::memory_order_relaxed);
+      if (taken) {
+        JobSharedMessage *message = cell->message;
+        release_cell(cell, pos);
+        consumer_positions_[consumer_id].store(0, std::memory_order_relaxed);
+        if (!skipped) {
+          return message;
+        }
+      }
+      pos = dequeue_pos_.load(std::memory_order_relaxed);
+    } else if (diff < 0) {
+      consumer_positions_[consumer_id].store(0, std::memory_order_relaxed);
+      return nullptr;
+    } else {
+      size_t expected_pos = pos;
+      dequeue_pos_.compare_exchange_strong(expected_pos, pos + 1, std::memory_order_relaxed);
+      pos = dequeue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+bool JobRing::skip_cell_of_dead_producer(uint16_t producer_id) noexcept {
+  assert(producer_id < max_producers_);
+  const size_t position = producer_positions_[producer_id].exchange(0, std::memory_order_relaxed);
+  if (!position) {
+    return false;
+  }
+  const size_t pos = position - 1;
+  Cell &cell = cells_[pos & mask_];
+  // the dead producer could fail to take the cell or could publish it before forgetting the position
+  if (cell.owner.load(std::memory_order_relaxed) != cell_owner(pos, CellState::produced, producer_id)
+      || cell.sequence.load(std::memory_order_acquire) != pos) {
+    return false;
+  }
+  size_t expected_pos = pos;
+  enqueue_pos_.compare_exchange_strong(expected_pos, pos + 1, std::memory_order_relaxed);
+  cell.message = nullptr;
+  cell.owner.store(cell_owner(pos, CellState::skipped), std::memory_order_relaxed);
+  cell.sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+bool JobRing::release_cell_of_dead_consumer(uint16_t consumer_id) noexcept {
+  assert(consumer_id < max_consumers_);
+  const size_t position = consumer_positions_[consumer_id].exchange(0, std::memory_order_relaxed);
+  if (!position) {
+    return false;
+  }
+  const size_t pos = position - 1;
+  Cell &cell = cells_[pos & mask_];
+  const size_t owner = cell.owner.load(std::memory_order_relaxed);
+  if (owner == cell_owner(pos, CellState::consumed, consumer_id)) {
+    // the message taken by the dead consumer is lost anyway
+    size_t expected_pos = pos;
+    dequeue_pos_.compare_exchange_strong(expected_pos, pos + 1, std::memory_order_relaxed);
+    release_cell(&cell, pos);
+    return true;
+  }
+  // the dead consumer could be killed in the middle of the cell releasing
+  size_t sequence = pos + 1;
+  return owner == cell_owner(pos + mask_ + 1, CellState::free)
+         && cell.sequence.compare_exchange_strong(sequence, pos + mask_ + 1, std::memory_order_release, std::memory_order_relaxed);
+}
+
+void JobRing::release_cell(Cell *cell, size_t pos) noexcept {
+  cell->owner.store(cell_owner(pos + mask_ + 1, CellState::free), std::memory_order_relaxed);
+  // the master can complete the releasing for the consumer killed right here, so the sequence is moved only once
+  size_t sequence = pos + 1;
+  cell->sequence.compare_exchange_strong(sequence, pos + mask_ + 1, std::memory_order_release, std::memory_order_relaxed);
+}
+
+bool JobRing::empty() const noexcept {
+  const size_t pos = dequeue_pos_.load(std::memory_order_acquire);
+  return cells_[pos & mask_].sequence.load(std::memory_order_acquire) != pos + 1;
+}
+
+void JobRing::go_to_sleep(uint16_t consumer_id) noexcept {
+  assert(consumer_id < max_consumers_);
+  if (!sleeping_[consumer_id].exchange(true, std::memory_order_relaxed)) {
+    sleeping_consumers_.fetch_add(1, std::memory_order_relaxed);
+  }
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void JobRing::wake_up(uint16_t consumer_id) noexcept {
+  assert(consumer_id < max_consumers_);
+  if (sleeping_[consumer_id].exchange(false, std::memory_order_relaxed)) {
+    sleeping_consumers_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+} // namespace job_workers
@@ -0,0 +1,114 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "common/mixin/not_copyable.h"
+
+namespace job_workers {
+
+struct JobSharedMessage;
+
+// The fd the sleeping consumers of a JobRing wait on in epoll: eventfd on Linux, pipe otherwise.
+// In the semaphore mode each notification wakes up one consumer, otherwise all the notifications are consumed at once.
+class JobWakeupFd {
+public:
+  bool init(bool semaphore) noexcept;
+
+  int get_read_fd() const noexcept {
+    return read_fd_;
+  }
+
+  bool notify() const noexcept;
+  // returns false if there are no notifications
+  bool consume() const noexcept;
+
+private:
+  int read_fd_{-1};
+  int write_fd_{-1};
+  bool semaphore_{false};
+};
+
+// Bounded lock-free queue of the job messages placed in the shared memory (the array based MPMC queue by D. Vyukov),
+// it's used as MPMC for the job requests and as MPSC for the job results of a client.
+// The consumers announce that they are going to sleep, so the producers notify the wakeup fd only if somebody sleeps,
+// and the busy consumers take the next message right from the ring without any syscalls.
+// A process killed between taking a cell and publishing or releasing it would stall the ring forever,
+// so the cells are taken by their owners first, and the master skips or releases the cells of the dead processes.
+class JobRing : vk::not_copyable {
+public:
+  // the capacity is rounded up to a power of two
+  static JobRing *create_in_shared_memory(size_t capacity, uint16_t max_consumers, uint16_t max_producers) noexcept;
+
+  bool push(JobSharedMessage *message, uint16_t producer_id) noexcept;
+  // the skipped cells are dropped silently
+  JobSharedMessage *pop(uint16_t consumer_id) noexcept;
+
+  // they are called by the master for the dead processes, return true if the stalled cell is found
+  bool skip_cell_of_dead_producer(uint16_t producer_id) noexcept;
+  bool release_cell_of_dead_consumer(uint16_t consumer_id) noexcept;
+
+  bool empty() const noexcept;
+
+  size_t get_capacity() const noexcept {
+    return mask_ + 1;
+  }
+
+  // the consumer must check the ring once more after it, otherwise the message pushed in between can be missed
+  void go_to_sleep(uint16_t consumer_id) noexcept;
+  // it's also called by the master for the dead consumers
+  void wake_up(uint16_t consumer_id) noexcept;
+
+  // the producer should notify the wakeup fd after the push if it returns true
+  bool has_sleeping_consumers() const noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return sleeping_consumers_.load(std::memory_order_relaxed) > 0;
+  }
+
+private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    // the position of the cell, the cell state and the id of the producer or the consumer, see cell_owner()
+    std::atomic<size_t> owner;
+    JobSharedMessage *message;
+  };
+
+  enum class CellState : size_t {
+    free,
+    produced,
+    skipped,
+    consumed
+  };
+
+  JobRing(size_t capacity, uint16_t max_consumers, uint16_t max_producers, Cell *cells, std::atomic<bool> *sleeping,
+          std::atomic<size_t> *producer_positions, std::atomic<size_t> *consumer_positions) noexcept;
+
+  static constexpr size_t CACHE_LINE_SIZE = 64;
+  static constexpr size_t OWNER_ID_BITS = 16;
+  static constexpr size_t CELL_STATE_BITS = 2;
+
+  static size_t cell_owner(size_t pos, CellState state, uint16_t id = 0) noexcept {
+    return (((pos << CELL_STATE_BITS) | static_cast<size_t>(state)) << OWNER_ID_BITS) | id;
+  }
+
+  void release_cell(Cell *cell, size_t pos) noexcept;
+
+  const size_t mask_{0};
+  const uint16_t max_consumers_{0};
+  const uint16_t max_producers_{0};
+  Cell *const cells_{nullptr};
+  std::atomic<bool> *const sleeping_{nullptr};
+  // the position + 1 each producer or consumer is going to take, the master finds the cells of the dead processes by them
+  std::atomic<size_t> *const producer_positions_{nullptr};
+  std::atomic<size_t> *const consumer_positions_{nullptr};
+  alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueue_pos_{0};
+  alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeue_pos_{0};
+  alignas(CACHE_LINE_SIZE) std::atomic<int32_t> sleeping_consumers_{0};
+};
+
+} // namespace job_workers
@@ -40,6 +40,12 @@ void JobStats::write_stats_to(stats_t *stats) const noexcept {
   stats->add_gauge_stat(job_queue_size, prefix, "jobs.queue_size");
   stats->add_gauge_stat(jobs_sent, prefix, "jobs.sent");
   stats->add_gauge_stat(jobs_replied, prefix, "jobs.replied");
+  stats->add_gauge_stat(jobs_wakeups, prefix, "jobs.wakeups");
+  stats->add_gauge_stat(job_results_wakeups, prefix, "jobs.results_wakeups");
+  stats->add_gauge_stat(job_response_chunks, prefix, "jobs.response_chunks");
+  stats->add_gauge_stat(job_response_chunks_throttled, prefix, "jobs.response_chunks_throttled");
+  stats->add_gauge_stat(numa_remote_job_requests, prefix, "jobs.numa_remote_requests");
+  stats->add_gauge_stat(numa_remote_message_acquires, prefix, "memory.messages.numa_remote_acquires");
 
   size_t currently_used = messages.write_stats_to(stats, "workers.job.memory.messages.shared_messages.", JOB_SHARED_MESSAGE_BYTES);
   constexpr std::array<const char *, JOB_EXTRA_MEMORY_BUFFER_BUCKETS> extra_memory_prefixes{
@@ -27,6 +27,17 @@ public:
   std::atomic<size_t> jobs_sent{0};
   std::atomic<size_t> jobs_replied{0};
   std::atomic<int32_t> job_queue_size{0};
+  // the notifications of the sleeping job workers and clients, the busy ones take the messages from the rings without them
+  std::atomic<size_t> jobs_wakeups{0};
+  std::atomic<size_t> job_results_wakeups{0};
+  // the response chunks of the streaming jobs, and the ones refused because of the lack of free shared messages
+  std::atomic<size_t> job_response_chunks{0};
+  std::atomic<size_t> job_response_chunks_throttled{0};
+
+  // with NUMA binding: the messages taken from the pool of another node because the local one is exhausted,
+  // and the jobs whose request message is placed on another node than the job worker
+  std::atomic<size_t> numa_remote_message_acquires{0};
+  std::atomic<size_t> numa_remote_job_requests{0};
 
   uint32_t unused_memory{0};
   size_t memory_limit{0};
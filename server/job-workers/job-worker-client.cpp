@@ -3,6 +3,8 @@
 // Distributed under the GPL v3 License, see LICENSE.notice.txt
 
 #include <cassert>
+#include <cerrno>
+#include <cstring>
 #include <unistd.h>
 
 #include "common/kprintf.h"
@@ -15,6 +17,7 @@
 #include "server/job-workers/job-workers-context.h"
 #include "server/job-workers/job-stats.h"
 #include "server/job-workers/shared-memory-manager.h"
+#include "server/php-engine-vars.h"
 #include "server/php-engine.h"
 #include "server/php-queries.h"
 #include "server/server-log.h"
@@ -25,7 +28,7 @@ int JobWorkerClient::read_job_results(int fd, void *data __attribute__((unused))
   vkprintf(3, "JobWorkerClient::read_job_results: fd=%d\n", fd);
 
   auto &job_worker_client = vk::singleton<JobWorkerClient>::get();
-  assert(fd == job_worker_client.read_job_result_fd);
+  assert(fd == job_worker_client.job_results_wakeup_fd->get_read_fd());
   if (ev->ready & EVT_SPEC) {
     log_server_error("job worker client special event: fd = %d, flags = %d", fd, ev->ready);
     // TODO:
@@ -36,69 +39,77 @@ int JobWorkerClient::read_job_results(int fd, void *data __attribute__((unused))
     return 0;
   }
 
-  PipeJobReader::ReadStatus status{};
-
-  do {
-    JobSharedMessage *job_result = nullptr;
-    status = job_worker_client.job_reader.read_job_result(job_result);
-    if (status == PipeJobReader::READ_FAIL) {
-      ++vk::singleton<SharedMemoryManager>::get().get_stats().errors_pipe_client_read;
-      return -1;
-    }
-    if (status == PipeJobReader::READ_OK) {
-      tvkprintf(job_workers, 2, "got job result: ready_job_id = %d, job_result_memory_ptr = %p\n", job_result->job_id, job_result);
-      vk::singleton<SharedMemoryManager>::get().attach_shared_message_to_this_proc(job_result);
-      const int event_status = create_job_worker_answer_event(job_result);
-      vk::singleton<SharedMemoryManager>::get().release_shared_message(job_result);
-      on_net_event(event_status);
-    }
-  } while (status != PipeJobReader::READ_BLOCK);
+  job_worker_client.job_results_wakeup_fd->consume();
+  job_worker_client.after_wakeup();
+  while (JobSharedMessage *job_result = job_worker_client.job_results_ring->pop(0)) {
+    tvkprintf(job_workers, 2, "got job result: ready_job_id = %d, job_result_memory_ptr = %p\n", job_result->job_id, job_result);
+    vk::singleton<SharedMemoryManager>::get().attach_shared_message_to_this_proc(job_result);
+    const int event_status = create_job_worker_answer_event(job_result);
+    vk::singleton<SharedMemoryManager>::get().release_shared_message(job_result);
+    on_net_event(event_status);
+  }
 
   return 0;
 }
 
-void JobWorkerClient::init(int job_result_slot) {
+void JobWorkerClient::init(int job_result_slot_to_set) {
   auto &job_workers_ctx = vk::singleton<JobWorkersContext>::get();
 
-  assert(job_workers_ctx.pipes_inited);
+  assert(job_workers_ctx.rings_inited);
 
-  write_job_fd = job_workers_ctx.job_pipe[1];
+  jobs_ring = job_workers_ctx.jobs_ring;
+  jobs_wakeup_fd = &job_workers_ctx.jobs_wakeup_fd;
+  job_result_slot = job_result_slot_to_set;
+  job_results_ring = job_workers_ctx.job_results_rings.at(job_result_slot);
+  job_results_wakeup_fd = &job_workers_ctx.job_results_wakeup_fds.at(job_result_slot);
 
-  for (int i = 0; i < job_workers_ctx.result_pipes.size(); ++i) {
-    auto &result_pipe = job_workers_ctx.result_pipes[i];
-    if (i == job_result_slot) {
-      read_job_result_fd = result_pipe[0];
-      job_result_fd_idx = job_result_slot;
-    } else {
-      close(result_pipe[0]); // this endpoint is for another client worker to read job result
-      clear_event(result_pipe[0]);
-    }
-  }
-
-  if (read_job_result_fd >= 0) {
-    epoll_sethandler(read_job_result_fd, 0, JobWorkerClient::read_job_results, nullptr);
-    epoll_insert(read_job_result_fd, EVT_READ | EVT_SPEC);
-    job_reader = PipeJobReader{read_job_result_fd};
-  }
+  const int read_fd = job_results_wakeup_fd->get_read_fd();
+  epoll_sethandler(read_fd, 0, JobWorkerClient::read_job_results, nullptr);
+  epoll_insert(read_fd, EVT_READ | EVT_SPEC);
+  // the previous client of this slot could die in the sleep
+  job_results_ring->wake_up(0);
 }
 
 int JobWorkerClient::send_job(JobSharedMessage *job_request) {
   slot_id_t job_id = parallel_job_ids_factory.create_slot();
 
-  tvkprintf(job_workers, 2, "sending job: <job_result_fd_idx, job_id> = <%d, %d> , job_memory_ptr = %p, write_job_fd = %d\n",
-            job_result_fd_idx, job_id, job_request, write_job_fd);
+  tvkprintf(job_workers, 2, "sending job: <job_result_slot, job_id> = <%d, %d> , job_memory_ptr = %p\n", job_result_slot, job_id, job_request);
 
   job_request->job_id = job_id;
-  job_request->job_result_fd_idx = job_result_fd_idx;
-  bool success = job_writer.write_job(job_request, write_job_fd);
-  if (!success) {
+  job_request->job_result_fd_idx = job_result_slot;
+  if (!jobs_ring->push(job_request, static_cast<uint16_t>(logname_id))) {
+    log_server_error("Fail on writing job: jobs queue is full");
     ++vk::singleton<SharedMemoryManager>::get().get_stats().errors_pipe_client_write;
     return -1;
   }
+  auto &stats = vk::singleton<SharedMemoryManager>::get().get_stats();
+  if (jobs_ring->has_sleeping_consumers()) {
+    ++stats.jobs_wakeups;
+    if (!jobs_wakeup_fd->notify()) {
+      log_server_error("Fail on waking up job workers: %s", strerror(errno));
+    }
+  }
 
-  ++vk::singleton<SharedMemoryManager>::get().get_stats().job_queue_size;
-  ++vk::singleton<SharedMemoryManager>::get().get_stats().jobs_sent;
+  ++stats.job_queue_size;
+  ++stats.jobs_sent;
   return job_id;
 }
 
+void JobWorkerClient::before_sleep() noexcept {
+  if (!is_inited()) {
+    return;
+  }
+  job_results_ring->go_to_sleep(0);
+  // the results pushed before the client fell asleep don't wake it up, so it wakes up itself
+  if (!job_results_ring->empty()) {
+    job_results_wakeup_fd->notify();
+  }
+}
+
+void JobWorkerClient::after_wakeup() noexcept {
+  if (is_inited()) {
+    job_results_ring->wake_up(0);
+  }
+}
+
 } // namespace job_workers
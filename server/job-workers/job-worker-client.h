@@ -9,7 +9,7 @@
 #include "common/algorithms/find.h"
 #include "common/mixin/not_copyable.h"
 #include "common/smart_ptrs/singleton.h"
-#include "server/job-workers/pipe-io.h"
+#include "server/job-workers/job-ring.h"
 
 typedef struct event_descr event_t;
 
@@ -24,20 +24,25 @@ class JobWorkerClient : vk::not_copyable {
 public:
   friend class vk::singleton<JobWorkerClient>;
 
-  int job_result_fd_idx{-1};
-  int read_job_result_fd{-1};
-  int write_job_fd{-1};
-  PipeJobWriter job_writer;
-  PipeJobReader job_reader;
+  int job_result_slot{-1};
+  JobRing *jobs_ring{nullptr};
+  const JobWakeupFd *jobs_wakeup_fd{nullptr};
+  JobRing *job_results_ring{nullptr};
+  const JobWakeupFd *job_results_wakeup_fd{nullptr};
 
   void init(int job_result_slot);
 
   bool is_inited() const {
-    return vk::none_of_equal(-1, job_result_fd_idx, read_job_result_fd, write_job_fd);
+    return job_result_slot != -1 && vk::none_of_equal(nullptr, jobs_ring, job_results_ring);
   }
 
   int send_job(JobSharedMessage *job_request);
 
+  // the worker event loop calls them around the events waiting,
+  // so the job workers notify the client about the results only if it sleeps
+  void before_sleep() noexcept;
+  void after_wakeup() noexcept;
+
 private:
   JobWorkerClient() = default;
 
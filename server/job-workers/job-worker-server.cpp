@@ -3,7 +3,9 @@
 // Distributed under the GPL v3 License, see LICENSE.notice.txt
 
 #include <cassert>
+#include <cerrno>
 #include <chrono>
+#include <cstring>
 
 #include "common/containers/final_action.h"
 #include "common/kprintf.h"
@@ -16,6 +18,7 @@
 #include "server/job-workers/job-worker-server.h"
 #include "server/job-workers/job-workers-context.h"
 #include "server/job-workers/shared-memory-manager.h"
+#include "server/php-engine-vars.h"
 #include "server/php-worker.h"
 #include "server/server-log.h"
 #include "server/server-stats.h"
@@ -128,29 +131,20 @@ int JobWorkerServer::job_parse_execute(connection *c) noexcept {
     return 0;
   }
 
-  JobSharedMessage *job = nullptr;
-  PipeJobReader::ReadStatus status = job_reader.read_job(job);
-
-  auto job_fd_rearmer = vk::finally([this]() {
-    rearm_read_job_fd(); // because > 1 workers can wake up on single job
-  });
-
-  if (status == PipeJobReader::READ_BLOCK) {
-    assert(errno == EWOULDBLOCK);
-    // another job worker has already taken the job (all job workers are readers for this fd)
-    // or there are no more jobs in pipe
-    tvkprintf(job_workers, 3, "No jobs in pipe after wakeup\n");
-    ++vk::singleton<SharedMemoryManager>::get().get_stats().job_worker_skip_job_due_steal;
+  JobSharedMessage *job = take_job();
+  if (!job) {
+    // another job worker has already taken the job (all the sleeping job workers are woken up by the single notification)
+    // or there are no more jobs in the ring
+    tvkprintf(job_workers, 3, "No jobs in ring after wakeup\n");
+    rearm_read_job_fd();
     return 0;
-  } else if (status == PipeJobReader::READ_FAIL) {
-    ++vk::singleton<SharedMemoryManager>::get().get_stats().errors_pipe_server_read;
-    return -1;
   }
 
-  job_fd_rearmer.disable();
-
   auto &memory_manager = vk::singleton<job_workers::SharedMemoryManager>::get();
   --memory_manager.get_stats().job_queue_size;
+  if (!memory_manager.is_numa_local_message(job)) {
+    ++memory_manager.get_stats().numa_remote_job_requests;
+  }
   memory_manager.attach_shared_message_to_this_proc(job);
   if (job->common_job) {
     memory_manager.attach_shared_message_to_this_proc(job->common_job);
@@ -186,24 +180,56 @@ int JobWorkerServer::job_parse_execute(connection *c) noexcept {
 }
 
 void JobWorkerServer::init() noexcept {
-  const auto &job_workers_ctx = vk::singleton<JobWorkersContext>::get();
+  auto &job_workers_ctx = vk::singleton<JobWorkersContext>::get();
 
-  assert(job_workers_ctx.pipes_inited);
+  assert(job_workers_ctx.rings_inited);
 
-  read_job_fd = job_workers_ctx.job_pipe[0];
+  jobs_ring = job_workers_ctx.jobs_ring;
+  jobs_wakeup_fd = &job_workers_ctx.jobs_wakeup_fd;
+  consumer_id = static_cast<uint16_t>(logname_id);
 
-  read_job_connection = epoll_insert_pipe(pipe_for_read, read_job_fd, &php_jobs_server, nullptr, EPOLL_FLAGS);
+  read_job_connection = epoll_insert_pipe(pipe_for_read, jobs_wakeup_fd->get_read_fd(), &php_jobs_server, nullptr, EPOLL_FLAGS);
   assert(read_job_connection);
   memset(read_job_connection->custom_data, 0, sizeof(read_job_connection->custom_data));
 
   tvkprintf(job_workers, 1, "insert read job connection [fd = %d] to epoll\n", read_job_connection->fd);
 
-  job_reader = PipeJobReader{read_job_fd};
+  // the jobs sent while there were no sleeping job workers don't wake anybody up
+  sleeping = true;
+  jobs_ring->go_to_sleep(consumer_id);
+  if (!jobs_ring->empty()) {
+    jobs_wakeup_fd->notify();
+  }
 }
 
 void JobWorkerServer::rearm_read_job_fd() noexcept {
   // We need to rearm fd because we use EPOLLONESHOT
-  epoll_insert(read_job_fd, EPOLL_FLAGS);
+  epoll_insert(jobs_wakeup_fd->get_read_fd(), EPOLL_FLAGS);
+}
+
+JobSharedMessage *JobWorkerServer::take_job() noexcept {
+  auto &stats = vk::singleton<SharedMemoryManager>::get().get_stats();
+  const bool was_sleeping = sleeping;
+  if (sleeping) {
+    sleeping = false;
+    jobs_ring->wake_up(consumer_id);
+    jobs_wakeup_fd->consume();
+  }
+
+  // the busy job worker takes the next job right after the previous one without any syscalls
+  JobSharedMessage *job = jobs_ring->pop(consumer_id);
+  if (!job) {
+    sleeping = true;
+    jobs_ring->go_to_sleep(consumer_id);
+    // the job could be sent before the job worker fell asleep, then nobody wakes it up
+    if ((job = jobs_ring->pop(consumer_id))) {
+      sleeping = false;
+      jobs_ring->wake_up(consumer_id);
+    } else if (was_sleeping) {
+      ++stats.job_worker_skip_job_due_steal;
+    }
+  }
+  return job;
 }
 
 void JobWorkerServer::reset_running_job() noexcept {
@@ -218,20 +244,39 @@ const char *JobWorkerServer::send_job_reply(JobSharedMessage *job_response) noex
   if (!reply_is_expected()) {
     return reply_was_sent ? "The reply has been already sent" : "Job has no-reply flag";
   }
+  if (job_response->is_response_chunk && !running_job->stream_response) {
+    return "Job isn't started as a stream";
+  }
 
-  int write_job_result_fd = vk::singleton<JobWorkersContext>::get().result_pipes.at(running_job->job_result_fd_idx)[1];
+  auto &job_workers_ctx = vk::singleton<JobWorkersContext>::get();
+  const size_t job_result_slot = running_job->job_result_fd_idx;
+  JobRing *job_results_ring = job_workers_ctx.job_results_rings.at(job_result_slot);
   job_response->job_id = running_job->job_id;
 
-  const auto &job_memory_stats = job_response->resource.get_memory_stats();
-  job_stat.job_response_max_real_memory_used = job_memory_stats.max_real_memory_used;
-  job_stat.job_response_max_memory_used = job_memory_stats.max_memory_used;
+  if (!job_response->is_response_chunk) {
+    const auto &job_memory_stats = job_response->resource.get_memory_stats();
+    job_stat.job_response_max_real_memory_used = job_memory_stats.max_real_memory_used;
+    job_stat.job_response_max_memory_used = job_memory_stats.max_memory_used;
+  }
 
   int32_t job_response_id = job_response->job_id;
-  if (!job_writer.write_job_result(job_response, write_job_result_fd)) {
-    ++vk::singleton<SharedMemoryManager>::get().get_stats().errors_pipe_server_write;
-    return "Can't write job reply to the pipe";
+  auto &stats = vk::singleton<SharedMemoryManager>::get().get_stats();
+  if (!job_results_ring->push(job_response, static_cast<uint16_t>(logname_id))) {
+    ++stats.errors_pipe_server_write;
+    return "Can't write job reply to the ring: it is full";
+  }
+  if (job_results_ring->has_sleeping_consumers()) {
+    ++stats.job_results_wakeups;
+    if (!job_workers_ctx.job_results_wakeup_fds.at(job_result_slot).notify()) {
+      log_server_error("Fail on waking up job worker client: %s", strerror(errno));
+    }
+  }
+  if (job_response->is_response_chunk) {
+    ++stats.job_response_chunks;
+    tvkprintf(job_workers, 2, "send job response chunk: ready_job_id = %d, job_result_memory_ptr = %p\n", job_response_id, job_response);
+    return nullptr;
   }
-  ++vk::singleton<SharedMemoryManager>::get().get_stats().jobs_replied;
+  ++stats.jobs_replied;
   reply_was_sent = true;
   tvkprintf(job_workers, 2, "send job response: ready_job_id = %d, job_result_memory_ptr = %p\n", job_response_id, job_response);
 
@@ -9,7 +9,7 @@
 #include "common/mixin/not_copyable.h"
 #include "common/smart_ptrs/singleton.h"
 #include "common/timer.h"
-#include "server/job-workers/pipe-io.h"
+#include "server/job-workers/job-ring.h"
 
 struct connection;
 
@@ -50,11 +50,14 @@ public:
 
 private:
   const char *send_job_reply(JobSharedMessage *response) noexcept;
+  JobSharedMessage *take_job() noexcept;
 
   JobSharedMessage *running_job{nullptr};
-  PipeJobWriter job_writer;
-  PipeJobReader job_reader;
-  int read_job_fd{-1};
+  JobRing *jobs_ring{nullptr};
+  const JobWakeupFd *jobs_wakeup_fd{nullptr};
+  // the job worker unique id
+  uint16_t consumer_id{0};
+  bool sleeping{false};
   connection *read_job_connection{nullptr};
   bool reply_was_sent{false};
 
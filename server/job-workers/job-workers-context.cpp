@@ -2,44 +2,72 @@
 // Copyright (c) 2020 LLC «V Kontakte»
 // Distributed under the GPL v3 License, see LICENSE.notice.txt
 
+#include <algorithm>
 #include <cassert>
 #include <cerrno>
 #include <cstring>
-#include <fcntl.h>
-#include <unistd.h>
 
-#include "common/macos-ports.h"
 #include "server/job-workers/job-workers-context.h"
+#include "server/job-workers/shared-memory-manager.h"
 #include "server/server-log.h"
+#include "server/workers-control.h"
 
 DEFINE_VERBOSITY(job_workers);
 
 namespace job_workers {
 
-void JobWorkersContext::master_init_pipes(int job_result_slots_num) {
-  if (pipes_inited) {
+void JobWorkersContext::master_init_rings(int job_result_slots_num) {
+  if (rings_inited) {
     return;
   }
 
-  int err = pipe2(job_pipe.data(), O_NONBLOCK);
-  if (err) {
-    log_server_critical("Unable to create job pipe: %s", strerror(errno));
+  const auto &memory_manager = vk::singleton<SharedMemoryManager>::get();
+  assert(memory_manager.is_initialized());
+  const size_t messages_count = memory_manager.get_messages_count();
+  jobs_ring = JobRing::create_in_shared_memory(messages_count, WorkersControl::max_workers_count, WorkersControl::max_workers_count);
+  // each wakeup takes one job, so the other sleeping job workers aren't woken up for nothing
+  if (!jobs_wakeup_fd.init(true)) {
+    log_server_critical("Unable to create jobs wakeup fd: %s", strerror(errno));
     assert(false);
     return;
   }
 
-  result_pipes.resize(job_result_slots_num);
-  for (int i = 0; i < result_pipes.size(); ++i) {
-    auto &result_pipe = result_pipes.at(i);
-    err = pipe2(result_pipe.data(), O_NONBLOCK);
-    if (err) {
-      log_server_critical("Unable to create job result pipe: %s", strerror(errno));
+  job_results_rings.resize(job_result_slots_num);
+  job_results_wakeup_fds.resize(job_result_slots_num);
+  for (int i = 0; i < job_result_slots_num; ++i) {
+    job_results_rings[i] = JobRing::create_in_shared_memory(std::min(messages_count, JOB_RESULTS_RING_MAX_CAPACITY), 1, WorkersControl::max_workers_count);
+    if (!job_results_wakeup_fds[i].init(false)) {
+      log_server_critical("Unable to create job results wakeup fd: %s", strerror(errno));
       assert(false);
       return;
     }
   }
 
-  pipes_inited = true;
+  rings_inited = true;
+}
+
+void JobWorkersContext::master_on_worker_terminated(uint16_t worker_unique_id) noexcept {
+  if (rings_inited) {
+    jobs_ring->wake_up(worker_unique_id);
+    if (jobs_ring->release_cell_of_dead_consumer(worker_unique_id)) {
+      log_server_warning("Release the jobs ring cell stalled by the dead worker #%d", worker_unique_id);
+    }
+    if (worker_unique_id < job_results_rings.size()) {
+      job_results_rings[worker_unique_id]->wake_up(0);
+      if (job_results_rings[worker_unique_id]->release_cell_of_dead_consumer(0)) {
+        log_server_warning("Release the job results ring cell stalled by the dead worker #%d", worker_unique_id);
+      }
+    }
+    // both the clients and the job workers push into the rings
+    if (jobs_ring->skip_cell_of_dead_producer(worker_unique_id)) {
+      log_server_warning("Skip the jobs ring cell stalled by the dead worker #%d", worker_unique_id);
+    }
+    for (size_t i = 0; i != job_results_rings.size(); ++i) {
+      if (job_results_rings[i]->skip_cell_of_dead_producer(worker_unique_id)) {
+        log_server_warning("Skip the job results ring #%zu cell stalled by the dead worker #%d", i, worker_unique_id);
+      }
+    }
+  }
 }
 
 } // namespace job_workers
@@ -4,14 +4,14 @@
 
 #pragma once
 
-#include <array>
 #include <cstddef>
-#include <queue>
-#include <unordered_set>
+#include <cstdint>
+#include <vector>
 
 #include "common/kprintf.h"
 #include "common/mixin/not_copyable.h"
 #include "common/smart_ptrs/singleton.h"
+#include "server/job-workers/job-ring.h"
 #include "server/job-workers/job-worker-server.h"
 
 DECLARE_VERBOSITY(job_workers);
@@ -24,21 +24,28 @@ namespace job_workers {
 class JobWorkersContext : vk::not_copyable {
 public:
   friend class vk::singleton<JobWorkersContext>;
-  using Pipe = std::array<int, 2>;
 
-  Pipe job_pipe{};
-  std::vector<Pipe> result_pipes;
-  bool pipes_inited{false};
+  // the jobs ring fits all the shared messages, so it is never full;
+  // a client hardly waits for more jobs at once, the results ring overflow is reported as the job reply error
+  static constexpr size_t JOB_RESULTS_RING_MAX_CAPACITY = 1 << 12;
 
-  void master_init_pipes(int job_result_slots_num);
+  // the job workers consume the jobs ring, they are identified by the worker unique id
+  JobRing *jobs_ring{nullptr};
+  JobWakeupFd jobs_wakeup_fd;
+  // each client worker consumes its own job results ring
+  std::vector<JobRing *> job_results_rings;
+  std::vector<JobWakeupFd> job_results_wakeup_fds;
+  bool rings_inited{false};
+
+  // the rings are sized by the shared messages count, so the shared memory manager must be initialized before
+  void master_init_rings(int job_result_slots_num);
+
+  // a dead worker could fall asleep waiting for the jobs or the job results, it mustn't be woken up anymore;
+  // it also could be killed in the middle of a push or a pop, then the cell it has taken is skipped or released
+  void master_on_worker_terminated(uint16_t worker_unique_id) noexcept;
 
 private:
-  JobWorkersContext() {
-    job_pipe.fill(-1);
-    for (auto &result_pipe : result_pipes) {
-      result_pipe.fill(-1);
-    }
-  }
+  JobWorkersContext() = default;
 };
 
 } // namespace job_workers
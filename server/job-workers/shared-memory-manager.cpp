@@ -2,8 +2,12 @@
 // Copyright (c) 2021 LLC «V Kontakte»
 // Distributed under the GPL v3 License, see LICENSE.notice.txt
 
+#include <algorithm>
+#include <unistd.h>
+
 #include "common/wrappers/memory-utils.h"
 
+#include "server/numa-configuration.h"
 #include "server/php-engine-vars.h"
 #include "server/workers-control.h"
 
@@ -32,10 +36,30 @@ void SharedMemoryManager::init() noexcept {
   const uint32_t messages_count = std::min(shared_messages_count_, left_memory / sizeof(JobSharedMessage));
   control_block_ = new(raw_mem) ControlBlock{};
   raw_mem += sizeof(ControlBlock);
-  for (uint32_t i = 0; i != messages_count; ++i) {
-    freelist_put(&control_block_->free_messages, raw_mem);
-    raw_mem += sizeof(JobSharedMessage);
+
+  const auto &numa = vk::singleton<NumaConfiguration>::get();
+  const size_t pools_count = numa.enabled() ? std::min(numa.get_numa_nodes().size(), MAX_MESSAGE_POOLS) : 1;
+  const auto page_size = static_cast<uintptr_t>(getpagesize());
+  control_block_->message_pools_count = pools_count;
+  for (size_t pool = 0; pool != pools_count; ++pool) {
+    uint8_t *pool_begin = raw_mem + sizeof(JobSharedMessage) * (messages_count * pool / pools_count);
+    uint8_t *pool_end = raw_mem + sizeof(JobSharedMessage) * (messages_count * (pool + 1) / pools_count);
+    control_block_->message_pool_bounds[pool] = pool_begin;
+    if (pools_count > 1) {
+      // the pool is bound before the freelist is built, as building it faults the pages in;
+      // the pages on the pool borders stay on the node they happen to be faulted in
+      const uintptr_t bind_begin = (reinterpret_cast<uintptr_t>(pool_begin) + page_size - 1) & ~(page_size - 1);
+      const uintptr_t bind_end = reinterpret_cast<uintptr_t>(pool_end) & ~(page_size - 1);
+      if (bind_begin < bind_end) {
+        numa.bind_memory_to_numa_node(reinterpret_cast<void *>(bind_begin), bind_end - bind_begin, numa.get_numa_nodes()[pool]);
+      }
+    }
+    for (uint8_t *message = pool_begin; message != pool_end; message += sizeof(JobSharedMessage)) {
+      freelist_put(&control_block_->free_messages[pool], message);
+    }
   }
+  raw_mem += sizeof(JobSharedMessage) * messages_count;
+  control_block_->message_pool_bounds[pools_count] = raw_mem;
 
   std::array<memory_resource::extra_memory_raw_bucket, JOB_EXTRA_MEMORY_BUFFER_BUCKETS> extra_memory;
   control_block_->stats.unused_memory = memory_resource::distribute_memory(extra_memory, shared_messages_count_ / 2, raw_mem,
@@ -102,11 +126,20 @@ void SharedMemoryManager::release_shared_message(JobMetadata *message) noexcept
       freelist_put(&control_block_->free_extra_memory[i], releasing_extra_memory);
       ++control_block_->stats.extra_memory[i].released;
     }
-    freelist_put(&control_block_->free_messages, message);
+    freelist_put(&control_block_->free_messages[get_message_pool(message)], message);
     ++control_block_->stats.messages.released;
   }
 }
 
+bool SharedMemoryManager::can_acquire_message_for_response_chunk() const noexcept {
+  assert(control_block_);
+  const auto &messages = control_block_->stats.messages;
+  const size_t acquired = messages.acquired.load(std::memory_order_relaxed);
+  const size_t released = messages.released.load(std::memory_order_relaxed);
+  const size_t used = acquired > released ? acquired - released : 0;
+  return used < messages.count - messages.count / JOB_RESPONSE_CHUNKS_MESSAGES_PART;
+}
+
 void SharedMemoryManager::attach_shared_message_to_this_proc(JobMetadata *message) noexcept {
   assert(message->owners_counter);
   dl::CriticalSectionGuard critical_section;
@@ -157,4 +190,44 @@ JobStats &SharedMemoryManager::get_stats() noexcept {
   return control_block_->stats;
 }
 
+size_t SharedMemoryManager::get_messages_count() const noexcept {
+  assert(control_block_);
+  return control_block_->stats.messages.count;
+}
+
+bool SharedMemoryManager::is_numa_local_message(const JobMetadata *message) const noexcept {
+  assert(control_block_);
+  return control_block_->message_pools_count == 1 || get_message_pool(message) == get_this_process_message_pool();
+}
+
+void *SharedMemoryManager::acquire_free_message() noexcept {
+  // the local pool is tried first, then the pools of the other nodes
+  const size_t pools_count = control_block_->message_pools_count;
+  const size_t local_pool = get_this_process_message_pool();
+  for (size_t i = 0; i != pools_count; ++i) {
+    const size_t pool = (local_pool + i) % pools_count;
+    if (void *free_mem = freelist_get(&control_block_->free_messages[pool])) {
+      if (pool != local_pool) {
+        ++control_block_->stats.numa_remote_message_acquires;
+      }
+      return free_mem;
+    }
+  }
+  return nullptr;
+}
+
+size_t SharedMemoryManager::get_message_pool(const void *message) const noexcept {
+  const auto &bounds = control_block_->message_pool_bounds;
+  const auto *pool_end = std::upper_bound(bounds.begin() + 1, bounds.begin() + control_block_->message_pools_count, message,
+                                          [](const void *m, const uint8_t *bound) { return m < bound; });
+  return pool_end - bounds.begin() - 1;
+}
+
+size_t SharedMemoryManager::get_this_process_message_pool() const noexcept {
+  if (control_block_->message_pools_count == 1) {
+    return 0;
+  }
+  return vk::singleton<NumaConfiguration>::get().get_worker_numa_node_index(logname_id) % control_block_->message_pools_count;
+}
+
 } // namespace job_workers
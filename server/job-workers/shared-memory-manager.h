@@ -63,7 +63,7 @@ public:
   JobMessageT *acquire_shared_message() noexcept {
     assert(control_block_);
     dl::CriticalSectionGuard critical_section;
-    if (void *free_mem = freelist_get(&control_block_->free_messages)) {
+    if (void *free_mem = acquire_free_message()) {
       auto *message = new(free_mem) JobMessageT{};
       control_block_->workers_table[logname_id].attach(message);
       ++control_block_->stats.messages.acquired;
@@ -75,6 +75,9 @@ public:
 
   void release_shared_message(JobMetadata *message) noexcept;
 
+  // the backpressure for the streaming jobs: a response chunk is sent only if there are enough free shared messages
+  bool can_acquire_message_for_response_chunk() const noexcept;
+
   void attach_shared_message_to_this_proc(JobMetadata *message) noexcept;
   void detach_shared_message_from_this_proc(JobMetadata *message) noexcept;
 
@@ -89,6 +92,11 @@ public:
 
   JobStats &get_stats() noexcept;
 
+  size_t get_messages_count() const noexcept;
+
+  // checks if the message is placed on the NUMA node of this process
+  bool is_numa_local_message(const JobMetadata *message) const noexcept;
+
   bool is_initialized() const noexcept {
     return control_block_;
   }
@@ -103,9 +111,13 @@ private:
   size_t per_process_memory_limit_{0};
   size_t shared_messages_count_process_multiplier_{0};
 
+  static constexpr size_t MAX_MESSAGE_POOLS = 8;
+
   struct alignas(8) ControlBlock {
     ControlBlock() noexcept {
-      freelist_init(&free_messages);
+      for (auto &free_pool_messages : free_messages) {
+        freelist_init(&free_pool_messages);
+      }
       for (auto &free_mem : free_extra_memory) {
         freelist_init(&free_mem);
       }
@@ -113,13 +125,22 @@ private:
 
     JobStats stats;
     std::array<WorkerProcessMeta, WorkersControl::max_workers_count> workers_table{};
-    freelist_t free_messages{};
+
+    // with NUMA binding the messages are split into the pools placed on the nodes of the workers, otherwise there is one pool;
+    // the messages of pool i are in [message_pool_bounds[i], message_pool_bounds[i + 1])
+    size_t message_pools_count{1};
+    std::array<uint8_t *, MAX_MESSAGE_POOLS + 1> message_pool_bounds{};
+    std::array<freelist_t, MAX_MESSAGE_POOLS> free_messages{};
 
     //  index => (1 << index) MB:
     //    0 => 1MB, 1 => 2MB, 2 => 4MB, 3 => 8MB, 4 => 16MB, 5 => 32MB, 6 => 64MB
     std::array<freelist_t, JOB_EXTRA_MEMORY_BUFFER_BUCKETS> free_extra_memory{};
   };
   ControlBlock *control_block_{nullptr};
+
+  void *acquire_free_message() noexcept;
+  size_t get_message_pool(const void *message) const noexcept;
+  size_t get_this_process_message_pool() const noexcept;
 };
 
 inline bool request_extra_shared_memory(memory_resource::unsynchronized_pool_resource &resource, size_t required_size) noexcept {
@@ -84,5 +84,20 @@ bool NumaConfiguration::enabled() const {
 }
 
 int NumaConfiguration::get_worker_numa_node(int worker_index) const {
-  return numa_nodes[worker_index % numa_nodes.size()];
+  return numa_nodes[get_worker_numa_node_index(worker_index)];
+}
+
+size_t NumaConfiguration::get_worker_numa_node_index(int worker_index) const {
+  return worker_index % numa_nodes.size();
+}
+
+const std::vector<int> &NumaConfiguration::get_numa_nodes() const {
+  return numa_nodes;
+}
+
+void NumaConfiguration::bind_memory_to_numa_node([[maybe_unused]] void *mem, [[maybe_unused]] size_t size, [[maybe_unused]] int numa_node_id) const {
+#if !defined(__APPLE__)
+  assert(numa_available() >= 0);
+  numa_tonode_memory(mem, size, numa_node_id);
+#endif
 }
@@ -22,8 +22,13 @@ public:
   bool add_numa_node(int numa_node_id, const bitmask *cpu_mask);
   bool enabled() const;
   int get_worker_numa_node(int worker_index) const;
+  // the index of the worker NUMA node in get_numa_nodes()
+  size_t get_worker_numa_node_index(int worker_index) const;
+  const std::vector<int> &get_numa_nodes() const;
   void distribute_worker(int worker_index) const;
   void set_memory_policy(MemoryPolicy policy);
+  // places the pages of the memory range on the NUMA node, it's inherited by the forked processes for the shared memory
+  void bind_memory_to_numa_node(void *mem, size_t size, int numa_node_id) const;
 
 private:
   std::vector<int> numa_nodes;
@@ -58,6 +58,8 @@ int force_clear_sql_connection = 0;
 long long static_buffer_length_limit = -1;
 int use_madvise_dontneed = 0;
 long long memory_used_to_recreate_script = LLONG_MAX;
+long long worker_prewarm_memory = 0;
+bool http_accept_only_when_idle = false;
 double sigterm_wait_timeout = 0.1;
 
 /***
@@ -69,6 +69,8 @@ extern int force_clear_sql_connection;
 extern long long static_buffer_length_limit;
 extern int use_madvise_dontneed;
 extern long long memory_used_to_recreate_script;
+extern long long worker_prewarm_memory;
+extern bool http_accept_only_when_idle;
 
 extern double sigterm_wait_timeout;
 constexpr double SIGTERM_MAX_TIMEOUT = 10.0;
@@ -55,10 +55,13 @@
 #include "net/net-tcp-rpc-client.h"
 #include "net/net-tcp-rpc-server.h"
 
+#include "runtime/allocator.h"
 #include "runtime/interface.h"
 #include "runtime/profiler.h"
 #include "runtime/rpc.h"
 #include "runtime/json-functions.h"
+#include "runtime/kphp-ml.h"
+#include "runtime/script-phases.h"
 #include "server/cluster-name.h"
 #include "server/confdata-binlog-replay.h"
 #include "server/database-drivers/adaptor.h"
@@ -81,10 +84,13 @@
 #include "server/php-runner.h"
 #include "server/php-sql-connections.h"
 #include "server/php-worker.h"
+#include "server/sampling-profiler.h"
+#include "server/allocation-profiler.h"
 #include "server/server-log.h"
 #include "server/server-stats.h"
 #include "server/statshouse/statshouse-client.h"
 #include "server/statshouse/worker-stats-buffer.h"
+#include "server/workers-autoscaler.h"
 #include "server/workers-control.h"
 
 using job_workers::JobWorkersContext;
@@ -494,6 +500,17 @@ void hts_stop() {
   hts_stopped = 1;
 }
 
+void hts_set_accept_paused(bool paused) {
+  // the job workers run the scripts too, but they don't listen the http socket
+  if (!http_accept_only_when_idle || hts_stopped || process_type == ProcessType::job_worker) {
+    return;
+  }
+  int http_sfd = vk::singleton<HttpServerContext>::get().worker_http_socket_fd();
+  if (http_sfd != -1) {
+    set_special_connections_accept_paused(http_sfd, paused);
+  }
+}
+
 void hts_at_query_end(connection *c, bool check_keep_alive) {
   hts_data *D = HTS_DATA (c);
 
@@ -1538,6 +1555,9 @@ void generic_event_loop(WorkerType worker_type, bool init_and_listen_rpc_port) n
 
   dl_allow_all_signals();
 
+  prewarm_php_script();
+  vk::singleton<ServerStats>::get().on_worker_ready();
+
   vkprintf (1, "Server started\n");
   for (int i = 0; !(pending_signals & ~((1ll << SIGUSR1) | (1ll << SIGHUP))); i++) {
     if (verbosity > 0 && !(i & 255)) {
@@ -1545,7 +1565,9 @@ void generic_event_loop(WorkerType worker_type, bool init_and_listen_rpc_port) n
                 active_connections, maxconn, NB_used, NB_alloc, NB_max);
     }
 
+    vk::singleton<JobWorkerClient>::get().before_sleep();
     epoll_work(57);
+    vk::singleton<JobWorkerClient>::get().after_wakeup();
 
     if (precise_now > next_create_outbound) {
       create_all_outbound_connections();
@@ -1661,10 +1683,15 @@ void init_all() {
   }
 
   global_init_runtime_libs();
-  global_init_php_scripts();
+  {
+    // the constants are built once here and shared with the forked workers
+    dl::ConstantsRegionGuard constants_region_guard;
+    global_init_php_scripts();
+  }
   global_init_script_allocator();
 
   init_handlers();
+  vk::singleton<SamplingProfiler>::get().init();
 
   init_drivers();
 
@@ -2045,6 +2072,11 @@ int main_args_handler(int i, const char *long_option) {
       return 0;
     }
     case 2025: {
+      std::string error;
+      if (!load_xgboost_model(optarg, error)) {
+        kprintf("--%s option: couldn't load XGBoost model '%s': %s\n", long_option, optarg, error.c_str());
+        return -1;
+      }
       return 0;
     }
     case 2026: {
@@ -2162,6 +2194,72 @@ int main_args_handler(int i, const char *long_option) {
       runtime_config = std::move(config);
       return 0;
     }
+    case 2033: {
+      ScriptPhasesStats::enable();
+      return 0;
+    }
+    case 2034: {
+      if (!vk::singleton<SamplingProfiler>::get().set_frequency(atoi(optarg))) {
+        kprintf("--%s option: frequency should be in range [1, 10000]\n", long_option);
+        return -1;
+      }
+      return 0;
+    }
+    case 2035: {
+      vk::singleton<SamplingProfiler>::get().set_output_path(optarg);
+      return 0;
+    }
+    case 2036: {
+      if (!vk::singleton<SamplingProfiler>::get().set_dump_period(atoi(optarg))) {
+        kprintf("--%s option: couldn't parse argument\n", long_option);
+        return -1;
+      }
+      return 0;
+    }
+    case 2037: {
+      worker_prewarm_memory = parse_memory_limit(optarg);
+      if (worker_prewarm_memory <= 0) {
+        kprintf("--%s option: couldn't parse argument\n", long_option);
+        return -1;
+      }
+      return 0;
+    }
+    case 2038: {
+      http_accept_only_when_idle = true;
+      return 0;
+    }
+    case 2039: {
+      double min_ratio = 0;
+      double max_ratio = 0;
+      if (sscanf(optarg, "%lf,%lf", &min_ratio, &max_ratio) != 2
+          || !vk::singleton<WorkersAutoscaler>::get().set_job_workers_ratio_bounds(min_ratio, max_ratio)) {
+        kprintf("--%s option: expected 'min,max' job workers ratios, 0 <= min < max < 1\n", long_option);
+        return -1;
+      }
+      return 0;
+    }
+    case 2040: {
+      WarmUpContext::get().set_instance_cache_snapshot_path(optarg);
+      return 0;
+    }
+    case 2041: {
+      if (!vk::singleton<AllocationProfiler>::get().set_sampling_interval(parse_memory_limit(optarg))) {
+        kprintf("--%s option: couldn't parse argument\n", long_option);
+        return -1;
+      }
+      return 0;
+    }
+    case 2042: {
+      if (!vk::singleton<AllocationProfiler>::get().set_workers_ratio(atof(optarg))) {
+        kprintf("--%s option: ratio should be in range (0, 1]\n", long_option);
+        return -1;
+      }
+      return 0;
+    }
+    case 2043: {
+      vk::singleton<AllocationProfiler>::get().set_output_prefix(optarg);
+      return 0;
+    }
     default:
       return -1;
   }
@@ -2247,7 +2345,8 @@ void parse_main_args(int argc, char *argv[]) {
   parse_option("mysql-host", required_argument, 2022, "MySQL host");
   parse_option("disable-mysql-same-datacenter-check", no_argument, 2023, "Disable MySQL same datacenter check");
   parse_option("use-utf8", no_argument, 2024, "Use UTF8");
-  parse_option("xgboost-model-path-experimental", required_argument, 2025, "intended for tests, don't use it for now!");
+  parse_option("xgboost-model-path-experimental", required_argument, 2025, "text dump of XGBoost model (Booster.dump_model()) for kphp_ml_xgboost_predict(), "
+                                                                          "experimental, intended for tests");
   parse_option("statshouse-client", required_argument, 2026, "host and port for statshouse client (host:port or just :port to use localhost)");
   parse_option("numa-node-to-bind", required_argument, 2027, "NUMA node description for binding workers to its cpu cores / memory "
                                                              "in format '<numa_node_id>: <cpus>'.\n"
@@ -2265,6 +2364,26 @@ void parse_main_args(int argc, char *argv[]) {
   parse_option("job-workers-shared-messages-process-multiplier", required_argument, 2031, "Coefficient used to calculate the total count of the shared messages for job workers related communication:\n"
                                                                                           "messages count = coefficient * processes_count");
   parse_option("runtime-config", required_argument, 2032, "JSON file path that will be available at runtime as 'mixed' via 'kphp_runtime_config()");
+  parse_option("track-script-phases", no_argument, 2033, "collect per request time spent in memory allocation, copying, json, serialization, regexp, "
+                                                         "instance cache and waiting for each RPC actor; it is sent to StatsHouse tagged by the script entry point");
+  parse_option("sampling-profiler-frequency", required_argument, 2034, "enable the sampling profiler of workers with the given number of samples per second of CPU time");
+  parse_option("sampling-profiler-output", required_argument, 2035, "file the master periodically writes the sampling profiler stacks to in the folded format "
+                                                                    "(default: kphp-sampling-profile.folded)");
+  parse_option("sampling-profiler-dump-period", required_argument, 2036, "period of the sampling profiler stacks dumping in seconds (default: 60)");
+  parse_option("worker-prewarm-memory", required_argument, 2037, "size of the script memory a worker faults in before serving the requests "
+                                                                 "and after the script is recreated, so the first requests aren't slowed down by page faults");
+  parse_option("http-accept-only-when-idle", no_argument, 2038, "general workers don't accept the new HTTP connections while running a script, "
+                                                                "so the connections go to the idle workers instead of waiting for the busy one");
+  parse_option("job-workers-ratio-bounds", required_argument, 2039, "'min,max' bounds of the jobs workers ratio: master rebalances the general/job workers split within them "
+                                                                   "depending on the running workers, the jobs queue and the idle host CPU (requires --job-workers-ratio)");
+  parse_option("instance-cache-snapshot", required_argument, 2040, "file used to hand over the instance cache on the graceful restart: the old master writes "
+                                                                  "the elements of @kphp-serializable classes into it, and the new master loads them");
+  parse_option("allocation-profiler-interval", required_argument, 2041, "enable the sampling profiler of the script allocations with the given average number of bytes between the samples; "
+                                                                       "the profile of a script is dumped if it runs out of the memory, exceeds --worker-memory-to-reload "
+                                                                       "or calls kphp_allocation_profile_dump()");
+  parse_option("allocation-profiler-workers-ratio", required_argument, 2042, "part of the workers the allocation profiler is enabled in (default: 1)");
+  parse_option("allocation-profiler-output", required_argument, 2043, "prefix of the allocation profiles files, they are written in the folded format "
+                                                                     "as <prefix>.<pid>.<script number>.folded (default: kphp-allocation-profile)");
   parse_engine_options_long(argc, argv, main_args_handler);
   parse_main_args_till_option(argc, argv);
   // TODO: remove it after successful migration from kphb.readyV2 to kphb.readyV3
@@ -2280,6 +2399,13 @@ void init_default() {
     kprintf ("fatal: not enough workers for general purposes\n");
     exit(1);
   }
+  if (vk::singleton<WorkersAutoscaler>::get().enabled()) {
+    if (!vk::singleton<WorkersControl>::get().get_count(WorkerType::job_worker)) {
+      kprintf ("fatal: --job-workers-ratio-bounds requires job workers\n");
+      exit(1);
+    }
+    vk::singleton<WorkersAutoscaler>::get().init(vk::singleton<WorkersControl>::get().get_total_workers_count());
+  }
 
   dl_set_default_handlers();
   now = (int)time(nullptr);
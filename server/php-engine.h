@@ -73,3 +73,6 @@ void reopen_json_log();
 
 int delete_pending_query(conn_query *q);
 
+// stops accepting the new HTTP connections while the worker runs a script, if --http-accept-only-when-idle is set
+void hts_set_accept_paused(bool paused);
+
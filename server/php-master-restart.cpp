@@ -175,6 +175,7 @@ void master_init(master_data_t *me, master_data_t *other) {
   me->sent_http_fds_generation = 0;
 
   me->instance_cache_elements_cached = 0;
+  me->instance_cache_snapshot_ready = 0;
 
   me->is_alive = true; //NB: must be the last operation.
 }
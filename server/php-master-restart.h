@@ -37,7 +37,10 @@ struct master_data_t {
 
   uint16_t http_ports[HttpServerContext::MAX_HTTP_PORTS];
 
-  int reserved[50 - 1 - HttpServerContext::MAX_HTTP_PORTS / 2];
+  // the old master has written the instance cache snapshot for the new one
+  int instance_cache_snapshot_ready;
+
+  int reserved[50 - 2 - HttpServerContext::MAX_HTTP_PORTS / 2];
 };
 
 struct shared_data_t {
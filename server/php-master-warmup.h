@@ -5,6 +5,7 @@
 #pragma once
 
 #include <chrono>
+#include <string>
 
 #include "common/smart_ptrs/singleton.h"
 #include "common/timer.h"
@@ -66,10 +67,19 @@ public:
     this->warm_up_max_time_ = warm_up_max_time;
   }
 
+  void set_instance_cache_snapshot_path(const char *instance_cache_snapshot_path) {
+    this->instance_cache_snapshot_path_ = instance_cache_snapshot_path;
+  }
+
+  const std::string &get_instance_cache_snapshot_path() const {
+    return instance_cache_snapshot_path_;
+  }
+
 private:
   double workers_part_for_warm_up_{1};
   double target_instance_cache_elements_part_{0};
   std::chrono::duration<double> warm_up_max_time_{5.0};
+  std::string instance_cache_snapshot_path_;
 
   vk::SteadyTimer<std::chrono::milliseconds> timer_{};
 
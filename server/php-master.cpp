@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cerrno>
+#include <cinttypes>
 #include <climits>
 #include <cstdio>
 #include <cstdlib>
@@ -52,6 +53,7 @@
 
 #include "runtime/confdata-global-manager.h"
 #include "runtime/instance-cache.h"
+#include "runtime/regexp.h"
 #include "server/cluster-name.h"
 #include "server/confdata-binlog-replay.h"
 #include "server/http-server-context.h"
@@ -62,11 +64,14 @@
 #include "server/server-stats.h"
 #include "server/statshouse/add-metrics-batch.h"
 #include "server/statshouse/statshouse-client.h"
+#include "server/workers-autoscaler.h"
 #include "server/workers-control.h"
 #include "server/lease-rpc-client.h"
 
 #include "server/php-master-restart.h"
 #include "server/php-master-warmup.h"
+#include "server/sampling-profiler.h"
+#include "server/allocation-profiler.h"
 #include "server/server-log.h"
 
 #include "server/job-workers/job-worker-client.h"
@@ -486,6 +491,103 @@ bool all_job_workers_killed() {
   return vk::singleton<WorkersControl>::get().get_alive_count(WorkerType::job_worker) == 0;
 }
 
+// the instance cache snapshot is written by this master as the old one and loaded as the new one on the graceful restart,
+// it's done after the shared data is unlocked, so the other master isn't blocked by that
+bool instance_cache_snapshot_to_write = false;
+bool instance_cache_snapshot_written = false;
+bool instance_cache_snapshot_write_ok = false;
+bool instance_cache_snapshot_to_load = false;
+bool instance_cache_snapshot_loaded = false;
+InstanceCacheSnapshotStats instance_cache_snapshot_stats;
+
+void reset_instance_cache_snapshot() {
+  instance_cache_snapshot_written = false;
+  instance_cache_snapshot_write_ok = false;
+  me->instance_cache_snapshot_ready = 0;
+}
+
+void process_instance_cache_snapshot() {
+  const char *path = WarmUpContext::get().get_instance_cache_snapshot_path().c_str();
+  if (std::exchange(instance_cache_snapshot_to_write, false)) {
+    instance_cache_snapshot_written = true;
+    instance_cache_snapshot_write_ok = instance_cache_write_snapshot(path, instance_cache_snapshot_stats);
+    if (instance_cache_snapshot_write_ok) {
+      vkprintf(0, "instance cache snapshot is written: %" PRIu64 " elements, %" PRIu64 " bytes in %.3f sec\n",
+               instance_cache_snapshot_stats.elements, instance_cache_snapshot_stats.bytes, instance_cache_snapshot_stats.snapshot_time_sec);
+    } else {
+      log_server_error("can't write instance cache snapshot to '%s'", path);
+    }
+  }
+  if (std::exchange(instance_cache_snapshot_to_load, false)) {
+    instance_cache_snapshot_loaded = true;
+    if (instance_cache_load_snapshot(path, instance_cache_snapshot_stats)) {
+      vkprintf(0, "instance cache snapshot is loaded: %" PRIu64 " elements, %" PRIu64 " bytes [snapshot = %.3f sec] [transfer = %.3f sec] [load = %.3f sec]\n",
+               instance_cache_snapshot_stats.elements, instance_cache_snapshot_stats.bytes, instance_cache_snapshot_stats.snapshot_time_sec,
+               instance_cache_snapshot_stats.transfer_time_sec, instance_cache_snapshot_stats.load_time_sec);
+    } else {
+      log_server_error("can't load instance cache snapshot from '%s'", path);
+    }
+  }
+}
+
+// the group the autoscaler moves a worker from, types_count if there is no move in progress
+WorkerType workers_move_from = WorkerType::types_count;
+
+void autoscale_workers() {
+  auto &autoscaler = vk::singleton<WorkersAutoscaler>::get();
+  if (!autoscaler.enabled() || state != master_state::on || other->is_alive
+      || !vk::singleton<job_workers::SharedMemoryManager>::get().is_initialized()) {
+    return;
+  }
+
+  unsigned long long cpu_total = 0;
+  unsigned long long cpu_idle = 0;
+  if (!get_cpu_total(&cpu_total, &cpu_idle)) {
+    return;
+  }
+  const auto &control = vk::singleton<WorkersControl>::get();
+  WorkersAutoscaler::Load load;
+  load.general_workers = control.get_count(WorkerType::general_worker);
+  load.job_workers = control.get_count(WorkerType::job_worker);
+  load.general_running_avg = server_stats.misc_stat_for_general_workers[1].get_stat().running_workers_avg;
+  load.job_running_avg = server_stats.misc_stat_for_job_workers[1].get_stat().running_workers_avg;
+  load.job_queue_size = vk::singleton<job_workers::SharedMemoryManager>::get().get_stats().job_queue_size.load(std::memory_order_relaxed);
+  load.cpu_total = cpu_total;
+  load.cpu_idle = cpu_idle;
+
+  const WorkerType move_from = autoscaler.on_load(my_now, load);
+  if (move_from != WorkerType::types_count && workers_move_from == WorkerType::types_count) {
+    vkprintf(1, "autoscaling: move a worker from the %s group [general = %u, running avg = %.2f] [job = %u, running avg = %.2f, queue = %d] [cpu idle = %.2f]\n",
+             move_from == WorkerType::general_worker ? "general" : "job", load.general_workers, load.general_running_avg,
+             load.job_workers, load.job_running_avg, load.job_queue_size, autoscaler.get_stats().cpu_idle);
+    workers_move_from = move_from;
+  }
+}
+
+// the boundary unique id changes its group when its worker is dead, then it's run as a worker of the other group
+void move_boundary_worker_if_needed() {
+  if (workers_move_from == WorkerType::types_count) {
+    return;
+  }
+  if (other->is_alive) {
+    // the graceful restart has started, the new master is going to take the split from the options anyway
+    workers_move_from = WorkerType::types_count;
+    return;
+  }
+  auto &control = vk::singleton<WorkersControl>::get();
+  if (control.try_move_boundary_worker(workers_move_from)) {
+    workers_move_from = WorkerType::types_count;
+    return;
+  }
+  const uint16_t boundary_unique_id = control.get_boundary_unique_id(workers_move_from);
+  for (int i = 0; i < control.get_all_alive(); i++) {
+    if (workers[i]->unique_id == boundary_unique_id && workers[i]->type == workers_move_from && !workers[i]->is_dying) {
+      terminate_worker(workers[i]);
+      break;
+    }
+  }
+}
+
 } // namespace
 
 WorkerType start_master() {
@@ -561,6 +663,8 @@ int run_worker(WorkerType worker_type) {
   assert (vk::singleton<WorkersControl>::get().get_all_alive() < WorkersControl::max_workers_count);
 
   tot_workers_started++;
+  // the new worker inherits the regexps promoted by the previous ones
+  compile_shared_regexp_patterns();
   const uint16_t worker_unique_id = vk::singleton<WorkersControl>::get().on_worker_creating(worker_type);
   pid_t new_pid = fork();
   if (new_pid == -1) {
@@ -641,6 +745,8 @@ int run_worker(WorkerType worker_type) {
     ConfdataGlobalManager::get().force_release_all_resources_acquired_by_this_proc_if_init();
     vk::singleton<job_workers::SharedMemoryManager>::get().forcibly_release_all_attached_messages();
     vk::singleton<ServerStats>::get().after_fork(pid, active_special_connections, max_special_connections, worker_unique_id, worker_type);
+    vk::singleton<SamplingProfiler>::get().start_in_worker();
+    vk::singleton<AllocationProfiler>::get().start_in_worker(worker_unique_id);
     return 1;
   }
 
@@ -670,6 +776,7 @@ void remove_worker(pid_t pid) {
   for (int i = 0; i < workers_control.get_all_alive(); i++) {
     if (workers[i]->pid == pid) {
       vk::singleton<WorkersControl>::get().on_worker_removing(workers[i]->type, workers[i]->is_dying, workers[i]->unique_id);
+      vk::singleton<JobWorkersContext>::get().master_on_worker_terminated(workers[i]->unique_id);
       if (workers[i]->type == WorkerType::general_worker && !workers[i]->is_dying) {
         failed++;
       }
@@ -1083,6 +1190,17 @@ STATS_PROVIDER_TAGGED(kphp_stats, 100, stats_tag_kphp_server) {
     stats->add_gauge_stat("workers.job.processes.running.max_1m", running_stats.running_workers_max);
   }
 
+  const auto &autoscaler = vk::singleton<WorkersAutoscaler>::get();
+  if (autoscaler.enabled()) {
+    const auto &autoscaling_stats = autoscaler.get_stats();
+    stats->add_gauge_stat("workers.autoscaling.job.min", autoscaler.get_min_job_workers());
+    stats->add_gauge_stat("workers.autoscaling.job.max", autoscaler.get_max_job_workers());
+    stats->add_gauge_stat("workers.autoscaling.general_to_job", autoscaling_stats.general_to_job);
+    stats->add_gauge_stat("workers.autoscaling.job_to_general", autoscaling_stats.job_to_general);
+    stats->add_gauge_stat("workers.autoscaling.skipped_busy_cpu", autoscaling_stats.skipped_busy_cpu);
+    stats->add_gauge_stat("workers.autoscaling.host_cpu_idle", autoscaling_stats.cpu_idle);
+  }
+
   stats->add_gauge_stat("server.workers.started", tot_workers_started);
   stats->add_gauge_stat("server.workers.dead", tot_workers_dead);
   stats->add_gauge_stat("server.workers.strange_dead", tot_workers_strange_dead);
@@ -1119,6 +1237,11 @@ STATS_PROVIDER_TAGGED(kphp_stats, 100, stats_tag_kphp_server) {
 
   stats->add_gauge_stat("graceful_restart.warmup.final_new_instance_cache_size", WarmUpContext::get().get_final_new_instance_cache_size());
   stats->add_gauge_stat("graceful_restart.warmup.final_old_instance_cache_size", WarmUpContext::get().get_final_old_instance_cache_size());
+  stats->add_gauge_stat("graceful_restart.instance_cache_snapshot.elements", instance_cache_snapshot_stats.elements);
+  stats->add_gauge_stat("graceful_restart.instance_cache_snapshot.bytes", instance_cache_snapshot_stats.bytes);
+  stats->add_gauge_stat("graceful_restart.instance_cache_snapshot.snapshot_time", instance_cache_snapshot_stats.snapshot_time_sec);
+  stats->add_gauge_stat("graceful_restart.instance_cache_snapshot.transfer_time", instance_cache_snapshot_stats.transfer_time_sec);
+  stats->add_gauge_stat("graceful_restart.instance_cache_snapshot.load_time", instance_cache_snapshot_stats.load_time_sec);
 
   if (vk::singleton<job_workers::SharedMemoryManager>::get().is_initialized()) {
     vk::singleton<job_workers::SharedMemoryManager>::get().get_stats().write_stats_to(stats);
@@ -1180,6 +1303,11 @@ void run_master_off_in_graceful_shutdown() {
 void run_master_off_in_graceful_restart() {
   vkprintf(2, "state: master_state::off_in_graceful_restart\n");
   assert (other->is_alive);
+
+  if (!WarmUpContext::get().get_instance_cache_snapshot_path().empty() && !instance_cache_snapshot_written) {
+    instance_cache_snapshot_to_write = true;
+  }
+  me->instance_cache_snapshot_ready = instance_cache_snapshot_write_ok;
   vkprintf(2, "other->to_kill_generation > me->generation --- %lld > %lld\n", other->to_kill_generation, me->generation);
 
   if (other->is_alive && other->ask_http_fds_generation > me->generation) {
@@ -1283,12 +1411,13 @@ void run_master_on() {
   }
 
   if (vk::singleton<WorkersControl>::get().get_count(WorkerType::job_worker) > 0) {
-    vk::singleton<JobWorkersContext>::get().master_init_pipes(vk::singleton<WorkersControl>::get().get_total_workers_count());
+    vk::singleton<JobWorkersContext>::get().master_init_rings(vk::singleton<WorkersControl>::get().get_total_workers_count());
   }
 
   bool done = init_http_sockets_if_needed();
 
   if (done) {
+    move_boundary_worker_if_needed();
     const auto &control = vk::singleton<WorkersControl>::get();
     const int total_workers = control.get_alive_count(WorkerType::general_worker) + (other->is_alive ? other->running_http_workers_n + other->dying_http_workers_n : 0);
     to_run = std::max(0, int{control.get_count(WorkerType::general_worker)} - total_workers);
@@ -1297,6 +1426,9 @@ void run_master_on() {
     if (other->is_alive) {
       auto &warm_up_ctx = WarmUpContext::get();
       warm_up_ctx.try_start_warmup();
+      if (other->instance_cache_snapshot_ready && !instance_cache_snapshot_loaded && !warm_up_ctx.get_instance_cache_snapshot_path().empty()) {
+        instance_cache_snapshot_to_load = true;
+      }
 
       int set_to_kill = std::clamp(MAX_KILL - other->dying_http_workers_n, 0, other->running_http_workers_n);
       bool need_more_workers_for_warmup = warm_up_ctx.need_more_workers_for_warmup();
@@ -1388,6 +1520,7 @@ static void cron() {
   server_stats.update_misc_stat_for_general_workers(MiscStatTimestamp{my_now, general_workers_stat.running_workers});
   const auto job_workers_stat = vk::singleton<ServerStats>::get().collect_workers_stat(WorkerType::job_worker);
   server_stats.update_misc_stat_for_job_workers(MiscStatTimestamp{my_now, job_workers_stat.running_workers});
+  autoscale_workers();
 
   utime += dead_utime;
   stime += dead_stime;
@@ -1397,6 +1530,7 @@ static void cron() {
   instance_cache_purge_expired_elements();
   check_and_instance_cache_try_swap_memory();
   confdata_binlog_update_cron();
+  vk::singleton<SamplingProfiler>::get().dump_if_needed();
 }
 
 auto get_steady_tp_ms_now() noexcept {
@@ -1479,6 +1613,7 @@ WorkerType run_master() {
 
     if (state != prev_state && state == master_state::on) {
       WarmUpContext::get().reset();
+      reset_instance_cache_snapshot();
     }
 
     //calc generation
@@ -1541,6 +1676,8 @@ WorkerType run_master() {
 
     shared_data_unlock(shared_data);
 
+    process_instance_cache_snapshot();
+
     if (to_exit) {
       vkprintf(1, "all workers killed. Exit\n");
       _exit(0);
@@ -806,24 +806,24 @@ void *dl_allocate_safe(size_t size) {
     return nullptr;
   }
 
-  assert (size <= (1u << 30) - 13);
-  void *dest = dl::allocate(size + 13);
+  // the memory is used as the string, which is assigned by string::assign_raw()
+  constexpr size_t header_size = string::inner_sizeof();
+  assert (size <= (1u << 30) - header_size - 1);
+  void *dest = dl::allocate(header_size + size + 1);
   if (dest == nullptr) {
     return nullptr;
   }
 
+  // size, capacity, reference counter and the hash, which isn't computed yet
+  static_assert(header_size == 3 * sizeof(int) + sizeof(int64_t), "string header layout is changed");
   int *dest_int = static_cast <int *> (dest);
   dest_int[0] = static_cast<int>(size);
   dest_int[1] = static_cast<int>(size);
   dest_int[2] = 0;
-  (static_cast <char *> (dest))[size + 12] = '\0';
+  memset(dest_int + 3, 0, sizeof(int64_t));
+  (static_cast <char *> (dest))[header_size + size] = '\0';
 
-//  fprintf (stderr, "Allocate string of len %d at %p\n", (int)size, (void *)(dest_int + 3));
-//  for (int i = 0; i < (int)size + 13; i++) {
-//    fprintf (stderr, "%d: %x(%d)\n", i - 12, static_cast <char *> (dest)[i], static_cast <char *> (dest)[i]);
-//  }
-
-  return (void *)(dest_int + 3);
+  return static_cast <char *> (dest) + header_size;
 }
 
 int alloc_net_event(slot_id_t slot_id, net_event_t **res) {
@@ -893,7 +893,7 @@ int create_job_worker_answer_event(job_workers::JobSharedMessage *job_result) {
   if (status <= 0) {
     return status;
   }
-  event->data = net_events_data::job_worker_answer{ job_workers::copy_finished_job_to_script_memory(job_result) };
+  event->data = net_events_data::job_worker_answer{ job_workers::copy_finished_job_to_script_memory(job_result), job_result->is_response_chunk };
   return 1;
 }
 
@@ -1127,7 +1127,7 @@ const char *net_event_t::get_description() const noexcept {
     },
     [](const net_events_data::job_worker_answer &event) {
       if (event.job_result) {
-        snprintf(BUF.data(), BUF.size(), "JOB RESPONSE: class name = %s", event.job_result->response.get_class());
+        snprintf(BUF.data(), BUF.size(), "JOB RESPONSE%s: class name = %s", event.is_chunk ? " CHUNK" : "", event.job_result->response.get_class());
       } else {
         snprintf(BUF.data(), BUF.size(), "JOB ERROR");
       }
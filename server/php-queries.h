@@ -36,6 +36,7 @@ struct rpc_error {
 
 struct job_worker_answer {
   job_workers::FinishedJob *job_result{};
+  bool is_chunk{false};
 };
 
 } // namespace net_events_data
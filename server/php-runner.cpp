@@ -4,12 +4,14 @@
 
 #include "server/php-runner.h"
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cerrno>
 #include <cstdlib>
 #include <cstring>
 #include <exception>
+#include <string>
 #include <execinfo.h>
 #include <sys/mman.h>
 #include <sys/time.h>
@@ -29,6 +31,9 @@
 #include "runtime/exception.h"
 #include "runtime/interface.h"
 #include "runtime/profiler.h"
+#include "runtime/regexp.h"
+#include "server/allocation-profiler.h"
+#include "server/job-workers/job-message.h"
 #include "server/json-logger.h"
 #include "server/php-engine-vars.h"
 #include "server/php-queries.h"
@@ -150,6 +155,18 @@ PhpScript::~PhpScript() noexcept {
   munmap(run_mem, mem_size);
 }
 
+void PhpScript::prewarm_memory(size_t size) noexcept {
+  size = std::min(size, mem_size);
+  if (our_madvise(run_mem, size, MADV_POPULATE_WRITE) == 0) {
+    return;
+  }
+  // MADV_POPULATE_WRITE is supported since Linux 5.14, the memory is anonymous, so writing zeroes doesn't change it
+  const size_t page_size = getpagesize();
+  for (size_t offset = 0; offset < size; offset += page_size) {
+    reinterpret_cast<volatile char *>(run_mem)[offset] = 0;
+  }
+}
+
 void PhpScript::init(script_t *script, php_query_data *data_to_set) noexcept {
   assert (script != nullptr);
   assert_state(run_state_t::empty);
@@ -182,6 +199,7 @@ void PhpScript::init(script_t *script, php_query_data *data_to_set) noexcept {
   memset(&query_stats, 0, sizeof(query_stats));
 
   PhpScript::ml_flag = false;
+  vk::singleton<AllocationProfiler>::get().on_script_start();
 }
 
 void PhpScript::on_request_timeout_error() {
@@ -317,6 +335,30 @@ run_state_t PhpScript::iterate() noexcept {
   return state;
 }
 
+// the phases are tagged by the http uri, the rpc function magic or the job request class
+static std::string get_script_entry_point(const php_query_data *data) noexcept {
+  // the long uris are cut, the tag values are limited anyway
+  constexpr int MAX_ENTRY_POINT_LEN = 64;
+  if (data == nullptr) {
+    return "cli";
+  }
+  if (const http_query_data *http_data = data->http_data) {
+    return "http:" + std::string{http_data->uri, static_cast<size_t>(std::min(http_data->uri_len, MAX_ENTRY_POINT_LEN))};
+  }
+  if (const rpc_query_data *rpc_data = data->rpc_data) {
+    char magic[16] = "unknown";
+    if (rpc_data->len > 0) {
+      snprintf(magic, sizeof(magic), "0x%08x", static_cast<unsigned>(rpc_data->data[0]));
+    }
+    return std::string{"rpc:"} + magic;
+  }
+  if (const job_query_data *job_data = data->job_data) {
+    const char *job_class = job_data->job_request && !job_data->job_request->instance.is_null() ? job_data->job_request->instance.get_class() : "unknown";
+    return "job:" + std::string{job_class, std::min(strlen(job_class), static_cast<size_t>(MAX_ENTRY_POINT_LEN))};
+  }
+  return "cli";
+}
+
 void PhpScript::finish() noexcept {
   assert (state == run_state_t::finished || state == run_state_t::error);
   assert(dl::is_malloc_replaced() == false);
@@ -326,6 +368,12 @@ void PhpScript::finish() noexcept {
   update_net_time();
   vk::singleton<ServerStats>::get().add_request_stats(script_time, net_time, queries_cnt, long_queries_cnt, script_mem_stats.max_memory_used,
                                                       script_mem_stats.max_real_memory_used, vk::singleton<CurlMemoryUsage>::get().total_allocated, error_type);
+  vk::singleton<ServerStats>::get().add_regexp_cache_stats(take_regexp_cache_stats());
+  if (ScriptPhasesStats::is_enabled()) {
+    vk::singleton<ServerStats>::get().add_script_phases_stats(vk::singleton<ScriptPhasesStats>::get(), get_script_entry_point(data));
+  }
+  vk::singleton<AllocationProfiler>::get().on_script_finish((save_state == run_state_t::error && error_type == script_error_t::memory_limit)
+                                                            || static_cast<long long>(script_mem_stats.max_real_memory_used) > memory_used_to_recreate_script);
   if (save_state == run_state_t::error) {
     assert (error_message != nullptr);
     kprintf("Critical error during script execution: %s\n", error_message);
@@ -122,6 +122,9 @@ public:
   PhpScript(size_t mem_size, size_t stack_size) noexcept;
   ~PhpScript() noexcept;
 
+  // faults in the beginning of the script memory, so the requests don't pay for these page faults
+  void prewarm_memory(size_t size) noexcept;
+
   void check_tl() noexcept;
 
   void init(script_t *script, php_query_data *data_to_set) noexcept;
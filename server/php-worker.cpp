@@ -109,6 +109,7 @@ void PhpWorker::state_try_start() noexcept {
   }
 
   php_worker_run_flag = 1;
+  hts_set_accept_paused(true);
   state = phpq_init_script;
 }
 
@@ -152,6 +153,14 @@ void PhpWorker::state_init_script() noexcept {
   state = phpq_run;
 }
 
+void prewarm_php_script() noexcept {
+  if (worker_prewarm_memory <= 0 || php_script != nullptr) {
+    return;
+  }
+  php_script = new PhpScript(max_memory, 8 << 20);
+  php_script->prewarm_memory(worker_prewarm_memory);
+}
+
 void php_worker_run_rpc_send_query(int32_t request_id, const net_queries_data::rpc_send &query) {
   int connection_id = query.host_num;
   slot_id_t slot_id = request_id;
@@ -373,11 +382,17 @@ void PhpWorker::set_result(script_result *res) noexcept {
 
 void PhpWorker::state_free_script() noexcept {
   php_worker_run_flag = 0;
+  hts_set_accept_paused(false);
   int f = 0;
 
   get_utime_monotonic();
   double worked = precise_now - start_time;
   double waited = start_time - init_time;
+  if (mode == http_worker) {
+    vk::singleton<ServerStats>::get().add_http_queue_wait_stats(waited);
+  } else if (mode == rpc_worker) {
+    vk::singleton<ServerStats>::get().add_rpc_queue_wait_stats(waited);
+  }
 
   assert(active_worker == this);
   active_worker = nullptr;
@@ -410,6 +425,7 @@ void PhpWorker::state_free_script() noexcept {
     delete php_script;
     php_script = nullptr;
     finished_queries = 0;
+    prewarm_php_script();
   }
 
   state = phpq_finish;
@@ -82,3 +82,7 @@ private:
 };
 
 extern PhpWorker *active_worker;
+
+// creates the script in advance and faults in its memory if --worker-prewarm-memory is set,
+// it's done when the worker starts and when the script is recreated, not to do it on the request
+void prewarm_php_script() noexcept;
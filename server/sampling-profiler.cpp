@@ -0,0 +1,236 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include "server/sampling-profiler.h"
+
+#include <cstdio>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <unordered_map>
+#include <vector>
+
+#include "common/dl-utils-lite.h"
+#include "common/fast-backtrace.h"
+#include "common/kprintf.h"
+#include "common/wrappers/memory-utils.h"
+
+#include "runtime/kphp-backtrace.h"
+#include "server/php-runner.h"
+#include "server/server-log.h"
+#include "server/ucontext-portable.h"
+
+namespace {
+
+uint64_t calc_stack_hash(void *const *frames, uint32_t depth) noexcept {
+  uint64_t hash = 14695981039346656037ULL;
+  for (uint32_t i = 0; i < depth; ++i) {
+    hash ^= reinterpret_cast<uintptr_t>(frames[i]);
+    hash *= 1099511628211ULL;
+  }
+  // zero is reserved for the empty slots
+  return hash | 1;
+}
+
+void sigprof_handler(int, siginfo_t *, void *ucontext) {
+  vk::singleton<SamplingProfiler>::get().on_sample(ucontext);
+}
+
+std::vector<std::string> symbolize_frames(const std::vector<void *> &frames) {
+  std::vector<std::string> names;
+  names.reserve(frames.size());
+  KphpBacktrace demangler{frames.data(), static_cast<int32_t>(frames.size())};
+  for (const char *name : demangler.make_demangled_backtrace_range()) {
+    names.emplace_back(name ? name : "");
+  }
+  return names;
+}
+
+} // namespace
+
+bool SamplingProfiler::set_frequency(int samples_per_second) noexcept {
+  if (samples_per_second <= 0 || samples_per_second > 10000) {
+    return false;
+  }
+  samples_per_second_ = samples_per_second;
+  return true;
+}
+
+void SamplingProfiler::set_output_path(const char *path) noexcept {
+  output_path_ = path;
+}
+
+bool SamplingProfiler::set_dump_period(int seconds) noexcept {
+  if (seconds <= 0) {
+    return false;
+  }
+  dump_period_ = std::chrono::seconds{seconds};
+  return true;
+}
+
+void SamplingProfiler::init() noexcept {
+  if (!enabled()) {
+    return;
+  }
+  tables_ = new(mmap_shared(sizeof(SampledStacksTables))) SampledStacksTables{};
+  last_dump_ = std::chrono::steady_clock::now();
+
+  rlimit stack_limit{};
+  main_stack_limit_ = getrlimit(RLIMIT_STACK, &stack_limit) == 0 && stack_limit.rlim_cur != RLIM_INFINITY
+                      ? stack_limit.rlim_cur
+                      : 8 * 1024 * 1024;
+}
+
+void SamplingProfiler::start_in_worker() noexcept {
+  if (!enabled()) {
+    return;
+  }
+  dl_sigaction(SIGPROF, nullptr, dl_get_empty_sigset(), SA_SIGINFO | SA_ONSTACK | SA_RESTART, sigprof_handler);
+
+  const long interval_us = 1000000 / samples_per_second_;
+  itimerval timer{.it_interval{interval_us / 1000000, interval_us % 1000000}, .it_value{interval_us / 1000000, interval_us % 1000000}};
+  setitimer(ITIMER_PROF, &timer, nullptr);
+}
+
+void SamplingProfiler::on_sample(void *ucontext) noexcept {
+  if (!tables_) {
+    return;
+  }
+
+  void *frames[SampledStacksTable::MAX_STACK_DEPTH];
+  uint32_t depth = 0;
+#if defined(__APPLE__)
+  static_cast<void>(ucontext);
+  return;
+#else
+  const auto *uc = static_cast<const ucontext_t *>(ucontext);
+#if defined(__x86_64__)
+  auto *ip = reinterpret_cast<void *>(uc->uc_mcontext.gregs[REG_RIP]);
+  auto *bp = reinterpret_cast<void *>(uc->uc_mcontext.gregs[REG_RBP]);
+  const auto *sp = reinterpret_cast<const char *>(uc->uc_mcontext.gregs[REG_RSP]);
+#elif defined(__aarch64__)
+  auto *ip = reinterpret_cast<void *>(uc->uc_mcontext.pc);
+  auto *bp = reinterpret_cast<void *>(uc->uc_mcontext.regs[29]);
+  const auto *sp = reinterpret_cast<const char *>(uc->uc_mcontext.sp);
+#else
+#error "Unsupported arch"
+#endif
+  frames[depth++] = ip;
+
+  // the interrupted code may use the frame pointer register for its own purposes,
+  // so the unwinding is limited by the stack the interrupted code is running on
+  const char *stack_end = nullptr;
+  if (PhpScript::is_running && PhpScript::current_script) {
+    const auto &script_stack = PhpScript::current_script->script_stack;
+    const char *script_stack_begin = script_stack.get_stack_ptr();
+    if (script_stack_begin <= sp && sp < script_stack_begin + script_stack.get_stack_size()) {
+      stack_end = script_stack_begin + script_stack.get_stack_size();
+    }
+  }
+  const auto *main_stack_end = static_cast<const char *>(__libc_stack_end);
+  if (!stack_end && sp < main_stack_end && static_cast<size_t>(main_stack_end - sp) <= main_stack_limit_) {
+    stack_end = main_stack_end;
+  }
+  if (stack_end) {
+    depth += fast_backtrace_by_bp(bp, sp, stack_end, frames + depth, SampledStacksTable::MAX_STACK_DEPTH - depth);
+  }
+#endif
+
+  tables_->active().add_stack(frames, depth);
+}
+
+void SamplingProfiler::dump_if_needed() noexcept {
+  if (!tables_) {
+    return;
+  }
+  const auto now = std::chrono::steady_clock::now();
+  if (now - last_dump_ < dump_period_) {
+    return;
+  }
+  last_dump_ = now;
+
+  const std::string tmp_path = output_path_ + ".tmp";
+  FILE *out = fopen(tmp_path.c_str(), "w");
+  if (!out) {
+    log_server_error("Can't open sampling profiler output file '%s': %s", tmp_path.c_str(), strerror(errno));
+  }
+
+  // the settled table is cleared, so it can become active
+  if (const uint64_t lost_samples = tables_->settled().dump_and_clear(out, symbolize_frames)) {
+    log_server_warning("Sampling profiler lost %" PRIu64 " samples due to the stacks table overflow", lost_samples);
+  }
+  tables_->flip();
+
+  if (out) {
+    fclose(out);
+    if (rename(tmp_path.c_str(), output_path_.c_str()) != 0) {
+      log_server_error("Can't rename sampling profiler output file to '%s': %s", output_path_.c_str(), strerror(errno));
+    }
+  }
+}
+
+void SampledStacksTable::add_stack(void *const *frames, uint32_t depth) noexcept {
+  const uint64_t hash = calc_stack_hash(frames, depth);
+  for (size_t probe = 0; probe < MAX_PROBES; ++probe) {
+    Stack &stack = stacks_[(hash + probe) & (MAX_STACKS - 1)];
+    uint64_t stack_hash = stack.hash.load(std::memory_order_acquire);
+    if (stack_hash == 0 && stack.hash.compare_exchange_strong(stack_hash, hash, std::memory_order_acq_rel)) {
+      std::copy(frames, frames + depth, stack.frames);
+      stack.depth = depth;
+      stack.ready.store(true, std::memory_order_release);
+      stack.samples.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    if (stack_hash == hash) {
+      stack.samples.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+  }
+  lost_samples_.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t SampledStacksTable::dump_and_clear(FILE *out, Symbolizer symbolizer) noexcept {
+  std::vector<void *> unique_frames;
+  std::unordered_map<void *, size_t> frame_ids;
+  if (out) {
+    for (const Stack &stack : stacks_) {
+      if (!stack.ready.load(std::memory_order_acquire)) {
+        continue;
+      }
+      for (uint32_t i = 0; i < stack.depth; ++i) {
+        if (frame_ids.emplace(stack.frames[i], unique_frames.size()).second) {
+          unique_frames.emplace_back(stack.frames[i]);
+        }
+      }
+    }
+  }
+
+  std::vector<std::string> frame_names;
+  if (!unique_frames.empty()) {
+    frame_names = symbolizer(unique_frames);
+    frame_names.resize(unique_frames.size());
+    for (size_t i = 0; i < frame_names.size(); ++i) {
+      if (frame_names[i].empty()) {
+        char address[32];
+        snprintf(address, sizeof(address), "%p", unique_frames[i]);
+        frame_names[i] = address;
+      }
+    }
+  }
+
+  for (Stack &stack : stacks_) {
+    if (out && stack.ready.load(std::memory_order_acquire)) {
+      // the folded format expects the frames starting from the root
+      for (uint32_t i = stack.depth; i != 0; --i) {
+        fprintf(out, i == stack.depth ? "%s" : ";%s", frame_names[frame_ids[stack.frames[i - 1]]].c_str());
+      }
+      fprintf(out, " %" PRIu64 "\n", stack.samples.load(std::memory_order_relaxed));
+    }
+    stack.ready.store(false, std::memory_order_relaxed);
+    stack.samples.store(0, std::memory_order_relaxed);
+    stack.depth = 0;
+    stack.hash.store(0, std::memory_order_release);
+  }
+
+  return lost_samples_.exchange(0, std::memory_order_relaxed);
+}
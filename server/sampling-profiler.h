@@ -0,0 +1,101 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "common/mixin/not_copyable.h"
+#include "common/smart_ptrs/singleton.h"
+
+// The stacks sampled by the workers: the lock-free open addressing hash table, which is placed in the shared memory.
+class SampledStacksTable : vk::not_copyable {
+public:
+  static constexpr uint32_t MAX_STACK_DEPTH = 64;
+  static constexpr size_t MAX_STACKS = 1 << 12;
+  static constexpr size_t MAX_PROBES = 64;
+
+  // it is called from the signal handler, the sample is lost if neither the stack nor an empty slot is found in MAX_PROBES slots
+  void add_stack(void *const *frames, uint32_t depth) noexcept;
+
+  // returns the names of the given frames, the unresolved frames have the empty names
+  using Symbolizer = std::vector<std::string> (*)(const std::vector<void *> &frames);
+
+  // writes the stacks in the folded format ("root;...;leaf samples" lines) to out if it isn't null and clears the table,
+  // returns the number of the samples lost since the previous call
+  uint64_t dump_and_clear(FILE *out, Symbolizer symbolizer) noexcept;
+
+private:
+  struct Stack {
+    std::atomic<uint64_t> hash{0};
+    std::atomic<bool> ready{false};
+    uint32_t depth{0};
+    std::atomic<uint64_t> samples{0};
+    void *frames[MAX_STACK_DEPTH];
+  };
+
+  std::atomic<uint64_t> lost_samples_{0};
+  Stack stacks_[MAX_STACKS];
+};
+
+// The workers write to the active table, the master dumps the other one and flips them.
+class SampledStacksTables : vk::not_copyable {
+public:
+  SampledStacksTable &active() noexcept {
+    return tables_[active_table_.load(std::memory_order_relaxed)];
+  }
+
+  // the table became inactive at the previous flip, so all the samples in it are complete
+  SampledStacksTable &settled() noexcept {
+    return tables_[active_table_.load(std::memory_order_relaxed) ^ 1];
+  }
+
+  void flip() noexcept {
+    active_table_.fetch_xor(1, std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<uint32_t> active_table_{0};
+  SampledStacksTable tables_[2];
+};
+
+// Low overhead alternative to the instrumenting profiler (runtime/profiler.h):
+// workers are interrupted by SIGPROF with the given frequency of the consumed CPU time,
+// the interrupted stack is unwound by frame pointers and accumulated in the shared memory.
+// The master periodically dumps the collected stacks in the folded format (suitable for flamegraph.pl).
+class SamplingProfiler : vk::not_copyable {
+public:
+  bool set_frequency(int samples_per_second) noexcept;
+  void set_output_path(const char *path) noexcept;
+  bool set_dump_period(int seconds) noexcept;
+
+  bool enabled() const noexcept {
+    return samples_per_second_ > 0;
+  }
+
+  // these function should be called from master
+  void init() noexcept;
+  void dump_if_needed() noexcept;
+
+  void start_in_worker() noexcept;
+  void on_sample(void *ucontext) noexcept;
+
+private:
+  int samples_per_second_{0};
+  std::string output_path_{"kphp-sampling-profile.folded"};
+  std::chrono::seconds dump_period_{60};
+  std::chrono::steady_clock::time_point last_dump_;
+  size_t main_stack_limit_{0};
+
+  SampledStacksTables *tables_{nullptr};
+
+  SamplingProfiler() = default;
+
+  friend class vk::singleton<SamplingProfiler>;
+};
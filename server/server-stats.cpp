@@ -14,6 +14,7 @@
 #include "net/net-events.h"
 
 #include "runtime/curl.h"
+#include "runtime/regexp.h"
 
 #include "server/workers-control.h"
 
@@ -53,6 +54,32 @@ struct QueriesStat : WithStatType<uint64_t> {
   };
 };
 
+struct RegexpCacheStat : WithStatType<uint64_t> {
+  enum class Key {
+    hits,
+    misses,
+    promotions,
+    compile_time,
+    types_count
+  };
+};
+
+struct WorkerStartSamples : WithStatType<uint64_t> {
+  enum class Key {
+    ready_time = 0,
+    first_request_script_time,
+    types_count
+  };
+};
+
+struct QueueWaitSamples : WithStatType<uint64_t> {
+  enum class Key {
+    http_wait_time = 0,
+    rpc_wait_time,
+    types_count
+  };
+};
+
 struct JobSamples : WithStatType<uint64_t> {
   enum class Key {
     wait_time = 0,
@@ -96,6 +123,7 @@ struct VMStat : WithStatType<uint32_t> {
     rss_peak_kb,
     rss_kb,
     shm_kb,
+    pss_kb,
     types_count
   };
 };
@@ -179,6 +207,7 @@ EnumTable<VMStat> get_virtual_memory_stat() noexcept {
   result[VMStat::Key::rss_peak_kb] = mem_stats.rss_peak;
   result[VMStat::Key::rss_kb] = mem_stats.rss;
   result[VMStat::Key::shm_kb] = mem_stats.rss_shmem + mem_stats.rss_file;
+  result[VMStat::Key::pss_kb] = get_self_pss_kb();
   return result;
 }
 
@@ -269,7 +298,9 @@ public:
 
 struct WorkerSharedStats : private vk::not_copyable {
   explicit WorkerSharedStats(std::mt19937 *gen) noexcept:
-    script_samples(gen) {
+    script_samples(gen),
+    start_samples(gen),
+    queue_wait_samples(gen) {
   }
 
   void add_request_stats(const EnumTable<QueriesStat> &queries, script_error_t error,
@@ -292,10 +323,32 @@ struct WorkerSharedStats : private vk::not_copyable {
     script_samples.add_sample(sample);
   }
 
+  void add_regexp_cache_stats(const RegexpCacheStats &regexp_cache_stats) noexcept {
+    regexp_cache_stat[RegexpCacheStat::Key::hits].fetch_add(regexp_cache_stats.hits, std::memory_order_relaxed);
+    regexp_cache_stat[RegexpCacheStat::Key::misses].fetch_add(regexp_cache_stats.misses, std::memory_order_relaxed);
+    regexp_cache_stat[RegexpCacheStat::Key::promotions].fetch_add(regexp_cache_stats.promotions, std::memory_order_relaxed);
+    regexp_cache_stat[RegexpCacheStat::Key::compile_time].fetch_add(regexp_cache_stats.compile_time_ns, std::memory_order_relaxed);
+  }
+
+  void add_worker_start_stat(WorkerStartSamples::Key key, uint64_t time_ns) noexcept {
+    EnumTable<WorkerStartSamples> sample{};
+    sample[key] = time_ns;
+    start_samples.add_sample(sample);
+  }
+
+  void add_queue_wait_stat(QueueWaitSamples::Key key, uint64_t wait_time_ns) noexcept {
+    EnumTable<QueueWaitSamples> sample{};
+    sample[key] = wait_time_ns;
+    queue_wait_samples.add_sample(sample);
+  }
+
   std::array<std::atomic<uint32_t>, static_cast<size_t>(script_error_t::errors_count)> errors{};
 
   EnumTable<QueriesStat, std::atomic<QueriesStat::StatType>> total_queries_stat;
+  EnumTable<RegexpCacheStat, std::atomic<RegexpCacheStat::StatType>> regexp_cache_stat;
   SharedSamplesBundle<ScriptSamples> script_samples;
+  SharedSamplesBundle<WorkerStartSamples> start_samples;
+  SharedSamplesBundle<QueueWaitSamples> queue_wait_samples;
 };
 
 struct JobWorkerSharedStats : WorkerSharedStats {
@@ -514,12 +567,16 @@ struct WorkerPercentilesBundle : EnumTable<E, Percentiles<typename E::StatType>>
 
 struct WorkerAggregatedStats {
   explicit WorkerAggregatedStats(std::mt19937 *gen) noexcept:
-    script_samples(gen) {
+    script_samples(gen),
+    start_samples(gen),
+    queue_wait_samples(gen) {
   }
 
-  void recalc(SharedSamplesBundle<ScriptSamples> &script_shared_samples, std::chrono::steady_clock::time_point now_tp,
+  void recalc(WorkerSharedStats &shared_stats, std::chrono::steady_clock::time_point now_tp,
               const WorkerProcessStats &stats, uint16_t first_id, uint16_t last_id) noexcept {
-    script_samples.recalc(script_shared_samples, now_tp);
+    script_samples.recalc(shared_stats.script_samples, now_tp);
+    start_samples.recalc(shared_stats.start_samples, now_tp);
+    queue_wait_samples.recalc(shared_stats.queue_wait_samples, now_tp);
     heap_samples.recalc(stats.heap_stats, first_id, last_id);
     malloc_samples.recalc(stats.malloc_stats, first_id, last_id);
     vm_samples.recalc(stats.vm_stats, first_id, last_id);
@@ -527,6 +584,8 @@ struct WorkerAggregatedStats {
   }
 
   AggregatedSamplesBundle<ScriptSamples> script_samples;
+  AggregatedSamplesBundle<WorkerStartSamples> start_samples;
+  AggregatedSamplesBundle<QueueWaitSamples> queue_wait_samples;
   WorkerSamplesBundle<MallocStat> malloc_samples;
   WorkerSamplesBundle<HeapStat> heap_samples;
   WorkerSamplesBundle<VMStat> vm_samples;
@@ -591,6 +650,17 @@ void ServerStats::after_fork(pid_t worker_pid, uint64_t active_connections, uint
   gen_->seed(worker_pid);
   shared_stats_->workers.reset_worker_stats(worker_pid, active_connections, max_connections, worker_process_id_);
   last_update_ = std::chrono::steady_clock::now();
+  fork_time_ = last_update_;
+  is_first_request_ = true;
+}
+
+void ServerStats::on_worker_ready() noexcept {
+  if (fork_time_ == std::chrono::steady_clock::time_point{}) {
+    return;
+  }
+  auto &stats = worker_type_ == WorkerType::job_worker ? shared_stats_->job_workers : shared_stats_->general_workers;
+  const auto ready_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - fork_time_);
+  stats.add_worker_start_stat(WorkerStartSamples::Key::ready_time, ready_time.count());
 }
 
 void ServerStats::add_request_stats(double script_time_sec, double net_time_sec, int64_t script_queries, int64_t long_script_queries, int64_t memory_used,
@@ -602,6 +672,10 @@ void ServerStats::add_request_stats(double script_time_sec, double net_time_sec,
 
   stats.add_request_stats(queries_stat, error, memory_used, real_memory_used, curl_total_allocated);
   shared_stats_->workers.add_worker_stats(queries_stat, worker_process_id_);
+  if (is_first_request_) {
+    is_first_request_ = false;
+    stats.add_worker_start_stat(WorkerStartSamples::Key::first_request_script_time, script_time.count());
+  }
 
   using namespace statshouse;
   vk::singleton<WorkerStatsBuffer>::get().add_query_stat(GenericQueryStatKey::memory_used, worker_type_, memory_used);
@@ -614,6 +688,21 @@ void ServerStats::add_request_stats(double script_time_sec, double net_time_sec,
   vk::singleton<WorkerStatsBuffer>::get().add_query_stat(GenericQueryStatKey::outgoing_long_queries, worker_type_, long_script_queries);
 }
 
+void ServerStats::add_script_phases_stats(const ScriptPhasesStats &phases_stats, const std::string &entry_point) noexcept {
+  using namespace statshouse;
+  auto &stats_buffer = vk::singleton<WorkerStatsBuffer>::get();
+  const auto tsc2ns = [&phases_stats](uint64_t tsc) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(phases_stats.tsc2sec(tsc))).count();
+  };
+
+  phases_stats.for_each_phase([&](ScriptPhase phase, uint64_t spent_tsc) {
+    stats_buffer.add_script_phase_stat(entry_point, phase, worker_type_, tsc2ns(spent_tsc));
+  });
+  phases_stats.for_each_rpc_actor([&](const ScriptPhasesStats::RpcActorStats &actor_stats) {
+    stats_buffer.add_rpc_actor_wait_stat(actor_stats.actor_id, tsc2ns(actor_stats.wait_tsc));
+  });
+}
+
 void ServerStats::add_job_stats(double job_wait_time_sec, int64_t request_memory_used, int64_t request_real_memory_used, int64_t response_memory_used,
                                 int64_t response_real_memory_used) noexcept {
   const auto job_wait_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(job_wait_time_sec));
@@ -627,6 +716,22 @@ void ServerStats::add_job_stats(double job_wait_time_sec, int64_t request_memory
   vk::singleton<WorkerStatsBuffer>::get().add_query_stat(QueryStatKey::job_response_real_memory_usage, response_real_memory_used);
 }
 
+void ServerStats::add_http_queue_wait_stats(double wait_time_sec) noexcept {
+  const auto wait_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(wait_time_sec));
+  shared_stats_->general_workers.add_queue_wait_stat(QueueWaitSamples::Key::http_wait_time, wait_time.count());
+
+  using namespace statshouse;
+  vk::singleton<WorkerStatsBuffer>::get().add_query_stat(QueryStatKey::http_queue_wait_time, wait_time.count());
+}
+
+void ServerStats::add_rpc_queue_wait_stats(double wait_time_sec) noexcept {
+  const auto wait_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(wait_time_sec));
+  shared_stats_->general_workers.add_queue_wait_stat(QueueWaitSamples::Key::rpc_wait_time, wait_time.count());
+
+  using namespace statshouse;
+  vk::singleton<WorkerStatsBuffer>::get().add_query_stat(QueryStatKey::rpc_queue_wait_time, wait_time.count());
+}
+
 void ServerStats::add_job_common_memory_stats(int64_t common_request_memory_used, int64_t common_request_real_memory_used) noexcept {
   shared_stats_->job_workers.add_job_common_memory_stats(common_request_memory_used, common_request_real_memory_used);
 
@@ -635,6 +740,11 @@ void ServerStats::add_job_common_memory_stats(int64_t common_request_memory_used
   vk::singleton<WorkerStatsBuffer>::get().add_query_stat(QueryStatKey::job_common_request_real_memory_usage, common_request_real_memory_used);
 }
 
+void ServerStats::add_regexp_cache_stats(const RegexpCacheStats &regexp_cache_stats) noexcept {
+  auto &stats = worker_type_ == WorkerType::job_worker ? shared_stats_->job_workers : shared_stats_->general_workers;
+  stats.add_regexp_cache_stats(regexp_cache_stats);
+}
+
 void ServerStats::update_this_worker_stats() noexcept {
   const auto now_tp = std::chrono::steady_clock::now();
   if (now_tp - last_update_ >= std::chrono::seconds{5}) {
@@ -671,12 +781,12 @@ void ServerStats::aggregate_stats() noexcept {
   const uint16_t general_workers = workers_control.get_count(WorkerType::general_worker);
   const uint16_t job_workers = workers_control.get_count(WorkerType::job_worker);
 
-  aggregated_stats_->general_workers.recalc(shared_stats_->general_workers.script_samples, now_tp,
+  aggregated_stats_->general_workers.recalc(shared_stats_->general_workers, now_tp,
                                             shared_stats_->workers, 0, general_workers);
 
   aggregated_stats_->job_workers.job_samples.recalc(shared_stats_->job_workers.job_samples, now_tp);
   aggregated_stats_->job_workers.job_common_memory_samples.recalc(shared_stats_->job_workers.job_common_memory_samples, now_tp);
-  aggregated_stats_->job_workers.recalc(shared_stats_->job_workers.script_samples, now_tp,
+  aggregated_stats_->job_workers.recalc(shared_stats_->job_workers, now_tp,
                                         shared_stats_->workers, general_workers, job_workers + general_workers);
 
   aggregated_stats_->master_process.vm_stats = get_virtual_memory_stat();
@@ -736,6 +846,11 @@ void write_to(stats_t *stats, const char *prefix, const WorkerAggregatedStats &a
   stats->add_gauge_stat(shared.total_queries_stat[QueriesStat::Key::outgoing_queries], prefix, ".requests.total_outgoing_queries");
   stats->add_gauge_stat(shared.total_queries_stat[QueriesStat::Key::outgoing_long_queries], prefix, ".requests.total_outgoing_long_queries");
 
+  stats->add_gauge_stat(shared.regexp_cache_stat[RegexpCacheStat::Key::hits], prefix, ".regexp_cache.hits");
+  stats->add_gauge_stat(shared.regexp_cache_stat[RegexpCacheStat::Key::misses], prefix, ".regexp_cache.misses");
+  stats->add_gauge_stat(shared.regexp_cache_stat[RegexpCacheStat::Key::promotions], prefix, ".regexp_cache.promotions");
+  stats->add_gauge_stat(ns2double(shared.regexp_cache_stat[RegexpCacheStat::Key::compile_time]), prefix, ".regexp_cache.compile_time.total");
+
   write_to(stats, prefix, ".requests.outgoing_queries", agg.script_samples[ScriptSamples::Key::outgoing_queries]);
   write_to(stats, prefix, ".requests.outgoing_long_queries", agg.script_samples[ScriptSamples::Key::outgoing_long_queries]);
   write_to(stats, prefix, ".requests.script_time", agg.script_samples[ScriptSamples::Key::script_time], ns2double);
@@ -755,8 +870,14 @@ void write_to(stats_t *stats, const char *prefix, const WorkerAggregatedStats &a
   write_to(stats, prefix, ".memory.rss_bytes", agg.vm_samples[VMStat::Key::rss_kb], kb2bytes);
   write_to(stats, prefix, ".memory.vms_bytes", agg.vm_samples[VMStat::Key::vm_kb], kb2bytes);
   write_to(stats, prefix, ".memory.shm_bytes", agg.vm_samples[VMStat::Key::shm_kb], kb2bytes);
+  write_to(stats, prefix, ".memory.pss_bytes", agg.vm_samples[VMStat::Key::pss_kb], kb2bytes);
 
   write_to(stats, prefix, ".cpu.recent_idle", agg.idle_samples[IdleStat::Key::recent_idle_percent]);
+
+  write_to(stats, prefix, ".start.ready_time", agg.start_samples[WorkerStartSamples::Key::ready_time], ns2double);
+  write_to(stats, prefix, ".start.first_request_script_time", agg.start_samples[WorkerStartSamples::Key::first_request_script_time], ns2double);
+  write_to(stats, prefix, ".requests.http_queue_wait_time", agg.queue_wait_samples[QueueWaitSamples::Key::http_wait_time], ns2double);
+  write_to(stats, prefix, ".requests.rpc_queue_wait_time", agg.queue_wait_samples[QueueWaitSamples::Key::rpc_wait_time], ns2double);
 }
 
 void write_to(stats_t *stats, const char *prefix, const JobWorkerAggregatedStats &job_agg) noexcept {
@@ -777,6 +898,7 @@ void write_to(stats_t *stats, const char *prefix, const MasterProcessStats &mast
   stats->add_gauge_stat(kb2bytes(master_process.vm_stats[VMStat::Key::rss_kb]), prefix, ".memory.rss_bytes");
   stats->add_gauge_stat(kb2bytes(master_process.vm_stats[VMStat::Key::vm_kb]), prefix, ".memory.vms_bytes");
   stats->add_gauge_stat(kb2bytes(master_process.vm_stats[VMStat::Key::shm_kb]), prefix, ".memory.shm_bytes");
+  stats->add_gauge_stat(kb2bytes(master_process.vm_stats[VMStat::Key::pss_kb]), prefix, ".memory.pss_bytes");
 }
 
 template<class S>
@@ -799,6 +921,8 @@ void write_server_vm_to(stats_t *stats, const char *prefix, const EnumTable<VMSt
 
   const uint64_t rss_no_shm = get_sum(general_vm, job_vm, master_vm, VMStat::Key::rss_kb) - get_sum(general_vm, job_vm, master_vm, VMStat::Key::shm_kb);
   stats->add_gauge_stat(kb2bytes(rss_no_shm), prefix, ".memory.rss_no_shm_total_bytes");
+  // unlike the rss sum, the pss sum counts the pages shared with the master (e.g. the constants) once
+  stats->add_gauge_stat(kb2bytes(get_sum(general_vm, job_vm, master_vm, VMStat::Key::pss_kb)), prefix, ".memory.pss_total_bytes");
 }
 
 } // namespace
@@ -836,6 +960,7 @@ void ServerStats::write_stats_to(std::ostream &os, bool add_worker_pids) const n
      << "VM_max\t" << get_max(general_vm, job_vm, master_vm, VMStat::Key::vm_peak_kb) << "Kb\n"
      << "RSS\t" << get_sum(general_vm, job_vm, master_vm, VMStat::Key::rss_kb) << "Kb\n"
      << "RSS_max\t" << get_sum(general_vm, job_vm, master_vm, VMStat::Key::rss_peak_kb) << "Kb\n"
+     << "PSS\t" << get_sum(general_vm, job_vm, master_vm, VMStat::Key::pss_kb) << "Kb\n"
      << "tot_queries\t" << total_queries[QueriesStat::Key::incoming_queries].load(std::memory_order_relaxed) << "\n"
      << "tot_script_queries\t" << total_queries[QueriesStat::Key::outgoing_queries].load(std::memory_order_relaxed) << "\n"
      << "worked_time\t" << total_script_time + total_net_time << "\n"
@@ -862,6 +987,7 @@ void ServerStats::write_stats_to(std::ostream &os, bool add_worker_pids) const n
        << "VM_max " << worker_pid << "\t" << workers_vm.get_stat(VMStat::Key::vm_peak_kb, w) << "Kb\n"
        << "RSS " << worker_pid << "\t" << workers_vm.get_stat(VMStat::Key::rss_kb, w) << "Kb\n"
        << "RSS_max " << worker_pid << "\t" << workers_vm.get_stat(VMStat::Key::rss_peak_kb, w) << "Kb\n"
+       << "PSS " << worker_pid << "\t" << workers_vm.get_stat(VMStat::Key::pss_kb, w) << "Kb\n"
        << "tot_queries " << worker_pid << "\t" << workers_query.get_stat(QueriesStat::Key::incoming_queries, w) << "\n"
        << "tot_script_queries " << worker_pid << "\t" << workers_query.get_stat(QueriesStat::Key::outgoing_queries, w) << "\n"
        << "worked_time " << worker_pid << "\t" << net_time + script_time << "\n"
@@ -7,23 +7,33 @@
 #include <chrono>
 #include <memory>
 #include <random>
+#include <string>
 
 #include "common/mixin/not_copyable.h"
 #include "common/smart_ptrs/singleton.h"
 #include "common/stats/provider.h"
 
+#include "runtime/script-phases.h"
+
 #include "server/php-runner.h"
 #include "server/workers-control.h"
 
+struct RegexpCacheStats;
+
 class ServerStats : vk::not_copyable {
 public:
   void init() noexcept;
 
   void add_request_stats(double script_time_sec, double net_time_sec, int64_t script_queries, int64_t long_script_queries, int64_t memory_used,
                          int64_t real_memory_used, int64_t curl_total_allocated, script_error_t error) noexcept;
+  void add_script_phases_stats(const ScriptPhasesStats &phases_stats, const std::string &entry_point) noexcept;
   void add_job_stats(double job_wait_time_sec, int64_t request_memory_used, int64_t request_real_memory_used, int64_t response_memory_used,
                      int64_t response_real_memory_used) noexcept;
+  // the time the query waited for the worker to start its script
+  void add_http_queue_wait_stats(double wait_time_sec) noexcept;
+  void add_rpc_queue_wait_stats(double wait_time_sec) noexcept;
   void add_job_common_memory_stats(int64_t common_request_memory_used, int64_t common_request_real_memory_used) noexcept;
+  void add_regexp_cache_stats(const RegexpCacheStats &regexp_cache_stats) noexcept;
   void update_this_worker_stats() noexcept;
   void update_active_connections(uint64_t active_connections, uint64_t max_connections) noexcept;
 
@@ -33,6 +43,8 @@ public:
 
   void after_fork(pid_t worker_pid, uint64_t active_connections, uint64_t max_connections,
                   uint16_t worker_process_id, WorkerType worker_type) noexcept;
+  // is called when the forked worker is about to serve the requests
+  void on_worker_ready() noexcept;
 
   // these functions should be called only from the master process
   void aggregate_stats() noexcept;
@@ -57,6 +69,8 @@ private:
   WorkerType worker_type_{WorkerType::general_worker};
   uint16_t worker_process_id_{0};
   std::chrono::steady_clock::time_point last_update_;
+  std::chrono::steady_clock::time_point fork_time_;
+  bool is_first_request_{false};
 
   std::mt19937 *gen_{nullptr};
 
@@ -1,4 +1,5 @@
 prepend(KPHP_SERVER_SOURCES ${BASE_DIR}/server/
+        allocation-profiler.cpp
         cluster-name.cpp
         confdata-binlog-replay.cpp
         confdata-stats.cpp
@@ -21,20 +22,22 @@ prepend(KPHP_SERVER_SOURCES ${BASE_DIR}/server/
         php-init-scripts.cpp
         php-sql-connections.cpp
         php-worker.cpp
+        sampling-profiler.cpp
         server-log.cpp
         server-stats.cpp
         slot-ids-factory.cpp
+        workers-autoscaler.cpp
         workers-control.cpp
         statshouse/statshouse-client.cpp
         statshouse/add-metrics-batch.cpp
         statshouse/worker-stats-buffer.cpp)
 
 prepend(KPHP_JOB_WORKERS_SOURCES ${BASE_DIR}/server/job-workers/
+        job-ring.cpp
         job-stats.cpp
         job-worker-server.cpp
         job-worker-client.cpp
         job-workers-context.cpp
-        pipe-io.cpp
         shared-memory-manager.cpp)
 
 prepend(KPHP_DATABASE_DRIVERS_SOURCES ${BASE_DIR}/server/database-drivers/
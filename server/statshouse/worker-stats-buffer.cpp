@@ -60,6 +60,37 @@ void WorkerStatsBuffer::add_query_stat(QueryStatKey key, double value) {
   stats_buffer.add_stat(value);
 }
 
+WorkerStatsBuffer::ScriptPhasesBuffers &WorkerStatsBuffer::get_script_phases_buffers(const std::string &entry_point, WorkerType worker_type) {
+  auto &entry_points = script_phases_stats[static_cast<size_t>(worker_type)];
+  auto it = entry_points.find(entry_point);
+  if (it == entry_points.end()) {
+    it = entry_points.try_emplace(entry_points.size() < MAX_SCRIPT_ENTRY_POINTS ? entry_point : std::string{"other"}).first;
+  }
+  return it->second;
+}
+
+void WorkerStatsBuffer::add_script_phase_stat(const std::string &entry_point, ScriptPhase phase, WorkerType worker_type, double value) {
+  if (!enabled) {
+    return;
+  }
+  if (get_script_phases_buffers(entry_point, worker_type)[static_cast<size_t>(phase)].is_need_to_flush()) {
+    flush();
+  }
+  // flush() drops the entry points, so the buffer has to be looked up again
+  get_script_phases_buffers(entry_point, worker_type)[static_cast<size_t>(phase)].add_stat(value);
+}
+
+void WorkerStatsBuffer::add_rpc_actor_wait_stat(int64_t actor_id, double value) {
+  if (!enabled) {
+    return;
+  }
+  if (rpc_actors_wait_stats[actor_id].is_need_to_flush()) {
+    flush();
+  }
+  // flush() drops the actors, so the buffer has to be looked up again
+  rpc_actors_wait_stats[actor_id].add_stat(value);
+}
+
 void WorkerStatsBuffer::make_generic_metric(std::vector<StatsHouseMetric> &metrics, const char *name, GenericQueryStatKey stat_key, size_t worker_type,
                                             const std::vector<tag> &tags) {
   auto &stats_buffer = generic_query_stats[worker_type][static_cast<size_t>(stat_key)];
@@ -69,7 +100,10 @@ void WorkerStatsBuffer::make_generic_metric(std::vector<StatsHouseMetric> &metri
 }
 
 void WorkerStatsBuffer::make_metric(std::vector<StatsHouseMetric> &metrics, const char *name, QueryStatKey stat_key, const std::vector<tag> &tags) {
-  auto &stats_buffer = query_stats[static_cast<size_t>(stat_key)];
+  make_metric(metrics, name, query_stats[static_cast<size_t>(stat_key)], tags);
+}
+
+void WorkerStatsBuffer::make_metric(std::vector<StatsHouseMetric> &metrics, const char *name, StatsBuffer &stats_buffer, const std::vector<tag> &tags) {
   if (!stats_buffer.empty()) {
     metrics.push_back(make_statshouse_value_metrics(name, stats_buffer.get_data_and_reset_buffer(), tags));
   }
@@ -95,6 +129,16 @@ void WorkerStatsBuffer::flush() {
     make_generic_metric(metrics, "kphp_memory_script_usage", GenericQueryStatKey::memory_used, i, tags);
     make_generic_metric(metrics, "kphp_memory_script_real_usage", GenericQueryStatKey::real_memory_used, i, tags);
     make_generic_metric(metrics, "kphp_memory_script_total_allocated_by_curl", GenericQueryStatKey::total_allocated_by_curl, i, tags);
+
+    for (auto &entry_point_stats : script_phases_stats[i]) {
+      for (size_t phase = 0; phase < static_cast<size_t>(ScriptPhase::types_count); ++phase) {
+        std::vector<tag> phase_tags = tags;
+        phase_tags.emplace_back("entry_point", entry_point_stats.first);
+        phase_tags.emplace_back("phase", script_phase_name(static_cast<ScriptPhase>(phase)));
+        make_metric(metrics, "kphp_requests_phase_time", entry_point_stats.second[phase], phase_tags);
+      }
+    }
+    script_phases_stats[i].clear();
   }
 
   std::vector<tag> tags;
@@ -102,6 +146,13 @@ void WorkerStatsBuffer::flush() {
     tags.emplace_back("host", hostname);
   }
 
+  std::vector<tag> http_tags = tags;
+  http_tags.emplace_back("query_type", "http");
+  make_metric(metrics, "kphp_requests_queue_time", QueryStatKey::http_queue_wait_time, http_tags);
+  std::vector<tag> rpc_tags = tags;
+  rpc_tags.emplace_back("query_type", "rpc");
+  make_metric(metrics, "kphp_requests_queue_time", QueryStatKey::rpc_queue_wait_time, rpc_tags);
+
   make_metric(metrics, "kphp_jobs_queue_time", QueryStatKey::job_wait_time, tags);
   make_metric(metrics, "kphp_memory_job_request_usage", QueryStatKey::job_request_memory_usage, tags);
   make_metric(metrics, "kphp_memory_job_request_real_usage", QueryStatKey::job_request_real_memory_usage, tags);
@@ -111,6 +162,13 @@ void WorkerStatsBuffer::flush() {
   make_metric(metrics, "kphp_memory_job_common_request_usage", QueryStatKey::job_common_request_memory_usage, tags);
   make_metric(metrics, "kphp_memory_job_common_request_real_usage", QueryStatKey::job_common_request_real_memory_usage, tags);
 
+  for (auto &actor_stats : rpc_actors_wait_stats) {
+    std::vector<tag> actor_tags = tags;
+    actor_tags.emplace_back("actor", actor_stats.first == ScriptPhasesStats::OTHER_RPC_ACTORS_ID ? "other" : std::to_string(actor_stats.first));
+    make_metric(metrics, "kphp_requests_rpc_actor_wait_time", actor_stats.second, actor_tags);
+  }
+  rpc_actors_wait_stats.clear();
+
   if (metrics.empty()) {
     last_send_time = std::chrono::steady_clock::now();
     return;
@@ -7,10 +7,12 @@
 #include <array>
 #include <chrono>
 #include <ostream>
+#include <unordered_map>
 
 #include "add-metrics-batch.h"
 #include "common/mixin/not_copyable.h"
 #include "common/tl/methods/string.h"
+#include "runtime/script-phases.h"
 #include "server/workers-control.h"
 
 namespace statshouse {
@@ -29,6 +31,9 @@ enum class GenericQueryStatKey {
 };
 
 enum class QueryStatKey {
+  http_queue_wait_time,
+  rpc_queue_wait_time,
+
   job_wait_time,
   job_request_memory_usage,
   job_request_real_memory_usage,
@@ -58,6 +63,8 @@ public:
   WorkerStatsBuffer();
   void add_query_stat(GenericQueryStatKey key, WorkerType worker_type, double value);
   void add_query_stat(QueryStatKey key, double value);
+  void add_script_phase_stat(const std::string &entry_point, ScriptPhase phase, WorkerType worker_type, double value);
+  void add_rpc_actor_wait_stat(int64_t actor_id, double value);
   void flush_if_needed();
   void enable();
   using tag = std::pair<std::string, std::string>;
@@ -67,9 +74,18 @@ private:
   void make_generic_metric(std::vector<StatsHouseMetric> &metrics, const char *name, GenericQueryStatKey stat_key, size_t worker_type,
                            const std::vector<tag> &tags);
   void make_metric(std::vector<StatsHouseMetric> &metrics, const char *name, QueryStatKey stat_key, const std::vector<tag> &tags);
+  void make_metric(std::vector<StatsHouseMetric> &metrics, const char *name, StatsBuffer &stats_buffer, const std::vector<tag> &tags);
+
+  using ScriptPhasesBuffers = std::array<StatsBuffer, static_cast<size_t>(ScriptPhase::types_count)>;
+  ScriptPhasesBuffers &get_script_phases_buffers(const std::string &entry_point, WorkerType worker_type);
+
+  // the entry points over the limit are accounted as the "other" one till the next flush
+  static constexpr size_t MAX_SCRIPT_ENTRY_POINTS = 64;
 
   std::array<std::array<StatsBuffer, static_cast<size_t>(GenericQueryStatKey::types_count)>, static_cast<size_t>(WorkerType::types_count)> generic_query_stats;
   std::array<StatsBuffer, static_cast<size_t>(QueryStatKey::types_count)> query_stats;
+  std::array<std::unordered_map<std::string, ScriptPhasesBuffers>, static_cast<size_t>(WorkerType::types_count)> script_phases_stats;
+  std::unordered_map<int64_t, StatsBuffer> rpc_actors_wait_stats;
   std::chrono::steady_clock::time_point last_send_time;
   bool enabled = false;
 };
@@ -0,0 +1,71 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include "server/workers-autoscaler.h"
+
+#include <algorithm>
+#include <cmath>
+
+bool WorkersAutoscaler::set_job_workers_ratio_bounds(double min_ratio, double max_ratio) noexcept {
+  if (min_ratio < 0 || max_ratio >= 1 || min_ratio >= max_ratio) {
+    return false;
+  }
+  min_ratio_ = min_ratio;
+  max_ratio_ = max_ratio;
+  return true;
+}
+
+void WorkersAutoscaler::init(uint16_t total_workers_count) noexcept {
+  if (!enabled() || total_workers_count < 2) {
+    return;
+  }
+  // there is at least one worker of each type, the job workers can't appear from nowhere
+  min_job_workers_ = std::max(static_cast<uint16_t>(std::ceil(min_ratio_ * total_workers_count)), uint16_t{1});
+  max_job_workers_ = std::min(static_cast<uint16_t>(std::floor(max_ratio_ * total_workers_count)), static_cast<uint16_t>(total_workers_count - 1));
+  max_job_workers_ = std::max(max_job_workers_, min_job_workers_);
+}
+
+WorkerType WorkersAutoscaler::wanted_move(const Load &load) const noexcept {
+  if (load.general_running_avg < 0 || load.job_running_avg < 0 || !load.general_workers || !load.job_workers) {
+    return WorkerType::types_count;
+  }
+  const bool general_busy = load.general_running_avg >= BUSY_WORKERS_PART * load.general_workers;
+  const bool general_idle = load.general_running_avg <= IDLE_WORKERS_PART * load.general_workers;
+  const bool job_busy = load.job_running_avg >= BUSY_WORKERS_PART * load.job_workers || load.job_queue_size >= load.job_workers;
+  const bool job_idle = load.job_running_avg <= IDLE_WORKERS_PART * load.job_workers && load.job_queue_size <= 0;
+
+  if (job_busy && general_idle && load.job_workers < max_job_workers_) {
+    return WorkerType::general_worker;
+  }
+  if (general_busy && job_idle && load.job_workers > min_job_workers_) {
+    return WorkerType::job_worker;
+  }
+  return WorkerType::types_count;
+}
+
+WorkerType WorkersAutoscaler::on_load(double now, const Load &load) noexcept {
+  if (prev_cpu_total_ && load.cpu_total > prev_cpu_total_ && load.cpu_idle >= prev_cpu_idle_) {
+    stats_.cpu_idle = static_cast<double>(load.cpu_idle - prev_cpu_idle_) / static_cast<double>(load.cpu_total - prev_cpu_total_);
+  }
+  prev_cpu_total_ = load.cpu_total;
+  prev_cpu_idle_ = load.cpu_idle;
+
+  const WorkerType wanted = wanted_move(load);
+  if (wanted != candidate_) {
+    candidate_ = wanted;
+    candidate_samples_ = 0;
+  }
+  if (wanted == WorkerType::types_count || ++candidate_samples_ < STABLE_SAMPLES || now < last_move_time_ + COOLDOWN_SEC) {
+    return WorkerType::types_count;
+  }
+
+  candidate_samples_ = 0;
+  if (stats_.cpu_idle < MIN_CPU_IDLE) {
+    ++stats_.skipped_busy_cpu;
+    return WorkerType::types_count;
+  }
+  last_move_time_ = now;
+  ++(wanted == WorkerType::general_worker ? stats_.general_to_job : stats_.job_to_general);
+  return wanted;
+}
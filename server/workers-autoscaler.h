@@ -0,0 +1,90 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/mixin/not_copyable.h"
+#include "common/smart_ptrs/singleton.h"
+
+#include "server/workers-control.h"
+
+// Rebalances the general/job workers split within the configured bounds of the job workers ratio.
+// The master feeds it with the load every second; a worker is moved to the other group
+// only if the load stays skewed for a while and the host has some idle CPU (otherwise the move doesn't add any throughput).
+class WorkersAutoscaler : vk::not_copyable {
+public:
+  struct Load {
+    uint16_t general_workers{0};
+    uint16_t job_workers{0};
+    // the average running workers for the last minute, negative if unknown
+    double general_running_avg{-1};
+    double job_running_avg{-1};
+    int32_t job_queue_size{0};
+    // the /proc/stat counters
+    uint64_t cpu_total{0};
+    uint64_t cpu_idle{0};
+  };
+
+  struct Stats {
+    uint32_t general_to_job{0};
+    uint32_t job_to_general{0};
+    // the moves wanted by the load, but skipped due to the lack of idle CPU
+    uint32_t skipped_busy_cpu{0};
+    double cpu_idle{0};
+  };
+
+  // the bounds must be set before WorkersControl::init()
+  bool set_job_workers_ratio_bounds(double min_ratio, double max_ratio) noexcept;
+
+  bool enabled() const noexcept {
+    return max_ratio_ > min_ratio_;
+  }
+
+  void init(uint16_t total_workers_count) noexcept;
+
+  uint16_t get_min_job_workers() const noexcept {
+    return min_job_workers_;
+  }
+
+  uint16_t get_max_job_workers() const noexcept {
+    return max_job_workers_;
+  }
+
+  // returns the group a worker should be moved from, types_count if the split is fine
+  WorkerType on_load(double now, const Load &load) noexcept;
+
+  const Stats &get_stats() const noexcept {
+    return stats_;
+  }
+
+  // a load must hold for that many consecutive samples to move a worker
+  static constexpr int STABLE_SAMPLES = 30;
+  // the running workers average is for the last minute, so it must forget the previous split
+  static constexpr double COOLDOWN_SEC = 60;
+  static constexpr double BUSY_WORKERS_PART = 0.9;
+  static constexpr double IDLE_WORKERS_PART = 0.5;
+  static constexpr double MIN_CPU_IDLE = 0.1;
+
+private:
+  WorkerType wanted_move(const Load &load) const noexcept;
+
+  double min_ratio_{0};
+  double max_ratio_{0};
+  uint16_t min_job_workers_{0};
+  uint16_t max_job_workers_{0};
+
+  WorkerType candidate_{WorkerType::types_count};
+  int candidate_samples_{0};
+  double last_move_time_{0};
+  uint64_t prev_cpu_total_{0};
+  uint64_t prev_cpu_idle_{0};
+
+  Stats stats_;
+
+  WorkersAutoscaler() = default;
+
+  friend class vk::singleton<WorkersAutoscaler>;
+};
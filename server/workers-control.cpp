@@ -2,6 +2,7 @@
 // Copyright (c) 2021 LLC «V Kontakte»
 // Distributed under the GPL v3 License, see LICENSE.notice.txt
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <limits>
@@ -54,6 +55,38 @@ void WorkersControl::on_worker_removing(WorkerType worker_type, bool dying, uint
   assert(next_unique_id == EMPTY_ID);
 }
 
+uint16_t WorkersControl::get_boundary_unique_id(WorkerType from) const noexcept {
+  const uint16_t general_count = get_count(WorkerType::general_worker);
+  return from == WorkerType::general_worker ? general_count - 1 : general_count;
+}
+
+bool WorkersControl::try_move_boundary_worker(WorkerType from) noexcept {
+  const WorkerType to = from == WorkerType::general_worker ? WorkerType::job_worker : WorkerType::general_worker;
+  auto &from_meta = meta_[static_cast<size_t>(from)];
+  auto &to_meta = meta_[static_cast<size_t>(to)];
+  if (from_meta.count <= 1) {
+    return false;
+  }
+
+  const uint16_t boundary_unique_id = get_boundary_unique_id(from);
+  // the free ids are at the beginning of the stack
+  const uint16_t from_free = from_meta.count - get_alive_count(from);
+  const auto free_ids_end = from_meta.unique_ids_.begin() + from_free;
+  const auto boundary_it = std::find(from_meta.unique_ids_.begin(), free_ids_end, boundary_unique_id);
+  if (boundary_it == free_ids_end) {
+    return false;
+  }
+  std::iter_swap(boundary_it, free_ids_end - 1);
+  *(free_ids_end - 1) = EMPTY_ID;
+  --from_meta.count;
+
+  const uint16_t to_free = to_meta.count - get_alive_count(to);
+  const uint16_t next_unique_id = std::exchange(to_meta.unique_ids_[to_free], boundary_unique_id);
+  assert(next_unique_id == EMPTY_ID);
+  ++to_meta.count;
+  return true;
+}
+
 uint16_t WorkersControl::on_worker_creating(WorkerType worker_type) noexcept {
   auto &meta = meta_[static_cast<size_t>(worker_type)];
   const uint16_t alive = get_alive_count(worker_type);
@@ -6,6 +6,7 @@
 
 #include <array>
 #include <cinttypes>
+#include <cstddef>
 
 #include "common/mixin/not_copyable.h"
 #include "common/smart_ptrs/singleton.h"
@@ -59,6 +60,12 @@ public:
     meta_[static_cast<size_t>(worker_type)].ratio = ratio;
   }
 
+  // the general workers have the unique ids [0, general count) and the job workers have the rest,
+  // so a worker can change its group only at the boundary: the last general id or the first job id
+  uint16_t get_boundary_unique_id(WorkerType from) const noexcept;
+  // moves the boundary unique id to the other group, returns false if its worker is still alive
+  bool try_move_boundary_worker(WorkerType from) noexcept;
+
   uint16_t on_worker_creating(WorkerType worker_type) noexcept;
   void on_worker_terminating(WorkerType worker_type) noexcept;
   void on_worker_removing(WorkerType worker_type, bool dying, uint16_t worker_unique_id) noexcept;
@@ -5,6 +5,18 @@ class BenchmarkExplode {
   private $words4 = 'one two three four';
   private $words8 = 'one two three four five six seven eight';
   private $delim = ' ';
+  private $text = '';
+  private $lines = '';
+
+  public function __construct() {
+    $words = ['lorem', 'ipsum', 'dolor', 'sit', 'amet', 'consectetur', 'adipiscing', 'elit', 'sed', 'do'];
+    for ($i = 0; $i < 3000; $i++) {
+      $this->text .= $words[($i * 7) % 10] . ' ';
+      if ($i % 10 == 9) {
+        $this->lines .= "line number $i\r\n";
+      }
+    }
+  }
 
   public function benchmarkExplodeToArray() {
     $res1 = explode(' ', $this->words2);
@@ -65,4 +77,12 @@ class BenchmarkExplode {
     [$y1, $y2, $y3, $y4] = explode($this->delim, $this->words8, 10);
     return strlen($x1) + strlen($x2) + strlen($x3) + strlen($x4) + strlen($y1) + strlen($y2) + strlen($y3) + strlen($y4);
   }
+
+  public function benchmarkExplodeLongText() {
+    return count(explode(' ', $this->text));
+  }
+
+  public function benchmarkExplodeLines() {
+    return count(explode("\r\n", $this->lines));
+  }
 }
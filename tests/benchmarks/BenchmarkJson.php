@@ -1,5 +1,21 @@
 <?php
 
+class BenchmarkJsonUser {
+  public int $id = 0;
+  public string $name = '';
+  public float $rating = 0.0;
+  public bool $is_active = false;
+  /** @var string[] */
+  public $tags = [];
+  public ?BenchmarkJsonUser $invited_by = null;
+}
+
+class BenchmarkJsonUsersList {
+  public int $total = 0;
+  /** @var BenchmarkJsonUser[] */
+  public $users = [];
+}
+
 class BenchmarkJson {
   private static $array_data = [
     'a' => [
@@ -23,7 +39,42 @@ class BenchmarkJson {
     ],
   ];
 
+  private static $small_json = '{"a":{"b":{"c":{"d":10,"e":20},"f":30},"50":[],"60":[],"70":[]},"g":[[1],[2],[3],[1,2,3],[1,2,3,4,5,6,7,8,9,10]]}';
+
+  private $users_json = '';
+  private $text = '';
+
+  public function __construct() {
+    $users = [];
+    for ($i = 0; $i < 50; $i++) {
+      $users[] = '{"id": ' . $i . ', "name": "user name \"' . $i . '\"", "rating": ' . ($i + 0.5) . ', "is_active": ' . ($i % 2 ? 'true' : 'false') .
+        ', "tags": ["first", "second", "third"], "invited_by": ' . ($i ? '{"id": ' . ($i - 1) . ', "name": "inviter"}' : 'null') . ', "unused": {"x": [1, 2, 3]}}';
+    }
+    $this->users_json = '{"total": 50, "users": [' . implode(",\n  ", $users) . ']}';
+    $this->text = str_repeat('Lorem ipsum dolor sit amet, consectetur adipiscing elit. ', 100) . "\"quoted\"\n";
+  }
+
   public function benchmarkEncodeSafeArray() {
     return vk_json_encode_safe(self::$array_data);
   }
+
+  public function benchmarkEncodeText() {
+    return json_encode($this->text);
+  }
+
+  public function benchmarkEncodeTextSafe() {
+    return vk_json_encode_safe($this->text);
+  }
+
+  public function benchmarkDecodeSmall() {
+    return json_decode(self::$small_json, true);
+  }
+
+  public function benchmarkDecodeUsersArray() {
+    return json_decode($this->users_json, true);
+  }
+
+  public function benchmarkDecodeUsersClass() {
+    return JsonEncoder::decode($this->users_json, BenchmarkJsonUsersList::class);
+  }
 }
@@ -0,0 +1,40 @@
+<?php
+
+class BenchmarkMbString {
+  private $latin = '';
+  private $cyrillic = '';
+  private $short = 'Привет, World!';
+
+  public function __construct() {
+    $latin_words = ['hello', 'World', 'KPHP', 'compiler', 'is', 'fast'];
+    $cyrillic_words = ['Привет', 'мир', 'КПХП', 'быстрый', 'и', 'VK'];
+    for ($i = 0; $i < 2000; $i++) {
+      $this->latin .= $latin_words[($i * 7) % 6] . ' ';
+      $this->cyrillic .= $cyrillic_words[($i * 7) % 6] . ' ';
+    }
+  }
+
+  public function benchmarkStrtolowerLatin() {
+    return strlen(mb_strtolower($this->latin));
+  }
+
+  public function benchmarkStrtolowerCyrillic() {
+    return strlen(mb_strtolower($this->cyrillic));
+  }
+
+  public function benchmarkStrtoupperShort() {
+    return strlen(mb_strtoupper($this->short));
+  }
+
+  public function benchmarkStrlen() {
+    return mb_strlen($this->latin) + mb_strlen($this->cyrillic);
+  }
+
+  public function benchmarkSubstr() {
+    return strlen(mb_substr($this->cyrillic, 5000, 100));
+  }
+
+  public function benchmarkCheckEncoding() {
+    return (int)mb_check_encoding($this->latin, 'UTF-8') + (int)mb_check_encoding($this->cyrillic, 'UTF-8');
+  }
+}
@@ -0,0 +1,64 @@
+<?php
+
+class BenchmarkSort {
+  /** @var int[] */
+  private $ints = [];
+  /** @var float[] */
+  private $floats = [];
+  /** @var string[] */
+  private $strings = [];
+  /** @var int[] */
+  private $map = [];
+
+  public function __construct() {
+    mt_srand(7);
+    for ($i = 0; $i < 10000; $i++) {
+      $this->ints[] = mt_rand(-1000000000, 1000000000);
+      $this->floats[] = mt_rand() / 1000.0;
+      $this->strings[] = 'user_' . mt_rand();
+      $this->map['key' . mt_rand()] = mt_rand();
+    }
+  }
+
+  public function benchmarkSortInts() {
+    $a = $this->ints;
+    sort($a);
+    return $a[0];
+  }
+
+  public function benchmarkRsortInts() {
+    $a = $this->ints;
+    rsort($a);
+    return $a[0];
+  }
+
+  public function benchmarkSortFloats() {
+    $a = $this->floats;
+    sort($a);
+    return $a[0];
+  }
+
+  public function benchmarkSortStrings() {
+    $a = $this->strings;
+    sort($a, SORT_STRING);
+    return $a[0];
+  }
+
+  public function benchmarkUsortInts() {
+    $a = $this->ints;
+    usort($a, function(int $x, int $y) { return $x <=> $y; });
+    return $a[0];
+  }
+
+  public function benchmarkAsort() {
+    $a = $this->map;
+    asort($a);
+    return count($a);
+  }
+
+  public function benchmarkKsort() {
+    $a = $this->map;
+    ksort($a);
+    return count($a);
+  }
+}
@@ -0,0 +1,51 @@
+<?php
+
+class BenchmarkStringHash {
+  /** @var string[] */
+  private $keys = [];
+  /** @var int[] */
+  private $map = [];
+
+  public function __construct() {
+    for ($i = 0; $i < 1000; $i++) {
+      $key = 'field_name_' . ($i * 7919) . '_suffix';
+      $this->keys[] = $key;
+      $this->map[$key] = $i;
+    }
+  }
+
+  // the same key strings are hashed once
+  public function benchmarkLookupSameKeys() {
+    $sum = 0;
+    foreach ($this->keys as $key) {
+      $sum += $this->map[$key];
+    }
+    return $sum;
+  }
+
+  // every key is a new string, so its hash is computed on every lookup
+  public function benchmarkLookupNewKeys() {
+    $sum = 0;
+    for ($i = 0; $i < 1000; $i++) {
+      $sum += $this->map['field_name_' . ($i * 7919) . '_suffix'];
+    }
+    return $sum;
+  }
+
+  public function benchmarkCopyMapByKeys() {
+    $copy = [];
+    foreach ($this->map as $key => $value) {
+      $copy[$key] = $value;
+    }
+    return count($copy);
+  }
+
+  // the memory side: each string keeps 8 more bytes for the hash
+  public function benchmarkCreateShortStrings() {
+    $strings = [];
+    for ($i = 0; $i < 1000; $i++) {
+      $strings[] = 'k' . $i;
+    }
+    return count($strings);
+  }
+}
@@ -0,0 +1,32 @@
+<?php
+
+class BenchmarkStringSearch {
+  private $text = '';
+
+  public function __construct() {
+    $words = ['lorem', 'ipsum', 'dolor', 'sit', 'amet', 'consectetur', 'adipiscing', 'elit', 'sed', 'do'];
+    for ($i = 0; $i < 3000; $i++) {
+      $this->text .= $words[($i * 7) % 10] . ' ';
+    }
+  }
+
+  public function benchmarkStrposMiss() {
+    return strpos($this->text, 'not found') === false ? 1 : 0;
+  }
+
+  public function benchmarkStrposLate() {
+    return (int)strrpos($this->text, 'adipiscing') + (int)strpos($this->text, 'elit sed', 10000);
+  }
+
+  public function benchmarkSubstrCount() {
+    return substr_count($this->text, 'sit ');
+  }
+
+  public function benchmarkStrReplace() {
+    return strlen(str_replace('dolor', 'DOLOR', $this->text));
+  }
+
+  public function benchmarkStrtrChars() {
+    return strlen(strtr($this->text, 'aeiou', 'AEIOU'));
+  }
+}
@@ -132,3 +132,223 @@ TEST(array_test, test_mutate_shared_map) {
   ASSERT_EQ(arr_copy.get_reference_counter(), 1);
   ASSERT_FALSE(arr_copy.is_equal_inner_pointer(arr));
 }
+
+namespace {
+
+template<class T>
+std::vector<std::pair<int64_t, double>> dump_int_keys_array(const array<T> &arr) {
+  std::vector<std::pair<int64_t, double>> result;
+  for (const auto &it : arr) {
+    EXPECT_FALSE(it.is_string_key());
+    result.emplace_back(it.get_key().as_int(), f$floatval(it.get_value()));
+  }
+  return result;
+}
+
+} // namespace
+
+TEST(array_test, test_vector_with_holes) {
+  auto arr = array<int64_t>::create(0, 1, 2, 3, 4);
+  arr.set_value(7, 7);
+  ASSERT_FALSE(arr.is_vector());
+  ASSERT_TRUE(arr.is_vector_with_holes());
+  ASSERT_EQ(arr.count(), 6);
+  ASSERT_EQ(arr.get_next_key(), 8);
+
+  arr.push_back(8);
+  arr.unset(int64_t{2});
+  arr.unset(int64_t{5});
+  ASSERT_TRUE(arr.is_vector_with_holes());
+  ASSERT_EQ(arr.count(), 6);
+  ASSERT_EQ(dump_int_keys_array(arr), (std::vector<std::pair<int64_t, double>>{{0, 0}, {1, 1}, {3, 3}, {4, 4}, {7, 7}, {8, 8}}));
+
+  ASSERT_EQ(*arr.find_value(7), 7);
+  ASSERT_EQ(arr.find_value(2), nullptr);
+  ASSERT_EQ(arr.find_value(100500), nullptr);
+  ASSERT_EQ(arr.find_value(string{"foo"}), nullptr);
+  ASSERT_EQ(arr.find_no_mutate(string{"4"}).get_value(), 4);
+  ASSERT_EQ((--arr.end()).get_key().as_int(), 8);
+  ASSERT_EQ(arr.middle(4).get_key().as_int(), 7);
+  ASSERT_EQ(arr.middle(-5).get_key().as_int(), 1);
+
+  // the values are overwritten in place
+  arr[3] = 30;
+  arr.set_value(string{"4"}, 40);
+  ASSERT_TRUE(arr.is_vector_with_holes());
+  ASSERT_EQ(dump_int_keys_array(arr), (std::vector<std::pair<int64_t, double>>{{0, 0}, {1, 1}, {3, 30}, {4, 40}, {7, 7}, {8, 8}}));
+
+  // the unset max key isn't reused, as in map
+  ASSERT_EQ(arr.pop(), 8);
+  arr.push_back(9);
+  ASSERT_TRUE(arr.is_vector_with_holes());
+  ASSERT_EQ((--arr.end()).get_key().as_int(), 9);
+
+  int64_t runs = 0;
+  int64_t sum = 0;
+  arr.for_each_vector_run([&](int64_t first_key, const int64_t *values, size_t n) {
+    ++runs;
+    for (size_t i = 0; i != n; ++i) {
+      EXPECT_EQ(*arr.find_value(first_key + static_cast<int64_t>(i)), values[i]);
+      sum += values[i];
+    }
+    return true;
+  });
+  ASSERT_EQ(runs, 4);
+  ASSERT_EQ(sum, 0 + 1 + 30 + 40 + 7 + 9);
+}
+
+TEST(array_test, test_vector_with_holes_conversion_to_map) {
+  auto arr = array<double>::create(0.5, 1.5, 2.5);
+  arr.set_value(5, 5.5);
+  ASSERT_TRUE(arr.is_vector_with_holes());
+
+  // the keys must be iterated in the insertion order, so the holes can't be filled
+  auto with_key_inside = arr;
+  with_key_inside.set_value(4, 4.5);
+  ASSERT_FALSE(with_key_inside.is_vector_with_holes());
+  ASSERT_EQ(dump_int_keys_array(with_key_inside), (std::vector<std::pair<int64_t, double>>{{0, 0.5}, {1, 1.5}, {2, 2.5}, {5, 5.5}, {4, 4.5}}));
+  ASSERT_EQ(with_key_inside.get_next_key(), 6);
+
+  auto with_string_key = arr;
+  with_string_key.set_value(string{"foo"}, 1);
+  ASSERT_FALSE(with_string_key.is_vector_with_holes());
+  ASSERT_EQ(with_string_key.count(), 5);
+
+  auto too_sparse = arr;
+  too_sparse.set_value(1000, 1);
+  ASSERT_FALSE(too_sparse.is_vector_with_holes());
+  ASSERT_EQ(too_sparse.count(), 5);
+
+  auto with_negative_key = arr;
+  with_negative_key.set_value(-1, 1);
+  ASSERT_FALSE(with_negative_key.is_vector_with_holes());
+
+  auto with_unset_values = arr;
+  with_unset_values.set_value(20, 20.5);
+  ASSERT_TRUE(with_unset_values.is_vector_with_holes());
+  for (int64_t i = 0; i != 3; ++i) {
+    with_unset_values.unset(i);
+  }
+  ASSERT_FALSE(with_unset_values.is_vector_with_holes());
+  ASSERT_EQ(dump_int_keys_array(with_unset_values), (std::vector<std::pair<int64_t, double>>{{5, 5.5}, {20, 20.5}}));
+  ASSERT_EQ(with_unset_values.get_next_key(), 21);
+
+  // the original one is untouched
+  ASSERT_TRUE(arr.is_vector_with_holes());
+  ASSERT_EQ(arr.get_reference_counter(), 1);
+  ASSERT_EQ(dump_int_keys_array(arr), (std::vector<std::pair<int64_t, double>>{{0, 0.5}, {1, 1.5}, {2, 2.5}, {5, 5.5}}));
+
+  // the other values never have holes
+  auto strings = array<string>::create(string{"a"}, string{"b"});
+  strings.set_value(3, string{"d"});
+  ASSERT_FALSE(strings.is_vector());
+  ASSERT_FALSE(strings.is_vector_with_holes());
+}
+
+TEST(array_test, test_mutate_shared_vector_with_holes) {
+  auto arr = array<int64_t>::create(0, 1, 2);
+  arr.set_value(4, 4);
+  ASSERT_TRUE(arr.is_vector_with_holes());
+  // no effect
+  arr.mutate_if_shared();
+
+  const auto arr_copy = arr;
+  ASSERT_TRUE(arr.is_equal_inner_pointer(arr_copy));
+
+  for (auto it : arr) {
+    it.get_value() *= 10;
+  }
+  ASSERT_FALSE(arr.is_equal_inner_pointer(arr_copy));
+  ASSERT_TRUE(arr.is_vector_with_holes());
+  ASSERT_TRUE(arr_copy.is_vector_with_holes());
+  ASSERT_EQ(dump_int_keys_array(arr), (std::vector<std::pair<int64_t, double>>{{0, 0}, {1, 10}, {2, 20}, {4, 40}}));
+  ASSERT_EQ(dump_int_keys_array(arr_copy), (std::vector<std::pair<int64_t, double>>{{0, 0}, {1, 1}, {2, 2}, {4, 4}}));
+  ASSERT_EQ(arr.estimate_memory_usage(), arr_copy.estimate_memory_usage());
+}
+
+TEST(array_test, test_vector_with_holes_renumbering) {
+  auto arr = array<int64_t>::create(5, 4, 3, 2, 1);
+  arr.unset(int64_t{1});
+  arr.set_value(7, 0);
+  ASSERT_TRUE(arr.is_vector_with_holes());
+
+  auto shifted = arr;
+  ASSERT_EQ(shifted.shift(), 5);
+  ASSERT_TRUE(shifted.is_vector());
+  ASSERT_EQ(dump_int_keys_array(shifted), (std::vector<std::pair<int64_t, double>>{{0, 3}, {1, 2}, {2, 1}, {3, 0}}));
+
+  auto unshifted = arr;
+  ASSERT_EQ(unshifted.unshift(6), 6);
+  ASSERT_TRUE(unshifted.is_vector());
+  ASSERT_EQ(dump_int_keys_array(unshifted), (std::vector<std::pair<int64_t, double>>{{0, 6}, {1, 5}, {2, 3}, {3, 2}, {4, 1}, {5, 0}}));
+
+  auto sorted = arr;
+  sorted.sort([](int64_t lhs, int64_t rhs) { return lhs < rhs ? -1 : lhs > rhs; }, true);
+  ASSERT_TRUE(sorted.is_vector());
+  ASSERT_EQ(dump_int_keys_array(sorted), (std::vector<std::pair<int64_t, double>>{{0, 0}, {1, 1}, {2, 2}, {3, 3}, {4, 5}}));
+
+  array<double> converted = arr;
+  ASSERT_FALSE(converted.is_vector());
+  ASSERT_EQ(dump_int_keys_array(converted), dump_int_keys_array(arr));
+  ASSERT_EQ(converted.get_next_key(), arr.get_next_key());
+
+  auto merged = arr + array<int64_t>::create(10, 11, 12, 13, 14, 15, 16, 17, 18);
+  ASSERT_EQ(dump_int_keys_array(merged), (std::vector<std::pair<int64_t, double>>{{0, 5}, {2, 3}, {3, 2}, {4, 1}, {7, 0}, {1, 11}, {5, 15}, {6, 16}, {8, 18}}));
+}
+
+// the vector with holes must behave exactly as the map it replaces, array<mixed> never has holes
+TEST(array_test, test_vector_with_holes_as_map) {
+  srand(42);
+  for (int iteration = 0; iteration != 300; ++iteration) {
+    array<int64_t> arr;
+    array<mixed> reference;
+    for (int op = 0; op != 200; ++op) {
+      const int64_t max_key = arr.get_next_key();
+      const int64_t key = rand() % 16 == 0 ? rand() % (max_key + 2) : max_key + rand() % 4;
+      const int64_t value = rand() % 1000;
+      switch (rand() % 10) {
+        case 0:
+        case 1:
+        case 2:
+          arr.set_value(key, value);
+          reference.set_value(key, value);
+          break;
+        case 3:
+          arr.push_back(value);
+          reference.push_back(value);
+          break;
+        case 4:
+        case 5:
+        case 6: {
+          // the rebuilt map doesn't keep the max key of the unset values, so the max key isn't unset
+          const int64_t existing_key = rand() % (max_key + 1);
+          if (existing_key + 1 < max_key) {
+            ASSERT_EQ(arr.unset(existing_key), reference.unset(existing_key).to_int());
+          }
+          break;
+        }
+        case 7: {
+          const auto copy = arr;
+          const auto reference_copy = reference;
+          const auto copy_dump = dump_int_keys_array(copy);
+          arr[key] += value;
+          reference[key] = reference.get_value(key).to_int() + value;
+          ASSERT_EQ(dump_int_keys_array(copy), copy_dump);
+          break;
+        }
+        case 8:
+          ASSERT_EQ(arr.has_key(key), reference.has_key(key));
+          break;
+        default:
+          if (rand() % 10 == 0) {
+            arr.sort([](int64_t lhs, int64_t rhs) { return lhs < rhs ? -1 : lhs > rhs; }, true);
+            reference.sort([](const mixed &lhs, const mixed &rhs) { return lhs.to_int() < rhs.to_int() ? -1 : lhs.to_int() > rhs.to_int(); }, true);
+          }
+          break;
+      }
+      ASSERT_EQ(arr.count(), reference.count());
+      ASSERT_EQ(arr.get_next_key(), reference.get_next_key());
+      ASSERT_EQ(dump_int_keys_array(arr), dump_int_keys_array(reference));
+    }
+  }
+}
@@ -0,0 +1,68 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include <cstring>
+#include <gtest/gtest.h>
+
+#include "runtime/memory_resource/heap_resource.h"
+
+namespace mr = memory_resource;
+
+TEST(heap_resource_test, test_constants_region) {
+  mr::heap_resource resource;
+  resource.open_constants_region(1024 * 1024);
+
+  char *first = static_cast<char *>(resource.allocate(10));
+  std::memset(first, 'a', 10);
+  char *second = static_cast<char *>(resource.allocate0(100));
+  ASSERT_EQ(second - first, 16);
+  for (size_t i = 0; i < 100; ++i) {
+    ASSERT_EQ(second[i], 0);
+  }
+  ASSERT_EQ(resource.memory_used(), 110);
+  ASSERT_EQ(resource.constants_region_used(), 16 + 112);
+
+  // the last allocation is extended in place, the others are moved
+  ASSERT_EQ(resource.reallocate(second, 200, 100), second);
+  char *first_moved = static_cast<char *>(resource.reallocate(first, 20, 10));
+  ASSERT_EQ(first_moved, second + 208);
+  ASSERT_EQ(std::string(first_moved, 10), std::string(10, 'a'));
+  ASSERT_EQ(resource.memory_used(), 220);
+
+  // the last allocation space is reused
+  resource.deallocate(first_moved, 20);
+  ASSERT_EQ(resource.constants_region_used(), 16 + 208);
+  std::memset(resource.allocate(20), 'b', 20);
+  resource.deallocate(second + 208, 20);
+  char *zeroed = static_cast<char *>(resource.allocate0(20));
+  ASSERT_EQ(zeroed, second + 208);
+  ASSERT_EQ(std::string(zeroed, 20), std::string(20, '\0'));
+
+  resource.close_constants_region();
+  ASSERT_EQ(resource.constants_region_used(), 16 + 208 + 32);
+
+  // the allocations after the region is closed are done with malloc
+  void *heap = resource.allocate(16);
+  ASSERT_NE(heap, second + 240);
+  resource.deallocate(heap, 16);
+
+  // the region memory may still be reallocated and freed
+  char *moved = static_cast<char *>(resource.reallocate(second, 300, 200));
+  ASSERT_NE(moved, second);
+  resource.deallocate(moved, 300);
+  resource.deallocate(zeroed, 20);
+  ASSERT_EQ(resource.memory_used(), 0);
+}
+
+TEST(heap_resource_test, test_constants_region_overflow) {
+  mr::heap_resource resource;
+  resource.open_constants_region(1);
+  void *small = resource.allocate(4000);
+  void *large = resource.allocate(10000);
+  ASSERT_EQ(resource.constants_region_used(), 4000);
+  resource.deallocate(large, 10000);
+  resource.close_constants_region();
+  resource.deallocate(small, 4000);
+  ASSERT_EQ(resource.memory_used(), 0);
+}
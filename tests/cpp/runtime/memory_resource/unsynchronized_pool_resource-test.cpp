@@ -292,4 +292,53 @@ TEST(unsynchronized_pool_resource_test, test_auto_defragmentation_small_piece) {
   ASSERT_EQ(mem_stats.small_memory_pieces, 0);
 
   resource.deallocate(mem64, 64);
-}
\ No newline at end of file
+}
+namespace {
+
+size_t sampled_allocations = 0;
+size_t sampled_bytes = 0;
+
+int64_t sample_every_kilobyte(void *mem, size_t size) noexcept {
+  if (mem) {
+    ++sampled_allocations;
+    sampled_bytes += size;
+  }
+  return 1024;
+}
+
+} // namespace
+
+TEST(unsynchronized_pool_resource_test, test_allocation_sampler) {
+  std::array<char, 1024 * 128> some_memory{};
+  memory_resource::unsynchronized_pool_resource resource;
+  resource.init(some_memory.data(), some_memory.size());
+
+  resource.set_allocation_sampler(sample_every_kilobyte, 1024);
+  // 1024 / 64 allocations pass without the sampling, the next one crosses the interval
+  for (int i = 0; i < 16; ++i) {
+    resource.deallocate(resource.allocate(64), 64);
+  }
+  ASSERT_EQ(sampled_allocations, 0);
+  void *mem = resource.allocate(64);
+  ASSERT_EQ(sampled_allocations, 1);
+  ASSERT_EQ(sampled_bytes, 64);
+  resource.deallocate(mem, 64);
+
+  // the sampler survives the reinitialization, every 17th allocation is sampled
+  resource.hard_reset();
+  for (int i = 0; i < 17 * 10; ++i) {
+    resource.deallocate(resource.allocate(64), 64);
+  }
+  ASSERT_EQ(sampled_allocations, 11);
+
+  // an allocation bigger than the interval is always sampled
+  mem = resource.allocate(4096);
+  ASSERT_EQ(sampled_allocations, 12);
+  resource.deallocate(mem, 4096);
+
+  resource.set_allocation_sampler(nullptr, 0);
+  for (int i = 0; i < 1000; ++i) {
+    resource.deallocate(resource.allocate(1024), 1024);
+  }
+  ASSERT_EQ(sampled_allocations, 12);
+}
@@ -16,7 +16,9 @@ prepend(RUNTIME_TESTS_SOURCES ${BASE_DIR}/tests/cpp/runtime/
         memory_resource/details/memory_chunk_tree-test.cpp
         memory_resource/details/memory_ordered_chunk_list-test.cpp
         memory_resource/extra-memory-pool-test.cpp
+        memory_resource/heap_resource-test.cpp
         memory_resource/unsynchronized_pool_resource-test.cpp
+        script-phases-test.cpp
         string-list-test.cpp
         string-test.cpp
         zstd-test.cpp)
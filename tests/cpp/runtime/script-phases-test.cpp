@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include "runtime/script-phases.h"
+
+TEST(script_phases_test, test_outermost_phase_only) {
+  auto &stats = vk::singleton<ScriptPhasesStats>::get();
+  stats.reset();
+
+  ASSERT_TRUE(stats.try_enter());
+  ASSERT_FALSE(stats.try_enter());
+  stats.leave(ScriptPhase::json, 100);
+  ASSERT_TRUE(stats.try_enter());
+  stats.leave(ScriptPhase::json, 20);
+
+  stats.for_each_phase([](ScriptPhase phase, uint64_t spent_tsc) {
+    ASSERT_EQ(spent_tsc, phase == ScriptPhase::json ? 120 : 0);
+  });
+
+  stats.reset();
+  stats.for_each_phase([](ScriptPhase, uint64_t spent_tsc) {
+    ASSERT_EQ(spent_tsc, 0);
+  });
+}
+
+TEST(script_phases_test, test_rpc_actors_overflow) {
+  auto &stats = vk::singleton<ScriptPhasesStats>::get();
+  stats.reset();
+
+  for (int64_t actor_id = 1; actor_id <= 2 * ScriptPhasesStats::MAX_RPC_ACTORS; ++actor_id) {
+    stats.add_rpc_actor_wait(actor_id, 10);
+  }
+  stats.add_rpc_actor_wait(1, 5);
+
+  size_t actors = 0;
+  uint64_t total_queries = 0;
+  stats.for_each_rpc_actor([&](const ScriptPhasesStats::RpcActorStats &actor_stats) {
+    ++actors;
+    total_queries += actor_stats.queries;
+    if (actor_stats.actor_id == 1) {
+      ASSERT_EQ(actor_stats.queries, 2);
+      ASSERT_EQ(actor_stats.wait_tsc, 15);
+    }
+    if (actor_stats.actor_id == ScriptPhasesStats::OTHER_RPC_ACTORS_ID) {
+      ASSERT_EQ(actor_stats.queries, ScriptPhasesStats::MAX_RPC_ACTORS + 1);
+    }
+  });
+  ASSERT_EQ(actors, ScriptPhasesStats::MAX_RPC_ACTORS);
+  ASSERT_EQ(total_queries, 2 * ScriptPhasesStats::MAX_RPC_ACTORS + 1);
+}
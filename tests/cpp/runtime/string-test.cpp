@@ -82,6 +82,38 @@ TEST(string_test, test_copy_and_make_not_shared) {
   ASSERT_EQ(str3.get_reference_counter(), 1);
 }
 
+TEST(string_test, test_hash) {
+  auto expected_hash = [](const string &s) { return string_hash(s.c_str(), s.size()); };
+
+  string str1{"hello world"};
+  ASSERT_EQ(str1.hash(), expected_hash(str1));
+  // the cached hash is shared with the copies and kept by the clones
+  const string str2 = str1;
+  ASSERT_EQ(str2.hash(), expected_hash(str1));
+  const string str3 = str1.copy_and_make_not_shared();
+  ASSERT_EQ(str3.hash(), expected_hash(str3));
+
+  // the changes must drop the cached hash
+  str1.append("!");
+  ASSERT_EQ(str1.hash(), expected_hash(str1));
+  str1[0] = 'H';
+  ASSERT_EQ(str1.hash(), expected_hash(str1));
+  str1.buffer()[1] = 'E';
+  ASSERT_EQ(str1.hash(), expected_hash(str1));
+  str1.shrink(5);
+  ASSERT_EQ(str1.hash(), expected_hash(str1));
+  str1.assign("other", 5);
+  ASSERT_EQ(str1.hash(), expected_hash(str1));
+  ASSERT_EQ(str2.hash(), expected_hash(string{"hello world"}));
+
+  alignas(8) char raw[64];
+  ASSERT_EQ(string_raw(raw, sizeof(raw), "raw string", 10), string_raw_len(10));
+  string const_str;
+  const_str.assign_raw(raw);
+  ASSERT_EQ(const_str, string{"raw string"});
+  ASSERT_EQ(const_str.hash(), expected_hash(const_str));
+}
+
 TEST(string_test, test_to_int) {
   struct TestCase {
     std::string s;
@@ -0,0 +1,258 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2023 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <poll.h>
+#include <sched.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "common/macos-ports.h"
+#include "common/wrappers/memory-utils.h"
+
+#include "server/job-workers/job-ring.h"
+
+using namespace job_workers;
+
+namespace {
+
+JobSharedMessage *as_message(size_t value) {
+  return reinterpret_cast<JobSharedMessage *>(value);
+}
+
+size_t as_value(JobSharedMessage *message) {
+  return reinterpret_cast<size_t>(message);
+}
+
+void wait_children(const pid_t *children, size_t count) {
+  for (size_t i = 0; i != count; ++i) {
+    int status = 0;
+    ASSERT_GE(waitpid(children[i], &status, 0), 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+  }
+}
+
+void wait_readable(int fd) {
+  pollfd poll_fd{fd, POLLIN, 0};
+  while (poll(&poll_fd, 1, -1) != 1) {
+  }
+}
+
+} // namespace
+
+TEST(job_ring_test, test_push_pop) {
+  JobRing *ring = JobRing::create_in_shared_memory(1000, 1, 1);
+  ASSERT_EQ(ring->get_capacity(), 1024);
+  ASSERT_TRUE(ring->empty());
+  ASSERT_EQ(ring->pop(0), nullptr);
+
+  for (size_t i = 1; i <= ring->get_capacity(); ++i) {
+    ASSERT_TRUE(ring->push(as_message(i), 0));
+  }
+  ASSERT_FALSE(ring->push(as_message(100500), 0));
+  ASSERT_FALSE(ring->empty());
+
+  for (size_t i = 1; i <= ring->get_capacity() / 2; ++i) {
+    ASSERT_EQ(as_value(ring->pop(0)), i);
+  }
+  // the ring is wrapped around
+  for (size_t i = ring->get_capacity() + 1; i <= ring->get_capacity() * 3 / 2; ++i) {
+    ASSERT_TRUE(ring->push(as_message(i), 0));
+  }
+  ASSERT_FALSE(ring->push(as_message(100500), 0));
+  for (size_t i = ring->get_capacity() / 2 + 1; i <= ring->get_capacity() * 3 / 2; ++i) {
+    ASSERT_EQ(as_value(ring->pop(0)), i);
+  }
+  ASSERT_TRUE(ring->empty());
+  ASSERT_EQ(ring->pop(0), nullptr);
+}
+
+TEST(job_ring_test, test_sleeping_consumers) {
+  JobRing *ring = JobRing::create_in_shared_memory(16, 3, 1);
+  ASSERT_FALSE(ring->has_sleeping_consumers());
+
+  ring->go_to_sleep(1);
+  ring->go_to_sleep(1);
+  ring->go_to_sleep(2);
+  ASSERT_TRUE(ring->has_sleeping_consumers());
+
+  ring->wake_up(1);
+  ASSERT_TRUE(ring->has_sleeping_consumers());
+  ring->wake_up(2);
+  ASSERT_FALSE(ring->has_sleeping_consumers());
+  // the master wakes up the dead consumers, they can be already awake
+  ring->wake_up(0);
+  ring->wake_up(2);
+  ASSERT_FALSE(ring->has_sleeping_consumers());
+}
+
+TEST(job_ring_test, test_multiple_producers_and_consumers) {
+  constexpr size_t producers_count = 4;
+  constexpr size_t consumers_count = 4;
+  constexpr size_t messages_per_producer = 20000;
+
+  JobRing *ring = JobRing::create_in_shared_memory(64, consumers_count, producers_count);
+  auto *consumed = static_cast<std::atomic<size_t> *>(mmap_shared(2 * sizeof(std::atomic<size_t>)));
+  auto *consumed_sum = consumed + 1;
+
+  std::array<pid_t, producers_count + consumers_count> children{};
+  for (size_t i = 0; i != producers_count; ++i) {
+    if (!(children[i] = fork())) {
+      prctl(PR_SET_PDEATHSIG, SIGKILL);
+      for (size_t j = 1; j <= messages_per_producer; ++j) {
+        while (!ring->push(as_message(i * messages_per_producer + j), i)) {
+          sched_yield();
+        }
+      }
+      _exit(0);
+    }
+  }
+  for (size_t i = 0; i != consumers_count; ++i) {
+    if (!(children[producers_count + i] = fork())) {
+      prctl(PR_SET_PDEATHSIG, SIGKILL);
+      while (consumed->load() != producers_count * messages_per_producer) {
+        if (JobSharedMessage *message = ring->pop(i)) {
+          *consumed_sum += as_value(message);
+          ++*consumed;
+        } else {
+          sched_yield();
+        }
+      }
+      _exit(0);
+    }
+  }
+  wait_children(children.data(), children.size());
+
+  const size_t total = producers_count * messages_per_producer;
+  ASSERT_EQ(consumed->load(), total);
+  ASSERT_EQ(consumed_sum->load(), total * (total + 1) / 2);
+  ASSERT_TRUE(ring->empty());
+}
+
+TEST(job_ring_test, test_dead_producers_and_consumers) {
+  constexpr uint16_t processes_count = 4;
+  constexpr uint16_t master_id = processes_count;
+  constexpr size_t kills = 300;
+
+  JobRing *ring = JobRing::create_in_shared_memory(8, processes_count + 1, processes_count + 1);
+  // nothing is stalled by the process, which has finished its push and pop
+  ASSERT_TRUE(ring->push(as_message(1), 0));
+  ASSERT_EQ(as_value(ring->pop(0)), 1);
+  ASSERT_FALSE(ring->skip_cell_of_dead_producer(0));
+  ASSERT_FALSE(ring->release_cell_of_dead_consumer(0));
+
+  size_t stalled = 0;
+  for (size_t i = 0; i != kills; ++i) {
+    const auto id = static_cast<uint16_t>(i % processes_count);
+    const pid_t child_pid = fork();
+    if (!child_pid) {
+      prctl(PR_SET_PDEATHSIG, SIGKILL);
+      while (true) {
+        ring->push(as_message(id + 1), id);
+        ring->pop(id);
+      }
+    }
+    usleep(static_cast<useconds_t>(rand() % 200));
+    ASSERT_EQ(kill(child_pid, SIGKILL), 0);
+    ASSERT_EQ(waitpid(child_pid, nullptr, 0), child_pid);
+    stalled += ring->skip_cell_of_dead_producer(id);
+    stalled += ring->release_cell_of_dead_consumer(id);
+
+    // the process could be killed in the middle of the push or the pop, the ring isn't stalled anyway
+    while (ring->pop(master_id)) {
+    }
+    ASSERT_TRUE(ring->empty());
+    for (size_t j = 1; j <= ring->get_capacity(); ++j) {
+      ASSERT_TRUE(ring->push(as_message(j), master_id));
+    }
+    for (size_t j = 1; j <= ring->get_capacity(); ++j) {
+      ASSERT_EQ(as_value(ring->pop(master_id)), j);
+    }
+  }
+  fprintf(stderr, "%zu of %zu killed processes stalled the ring\n", stalled, kills);
+}
+
+// It isn't a test actually, it compares the job dispatch latency through the pipes (as it was before) and through the rings
+TEST(job_ring_test, test_dispatch_latency) {
+  constexpr size_t iterations = 20000;
+
+  int requests_pipe[2];
+  int results_pipe[2];
+  ASSERT_EQ(pipe(requests_pipe), 0);
+  ASSERT_EQ(pipe(results_pipe), 0);
+
+  JobRing *requests_ring = JobRing::create_in_shared_memory(16, 1, 1);
+  JobRing *results_ring = JobRing::create_in_shared_memory(16, 1, 1);
+  JobWakeupFd requests_wakeup_fd;
+  JobWakeupFd results_wakeup_fd;
+  ASSERT_TRUE(requests_wakeup_fd.init(true));
+  ASSERT_TRUE(results_wakeup_fd.init(false));
+
+  const pid_t child_pid = fork();
+  if (!child_pid) {
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    JobSharedMessage *message = nullptr;
+    for (size_t i = 0; i != iterations; ++i) {
+      wait_readable(requests_pipe[0]);
+      if (read(requests_pipe[0], &message, sizeof(message)) != sizeof(message) || write(results_pipe[1], &message, sizeof(message)) != sizeof(message)) {
+        _exit(1);
+      }
+    }
+    for (size_t i = 0; i != iterations; ++i) {
+      // the job worker protocol: go to sleep, check the ring once more and wait for the wakeup
+      requests_ring->go_to_sleep(0);
+      while (!(message = requests_ring->pop(0))) {
+        wait_readable(requests_wakeup_fd.get_read_fd());
+        requests_wakeup_fd.consume();
+      }
+      requests_ring->wake_up(0);
+      results_ring->push(message, 0);
+      if (results_ring->has_sleeping_consumers()) {
+        results_wakeup_fd.notify();
+      }
+    }
+    _exit(0);
+  }
+
+  using clock = std::chrono::steady_clock;
+  const auto pipes_start = clock::now();
+  for (size_t i = 1; i <= iterations; ++i) {
+    JobSharedMessage *message = as_message(i);
+    ASSERT_EQ(write(requests_pipe[1], &message, sizeof(message)), sizeof(message));
+    wait_readable(results_pipe[0]);
+    ASSERT_EQ(read(results_pipe[0], &message, sizeof(message)), sizeof(message));
+    ASSERT_EQ(as_value(message), i);
+  }
+  const auto pipes_time = clock::now() - pipes_start;
+
+  size_t wakeups = 0;
+  const auto rings_start = clock::now();
+  for (size_t i = 1; i <= iterations; ++i) {
+    ASSERT_TRUE(requests_ring->push(as_message(i), 0));
+    if (requests_ring->has_sleeping_consumers()) {
+      ++wakeups;
+      requests_wakeup_fd.notify();
+    }
+    JobSharedMessage *message = nullptr;
+    results_ring->go_to_sleep(0);
+    while (!(message = results_ring->pop(0))) {
+      wait_readable(results_wakeup_fd.get_read_fd());
+      results_wakeup_fd.consume();
+    }
+    results_ring->wake_up(0);
+    ASSERT_EQ(as_value(message), i);
+  }
+  const auto rings_time = clock::now() - rings_start;
+  wait_children(&child_pid, 1);
+
+  using std::chrono::nanoseconds;
+  fprintf(stderr, "job dispatch round trip: pipes %.0f ns, rings %.0f ns (%zu of %zu jobs needed a wakeup)\n",
+          static_cast<double>(std::chrono::duration_cast<nanoseconds>(pipes_time).count()) / iterations,
+          static_cast<double>(std::chrono::duration_cast<nanoseconds>(rings_time).count()) / iterations,
+          wakeups, iterations);
+}
@@ -0,0 +1,119 @@
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "server/sampling-profiler.h"
+
+namespace {
+
+void *as_frame(size_t value) {
+  return reinterpret_cast<void *>(value);
+}
+
+std::vector<std::string> symbolize_test_frames(const std::vector<void *> &frames) {
+  std::vector<std::string> names;
+  for (void *frame : frames) {
+    // the odd frames are not resolved
+    const auto value = reinterpret_cast<size_t>(frame);
+    names.emplace_back(value % 2 ? "" : "f" + std::to_string(value));
+  }
+  return names;
+}
+
+// returns the folded lines with their samples
+std::map<std::string, uint64_t> dump_folded(SampledStacksTable &table, uint64_t &lost_samples) {
+  FILE *out = tmpfile();
+  lost_samples = table.dump_and_clear(out, symbolize_test_frames);
+  rewind(out);
+  std::map<std::string, uint64_t> stacks;
+  char line[4096];
+  while (fgets(line, sizeof(line), out)) {
+    std::string folded{line};
+    EXPECT_EQ(folded.back(), '\n');
+    folded.pop_back();
+    const size_t samples_pos = folded.rfind(' ');
+    EXPECT_NE(samples_pos, std::string::npos);
+    EXPECT_TRUE(stacks.emplace(folded.substr(0, samples_pos), std::stoull(folded.substr(samples_pos + 1))).second);
+  }
+  fclose(out);
+  return stacks;
+}
+
+} // namespace
+
+TEST(sampling_profiler_test, test_add_and_dump) {
+  auto table = std::make_unique<SampledStacksTable>();
+  // the leaf frame is the first one
+  void *stack1[] = {as_frame(2), as_frame(4), as_frame(6)};
+  void *stack2[] = {as_frame(8), as_frame(4), as_frame(6)};
+  void *stack3[] = {as_frame(3)};
+  for (int i = 0; i < 5; ++i) {
+    table->add_stack(stack1, 3);
+  }
+  table->add_stack(stack2, 3);
+  table->add_stack(stack3, 1);
+  table->add_stack(stack2, 3);
+
+  uint64_t lost_samples = 0;
+  const auto stacks = dump_folded(*table, lost_samples);
+  ASSERT_EQ(lost_samples, 0);
+  char unresolved[32];
+  snprintf(unresolved, sizeof(unresolved), "%p", as_frame(3));
+  const std::map<std::string, uint64_t> expected{{"f6;f4;f2", 5}, {"f6;f4;f8", 2}, {unresolved, 1}};
+  ASSERT_EQ(stacks, expected);
+
+  // the table is cleared by the dump
+  ASSERT_TRUE(dump_folded(*table, lost_samples).empty());
+  table->add_stack(stack2, 3);
+  ASSERT_EQ(dump_folded(*table, lost_samples), (std::map<std::string, uint64_t>{{"f6;f4;f8", 1}}));
+}
+
+TEST(sampling_profiler_test, test_overflow) {
+  auto table = std::make_unique<SampledStacksTable>();
+  const size_t stacks_count = SampledStacksTable::MAX_STACKS * 2;
+  for (size_t i = 0; i < stacks_count; ++i) {
+    void *stack[] = {as_frame(2 * i + 2), as_frame(2 * i + 4)};
+    table->add_stack(stack, 2);
+  }
+
+  uint64_t lost_samples = 0;
+  const auto stacks = dump_folded(*table, lost_samples);
+  ASSERT_GT(lost_samples, 0);
+  ASSERT_LE(stacks.size(), SampledStacksTable::MAX_STACKS);
+  uint64_t samples = 0;
+  for (const auto &stack : stacks) {
+    samples += stack.second;
+  }
+  ASSERT_EQ(samples + lost_samples, stacks_count);
+
+  // the lost samples are reset by the dump, the cleared table accepts the new stacks
+  void *stack[] = {as_frame(2)};
+  table->add_stack(stack, 1);
+  ASSERT_EQ(dump_folded(*table, lost_samples), (std::map<std::string, uint64_t>{{"f2", 1}}));
+  ASSERT_EQ(lost_samples, 0);
+}
+
+TEST(sampling_profiler_test, test_tables_flip) {
+  auto tables = std::make_unique<SampledStacksTables>();
+  void *stack1[] = {as_frame(2)};
+  void *stack2[] = {as_frame(4)};
+  uint64_t lost_samples = 0;
+
+  SampledStacksTable *first = &tables->active();
+  ASSERT_NE(first, &tables->settled());
+  tables->active().add_stack(stack1, 1);
+  ASSERT_TRUE(dump_folded(tables->settled(), lost_samples).empty());
+
+  tables->flip();
+  ASSERT_EQ(&tables->settled(), first);
+  tables->active().add_stack(stack2, 1);
+  ASSERT_EQ(dump_folded(tables->settled(), lost_samples), (std::map<std::string, uint64_t>{{"f2", 1}}));
+
+  tables->flip();
+  ASSERT_EQ(&tables->active(), first);
+  ASSERT_EQ(dump_folded(tables->settled(), lost_samples), (std::map<std::string, uint64_t>{{"f4", 1}}));
+  ASSERT_TRUE(dump_folded(tables->active(), lost_samples).empty());
+}
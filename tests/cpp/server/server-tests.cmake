@@ -1,8 +1,11 @@
 prepend(SERVER_TESTS_SOURCES ${BASE_DIR}/tests/cpp/server/
+        job-workers/job-ring-test.cpp
         job-workers/shared-memory-manager-test.cpp
         cluster-name-test.cpp
         confdata-binlog-events-test.cpp
         php-engine-test.cpp
+        sampling-profiler-test.cpp
+        workers-autoscaler-test.cpp
         workers-control-test.cpp)
 
 if(COMPILER_GCC)
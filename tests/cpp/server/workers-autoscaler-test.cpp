@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include "server/workers-autoscaler.h"
+
+namespace {
+
+WorkersAutoscaler::Load make_load(double general_running_avg, double job_running_avg, int32_t job_queue_size, uint64_t cpu_total, uint64_t cpu_idle) {
+  WorkersAutoscaler::Load load;
+  load.general_workers = 80;
+  load.job_workers = 20;
+  load.general_running_avg = general_running_avg;
+  load.job_running_avg = job_running_avg;
+  load.job_queue_size = job_queue_size;
+  load.cpu_total = cpu_total;
+  load.cpu_idle = cpu_idle;
+  return load;
+}
+
+} // namespace
+
+TEST(workers_autoscaler_test, test_bounds) {
+  auto &autoscaler = vk::singleton<WorkersAutoscaler>::get();
+  ASSERT_FALSE(autoscaler.enabled());
+  ASSERT_FALSE(autoscaler.set_job_workers_ratio_bounds(0.5, 0.5));
+  ASSERT_FALSE(autoscaler.set_job_workers_ratio_bounds(0.1, 1));
+  ASSERT_FALSE(autoscaler.set_job_workers_ratio_bounds(-0.1, 0.5));
+  ASSERT_TRUE(autoscaler.set_job_workers_ratio_bounds(0.1, 0.3));
+  ASSERT_TRUE(autoscaler.enabled());
+
+  autoscaler.init(100);
+  ASSERT_EQ(autoscaler.get_min_job_workers(), 10);
+  ASSERT_EQ(autoscaler.get_max_job_workers(), 30);
+}
+
+TEST(workers_autoscaler_test, test_decisions) {
+  auto &autoscaler = vk::singleton<WorkersAutoscaler>::get();
+  ASSERT_TRUE(autoscaler.set_job_workers_ratio_bounds(0.1, 0.3));
+  autoscaler.init(100);
+
+  uint64_t cpu_total = 0;
+  uint64_t cpu_idle = 0;
+  double now = 1000;
+  auto run = [&](int samples, double general_running_avg, double job_running_avg, int32_t job_queue_size, uint64_t idle_per_tick) {
+    WorkerType result = WorkerType::types_count;
+    for (int i = 0; i < samples; ++i) {
+      cpu_total += 100;
+      cpu_idle += idle_per_tick;
+      const WorkerType decision = autoscaler.on_load(now++, make_load(general_running_avg, job_running_avg, job_queue_size, cpu_total, cpu_idle));
+      if (decision != WorkerType::types_count) {
+        EXPECT_EQ(result, WorkerType::types_count);
+        result = decision;
+      }
+    }
+    return result;
+  };
+
+  // the balanced load
+  ASSERT_EQ(run(100, 60, 15, 0, 50), WorkerType::types_count);
+  // the jobs are queued, but not for long enough
+  ASSERT_EQ(run(WorkersAutoscaler::STABLE_SAMPLES - 1, 20, 20, 50, 50), WorkerType::types_count);
+  ASSERT_EQ(run(1, 60, 15, 0, 50), WorkerType::types_count);
+
+  ASSERT_EQ(run(WorkersAutoscaler::STABLE_SAMPLES, 20, 20, 50, 50), WorkerType::general_worker);
+  ASSERT_EQ(autoscaler.get_stats().general_to_job, 1);
+  // cooldown
+  ASSERT_EQ(run(WorkersAutoscaler::STABLE_SAMPLES, 20, 20, 50, 50), WorkerType::types_count);
+  ASSERT_EQ(run(WorkersAutoscaler::COOLDOWN_SEC, 20, 20, 50, 50), WorkerType::general_worker);
+  ASSERT_EQ(autoscaler.get_stats().general_to_job, 2);
+
+  // there is no idle CPU, moving workers doesn't help
+  ASSERT_EQ(run(WorkersAutoscaler::COOLDOWN_SEC * 2, 79, 2, 0, 1), WorkerType::types_count);
+  ASSERT_GT(autoscaler.get_stats().skipped_busy_cpu, 0);
+  ASSERT_EQ(run(WorkersAutoscaler::STABLE_SAMPLES, 79, 2, 0, 50), WorkerType::job_worker);
+  ASSERT_EQ(autoscaler.get_stats().job_to_general, 1);
+}
+
+TEST(workers_autoscaler_test, test_bounds_are_respected) {
+  auto &autoscaler = vk::singleton<WorkersAutoscaler>::get();
+  ASSERT_TRUE(autoscaler.set_job_workers_ratio_bounds(0.1, 0.2));
+  autoscaler.init(100);
+
+  double now = 100000;
+  for (uint64_t tick = 1; tick < 1000; ++tick) {
+    // the job workers count is already at the max bound
+    ASSERT_EQ(autoscaler.on_load(now++, make_load(10, 20, 100, tick * 100, tick * 50)), WorkerType::types_count);
+  }
+}
@@ -79,4 +79,26 @@ TEST(workers_control_test, test_workers_count) {
   ASSERT_EQ(control.on_worker_creating(WorkerType::job_worker), 300);
   ASSERT_WORKERS(WorkerType::general_worker, 247, 2, 356);
   ASSERT_WORKERS(WorkerType::job_worker, 106, 1, 356);
+
+  ASSERT_EQ(control.get_boundary_unique_id(WorkerType::general_worker), 248);
+  ASSERT_EQ(control.get_boundary_unique_id(WorkerType::job_worker), 249);
+  ASSERT_FALSE(control.try_move_boundary_worker(WorkerType::general_worker));
+  ASSERT_FALSE(control.try_move_boundary_worker(WorkerType::job_worker));
+
+  control.on_worker_removing(WorkerType::general_worker, false, 248);
+  ASSERT_TRUE(control.try_move_boundary_worker(WorkerType::general_worker));
+  ASSERT_EQ(control.get_count(WorkerType::general_worker), 248);
+  ASSERT_EQ(control.get_count(WorkerType::job_worker), 108);
+  ASSERT_EQ(control.get_boundary_unique_id(WorkerType::job_worker), 248);
+  ASSERT_EQ(control.on_worker_creating(WorkerType::job_worker), 248);
+  ASSERT_WORKERS(WorkerType::general_worker, 246, 2, 356);
+  ASSERT_WORKERS(WorkerType::job_worker, 107, 1, 356);
+
+  control.on_worker_removing(WorkerType::job_worker, false, 248);
+  ASSERT_TRUE(control.try_move_boundary_worker(WorkerType::job_worker));
+  ASSERT_EQ(control.get_count(WorkerType::general_worker), 249);
+  ASSERT_EQ(control.get_count(WorkerType::job_worker), 107);
+  ASSERT_EQ(control.on_worker_creating(WorkerType::general_worker), 248);
+  ASSERT_WORKERS(WorkerType::general_worker, 247, 2, 356);
+  ASSERT_WORKERS(WorkerType::job_worker, 106, 1, 356);
 }
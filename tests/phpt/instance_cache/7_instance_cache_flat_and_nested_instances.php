@@ -0,0 +1,134 @@
+@ok
+<?php
+
+require_once 'kphp_tester_include.php';
+
+// there are no instances inside, the instance cache copies and destroys it without tracking the visited instances
+/** @kphp-immutable-class */
+class FlatPoint {
+  /** @var int */
+  public $x = 0;
+  /** @var float */
+  public $y = 0.0;
+  /** @var bool */
+  public $visible = true;
+
+  public function __construct(int $x, float $y) {
+    $this->x = $x;
+    $this->y = $y;
+  }
+}
+
+/** @kphp-immutable-class */
+class FlatRecord {
+  /** @var string */
+  public $name;
+  /** @var int[] */
+  public $ids;
+  /** @var mixed[] */
+  public $extra;
+  /** @var ?string */
+  public $comment = null;
+  /** @var tuple(int, string) */
+  public $pair;
+
+  public function __construct(string $name, int $ids_count) {
+    $this->name = $name;
+    $this->ids = range(1, $ids_count);
+    $this->extra = ['name' => $name, 'ids' => $this->ids, 'nested' => [1.5, false, null]];
+    $this->pair = tuple($ids_count, $name);
+  }
+}
+
+// the instances are inside, the visited instances are tracked
+/** @kphp-immutable-class */
+class NestedHolder {
+  /** @var FlatRecord */
+  public $record;
+  /** @var ?FlatPoint */
+  public $point = null;
+  /** @var FlatPoint[] */
+  public $points = [];
+  /** @var tuple(FlatPoint, string) */
+  public $tagged_point;
+
+  public function __construct(FlatRecord $record, int $points_count, bool $with_point) {
+    $this->record = $record;
+    if ($with_point) {
+      $this->point = new FlatPoint(-1, -1.5);
+    }
+    for ($i = 0; $i < $points_count; ++$i) {
+      $this->points[] = new FlatPoint($i, $i / 2);
+    }
+    $this->tagged_point = tuple(new FlatPoint(100, 0.25), "tag");
+  }
+}
+
+/** @kphp-immutable-class */
+class NestedOfNested {
+  /** @var NestedHolder[] */
+  public $holders = [];
+  /** @var FlatRecord */
+  public $common_record;
+
+  public function __construct(int $holders_count) {
+    $this->common_record = new FlatRecord("common", 3);
+    for ($i = 0; $i < $holders_count; ++$i) {
+      $this->holders[] = new NestedHolder(new FlatRecord("holder $i", $i + 1), $i, $i % 2 == 0);
+    }
+  }
+}
+
+function test_flat_instances() {
+  var_dump(instance_cache_store("flat_point", new FlatPoint(1, 2.5)));
+  var_dump(instance_cache_store("flat_record", new FlatRecord("record", 5)));
+  var_dump(instance_cache_store("flat_record_empty", new FlatRecord("", 0)));
+
+  var_dump(to_array_debug(instance_cache_fetch(FlatPoint::class, "flat_point")));
+  var_dump(to_array_debug(instance_cache_fetch(FlatRecord::class, "flat_record")));
+  var_dump(to_array_debug(instance_cache_fetch(FlatRecord::class, "flat_record_empty")));
+
+  // the same instance is stored under several keys
+  $point = new FlatPoint(7, 7.5);
+  var_dump(instance_cache_store("flat_point_1", $point));
+  var_dump(instance_cache_store("flat_point_2", $point));
+  var_dump(to_array_debug(instance_cache_fetch(FlatPoint::class, "flat_point_1")));
+  var_dump(to_array_debug(instance_cache_fetch(FlatPoint::class, "flat_point_2")));
+
+  // the stored instance is replaced and destroyed
+  var_dump(instance_cache_store("flat_record", new FlatRecord("replaced", 2)));
+  var_dump(to_array_debug(instance_cache_fetch(FlatRecord::class, "flat_record")));
+
+  var_dump(instance_cache_delete("flat_point"));
+  var_dump(!instance_cache_fetch(FlatPoint::class, "flat_point"));
+  var_dump(!instance_cache_fetch(FlatRecord::class, "flat_point_1"));
+}
+
+function test_nested_instances() {
+  $record = new FlatRecord("shared", 4);
+  var_dump(instance_cache_store("nested_holder_1", new NestedHolder($record, 3, true)));
+  var_dump(instance_cache_store("nested_holder_2", new NestedHolder($record, 0, false)));
+  // the flat instance inside the nested one is also stored alone
+  var_dump(instance_cache_store("nested_holder_record", $record));
+
+  var_dump(to_array_debug(instance_cache_fetch(NestedHolder::class, "nested_holder_1")));
+  var_dump(to_array_debug(instance_cache_fetch(NestedHolder::class, "nested_holder_2")));
+  var_dump(to_array_debug(instance_cache_fetch(FlatRecord::class, "nested_holder_record")));
+
+  var_dump(instance_cache_store("nested_of_nested", new NestedOfNested(4)));
+  $cached = instance_cache_fetch(NestedOfNested::class, "nested_of_nested");
+  var_dump(to_array_debug($cached));
+  var_dump(count($cached->holders));
+  var_dump($cached->holders[2]->point->y);
+  var_dump($cached->holders[3]->points[2]->x);
+
+  var_dump(instance_cache_store("nested_holder_1", new NestedHolder(new FlatRecord("replaced", 1), 1, false)));
+  var_dump(to_array_debug(instance_cache_fetch(NestedHolder::class, "nested_holder_1")));
+
+  var_dump(instance_cache_delete("nested_holder_2"));
+  var_dump(!instance_cache_fetch(NestedHolder::class, "nested_holder_2"));
+  var_dump(!instance_cache_fetch(FlatRecord::class, "nested_holder_1"));
+}
+
+test_flat_instances();
+test_nested_instances();
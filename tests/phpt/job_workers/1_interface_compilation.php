@@ -51,6 +51,34 @@ function test_compilation($should_start) {
   kphp_job_worker_store_response($m4);
 }
 
+function test_stream_compilation($should_start) {
+  if (!$should_start) {
+    return;
+  }
+
+  class StreamReq implements KphpJobWorkerRequest {}
+
+  class StreamResp implements KphpJobWorkerResponse {
+    public $x = 1;
+  }
+
+  $job = kphp_job_worker_start_stream(new StreamReq, -1);
+  if ($job) {
+    while ($chunk_future = kphp_job_worker_next_response_chunk($job)) {
+      $chunk = wait($chunk_future);
+      if ($chunk instanceof StreamResp) {
+        var_dump($chunk->x);
+      }
+    }
+    $resp = wait($job);
+    var_dump($resp instanceof StreamResp);
+  }
+
+  if (!kphp_job_worker_store_response_chunk(new StreamResp)) {
+    kphp_job_worker_store_response(new StreamResp);
+  }
+}
+
 function test_multiple_inheritance($x) {
   if (!$x) {
     return;
@@ -74,4 +102,5 @@ function test_multiple_inheritance($x) {
 }
 
 test_compilation(false);
+test_stream_compilation(false);
 test_multiple_inheritance(false);
@@ -0,0 +1,56 @@
+@ok
+<?php
+require_once 'kphp_tester_include.php';
+
+class A {
+  public int $id = 0;
+  public string $name = '';
+}
+
+class B {
+  public ?A $a = null;
+  /** @var A[] */
+  public $list = [];
+  /** @var int[] */
+  public $map = [];
+  /** @var mixed */
+  public $any;
+  public float $f = 0.0;
+}
+
+function test_decode_keys() {
+  // duplicated keys: the last one wins
+  $obj = JsonEncoder::decode('{"id": 1, "name": "first", "id": 2}', "A");
+  var_dump(to_array_debug($obj));
+  // escaped keys and values
+  $obj = JsonEncoder::decode('{"id": 3, "name": "тест \"q\""}', "A");
+  var_dump(to_array_debug($obj));
+  // unknown keys of all kinds are skipped
+  $obj = JsonEncoder::decode(" {\n\t\"x\": {\"y\": [1, {\"z\": null}]}, \"id\" : 4 , \"w\": \"}\" } ", "A");
+  var_dump(to_array_debug($obj));
+}
+
+function test_decode_fallbacks() {
+  $obj = JsonEncoder::decode('{"a": {"id": 5}, "list": [{"id": 6}, null, {"name": "x"}], "map": {"1": 10, "k": 20}, "any": {"0": [], "q": {}}, "f": 7}', "B");
+  var_dump(to_array_debug($obj));
+  // an object with integer keys
+  $obj = JsonEncoder::decode('{"0": 1, "id": 8}', "A");
+  var_dump(to_array_debug($obj));
+}
+
+function test_decode_errors() {
+  // errors in the fields that are not decoded are reported as well
+  $obj = JsonEncoder::decode('{"id": 1, "unused": [tru]}', "A");
+  var_dump($obj === null);
+  var_dump(JsonEncoder::getLastError() !== '');
+  $obj = JsonEncoder::decode('{"id": 1, "unused": "\u12"}', "A");
+  var_dump($obj === null);
+  var_dump(JsonEncoder::getLastError() !== '');
+  $obj = JsonEncoder::decode('{"id": 1.5}', "A");
+  var_dump($obj === null);
+  var_dump(JsonEncoder::getLastError());
+}
+
+test_decode_keys();
+test_decode_fallbacks();
+test_decode_errors();
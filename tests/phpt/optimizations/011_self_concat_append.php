@@ -0,0 +1,71 @@
+@ok
+<?php
+
+class A {
+  public $s = 'a';
+
+  public function __toString() {
+    return $this->s;
+  }
+}
+
+function modify_by_ref(string &$s) {
+  $s = 'modified';
+  return '!';
+}
+
+function test_loop() {
+  $s = '';
+  for ($i = 0; $i < 1000; ++$i) {
+    $s = $s . $i . ',';
+  }
+  var_dump(strlen($s), substr($s, -10));
+}
+
+function test_copy() {
+  $s = 'hello';
+  $t = $s;
+  $s = $s . ' world';
+  var_dump($s, $t);
+}
+
+function test_self() {
+  $s = 'ab';
+  $s = $s . $s;
+  $s = $s . '-' . $s;
+  var_dump($s);
+}
+
+function test_by_ref() {
+  $s = 'hello';
+  $s = $s . modify_by_ref($s);
+  var_dump($s);
+}
+
+function test_param(string $s, int $x, float $f, bool $b) {
+  $s = $s . $x . $f . $b . new A;
+  var_dump($s);
+  return $s;
+}
+
+function test_optional(?string $s) {
+  $s = $s . 'x';
+  var_dump($s);
+}
+
+function test_value_used() {
+  $s = 'a';
+  $t = ($s = $s . 'b');
+  var_dump($s, $t);
+}
+
+test_loop();
+test_copy();
+test_self();
+test_by_ref();
+$p = 'param';
+test_param($p, 1, 0.5, true);
+var_dump($p);
+test_optional(null);
+test_optional('y');
+test_value_used();
@@ -0,0 +1,32 @@
+@kphp_should_warn
+/expression A::\$html = A::\$html \. <...> copies the whole string in a loop, it can be replaced with A::\$html \.= <...>/
+/expression \$parts\['body'\] = \$parts\['body'\] \. <...> copies the whole string in a loop, it can be replaced with \$parts\['body'\] \.= <...>/
+/expression \$m = <...> \. \$m copies the whole string in a loop, the parts can be collected into an array and joined with implode\(\)/
+<?php
+
+class A {
+  public $html = '';
+}
+
+/**
+ * @kphp-warn-performance string-concat-in-loop
+ */
+function test() {
+  $a = new A;
+  for ($i = 0; $i != 1000; ++$i) {
+    $a->html = $a->html . "<li>" . $i . "</li>";
+  }
+
+  $parts = ['body' => ''];
+  foreach ([1, 2, 3] as $x) {
+    $parts['body'] = $parts['body'] . $x;
+  }
+
+  $m = '';
+  $i = 0;
+  while ($i++ < 10) {
+    $m = $i . ',' . $m;
+  }
+}
+
+test();
@@ -0,0 +1,33 @@
+@ok
+KPHP_ERROR_ON_WARNINGS=1
+<?php
+
+class A {
+  public $html = '';
+}
+
+/**
+ * @kphp-warn-performance string-concat-in-loop
+ */
+function test() {
+  $s = '';
+  for ($i = 0; $i != 10; ++$i) {
+    $s = $s . "<li>" . $i . "</li>";
+  }
+
+  $a = new A;
+  foreach ([1, 2, 3] as $x) {
+    $a->html .= $x . ',';
+  }
+
+  $t = '';
+  $i = 0;
+  while ($i++ < 10) {
+    $t = $s . $i;
+  }
+
+  $a->html = $a->html . $t;
+  echo $s, $a->html, $t, "\n";
+}
+
+test();
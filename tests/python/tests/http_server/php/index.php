@@ -8,6 +8,34 @@ class A {
   public $b = "hello";
 }
 
+/**
+ * @kphp-immutable-class
+ * @kphp-serializable
+ */
+class SerializableA {
+  /**
+   * @kphp-serialized-field 1
+   * @var string
+   */
+  public $value;
+
+  public function __construct(string $value) {
+    $this->value = $value;
+  }
+}
+
+/**
+ * @kphp-immutable-class
+ * @kphp-serializable
+ */
+class SerializableB {
+  /**
+   * @kphp-serialized-field 1
+   * @var int
+   */
+  public $value = 0;
+}
+
 /**
  * @kphp-required
  */
@@ -74,6 +102,14 @@ if ($_SERVER["PHP_SELF"] === "/ini_get") {
   echo "after sleep";
 } else if ($_SERVER["PHP_SELF"] === "/store-in-instance-cache") {
   echo instance_cache_store("test_key" . rand(), new A);
+} else if ($_SERVER["PHP_SELF"] === "/store-serializable-in-instance-cache") {
+  echo instance_cache_store("serializable_" . $_GET["key"], new SerializableA((string)$_GET["value"]));
+} else if ($_SERVER["PHP_SELF"] === "/fetch-serializable-from-instance-cache") {
+  $a = instance_cache_fetch(SerializableA::class, "serializable_" . $_GET["key"]);
+  echo $a ? $a->value : "null";
+} else if ($_SERVER["PHP_SELF"] === "/fetch-serializable-b-from-instance-cache") {
+  $b = instance_cache_fetch(SerializableB::class, "serializable_" . $_GET["key"]);
+  echo $b ? $b->value : "null";
 } else if ($_SERVER["PHP_SELF"] === "/test_zstd") {
   $res = "";
   switch($_GET["type"]) {
@@ -161,6 +197,26 @@ if ($_SERVER["PHP_SELF"] === "/ini_get") {
     echo "pid=" . posix_getpid();
 } else if ($_SERVER["PHP_SELF"] === "/test_script_errors") {
   critical_error("Test error");
+} else if ($_SERVER["PHP_SELF"] === "/test_xgboost_predict") {
+  $rows = [];
+  foreach ((array)json_decode(file_get_contents('php://input'), true) as $row) {
+    $features = [];
+    foreach ((array)$row as $feature => $value) {
+      $features[$feature] = (float)$value;
+    }
+    $rows[] = $features;
+  }
+  echo json_encode(kphp_ml_xgboost_predict($rows));
+} else if ($_SERVER["PHP_SELF"] === "/test_sampling_profiler") {
+  $sum = 0;
+  for ($i = 0; $i < (int)$_GET["iterations"]; ++$i) {
+    $sum += crc32("sample" . $i);
+  }
+  echo $sum;
+} else if ($_SERVER["PHP_SELF"] === "/test_regexp_cache") {
+  $matches = [];
+  preg_match((string)$_GET["pattern"], (string)$_GET["subject"], $matches);
+  echo $matches["word"] ?? "";
 } else {
     if ($_GET["hints"] === "yes") {
         send_http_103_early_hints(["Content-Type: text/plain or application/json", "Link: </script.js>; rel=preload; as=script"]);
@@ -0,0 +1,51 @@
+import signal
+
+from python.lib.testcase import KphpServerAutoTestCase
+
+
+class TestRegexpCache(KphpServerAutoTestCase):
+    @classmethod
+    def extra_class_setup(cls):
+        cls.kphp_server.update_options({
+            "--workers-num": 1
+        })
+
+    def _preg_match(self, pattern, subject):
+        resp = self.kphp_server.http_get(uri="/test_regexp_cache", params={"pattern": pattern, "subject": subject})
+        self.assertEqual(resp.status_code, 200)
+        return resp.text
+
+    def _restart_worker(self):
+        worker = self.kphp_server.get_workers()[0]
+        worker.send_signal(signal.SIGTERM)
+        worker.wait(timeout=10)
+
+    def test_shared_regexp_compilation(self):
+        pattern = "/(?<word>[a-z]+)(\\d+)(?=!)/"
+        stats_before = self.kphp_server.get_stats(prefix="kphp_server.workers_general_regexp_cache_")
+
+        # the pattern compiled in two requests is promoted to the worker cache and is shared with the master
+        self.assertEqual(self._preg_match(pattern, "..abc12!"), "abc")
+        self.assertEqual(self._preg_match(pattern, "..def34!"), "def")
+        self.kphp_server.assert_stats(
+            initial_stats=stats_before,
+            prefix="kphp_server.workers_general_regexp_cache_",
+            timeout=10,
+            expected_added_stats={"hits": 0, "misses": 2, "promotions": 1})
+
+        # the master compiles the pattern before forking the new worker, the new worker inherits it
+        self._restart_worker()
+        self.assertEqual(self._preg_match(pattern, "..xyz7!"), "xyz")
+        self.kphp_server.assert_stats(
+            initial_stats=stats_before,
+            prefix="kphp_server.workers_general_regexp_cache_",
+            timeout=10,
+            expected_added_stats={"hits": 1, "misses": 2, "promotions": 1})
+
+    def test_regexp_compilation_warnings(self):
+        # the warnings are reported by the request compilation only, the promotion and the master don't repeat them
+        for _ in range(3):
+            self.assertEqual(self._preg_match("/x+(?=y)/S", "xxy"), "")
+        self._restart_worker()
+        self.assertEqual(self._preg_match("/x+(?=y)/S", "xxy"), "")
+        self.kphp_server.assert_log(4 * ["Warning: Study doesn't supported"], timeout=5)
@@ -0,0 +1,39 @@
+import os
+import re
+import time
+
+from python.lib.testcase import KphpServerAutoTestCase
+
+
+class TestSamplingProfiler(KphpServerAutoTestCase):
+    OUTPUT_FILE = "sampling-profile.folded"
+
+    @classmethod
+    def extra_class_setup(cls):
+        cls.kphp_server.update_options({
+            "--workers-num": 2,
+            "--sampling-profiler-frequency": 1000,
+            "--sampling-profiler-output": cls.OUTPUT_FILE,
+            "--sampling-profiler-dump-period": 1,
+        })
+
+    def _read_profile(self):
+        try:
+            with open(os.path.join(self.kphp_server_working_dir, self.OUTPUT_FILE)) as f:
+                return f.read()
+        except FileNotFoundError:
+            return ""
+
+    def test_folded_output(self):
+        # the master dumps the samples of the previous period, so the workers are kept busy until they show up
+        profile = ""
+        deadline = time.time() + 30
+        while not profile and time.time() < deadline:
+            resp = self.kphp_server.http_get("/test_sampling_profiler", params={"iterations": 1000000})
+            self.assertEqual(resp.status_code, 200)
+            profile = self._read_profile()
+        self.assertNotEqual(profile, "", "the sampling profiler output is empty")
+
+        for line in profile.splitlines():
+            self.assertRegex(line, re.compile(r"^[^ ;][^;]*(;[^;]+)* \d+$"))
+            self.assertGreater(int(line.rsplit(" ", 1)[1]), 0)
@@ -58,3 +58,36 @@ class TestWarmUpOnGracefulRestart(KphpServerAutoTestCase):
         # here it must be hot enough
         self.assertEqual(os.waitpid(old_pid, os.WNOHANG)[0], old_pid)
         self.kphp_server.assert_log(["[is_instance_cache_hot_enough = 1]"], "Instance cache was not warmed up")
+
+    def test_instance_cache_snapshot(self):
+        snapshot_path = os.path.join(self.kphp_server_working_dir, "instance_cache.snapshot")
+        self.kphp_server.update_options({"--instance-cache-snapshot": snapshot_path})
+        try:
+            old_pid = self.prepare_for_test(workers_part=0.01, instance_cache_part=0.001, timeout_sec=30)
+            for i in range(10):
+                resp = self.kphp_server.http_get(uri='/store-serializable-in-instance-cache?key={}&value=v{}'.format(i, i))
+                self.assertEqual(resp.status_code, 200)
+                self.assertEqual(resp.text, "1")
+
+            time.sleep(1)
+            self.kphp_server.start()
+            self.kphp_server.assert_log(["instance cache snapshot is loaded: 10 elements"], "Instance cache snapshot was not loaded")
+            # the old master exits as soon as the loaded snapshot makes the new instance cache hot enough
+            for _ in range(20):
+                if os.waitpid(old_pid, os.WNOHANG)[0] == old_pid:
+                    break
+                time.sleep(0.5)
+
+            # the snapshot element of another class isn't unpacked, but it's reported
+            resp = self.kphp_server.http_get(uri='/fetch-serializable-b-from-instance-cache?key=0')
+            self.assertEqual(resp.status_code, 200)
+            self.assertEqual(resp.text, "null")
+            self.kphp_server.assert_log(["Warning: Trying to fetch incompatible instance class from the instance cache snapshot: "
+                                         "expect 'SerializableB', got 'SerializableA'"])
+
+            for i in range(10):
+                resp = self.kphp_server.http_get(uri='/fetch-serializable-from-instance-cache?key={}'.format(i))
+                self.assertEqual(resp.status_code, 200)
+                self.assertEqual(resp.text, "v{}".format(i))
+        finally:
+            self.kphp_server.update_options({"--instance-cache-snapshot": None})
@@ -0,0 +1,38 @@
+from python.lib.testcase import KphpServerAutoTestCase
+
+
+class TestXgboostPredict(KphpServerAutoTestCase):
+    @classmethod
+    def extra_class_setup(cls):
+        cls.kphp_server.update_options({
+            "--workers-num": 1,
+            "--xgboost-model-path-experimental": "data/xgboost_model.txt",
+        })
+
+    def _predict(self, rows):
+        resp = self.kphp_server.http_post(uri="/test_xgboost_predict", json=rows)
+        self.assertEqual(resp.status_code, 200)
+        return resp.json()
+
+    def test_predict_rows(self):
+        self.assertEqual(self._predict([
+            {"0": 0.0, "1": 0.0, "2": 0.0},
+            {"0": 1.0, "1": -2.0, "2": 5.0},
+            # the absent features are missing values
+            {},
+            {"2": 0.5},
+        ]), [0.0, 1.125, -0.375, -0.375])
+
+    def test_predict_batches(self):
+        # the rows are evaluated by batches of 64
+        rows = [{"0": 0.0, "1": 0.0, "2": 0.0}, {"0": 1.0, "1": -2.0, "2": 5.0}, {"0": 0.0, "1": -1.5}] * 50
+        self.assertEqual(self._predict(rows), [0.0, 1.125, 0.375] * 50)
+
+    def test_predict_malformed_rows(self):
+        self.assertEqual(self._predict([]), [])
+        # the string keys and the feature indexes out of the model are ignored
+        self.assertEqual(self._predict([
+            {"f0": 1.0, "-1": 7.0, "10": 3.0, "0": 1.0},
+            {"feature": 5.0},
+            {"100500": -1.0, "2": 2.0},
+        ]), [-0.375, -0.375, 1.125])
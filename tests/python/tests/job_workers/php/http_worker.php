@@ -70,6 +70,10 @@ function do_http_worker() {
       test_send_job_no_reply();
       return;
     }
+    case "/test_job_response_stream": {
+      test_job_response_stream();
+      return;
+    }
     case "/test_reference_invariant": {
       require_once "ReferenceInvariant/http_worker.php";
       test_reference_invariant();
@@ -240,3 +244,36 @@ function test_send_job_no_reply() {
   send_jobs($context, (int)$context["send-timeout"], true);
   echo json_encode("Success");
 }
+
+function test_job_response_stream() {
+  $context = json_decode(file_get_contents('php://input'));
+  $stream = (bool)$context["stream"];
+  $result = [];
+  foreach ($context["data"] as $arr) {
+    $req = new X2Request;
+    $req->tag = "x2_stream";
+    $req->arr_request = (array)$arr;
+    $job = $stream ? kphp_job_worker_start_stream($req, -1) : kphp_job_worker_start($req, -1);
+    if (!$job) {
+      critical_error("Can't send job");
+    }
+
+    $chunks = [];
+    while ($chunk_future = kphp_job_worker_next_response_chunk($job)) {
+      $chunk = wait($chunk_future);
+      if (!$chunk) {
+        break;
+      }
+      if ($chunk instanceof X2Response) {
+        $chunks[] = $chunk->arr_reply;
+      }
+    }
+    $resp = wait($job);
+    if ($resp instanceof X2Response) {
+      $result[] = ["chunks" => $chunks, "final" => $resp->arr_reply];
+    } else if ($resp instanceof KphpJobWorkerResponseError) {
+      $result[] = ["error" => $resp->getError(), "error_code" => $resp->getErrorCode()];
+    }
+  }
+  echo json_encode(["jobs-result" => $result]);
+}
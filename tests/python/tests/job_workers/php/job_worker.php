@@ -28,6 +28,8 @@ function do_job_worker() {
         return self_lock_job($req);
       case "x2_no_reply":
         return x2_no_reply($req);
+      case "x2_stream":
+        return x2_stream($req);
     }
     if ($req->tag !== "") {
       critical_error("Unknown tag " + $req->tag);
@@ -145,6 +147,19 @@ function x2_no_reply(X2Request $x2_req) {
   fprintf(STDERR, "Finish no reply job: sum = $sum\n");
 }
 
+function x2_stream(X2Request $x2_req) {
+  $x2_resp = new X2Response;
+  foreach ($x2_req->arr_request as $value) {
+    $chunk = new X2Response;
+    $chunk->arr_reply[] = $value ** 2;
+    if (!kphp_job_worker_store_response_chunk($chunk)) {
+      // the rest goes with the final response
+      $x2_resp->arr_reply[] = $value ** 2;
+    }
+  }
+  kphp_job_worker_store_response($x2_resp);
+}
+
 function sync_job(X2Request $req) {
   $id = $req->arr_request[0];
   instance_cache_store("sync_job_started_$id", new SyncJobCommand('started'));
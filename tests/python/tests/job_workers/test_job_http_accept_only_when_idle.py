@@ -0,0 +1,37 @@
+from python.lib.testcase import KphpServerAutoTestCase
+
+
+class TestJobHttpAcceptOnlyWhenIdle(KphpServerAutoTestCase):
+    @classmethod
+    def extra_class_setup(cls):
+        cls.kphp_server.update_options({
+            "--workers-num": 4,
+            "--job-workers-ratio": 0.5,
+            "--http-accept-only-when-idle": True,
+        })
+
+    def test_jobs_with_http_accept_only_when_idle(self):
+        stats_before = self.kphp_server.get_stats(prefix="kphp_server.server_workers_")
+        # the job workers run the scripts, but they don't pause the http socket they don't listen
+        for _ in range(5):
+            resp = self.kphp_server.http_post(
+                uri="/test_simple_cpu_job",
+                json={"data": [[1, 2, 3, 4], [7, 9, 12]]})
+            self.assertEqual(resp.status_code, 200)
+            self.assertEqual(resp.json(), {
+                "jobs-result": [
+                    {"data": [1 * 1, 2 * 2, 3 * 3, 4 * 4], "stats": []},
+                    {"data": [7 * 7, 9 * 9, 12 * 12], "stats": []},
+                ]})
+
+        self.kphp_server.assert_stats(
+            initial_stats=stats_before,
+            prefix="kphp_server.server_workers_",
+            timeout=10,
+            expected_added_stats={
+                "strange_dead": 0,
+                "killed": 0,
+                "failed": 0,
+                "dead": 0,
+                "terminated": 0,
+            })
@@ -0,0 +1,49 @@
+from python.lib.testcase import KphpServerAutoTestCase
+
+
+class TestJobResponseStream(KphpServerAutoTestCase):
+    @classmethod
+    def extra_class_setup(cls):
+        cls.kphp_server.update_options({
+            "--workers-num": 4,
+            "--job-workers-ratio": 0.5,
+            "--verbosity-job-workers=2": True,
+        })
+
+    def _request_stream(self, data, stream):
+        resp = self.kphp_server.http_post(
+            uri="/test_job_response_stream",
+            json={"data": data, "stream": stream})
+        self.assertEqual(resp.status_code, 200)
+        return resp.json()["jobs-result"]
+
+    def test_job_response_stream(self):
+        stats_before = self.kphp_server.get_stats(prefix="kphp_server.workers_job_")
+        data = [[1, 2, 3, 4], [7, 9, 12], list(range(100))]
+        result = self._request_stream(data, True)
+
+        self.assertEqual(len(result), len(data))
+        sent_chunks = 0
+        for arr, job_result in zip(data, result):
+            # the chunks refused because of the backpressure are moved into the final response
+            received = [x for chunk in job_result["chunks"] for x in chunk] + job_result["final"]
+            self.assertEqual(sorted(received), sorted(x * x for x in arr))
+            sent_chunks += len(job_result["chunks"])
+
+        total = sum(len(arr) for arr in data)
+        self.kphp_server.assert_stats(
+            initial_stats=stats_before,
+            prefix="kphp_server.workers_job_",
+            timeout=10,
+            expected_added_stats={
+                "jobs_response_chunks": sent_chunks,
+                "jobs_response_chunks_throttled": total - sent_chunks,
+                "memory_messages_shared_messages_buffer_acquire_fails": 0,
+            })
+
+    def test_job_response_chunks_without_stream(self):
+        result = self._request_stream([[1, 2, 3]], False)
+        self.assertEqual(result, [{"chunks": [], "final": [1, 4, 9]}])
+        self.kphp_server.assert_log(
+            3 * ["Warning: Can't store job response chunk X2Response: the job isn't started by kphp_job_worker_start_stream()"],
+            timeout=5)